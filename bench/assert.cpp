@@ -0,0 +1,174 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/assert.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Cost of each CGS_VIOLATE_* mode in hot loops.
+// Every mode's macro is defined whichever mode is selected, so they are all compared in one file.
+
+namespace
+{
+
+enum class mode
+{
+    none,
+    abort,
+    // abort with the failure path expanded at the call site, as cgs_assert_abort did before it was made cold
+    abort_inline,
+    // abort, with cgs_assert_compare_abort where the benchmark compares two values
+    abort_compare,
+    ignore,
+    throw_,
+    sample,
+};
+
+// asserts predicate(), which the mode may not evaluate
+template <mode Mode, typename Predicate>
+inline void check(Predicate predicate)
+{
+    if constexpr(Mode == mode::abort) {
+        cgs_assert_abort(predicate());
+    }
+    else if constexpr(Mode == mode::abort_inline) {
+        if(!cgs_likely(predicate())) {
+            std::fputs("Assertion failed (predicate()) at " __FILE__ ":" CGS_LINE "\n", stderr);
+            std::fflush(stderr);
+            std::abort();
+        }
+    }
+    else if constexpr(Mode == mode::ignore) {
+        cgs_assert_ignore(predicate());
+    }
+    else if constexpr(Mode == mode::throw_) {
+        cgs_assert_throw(predicate());
+    }
+    else if constexpr(Mode == mode::sample) {
+        cgs_assert_sample(predicate());
+    }
+    else {
+        static_cast<void>(predicate);
+    }
+}
+
+struct input
+{
+    std::vector<std::int32_t> values;
+    std::vector<std::uint32_t> indices;
+
+    input()
+        : values(1 << 14)
+        , indices(values.size())
+    {
+        bench::random random {};
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<std::int32_t>(random() % 1000);
+            indices[i] = static_cast<std::uint32_t>(random() % values.size());
+        }
+    }
+};
+
+// the kernels are out of line, so each loop is register allocated on its own,
+// not as part of the measuring code they would be inlined into
+
+// a precondition on every element, in a loop that vectorizes without it
+template <mode Mode>
+[[gnu::noinline]] std::int32_t sum_kernel(const std::int32_t* values, std::size_t size)
+{
+    std::int32_t sum = 0;
+    for(std::size_t i = 0; i < size; ++i) {
+        check<Mode>([&] { return values[i] >= 0; });
+        sum += values[i];
+    }
+    return sum;
+}
+
+// a bounds check on every access, in a loop that is scalar anyway
+template <mode Mode>
+[[gnu::noinline]] std::int32_t gather_kernel(const std::int32_t* values, const std::uint32_t* indices, std::size_t size)
+{
+    std::int32_t sum = 0;
+    for(std::size_t i = 0; i < size; ++i) {
+        if constexpr(Mode == mode::abort_compare) {
+            // also passes both operands to the failure path
+            cgs_assert_compare_abort(indices[i], <, size);
+        }
+        else {
+            check<Mode>([&] { return indices[i] < size; });
+        }
+        sum += values[indices[i]];
+    }
+    return sum;
+}
+
+// an O(n) invariant: the next `window` values are in range
+template <mode Mode>
+[[gnu::noinline]] std::int32_t expensive_kernel(const std::int32_t* values, std::size_t size, std::size_t window)
+{
+    std::int32_t sum = 0;
+    for(std::size_t i = 0; i < size - window; ++i) {
+        check<Mode>([&] {
+            bool inRange = true;
+            for(std::size_t j = i; j < i + window; ++j) {
+                inRange &= values[j] >= 0 && values[j] < 1000;
+            }
+            return inRange;
+        });
+        sum += values[i];
+    }
+    return sum;
+}
+
+template <mode Mode>
+void asserts(bench::state& state)
+{
+    static const input in {};
+    const std::int32_t* values = in.values.data();
+    const std::uint32_t* indices = in.indices.data();
+    const std::size_t size = in.values.size();
+    bench::do_not_optimize(values);
+    bench::do_not_optimize(indices);
+
+    if constexpr(Mode != mode::abort_compare) {
+        state.measure("sum", size, [&] {
+            bench::do_not_optimize(sum_kernel<Mode>(values, size));
+        });
+    }
+    state.measure("gather", size, [&] {
+        bench::do_not_optimize(gather_kernel<Mode>(values, indices, size));
+    });
+    if constexpr(Mode != mode::abort_compare) {
+        constexpr std::size_t window = 64;
+        state.measure("expensive", size - window, [&] {
+            bench::do_not_optimize(expensive_kernel<Mode>(values, size, window));
+        });
+    }
+}
+
+} // namespace
+
+CGS_BENCHMARK("assert/none") { asserts<mode::none>(state); }
+CGS_BENCHMARK("assert/abort") { asserts<mode::abort>(state); }
+CGS_BENCHMARK("assert/abort_inline") { asserts<mode::abort_inline>(state); }
+CGS_BENCHMARK("assert/abort_compare") { asserts<mode::abort_compare>(state); }
+CGS_BENCHMARK("assert/ignore") { asserts<mode::ignore>(state); }
+CGS_BENCHMARK("assert/throw") { asserts<mode::throw_>(state); }
+CGS_BENCHMARK("assert/sample") { asserts<mode::sample>(state); }
@@ -0,0 +1,289 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_BENCH_HPP
+#define CGS_BENCH_HPP
+
+#include <algorithm> // sort
+#include <chrono>
+#include <cmath> // ceil
+#include <cstddef> // size_t
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility> // forward
+#include <vector>
+
+/*
+A small microbenchmark harness for cgs-bench, so measuring needs no downloads.
+
+Register a benchmark with CGS_BENCHMARK, set up its input, then time a call with `state.measure`:
+
+    CGS_BENCHMARK("math/lerp/array")
+    {
+        std::vector<float> a = ..., b = ..., out(a.size());
+        state.measure(a.size(), [&] {
+            cgs::lerp(a.data(), a.data() + a.size(), b.data(), 0.5f, out.data());
+            bench::clobber_memory();
+        });
+    }
+
+`measure` calls the function until a sample takes at least `min_time`,
+then takes `repetitions` samples, and reports nanoseconds per item.
+Use `do_not_optimize` and `clobber_memory` so the compiler can not delete or hoist the work.
+*/
+
+// Define a benchmark, the body has a `bench::state& state` parameter.
+#define CGS_BENCHMARK(name) \
+    CGS_BENCH_DETAIL_BENCHMARK(name, CGS_BENCH_DETAIL_CONCAT(cgs_benchmark_, __LINE__))
+
+#define CGS_BENCH_DETAIL_CONCAT_(a, b) a##b
+#define CGS_BENCH_DETAIL_CONCAT(a, b) CGS_BENCH_DETAIL_CONCAT_(a, b)
+#define CGS_BENCH_DETAIL_BENCHMARK(name, function) \
+    static void function(::bench::state& state); \
+    static const ::bench::registrar CGS_BENCH_DETAIL_CONCAT(function, _registrar) { name, &function }; \
+    static void function([[maybe_unused]] ::bench::state& state)
+
+namespace bench
+{
+
+/**
+ * @brief Make the compiler assume value is read, so the computation of it is kept.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    if constexpr(std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(void*)) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+    else {
+        asm volatile("" : : "m"(value) : "memory");
+    }
+}
+
+/**
+ * @brief Make the compiler assume value is read and changed, so it can not constant fold or hoist it.
+ */
+template <typename T>
+inline void do_not_optimize(T& value)
+{
+    // not "+m,r": GCC may pick memory without storing value there first
+    if constexpr(std::is_integral<T>::value || std::is_pointer<T>::value) {
+        asm volatile("" : "+r"(value) : : "memory");
+    }
+    else {
+        asm volatile("" : "+m"(value) : : "memory");
+    }
+}
+
+/**
+ * @brief Make the compiler assume all memory is read and written, so stores are kept.
+ */
+inline void clobber_memory()
+{
+    asm volatile("" : : : "memory");
+}
+
+struct options
+{
+    // samples per measurement
+    std::size_t repetitions = 15;
+
+    // a sample calls the function until this much time passed
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds{ 5 };
+};
+
+/**
+ * @brief Samples of one measurement, in nanoseconds per item, sorted.
+ */
+struct result
+{
+    std::string name;
+    std::size_t items_per_call = 0;
+    std::size_t calls_per_sample = 0;
+    std::vector<double> samples;
+
+    /**
+     * @brief Sample at fraction q of the sorted samples, interpolated between neighbours.
+     */
+    double percentile(double q) const
+    {
+        if(samples.empty()) {
+            return 0;
+        }
+        const double position = q * static_cast<double>(samples.size() - 1);
+        const auto below = static_cast<std::size_t>(position);
+        const std::size_t above = std::min(below + 1, samples.size() - 1);
+        const double fraction = position - static_cast<double>(below);
+        return samples[below] + (samples[above] - samples[below]) * fraction;
+    }
+
+    double median() const
+    {
+        return percentile(0.5);
+    }
+
+    double mean() const
+    {
+        double sum = 0;
+        for(double sample : samples) {
+            sum += sample;
+        }
+        return samples.empty() ? 0 : sum / static_cast<double>(samples.size());
+    }
+};
+
+/**
+ * @brief Passed to each benchmark, to measure and collect results.
+ */
+class state
+{
+private:
+
+    using clock = std::chrono::steady_clock;
+
+    const std::string& _name;
+    const options& _options;
+    std::vector<result>& _results;
+
+    template <typename F>
+    static std::chrono::nanoseconds time_calls(std::size_t calls, F& f)
+    {
+        const auto start = clock::now();
+        for(std::size_t call = 0; call < calls; ++call) {
+            f();
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+    }
+
+public:
+
+    state(const std::string& name, const options& opts, std::vector<result>& results)
+        : _name(name)
+        , _options(opts)
+        , _results(results)
+    { }
+
+    state(const state&) = delete;
+    state& operator=(const state&) = delete;
+
+    const options& opts() const noexcept
+    {
+        return _options;
+    }
+
+    /**
+     * @brief Time f, which processes `items` items per call, as this benchmark's result.
+     */
+    template <typename F>
+    void measure(std::size_t items, F&& f)
+    {
+        measure(std::string{}, items, std::forward<F>(f));
+    }
+
+    /**
+     * @brief Time f as a result named `<benchmark>/<label>`, to compare variants on the same input.
+     */
+    template <typename F>
+    void measure(const std::string& label, std::size_t items, F&& f)
+    {
+        // warm up caches and branch predictors, and resolve dispatch tables
+        f();
+
+        // grow calls per sample until one sample takes min_time
+        std::size_t calls = 1;
+        for(;;) {
+            const auto elapsed = time_calls(calls, f);
+            if(elapsed >= _options.min_time) {
+                break;
+            }
+            const double scale = static_cast<double>(_options.min_time.count())
+                / static_cast<double>(std::max<std::chrono::nanoseconds::rep>(elapsed.count(), 1));
+            calls = static_cast<std::size_t>(std::ceil(static_cast<double>(calls) * std::min(scale * 1.2, 10.0)));
+        }
+
+        result measured {};
+        measured.name = label.empty() ? _name : _name + "/" + label;
+        measured.items_per_call = items;
+        measured.calls_per_sample = calls;
+        const double perSample = static_cast<double>(calls) * static_cast<double>(std::max<std::size_t>(items, 1));
+        for(std::size_t repetition = 0; repetition < _options.repetitions; ++repetition) {
+            measured.samples.push_back(static_cast<double>(time_calls(calls, f).count()) / perSample);
+        }
+        std::sort(measured.samples.begin(), measured.samples.end());
+        _results.push_back(std::move(measured));
+    }
+};
+
+using function = void (*)(state&);
+
+struct benchmark
+{
+    const char* name;
+    function run;
+};
+
+inline std::vector<benchmark>& registry()
+{
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+/**
+ * @brief Adds a benchmark to the registry during static initialization, used by CGS_BENCHMARK.
+ */
+struct registrar
+{
+    registrar(const char* name, function run)
+    {
+        registry().push_back({ name, run });
+    }
+};
+
+/**
+ * @brief Deterministic pseudo random numbers for benchmark input (xorshift64).
+ */
+class random
+{
+private:
+
+    std::uint64_t _state;
+
+public:
+
+    explicit random(std::uint64_t seed = 88172645463325252u) noexcept
+        : _state(seed)
+    { }
+
+    std::uint64_t operator()() noexcept
+    {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+
+    /**
+     * @brief Uniform in [low, high).
+     */
+    double uniform(double low, double high) noexcept
+    {
+        return low + (high - low) * static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+};
+
+} // namespace bench
+
+#endif // CGS_BENCH_HPP
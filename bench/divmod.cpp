@@ -0,0 +1,195 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/bounded.hpp"
+#include "cgs/divider.hpp"
+#include "cgs/math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// divmod before it was fused: div and mod each divide and adjust
+namespace separate
+{
+
+template <cgs::div_round_mode RoundMode, typename Int>
+Int div(Int n, Int d)
+{
+    if constexpr(RoundMode == cgs::div_round_mode::floor) {
+        if((n < 0) != (d < 0)) {
+            n -= d - 1;
+        }
+    }
+    else if constexpr(RoundMode == cgs::div_round_mode::euclid) {
+        if(n < 0) {
+            n -= cgs::abs(d) - 1;
+        }
+    }
+    return n / d;
+}
+
+template <cgs::div_round_mode RoundMode, typename Int>
+Int mod(Int n, Int d)
+{
+    const Int builtin = n % d;
+    if constexpr(RoundMode == cgs::div_round_mode::floor) {
+        if((n < 0) != (d < 0) && builtin != 0) {
+            return builtin + d;
+        }
+    }
+    else if constexpr(RoundMode == cgs::div_round_mode::euclid) {
+        if(n < 0 && builtin != 0) {
+            return builtin + cgs::abs(d);
+        }
+    }
+    return builtin;
+}
+
+template <cgs::div_round_mode RoundMode, typename Int>
+cgs::div_type<Int> divmod(Int n, Int d)
+{
+    return { div<RoundMode>(n, d), mod<RoundMode>(n, d) };
+}
+
+} // namespace separate
+
+namespace
+{
+
+using cgs::div_round_mode;
+
+template <typename Int>
+std::vector<Int> numerators()
+{
+    std::vector<Int> values(1 << 14);
+    bench::random random {};
+    for(Int& value : values) {
+        value = static_cast<Int>(random());
+    }
+    return values;
+}
+
+// a runtime divisor, so the compiler can not use magic numbers
+template <typename Int>
+Int divisor()
+{
+    Int d = -37;
+    bench::do_not_optimize(d);
+    return d;
+}
+
+template <div_round_mode RoundMode, typename Int>
+void div_mod(bench::state& state)
+{
+    const std::vector<Int> n = numerators<Int>();
+    const Int d = divisor<Int>();
+    std::vector<Int> quot(n.size());
+    std::vector<Int> rem(n.size());
+    std::vector<cgs::div_type<Int>> both(n.size());
+
+    state.measure("div", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            quot[i] = cgs::div<RoundMode>(n[i], d);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("mod", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            rem[i] = cgs::mod<RoundMode>(n[i], d);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("divmod", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            both[i] = cgs::divmod<RoundMode>(n[i], d);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("divmod_separate", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            both[i] = separate::divmod<RoundMode>(n[i], d);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("divmod_array", n.size(), [&] {
+        cgs::divmod<RoundMode>(n.data(), n.data() + n.size(), d, quot.data(), rem.data());
+        bench::clobber_memory();
+    });
+
+    const cgs::divider<Int, RoundMode> divider { d };
+    state.measure("divmod_divider", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            both[i] = divider.divmod(n[i]);
+        }
+        bench::clobber_memory();
+    });
+}
+
+// what the ranges of bounded operands remove: the zero check, the rounding fixup, or the division
+template <div_round_mode RoundMode>
+void bounded_mod(bench::state& state)
+{
+    using Int = std::int32_t;
+    using natural = cgs::bounded<Int, 0, INT32_MAX>;
+    using positive = cgs::bounded<Int, 1, INT32_MAX>;
+
+    std::vector<Int> n = numerators<Int>();
+    for(Int& value : n) {
+        value &= INT32_MAX;
+    }
+    Int d = 37;
+    bench::do_not_optimize(d);
+    std::vector<Int> rem(n.size());
+
+    state.measure("pow2", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            rem[i] = cgs::mod<RoundMode>(n[i], Int{16});
+        }
+        bench::clobber_memory();
+    });
+    state.measure("pow2_bounded", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            rem[i] = cgs::mod<RoundMode>(natural{ n[i] }, cgs::constant<Int{16}>);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("runtime", n.size(), [&] {
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            rem[i] = cgs::mod<RoundMode>(n[i], d);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("runtime_bounded", n.size(), [&] {
+        const positive divisor { d };
+        for(std::size_t i = 0; i < n.size(); ++i) {
+            rem[i] = cgs::mod<RoundMode>(natural{ n[i] }, divisor);
+        }
+        bench::clobber_memory();
+    });
+}
+
+} // namespace
+
+CGS_BENCHMARK("divmod/bounded/floor") { bounded_mod<div_round_mode::floor>(state); }
+CGS_BENCHMARK("divmod/bounded/euclid") { bounded_mod<div_round_mode::euclid>(state); }
+
+CGS_BENCHMARK("divmod/int32/trunc") { div_mod<div_round_mode::trunc, std::int32_t>(state); }
+CGS_BENCHMARK("divmod/int32/floor") { div_mod<div_round_mode::floor, std::int32_t>(state); }
+CGS_BENCHMARK("divmod/int32/euclid") { div_mod<div_round_mode::euclid, std::int32_t>(state); }
+CGS_BENCHMARK("divmod/int64/trunc") { div_mod<div_round_mode::trunc, std::int64_t>(state); }
+CGS_BENCHMARK("divmod/int64/floor") { div_mod<div_round_mode::floor, std::int64_t>(state); }
+CGS_BENCHMARK("divmod/int64/euclid") { div_mod<div_round_mode::euclid, std::int64_t>(state); }
@@ -0,0 +1,139 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/elementary.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// accurate is accuracy::accurate, the double-double code at runtime too.
+// std is also the default tier, accuracy::standard, at runtime.
+// inline is the code of accuracy::fast, which it runs at runtime only where it measures faster than std.
+
+namespace
+{
+
+
+template <typename T>
+std::vector<T> inputs(double low, double high, std::uint64_t seed)
+{
+    std::vector<T> values(1 << 14);
+    bench::random random { seed };
+    for(T& value : values) {
+        value = static_cast<T>(random.uniform(low, high));
+    }
+    return values;
+}
+
+template <typename T, typename Standard, typename Accurate, typename Inline>
+void unary(bench::state& state, double low, double high, Standard standard, Accurate accurate, Inline inline_code)
+{
+    const std::vector<T> x = inputs<T>(low, high, 1);
+    std::vector<T> out(x.size());
+
+    state.measure("std", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = standard(x[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("accurate", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = accurate(x[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("inline", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = inline_code(x[i]);
+        }
+        bench::clobber_memory();
+    });
+}
+
+template <typename T, typename Standard, typename Accurate, typename Inline>
+void binary(bench::state& state, double low, double high, double low2, double high2,
+    Standard standard, Accurate accurate, Inline inline_code)
+{
+    const std::vector<T> x = inputs<T>(low, high, 1);
+    const std::vector<T> y = inputs<T>(low2, high2, 2);
+    std::vector<T> out(x.size());
+
+    state.measure("std", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = standard(x[i], y[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("accurate", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = accurate(x[i], y[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("inline", x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = inline_code(x[i], y[i]);
+        }
+        bench::clobber_memory();
+    });
+}
+
+#define CGS_ELEMENTARY_UNARY(name, inline_name, T, low, high) \
+    unary<T>(state, low, high, [](T x) { return std::name(x); }, [](T x) { return cgs::name<cgs::accuracy::accurate>(x); }, \
+        [](T x) { return cgs::detail::inline_name(x); })
+
+} // namespace
+
+CGS_BENCHMARK("elementary/float/exp") { CGS_ELEMENTARY_UNARY(exp, exp_fast, float, -80, 80); }
+CGS_BENCHMARK("elementary/float/exp2") { CGS_ELEMENTARY_UNARY(exp2, exp2_fast, float, -120, 120); }
+CGS_BENCHMARK("elementary/float/log") { CGS_ELEMENTARY_UNARY(log, log_fast, float, 0, 1000); }
+CGS_BENCHMARK("elementary/float/log2") { CGS_ELEMENTARY_UNARY(log2, log2_fast, float, 0, 1000); }
+CGS_BENCHMARK("elementary/float/sin") { CGS_ELEMENTARY_UNARY(sin, sin_fast<0>, float, -10, 10); }
+CGS_BENCHMARK("elementary/float/cos") { CGS_ELEMENTARY_UNARY(cos, sin_fast<1>, float, -10, 10); }
+CGS_BENCHMARK("elementary/double/exp") { CGS_ELEMENTARY_UNARY(exp, exp_fast, double, -700, 700); }
+CGS_BENCHMARK("elementary/double/exp2") { CGS_ELEMENTARY_UNARY(exp2, exp2_fast, double, -1000, 1000); }
+CGS_BENCHMARK("elementary/double/log") { CGS_ELEMENTARY_UNARY(log, log_fast, double, 0, 1000); }
+CGS_BENCHMARK("elementary/double/log2") { CGS_ELEMENTARY_UNARY(log2, log2_fast, double, 0, 1000); }
+CGS_BENCHMARK("elementary/double/sin") { CGS_ELEMENTARY_UNARY(sin, sin_fast<0>, double, -10, 10); }
+CGS_BENCHMARK("elementary/double/cos") { CGS_ELEMENTARY_UNARY(cos, sin_fast<1>, double, -10, 10); }
+
+CGS_BENCHMARK("elementary/float/atan2")
+{
+    binary<float>(state, -10, 10, -10, 10, [](float y, float x) { return std::atan2(y, x); },
+        [](float y, float x) { return cgs::atan2<cgs::accuracy::accurate>(y, x); },
+        [](float y, float x) { return cgs::detail::atan2_fast(y, x); });
+}
+CGS_BENCHMARK("elementary/double/atan2")
+{
+    binary<double>(state, -10, 10, -10, 10, [](double y, double x) { return std::atan2(y, x); },
+        [](double y, double x) { return cgs::atan2<cgs::accuracy::accurate>(y, x); },
+        [](double y, double x) { return cgs::detail::atan2_fast(y, x); });
+}
+CGS_BENCHMARK("elementary/float/pow")
+{
+    binary<float>(state, 0, 10, -10, 10, [](float x, float y) { return std::pow(x, y); },
+        [](float x, float y) { return cgs::pow<cgs::accuracy::accurate>(x, y); },
+        [](float x, float y) { return cgs::detail::pow_fast(x, y); });
+}
+CGS_BENCHMARK("elementary/double/pow")
+{
+    binary<double>(state, 0, 10, -10, 10, [](double x, double y) { return std::pow(x, y); },
+        [](double x, double y) { return cgs::pow<cgs::accuracy::accurate>(x, y); },
+        [](double x, double y) { return cgs::detail::pow_fast(x, y); });
+}
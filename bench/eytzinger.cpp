@@ -0,0 +1,81 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/eytzinger.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+// n sorted even keys, and queries of which about half are keys
+void measure_searches(bench::state& state, std::size_t n)
+{
+    std::vector<std::uint32_t> sorted(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        sorted[i] = static_cast<std::uint32_t>(2 * i);
+    }
+    const cgs::eytzinger_set<std::uint32_t> set(sorted.begin(), sorted.end());
+
+    std::vector<std::uint32_t> queries(1 << 16);
+    bench::random random { 1 };
+    for(std::uint32_t& query : queries) {
+        query = static_cast<std::uint32_t>(random.uniform(0, 2.0 * static_cast<double>(n)));
+    }
+    std::vector<const std::uint32_t*> found(queries.size());
+
+    state.measure("std::lower_bound", queries.size(), [&] {
+        for(std::size_t i = 0; i < queries.size(); ++i) {
+            const auto it = std::lower_bound(sorted.begin(), sorted.end(), queries[i]);
+            found[i] = it == sorted.end() ? nullptr : &*it;
+        }
+        bench::clobber_memory();
+    });
+    state.measure("eytzinger", queries.size(), [&] {
+        for(std::size_t i = 0; i < queries.size(); ++i) {
+            found[i] = set.lower_bound(queries[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("eytzinger batch", queries.size(), [&] {
+        set.lower_bound(queries.begin(), queries.end(), found.begin());
+        bench::clobber_memory();
+    });
+}
+
+} // namespace
+
+// L1
+CGS_BENCHMARK("eytzinger/4K")
+{
+    measure_searches(state, std::size_t{1} << 12);
+}
+
+// L2
+CGS_BENCHMARK("eytzinger/256K")
+{
+    measure_searches(state, std::size_t{1} << 18);
+}
+
+// beyond the last level cache
+CGS_BENCHMARK("eytzinger/64M")
+{
+    measure_searches(state, std::size_t{1} << 26);
+}
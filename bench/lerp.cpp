@@ -0,0 +1,127 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/math.hpp"
+
+#include <cmath> // fabs
+#include <cstdint>
+#include <cstdlib> // abs
+#include <vector>
+
+namespace
+{
+
+using cgs::finite_check;
+
+// animation keyframes: finite, in a small range
+template <typename T>
+std::vector<T> frames(std::uint64_t seed)
+{
+    std::vector<T> values(1 << 14);
+    bench::random random { seed };
+    for(T& value : values) {
+        value = static_cast<T>(random.uniform(-100, 100));
+    }
+    return values;
+}
+
+template <finite_check Check, typename T>
+void lerp(bench::state& state)
+{
+    const std::vector<T> a = frames<T>(1);
+    const std::vector<T> b = frames<T>(2);
+    std::vector<T> amounts = frames<T>(3);
+    for(T& amount : amounts) {
+        amount = amount / 200 + T(0.5);
+    }
+    std::vector<T> out(a.size());
+    T amount = T(0.3);
+    bench::do_not_optimize(amount);
+
+    state.measure("scalar", a.size(), [&] {
+        for(std::size_t i = 0; i < a.size(); ++i) {
+            out[i] = cgs::lerp<Check>(a[i], b[i], amount);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("array", a.size(), [&] {
+        cgs::lerp<Check>(a.data(), a.data() + a.size(), b.data(), amount, out.data());
+        bench::clobber_memory();
+    });
+    state.measure("array_amounts", a.size(), [&] {
+        cgs::lerp<Check>(a.data(), a.data() + a.size(), b.data(), amounts.data(), out.data());
+        bench::clobber_memory();
+    });
+}
+
+template <typename T>
+void clamp(bench::state& state)
+{
+    const std::vector<T> values = frames<T>(4);
+    std::vector<T> out(values.size());
+    T low = T(-50);
+    T high = T(50);
+    bench::do_not_optimize(low);
+    bench::do_not_optimize(high);
+
+    state.measure("scalar", values.size(), [&] {
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            out[i] = cgs::clamp(values[i], low, high);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("array", values.size(), [&] {
+        cgs::clamp(values.data(), values.data() + values.size(), low, high, out.data());
+        bench::clobber_memory();
+    });
+}
+
+template <typename T, typename Standard>
+void abs(bench::state& state, Standard standard)
+{
+    const std::vector<T> values = frames<T>(5);
+    std::vector<T> out(values.size());
+
+    state.measure("cgs", values.size(), [&] {
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            out[i] = cgs::abs(values[i]);
+        }
+        bench::clobber_memory();
+    });
+    state.measure("std", values.size(), [&] {
+        for(std::size_t i = 0; i < values.size(); ++i) {
+            out[i] = standard(values[i]);
+        }
+        bench::clobber_memory();
+    });
+}
+
+} // namespace
+
+// lerp's two ways of checking for infinity, and no check
+CGS_BENCHMARK("lerp/float/inputs") { lerp<finite_check::inputs, float>(state); }
+CGS_BENCHMARK("lerp/float/difference") { lerp<finite_check::difference, float>(state); }
+CGS_BENCHMARK("lerp/float/none") { lerp<finite_check::none, float>(state); }
+CGS_BENCHMARK("lerp/double/inputs") { lerp<finite_check::inputs, double>(state); }
+CGS_BENCHMARK("lerp/double/difference") { lerp<finite_check::difference, double>(state); }
+
+CGS_BENCHMARK("clamp/float") { clamp<float>(state); }
+CGS_BENCHMARK("clamp/double") { clamp<double>(state); }
+CGS_BENCHMARK("clamp/int32") { clamp<std::int32_t>(state); }
+
+CGS_BENCHMARK("abs/float") { abs<float>(state, [](float x) { return std::fabs(x); }); }
+CGS_BENCHMARK("abs/int32") { abs<std::int32_t>(state, [](std::int32_t x) { return std::abs(x); }); }
@@ -0,0 +1,208 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/simd/dispatch.hpp"
+
+#include <cstdio>
+#include <cstdlib> // strtoul
+#include <cstring> // strncmp
+#include <string>
+#include <vector>
+
+namespace
+{
+
+void usage(std::FILE* out)
+{
+    std::fputs(
+        "usage: cgs-bench [options]\n"
+        "  --filter=A,B,...   only run benchmarks whose name contains A or B or ...\n"
+        "  --repetitions=N    samples per measurement (default 15)\n"
+        "  --min-time=MS      minimum milliseconds per sample (default 5)\n"
+        "  --json[=FILE]      write results as JSON to FILE, or stdout instead of the table\n"
+        "  --list             print benchmark names and exit\n"
+        "Set CGS_SIMD_ISA=baseline|sse2|avx2|avx512 to cap the dispatched kernels.\n",
+        out);
+}
+
+// value of --name=value, or null if arg is not --name
+const char* option_value(const char* arg, const char* name)
+{
+    const std::size_t length = std::strlen(name);
+    if(std::strncmp(arg, name, length) != 0) {
+        return nullptr;
+    }
+    if(arg[length] == '=') {
+        return arg + length + 1;
+    }
+    return arg[length] == '\0' ? "" : nullptr;
+}
+
+// does name contain any of the comma separated parts of filter
+bool matches(const char* name, const std::string& filter)
+{
+    std::size_t start = 0;
+    for(;;) {
+        const std::size_t end = std::min(filter.find(',', start), filter.size());
+        if(std::strstr(name, filter.substr(start, end - start).c_str())) {
+            return true;
+        }
+        if(end == filter.size()) {
+            return false;
+        }
+        start = end + 1;
+    }
+}
+
+void print_json_string(std::FILE* out, const std::string& text)
+{
+    std::fputc('"', out);
+    for(char c : text) {
+        if(c == '"' || c == '\\') {
+            std::fputc('\\', out);
+        }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+void print_json(std::FILE* out, const bench::options& opts, const std::vector<bench::result>& results)
+{
+    std::fprintf(out, "{\n  \"context\": {\n");
+    std::fprintf(out, "    \"isa\": \"%s\",\n", cgs::simd::to_string(cgs::simd::current_isa()));
+#ifdef __VERSION__
+    std::fprintf(out, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#ifdef NDEBUG
+    std::fprintf(out, "    \"ndebug\": true,\n");
+#else
+    std::fprintf(out, "    \"ndebug\": false,\n");
+#endif
+    std::fprintf(out, "    \"repetitions\": %zu,\n", opts.repetitions);
+    std::fprintf(out, "    \"min_time_ns\": %lld\n", static_cast<long long>(opts.min_time.count()));
+    std::fprintf(out, "  },\n  \"benchmarks\": [");
+
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        const bench::result& r = results[i];
+        std::fprintf(out, "%s\n    {\n      \"name\": ", i ? "," : "");
+        print_json_string(out, r.name);
+        std::fprintf(out, ",\n      \"items_per_call\": %zu,\n", r.items_per_call);
+        std::fprintf(out, "      \"calls_per_sample\": %zu,\n", r.calls_per_sample);
+        std::fprintf(out, "      \"unit\": \"ns/item\",\n");
+        std::fprintf(out, "      \"min\": %.6g,\n", r.percentile(0));
+        std::fprintf(out, "      \"p10\": %.6g,\n", r.percentile(0.1));
+        std::fprintf(out, "      \"median\": %.6g,\n", r.median());
+        std::fprintf(out, "      \"p90\": %.6g,\n", r.percentile(0.9));
+        std::fprintf(out, "      \"max\": %.6g,\n", r.percentile(1));
+        std::fprintf(out, "      \"mean\": %.6g,\n", r.mean());
+        std::fprintf(out, "      \"samples\": [");
+        for(std::size_t s = 0; s < r.samples.size(); ++s) {
+            std::fprintf(out, "%s%.6g", s ? ", " : "", r.samples[s]);
+        }
+        std::fprintf(out, "]\n    }");
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+void print_row(const bench::result& r)
+{
+    std::printf("%-48s %10.3f %10.3f %10.3f %9zu\n",
+        r.name.c_str(), r.median(), r.percentile(0.1), r.percentile(0.9), r.items_per_call);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bench::options opts {};
+    const char* filter = "";
+    const char* jsonPath = nullptr;
+    bool list = false;
+
+    for(int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if(const char* value = option_value(arg, "--filter")) {
+            filter = value;
+        }
+        else if(const char* value = option_value(arg, "--repetitions")) {
+            opts.repetitions = std::max<std::size_t>(std::strtoul(value, nullptr, 10), 1);
+        }
+        else if(const char* value = option_value(arg, "--min-time")) {
+            opts.min_time = std::chrono::milliseconds{ std::strtoul(value, nullptr, 10) };
+        }
+        else if(const char* value = option_value(arg, "--json")) {
+            jsonPath = value;
+        }
+        else if(option_value(arg, "--list")) {
+            list = true;
+        }
+        else {
+            usage(std::strcmp(arg, "--help") == 0 ? stdout : stderr);
+            return std::strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    // registration order depends on link order, sort for stable output
+    std::vector<bench::benchmark> benchmarks = bench::registry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const bench::benchmark& a, const bench::benchmark& b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+
+    // the table goes to stdout, unless JSON does
+    const bool table = !jsonPath || *jsonPath;
+    if(table && !list) {
+#ifndef NDEBUG
+        std::puts("warning: NDEBUG is not defined, configure with -DCMAKE_BUILD_TYPE=Release");
+#endif
+        std::printf("isa %s, %zu repetitions\n", cgs::simd::to_string(cgs::simd::current_isa()), opts.repetitions);
+        std::printf("%-48s %10s %10s %10s %9s\n", "benchmark (ns/item)", "median", "p10", "p90", "items");
+    }
+
+    std::vector<bench::result> results;
+    for(const bench::benchmark& benchmark : benchmarks) {
+        if(!matches(benchmark.name, filter)) {
+            continue;
+        }
+        if(list) {
+            std::puts(benchmark.name);
+            continue;
+        }
+        const std::string name = benchmark.name;
+        const std::size_t first = results.size();
+        bench::state state { name, opts, results };
+        benchmark.run(state);
+        if(table) {
+            for(std::size_t i = first; i < results.size(); ++i) {
+                print_row(results[i]);
+            }
+        }
+    }
+
+    if(jsonPath && !list) {
+        std::FILE* out = *jsonPath ? std::fopen(jsonPath, "w") : stdout;
+        if(!out) {
+            std::perror(jsonPath);
+            return EXIT_FAILURE;
+        }
+        print_json(out, opts, results);
+        if(out != stdout) {
+            std::fclose(out);
+        }
+    }
+    return EXIT_SUCCESS;
+}
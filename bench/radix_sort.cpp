@@ -0,0 +1,97 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/radix_sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+struct record
+{
+    std::uint32_t id;
+    float score;
+};
+
+void measure_sorts(bench::state& state, std::size_t n)
+{
+    std::vector<float> input(n);
+    bench::random random { 1 };
+    for(float& value : input) {
+        value = static_cast<float>(random.uniform(-1e6, 1e6));
+    }
+    std::vector<float> values;
+
+    state.measure("std::sort", n, [&] {
+        values = input;
+        std::sort(values.begin(), values.end());
+        bench::clobber_memory();
+    });
+    state.measure("radix_sort", n, [&] {
+        values = input;
+        cgs::radix_sort(values.begin(), values.end());
+        bench::clobber_memory();
+    });
+    state.measure("radix_sort par", n, [&] {
+        values = input;
+        cgs::radix_sort(cgs::execution::par, values.begin(), values.end());
+        bench::clobber_memory();
+    });
+}
+
+} // namespace
+
+CGS_BENCHMARK("radix_sort/1K")
+{
+    measure_sorts(state, 1000);
+}
+
+CGS_BENCHMARK("radix_sort/1M")
+{
+    measure_sorts(state, 1000000);
+}
+
+CGS_BENCHMARK("radix_sort/100M")
+{
+    measure_sorts(state, 100000000);
+}
+
+CGS_BENCHMARK("radix_sort/records")
+{
+    std::vector<record> input(1000000);
+    bench::random random { 2 };
+    for(std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = { static_cast<std::uint32_t>(i), static_cast<float>(random.uniform(0, 100)) };
+    }
+    std::vector<record> values;
+    const auto score = [](const record& r) { return r.score; };
+
+    state.measure("std::stable_sort", input.size(), [&] {
+        values = input;
+        std::stable_sort(values.begin(), values.end(), [](const record& a, const record& b) { return a.score < b.score; });
+        bench::clobber_memory();
+    });
+    state.measure("radix_sort", input.size(), [&] {
+        values = input;
+        cgs::radix_sort(values.begin(), values.end(), score);
+        bench::clobber_memory();
+    });
+}
@@ -0,0 +1,90 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+
+std::vector<float> random_floats(std::size_t n)
+{
+    std::vector<float> values(n);
+    bench::random random { 1 };
+    for(float& value : values) {
+        value = static_cast<float>(random.uniform(0, 1));
+    }
+    return values;
+}
+
+// many small arrays, like the distances to k nearest neighbours
+template <std::size_t N>
+void measure_tiny(bench::state& state)
+{
+    const std::vector<float> input = random_floats(N * 4096);
+    std::vector<float> values;
+
+    const auto each = [&](auto sort) {
+        return [&, sort] {
+            values = input;
+            for(std::size_t i = 0; i < values.size(); i += N) {
+                sort(values.data() + i);
+            }
+            bench::clobber_memory();
+        };
+    };
+    state.measure("std::sort", input.size() / N, each([](float* p) { std::sort(p, p + N); }));
+    state.measure("cgs::sort", input.size() / N, each([](float* p) { cgs::sort(p, p + N); }));
+    state.measure("sort_network", input.size() / N, each([](float* p) { cgs::sort_network<N>(p); }));
+}
+
+} // namespace
+
+CGS_BENCHMARK("sort/8")
+{
+    measure_tiny<8>(state);
+}
+
+CGS_BENCHMARK("sort/16")
+{
+    measure_tiny<16>(state);
+}
+
+CGS_BENCHMARK("sort/32")
+{
+    measure_tiny<32>(state);
+}
+
+CGS_BENCHMARK("sort/1M")
+{
+    const std::vector<float> input = random_floats(1 << 20);
+    std::vector<float> values;
+
+    state.measure("std::sort", input.size(), [&] {
+        values = input;
+        std::sort(values.begin(), values.end());
+        bench::clobber_memory();
+    });
+    state.measure("cgs::sort", input.size(), [&] {
+        values = input;
+        cgs::sort(values.begin(), values.end());
+        bench::clobber_memory();
+    });
+}
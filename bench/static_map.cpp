@@ -0,0 +1,106 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/static_map.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr std::array<std::pair<std::string_view, int>, 32> keywords {{
+    { "alignas", 0 }, { "alignof", 1 }, { "auto", 2 }, { "bool", 3 }, { "break", 4 }, { "case", 5 },
+    { "catch", 6 }, { "char", 7 }, { "class", 8 }, { "const", 9 }, { "constexpr", 10 }, { "continue", 11 },
+    { "decltype", 12 }, { "default", 13 }, { "delete", 14 }, { "double", 15 }, { "enum", 16 }, { "explicit", 17 },
+    { "float", 18 }, { "friend", 19 }, { "namespace", 20 }, { "noexcept", 21 }, { "operator", 22 }, { "private", 23 },
+    { "protected", 24 }, { "reinterpret_cast", 25 }, { "static_assert", 26 }, { "template", 27 },
+    { "thread_local", 28 }, { "typename", 29 }, { "unsigned", 30 }, { "virtual", 31 }
+}};
+
+constexpr auto keyword_map = cgs::make_static_map(keywords);
+
+template <std::size_t N>
+constexpr auto make_ids()
+{
+    std::array<std::pair<std::uint32_t, std::uint32_t>, N> pairs {};
+    for(std::uint32_t i = 0; i < N; ++i) {
+        pairs[i].first = i * 2654435761u;
+        pairs[i].second = i;
+    }
+    return pairs;
+}
+
+constexpr auto ids = make_ids<256>();
+constexpr auto id_map = cgs::make_static_map(ids);
+
+// queries of which about half are keys
+template <typename Map, typename Pairs, typename Miss>
+void measure_lookups(bench::state& state, const Map& map, const Pairs& pairs, Miss miss)
+{
+    using key_type = typename Map::key_type;
+    std::unordered_map<key_type, int> unordered;
+    for(const auto& pair : pairs) {
+        unordered.emplace(pair.first, static_cast<int>(pair.second));
+    }
+
+    std::vector<key_type> queries(1 << 12);
+    bench::random random { 1 };
+    for(std::size_t i = 0; i < queries.size(); ++i) {
+        const auto k = static_cast<std::size_t>(random.uniform(0, static_cast<double>(pairs.size()) - 0.5));
+        queries[i] = i % 2 ? pairs[k].first : miss(k);
+    }
+
+    std::size_t found = 0;
+    state.measure("std::unordered_map", queries.size(), [&] {
+        for(const key_type& query : queries) {
+            found += unordered.find(query) != unordered.end();
+        }
+        bench::clobber_memory();
+    });
+    state.measure("cgs::static_map", queries.size(), [&] {
+        for(const key_type& query : queries) {
+            found += map.find(query) != nullptr;
+        }
+        bench::clobber_memory();
+    });
+    bench::do_not_optimize(found);
+}
+
+} // namespace
+
+CGS_BENCHMARK("static_map/keywords")
+{
+    // misses as long as the keys, differing in the last byte
+    std::vector<std::string> misses;
+    for(const auto& pair : keywords) {
+        misses.emplace_back(pair.first);
+        misses.back().back() = '_';
+    }
+    measure_lookups(state, keyword_map, keywords, [&](std::size_t k) { return std::string_view { misses[k] }; });
+}
+
+CGS_BENCHMARK("static_map/ids")
+{
+    measure_lookups(state, id_map, ids, [](std::size_t k) { return static_cast<std::uint32_t>(k * 2654435761u + 1); });
+}
@@ -0,0 +1,60 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/table.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+constexpr float quarter_turn = 1.57079637f;
+
+constexpr auto sine = cgs::make_lerp_table<257>([](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+constexpr auto sine16 = cgs::make_lerp_table<257, cgs::float16>([](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+constexpr auto sine_fixed = cgs::make_lerp_table<257, cgs::fixed<std::int16_t, 14>>(
+    [](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+
+template <typename F>
+void measure(bench::state& state, const char* name, const std::vector<float>& x, std::vector<float>& out, F f)
+{
+    state.measure(name, x.size(), [&] {
+        for(std::size_t i = 0; i < x.size(); ++i) {
+            out[i] = f(x[i]);
+        }
+        bench::clobber_memory();
+    });
+}
+
+} // namespace
+
+CGS_BENCHMARK("table/sin")
+{
+    std::vector<float> x(1 << 14);
+    bench::random random { 1 };
+    for(float& value : x) {
+        value = static_cast<float>(random.uniform(0, quarter_turn));
+    }
+    std::vector<float> out(x.size());
+
+    measure(state, "std", x, out, [](float v) { return std::sin(v); });
+    measure(state, "float", x, out, [](float v) { return sine(v); });
+    measure(state, "float16", x, out, [](float v) { return sine16(v); });
+    measure(state, "fixed", x, out, [](float v) { return sine_fixed(v); });
+}
@@ -0,0 +1,68 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/algorithm.hpp"
+#include "cgs/execution.hpp"
+
+#include <cstdint>
+#include <functional> // plus
+#include <vector>
+
+namespace
+{
+
+// sum of squares, with every execution policy
+template <typename T>
+void sum_squares(bench::state& state, std::size_t size)
+{
+    std::vector<T> values(size);
+    bench::random random {};
+    for(T& value : values) {
+        value = static_cast<T>(random.uniform(-8, 8));
+    }
+    const T* first = values.data();
+    const T* last = values.data() + values.size();
+    const auto square = [](T x) { return x * x; };
+
+    state.measure("loop", size, [&] {
+        T sum {};
+        for(const T* it = first; it != last; ++it) {
+            sum += square(*it);
+        }
+        bench::do_not_optimize(sum);
+    });
+    state.measure("seq", size, [&] {
+        bench::do_not_optimize(cgs::transform_reduce(cgs::execution::seq, first, last, square, std::plus<>{}, T{}));
+    });
+    state.measure("unseq", size, [&] {
+        bench::do_not_optimize(cgs::transform_reduce(cgs::execution::unseq, first, last, square, std::plus<>{}, T{}));
+    });
+    state.measure("par", size, [&] {
+        bench::do_not_optimize(cgs::transform_reduce(cgs::execution::par, first, last, square, std::plus<>{}, T{}));
+    });
+    state.measure("par_unseq", size, [&] {
+        bench::do_not_optimize(cgs::transform_reduce(cgs::execution::par_unseq, first, last, square, std::plus<>{}, T{}));
+    });
+}
+
+} // namespace
+
+// in L1, and past the last level cache
+CGS_BENCHMARK("transform_reduce/float/4K") { sum_squares<float>(state, std::size_t{1} << 12); }
+CGS_BENCHMARK("transform_reduce/float/16M") { sum_squares<float>(state, std::size_t{1} << 24); }
+CGS_BENCHMARK("transform_reduce/double/4K") { sum_squares<double>(state, std::size_t{1} << 12); }
+CGS_BENCHMARK("transform_reduce/int32/4K") { sum_squares<std::int32_t>(state, std::size_t{1} << 12); }
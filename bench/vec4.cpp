@@ -0,0 +1,100 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "bench.hpp"
+
+#include "cgs/simd/vec4.hpp"
+
+// The claim in vec4.hpp: a trivially copyable vec4 is passed in registers,
+// while a type with a user provided copy constructor, like glm's aligned vec4, goes through memory.
+
+#ifdef CGS_SIMD_SSE
+
+using cgs::simd::vec4;
+
+// out of line and externally visible, so the arguments and result cross a call with the real ABI
+namespace abi
+{
+
+// like glm::aligned_highp_vec4
+struct glm_vec4
+{
+    __m128 data;
+
+    explicit glm_vec4(__m128 v) noexcept
+        : data(v)
+    { }
+
+    glm_vec4(const glm_vec4& other) noexcept
+        : data(other.data)
+    { }
+
+    glm_vec4& operator=(const glm_vec4& other) noexcept
+    {
+        data = other.data;
+        return *this;
+    }
+};
+
+[[gnu::noinline]] vec4 madd(vec4 a, vec4 b, vec4 c) noexcept
+{
+    return a * b + c;
+}
+
+[[gnu::noinline]] glm_vec4 madd(glm_vec4 a, glm_vec4 b, glm_vec4 c) noexcept
+{
+    return glm_vec4{ _mm_add_ps(_mm_mul_ps(a.data, b.data), c.data) };
+}
+
+} // namespace abi
+
+namespace
+{
+
+constexpr std::size_t calls = 1024;
+
+} // namespace
+
+CGS_BENCHMARK("vec4/abi/cgs")
+{
+    vec4 scale { 0.999f };
+    vec4 offset { 0.001f };
+    bench::do_not_optimize(scale);
+    bench::do_not_optimize(offset);
+    state.measure(calls, [&] {
+        vec4 v { 1.0f };
+        for(std::size_t i = 0; i < calls; ++i) {
+            v = abi::madd(v, scale, offset);
+        }
+        bench::do_not_optimize(v);
+    });
+}
+
+CGS_BENCHMARK("vec4/abi/glm")
+{
+    abi::glm_vec4 scale { _mm_set1_ps(0.999f) };
+    abi::glm_vec4 offset { _mm_set1_ps(0.001f) };
+    bench::do_not_optimize(scale);
+    bench::do_not_optimize(offset);
+    state.measure(calls, [&] {
+        abi::glm_vec4 v { _mm_set1_ps(1.0f) };
+        for(std::size_t i = 0; i < calls; ++i) {
+            v = abi::madd(v, scale, offset);
+        }
+        bench::do_not_optimize(v);
+    });
+}
+
+#endif
@@ -19,10 +19,23 @@
 
 #include "cgs/algorithm.hpp"
 #include "cgs/assert.hpp"
+#include "cgs/assert_profile.hpp"
+#include "cgs/bounded.hpp"
+#include "cgs/divider.hpp"
+#include "cgs/elementary.hpp"
+#include "cgs/execution.hpp"
+#include "cgs/expected.hpp"
+#include "cgs/eytzinger.hpp"
 #include "cgs/macro.hpp"
 #include "cgs/math.hpp"
 #include "cgs/meta.hpp"
 #include "cgs/optimize.hpp"
+#include "cgs/radix_sort.hpp"
+#include "cgs/simd.hpp"
+#include "cgs/sort.hpp"
+#include "cgs/static_map.hpp"
+#include "cgs/table.hpp"
+#include "cgs/thread_pool.hpp"
 #include "cgs/unowned_ptr.hpp"
 
 #endif // CGS_HPP
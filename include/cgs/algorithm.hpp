@@ -16,8 +16,25 @@
 #ifndef CGS_ALGORITHM_HPP
 #define CGS_ALGORITHM_HPP
 
+#include "cgs/execution.hpp"
+#include "cgs/meta/constexpr.hpp"
+#include "cgs/simd/dispatch.hpp"
+#include "cgs/simd/pack.hpp"
+#include "cgs/sort.hpp" // sort, stable_sort, partial_sort
+#include "cgs/thread_pool.hpp"
+
+#include <algorithm> // min
+#include <array>
+#include <atomic>
+#include <cstddef> // size_t, ptrdiff_t
+#include <cstdint> // uintptr_t
+#include <cstring> // memcpy
+#include <functional> // plus, multiplies
+#include <iterator> // iterator_traits
+#include <optional>
 #include <type_traits>
-#include <utility> // declval
+#include <utility> // declval, index_sequence
+#include <vector>
 
 // Similar to standard <algorithm> and <numeric>,
 // with constexpr everywhere.
@@ -25,12 +42,201 @@
 // I occasionally change the parameter order, to what I consider intuitive.
 // transform_reduce is changed from (init, binary, unary) to (unary, binary, init = {})
 
+#ifndef CGS_FILL_STREAMING_THRESHOLD
+    // bytes, roughly a last level cache
+    #define CGS_FILL_STREAMING_THRESHOLD (std::size_t{8} << 20)
+#endif
+
 namespace cgs
 {
 
+namespace detail
+{
+
+inline std::atomic<std::size_t>& fill_streaming_threshold_value() noexcept
+{
+    static std::atomic<std::size_t> threshold { CGS_FILL_STREAMING_THRESHOLD };
+    return threshold;
+}
+
+} // namespace detail
+
+/**
+ * @brief Contiguous fills of at least this many bytes use non-temporal stores.
+ *
+ * Defaults to `CGS_FILL_STREAMING_THRESHOLD`.
+ */
+inline std::size_t fill_streaming_threshold() noexcept
+{
+    return detail::fill_streaming_threshold_value().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Change fill_streaming_threshold(), 0 always streams, SIZE_MAX never does.
+ */
+inline void set_fill_streaming_threshold(std::size_t bytes) noexcept
+{
+    detail::fill_streaming_threshold_value().store(bytes, std::memory_order_relaxed);
+}
+
+namespace detail
+{
+
+// element sizes that tile every vector width
+constexpr std::size_t fill_pattern_size = 64;
+
+// store the repeating pattern over [dest, dest + bytes), bytes is a multiple of elementSize
+inline void fill_pattern_baseline(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t, bool)
+{
+    for(; bytes >= fill_pattern_size; dest += fill_pattern_size, bytes -= fill_pattern_size) {
+        std::memcpy(dest, pattern, fill_pattern_size);
+    }
+    std::memcpy(dest, pattern, bytes);
+}
+
+#ifdef CGS_SIMD_DISPATCH
+// vectors stay inside these, passing them between functions with different targets changes the ABI
+#define CGS_DETAIL_FILL_OPS(name, target, vector_type, width_bytes, load, storeu, stream) \
+struct name \
+{ \
+    static constexpr std::size_t width = width_bytes; \
+    /* count vectors from dest, unaligned */ \
+    target static void store_vectors(unsigned char* dest, std::size_t count, const unsigned char* pattern) \
+    { \
+        const vector_type v = load(reinterpret_cast<const vector_type*>(pattern)); \
+        for(; count >= 4; dest += 4 * width, count -= 4) { \
+            storeu(reinterpret_cast<vector_type*>(dest), v); \
+            storeu(reinterpret_cast<vector_type*>(dest + width), v); \
+            storeu(reinterpret_cast<vector_type*>(dest + 2 * width), v); \
+            storeu(reinterpret_cast<vector_type*>(dest + 3 * width), v); \
+        } \
+        for(; count; dest += width, --count) { \
+            storeu(reinterpret_cast<vector_type*>(dest), v); \
+        } \
+    } \
+    /* count vectors from dest, aligned to width */ \
+    target static void stream_vectors(unsigned char* dest, std::size_t count, const unsigned char* pattern) \
+    { \
+        const vector_type v = load(reinterpret_cast<const vector_type*>(pattern)); \
+        for(; count; dest += width, --count) { \
+            stream(reinterpret_cast<vector_type*>(dest), v); \
+        } \
+        /* order the weakly ordered stores before anything after fill */ \
+        _mm_sfence(); \
+    } \
+};
+
+CGS_DETAIL_FILL_OPS(fill_sse2_ops, CGS_TARGET_SSE2, __m128i, 16, _mm_load_si128, _mm_storeu_si128, _mm_stream_si128)
+CGS_DETAIL_FILL_OPS(fill_avx2_ops, CGS_TARGET_AVX2, __m256i, 32, _mm256_load_si256, _mm256_storeu_si256, _mm256_stream_si256)
+CGS_DETAIL_FILL_OPS(fill_avx512_ops, CGS_TARGET_AVX512, __m512i, 64, _mm512_load_si512, _mm512_storeu_si512, _mm512_stream_si512)
+
+#undef CGS_DETAIL_FILL_OPS
+
+template <typename Ops>
+void fill_pattern_vectors(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t elementSize, bool stream)
+{
+    constexpr std::size_t width = Ops::width;
+
+    // streaming stores must be aligned, which takes whole elements to reach
+    const std::size_t head = (width - reinterpret_cast<std::uintptr_t>(dest) % width) % width;
+    if(stream && head % elementSize == 0 && head <= bytes) {
+        std::memcpy(dest, pattern, head);
+        dest += head;
+        bytes -= head;
+        Ops::stream_vectors(dest, bytes / width, pattern);
+    }
+    else {
+        Ops::store_vectors(dest, bytes / width, pattern);
+    }
+    const std::size_t body = bytes / width * width;
+    std::memcpy(dest + body, pattern, bytes - body);
+}
+
+CGS_TARGET_SSE2 inline void fill_pattern_sse2(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t elementSize, bool stream)
+{
+    fill_pattern_vectors<fill_sse2_ops>(dest, bytes, pattern, elementSize, stream);
+}
+
+CGS_TARGET_AVX2 inline void fill_pattern_avx2(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t elementSize, bool stream)
+{
+    fill_pattern_vectors<fill_avx2_ops>(dest, bytes, pattern, elementSize, stream);
+}
+
+CGS_TARGET_AVX512 inline void fill_pattern_avx512(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t elementSize, bool stream)
+{
+    fill_pattern_vectors<fill_avx512_ops>(dest, bytes, pattern, elementSize, stream);
+}
+#endif
+
+inline void fill_pattern(unsigned char* dest, std::size_t bytes,
+    const unsigned char* pattern, std::size_t elementSize, bool stream)
+{
+    static const simd::dispatch<void(unsigned char*, std::size_t, const unsigned char*, std::size_t, bool)> table {
+        &fill_pattern_baseline,
+#ifdef CGS_SIMD_DISPATCH
+        &fill_pattern_sse2,
+        &fill_pattern_avx2,
+        &fill_pattern_avx512,
+#endif
+    };
+    table(dest, bytes, pattern, elementSize, stream);
+}
+
+// trivially copyable elements, whose size divides the smallest vector
+template <typename OutputIt, typename Sentinal, typename T, typename E = std::remove_pointer_t<OutputIt>>
+inline constexpr bool is_fill_pattern_range_v = std::is_pointer<OutputIt>::value
+    && std::is_same<OutputIt, Sentinal>::value
+    && !std::is_const<E>::value && !std::is_volatile<E>::value
+    && std::is_trivially_copyable<E>::value
+    && 16 % sizeof(E) == 0
+    && (std::is_same<std::remove_cv_t<T>, E>::value || (std::is_arithmetic<E>::value && std::is_arithmetic<T>::value));
+
+// below this, building the pattern costs more than it saves
+constexpr std::size_t fill_pattern_min_bytes = 256;
+
+template <typename E, typename T>
+void fill_contiguous(E* first, E* last, const T& value)
+{
+    const E element = static_cast<E>(value);
+    const auto bytes = static_cast<std::size_t>(last - first) * sizeof(E);
+    if(bytes < fill_pattern_min_bytes) {
+        for(; first != last; ++first) {
+            *first = element;
+        }
+        return;
+    }
+
+    alignas(fill_pattern_size) unsigned char pattern[fill_pattern_size];
+    for(std::size_t offset = 0; offset < fill_pattern_size; offset += sizeof(E)) {
+        std::memcpy(pattern + offset, &element, sizeof(E));
+    }
+    fill_pattern(reinterpret_cast<unsigned char*>(first), bytes, pattern, sizeof(E),
+        bytes >= fill_streaming_threshold());
+}
+
+} // namespace detail
+
+/**
+ * @brief Assign value to every element of [first, last).
+ *
+ * At runtime, contiguous ranges of trivially copyable elements use the widest vector stores the CPU supports.
+ * From fill_streaming_threshold() bytes, they use non-temporal stores, which bypass the cache,
+ * so clearing a large buffer does not evict the working set.
+ */
 template <typename OutputIt, typename Sentinal, typename T>
 constexpr void fill(OutputIt first, Sentinal last, const T& value)
 {
+    if constexpr(detail::is_fill_pattern_range_v<OutputIt, Sentinal, T>) {
+        if(!cgs::is_constant_evaluated()) {
+            detail::fill_contiguous(first, last, value);
+            return;
+        }
+    }
     for(; first != last; ++first) {
         *first = value;
     }
@@ -50,6 +256,364 @@ constexpr T transform_reduce(InputIt first, Sentinal last, UnaryOp unaryOp, Bina
     return init;
 }
 
+namespace detail
+{
+
+template <typename It, typename Sentinal>
+inline constexpr bool is_random_access_range_v = std::is_same<It, Sentinal>::value
+    && std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value;
+
+// binaryOps with an equivalent pack operator
+template <typename BinaryOp, typename T, std::size_t N>
+constexpr simd::pack<T, N> pack_binary_op(BinaryOp& binaryOp, const simd::pack<T, N>& a, const simd::pack<T, N>& b)
+{
+    if constexpr(std::is_same<BinaryOp, std::plus<T>>::value || std::is_same<BinaryOp, std::plus<>>::value) {
+        return a + b;
+    }
+    else if constexpr(std::is_same<BinaryOp, std::multiplies<T>>::value || std::is_same<BinaryOp, std::multiplies<>>::value) {
+        return a * b;
+    }
+    else {
+        return simd::pack<T, N>::generate([&](std::size_t i) { return binaryOp(a[i], b[i]); });
+    }
+}
+
+// Reduce a contiguous range with 4 packs of Width lanes.
+template <std::size_t Width, typename T, typename U, typename UnaryOp, typename BinaryOp>
+T transform_reduce_packs(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    using pack = simd::pack<T, Width>;
+    constexpr std::size_t Accumulators = 4;
+    constexpr std::size_t width = Width;
+    constexpr std::size_t step = Accumulators * width;
+
+    if(last - first < static_cast<std::ptrdiff_t>(step)) {
+        return cgs::transform_reduce(first, last, unaryOp, binaryOp, init);
+    }
+
+    const auto transformed = [&unaryOp](const U* p) {
+        return pack::generate([&unaryOp, p](std::size_t i) { return unaryOp(p[i]); });
+    };
+
+    // seed each accumulator with real elements, we don't know binaryOp's identity
+    pack acc[Accumulators] {};
+    for(std::size_t a = 0; a < Accumulators; ++a) {
+        acc[a] = transformed(first + a * width);
+    }
+    first += step;
+
+    for(; last - first >= static_cast<std::ptrdiff_t>(step); first += step) {
+        for(std::size_t a = 0; a < Accumulators; ++a) {
+            acc[a] = pack_binary_op(binaryOp, acc[a], transformed(first + a * width));
+        }
+    }
+
+    for(std::size_t half = Accumulators / 2; half > 0; half /= 2) {
+        for(std::size_t a = 0; a < half; ++a) {
+            acc[a] = pack_binary_op(binaryOp, acc[a], acc[a + half]);
+        }
+    }
+    init = binaryOp(init, simd::reduce(acc[0], binaryOp));
+
+    for(; first != last; ++first) {
+        init = binaryOp(init, unaryOp(*first));
+    }
+    return init;
+}
+
+template <typename T, typename U, typename UnaryOp, typename BinaryOp>
+T transform_reduce_baseline(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    return transform_reduce_packs<simd::native_width_v<T>>(first, last, unaryOp, binaryOp, init);
+}
+
+#ifdef CGS_SIMD_DISPATCH
+template <typename T, typename U, typename UnaryOp, typename BinaryOp>
+CGS_TARGET_SSE2 T transform_reduce_sse2(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    return transform_reduce_packs<simd::sse2_width_v<T>>(first, last, unaryOp, binaryOp, init);
+}
+
+template <typename T, typename U, typename UnaryOp, typename BinaryOp>
+CGS_TARGET_AVX2 T transform_reduce_avx2(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    return transform_reduce_packs<simd::avx2_width_v<T>>(first, last, unaryOp, binaryOp, init);
+}
+
+template <typename T, typename U, typename UnaryOp, typename BinaryOp>
+CGS_TARGET_AVX512 T transform_reduce_avx512(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    return transform_reduce_packs<simd::avx512_width_v<T>>(first, last, unaryOp, binaryOp, init);
+}
+#endif
+
+template <typename T, typename U, typename UnaryOp, typename BinaryOp>
+T transform_reduce_dispatch(const U* first, const U* last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    static const simd::dispatch<T(const U*, const U*, UnaryOp&, BinaryOp&, T)> table {
+        &transform_reduce_baseline<T, U, UnaryOp, BinaryOp>,
+#ifdef CGS_SIMD_DISPATCH
+        &transform_reduce_sse2<T, U, UnaryOp, BinaryOp>,
+        &transform_reduce_avx2<T, U, UnaryOp, BinaryOp>,
+        &transform_reduce_avx512<T, U, UnaryOp, BinaryOp>,
+#endif
+    };
+    return table(first, last, unaryOp, binaryOp, init);
+}
+
+template <typename T, typename RandomIt, typename UnaryOp, std::size_t... I>
+std::array<T, sizeof...(I)> transform_seed(RandomIt first, UnaryOp& unaryOp, std::index_sequence<I...>)
+{
+    return {{ T(unaryOp(first[I]))... }};
+}
+
+// Reduce a random access range with Accumulators independent scalar chains.
+// Requires last - first >= Accumulators.
+template <std::size_t Accumulators, typename RandomIt, typename UnaryOp, typename BinaryOp, typename T>
+T transform_reduce_chains(RandomIt first, RandomIt last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    // seed each chain with real elements, we don't know binaryOp's identity
+    auto acc = transform_seed<T>(first, unaryOp, std::make_index_sequence<Accumulators>{});
+    first += Accumulators;
+
+    for(; last - first >= static_cast<std::ptrdiff_t>(Accumulators); first += Accumulators) {
+        for(std::size_t a = 0; a < Accumulators; ++a) {
+            acc[a] = binaryOp(acc[a], unaryOp(first[a]));
+        }
+    }
+
+    for(std::size_t half = Accumulators / 2; half > 0; half /= 2) {
+        for(std::size_t a = 0; a < half; ++a) {
+            acc[a] = binaryOp(acc[a], acc[a + half]);
+        }
+    }
+    init = binaryOp(init, acc[0]);
+
+    for(; first != last; ++first) {
+        init = binaryOp(init, unaryOp(*first));
+    }
+    return init;
+}
+
+} // namespace detail
+
+/**
+ * @brief transform_reduce, combining elements in any order.
+ *
+ * binaryOp must be associative and commutative.
+ * Contiguous ranges (pointers) of arithmetic values reduce into several SIMD packs at once,
+ * using the widest ISA the CPU supports (see "cgs/simd/dispatch.hpp"),
+ * other random access ranges reduce into several independent accumulators,
+ * so the reduction is not limited by the latency of one binaryOp chain.
+ *
+ * Constant evaluation uses the sequential loop.
+ */
+template <typename InputIt, typename Sentinal, typename UnaryOp, typename BinaryOp,
+          typename T = std::remove_reference_t<
+              decltype(
+                std::declval<UnaryOp>()(*std::declval<InputIt>())
+              )
+          >>
+constexpr T transform_reduce(const execution::unsequenced_policy&,
+    InputIt first, Sentinal last, UnaryOp unaryOp, BinaryOp binaryOp, T init = {})
+{
+    if constexpr(detail::is_random_access_range_v<InputIt, Sentinal>) {
+        if(!cgs::is_constant_evaluated()) {
+            if constexpr(std::is_pointer<InputIt>::value && simd::detail::is_pack_element_v<T>) {
+                return detail::transform_reduce_dispatch<T>(first, last, unaryOp, binaryOp, init);
+            }
+            else {
+                constexpr std::size_t accumulators = 8;
+                if(last - first >= static_cast<std::ptrdiff_t>(accumulators)) {
+                    return detail::transform_reduce_chains<accumulators>(first, last, unaryOp, binaryOp, init);
+                }
+            }
+        }
+    }
+
+    return cgs::transform_reduce(first, last, unaryOp, binaryOp, init);
+}
+
+namespace detail
+{
+
+template <typename Policy>
+thread_pool& policy_pool(const Policy& policy)
+{
+    return policy.pool ? *policy.pool : thread_pool::global();
+}
+
+// chunk count, for a parallel algorithm over n elements
+inline std::size_t parallel_chunks(const thread_pool& pool, std::size_t minChunk, std::size_t n)
+{
+    const std::size_t threads = pool.size() + 1;
+    const std::size_t fit = n / (minChunk ? minChunk : 1);
+    return std::min(threads, fit);
+}
+
+// [begin, end) of chunk c
+template <typename RandomIt>
+std::pair<RandomIt, RandomIt> parallel_chunk(RandomIt first, std::size_t n, std::size_t chunks, std::size_t c)
+{
+    return {
+        first + static_cast<std::ptrdiff_t>(c * n / chunks),
+        first + static_cast<std::ptrdiff_t>((c + 1) * n / chunks)
+    };
+}
+
+template <typename RandomIt, typename T>
+void parallel_fill(thread_pool& pool, std::size_t minChunk, RandomIt first, RandomIt last, const T& value)
+{
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallel_chunks(pool, minChunk, n);
+    if(chunks <= 1) {
+        cgs::fill(first, last, value);
+        return;
+    }
+
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        const auto chunk = parallel_chunk(first, n, chunks, c);
+        cgs::fill(chunk.first, chunk.second, value);
+    });
+}
+
+template <bool Unsequenced, typename RandomIt, typename UnaryOp, typename BinaryOp, typename T>
+T parallel_transform_reduce(thread_pool& pool, std::size_t minChunk,
+    RandomIt first, RandomIt last, UnaryOp& unaryOp, BinaryOp& binaryOp, T init)
+{
+    const auto reduceChunk = [&unaryOp, &binaryOp](RandomIt chunkFirst, RandomIt chunkLast, T chunkInit) {
+        if constexpr(Unsequenced) {
+            return cgs::transform_reduce(execution::unseq, chunkFirst, chunkLast, unaryOp, binaryOp, chunkInit);
+        }
+        else {
+            return cgs::transform_reduce(chunkFirst, chunkLast, unaryOp, binaryOp, chunkInit);
+        }
+    };
+
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallel_chunks(pool, minChunk, n);
+    if(chunks <= 1) {
+        return reduceChunk(first, last, init);
+    }
+
+    std::vector<std::optional<T>> partials(chunks);
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        const auto chunk = parallel_chunk(first, n, chunks, c);
+        // seed with the chunk's first element, we don't know binaryOp's identity
+        partials[c] = reduceChunk(chunk.first + 1, chunk.second, T(unaryOp(*chunk.first)));
+    });
+
+    for(const auto& partial : partials) {
+        init = binaryOp(init, *partial);
+    }
+    return init;
+}
+
+} // namespace detail
+
+template <typename OutputIt, typename Sentinal, typename T>
+constexpr void fill(const execution::sequenced_policy&, OutputIt first, Sentinal last, const T& value)
+{
+    cgs::fill(first, last, value);
+}
+
+template <typename OutputIt, typename Sentinal, typename T>
+constexpr void fill(const execution::unsequenced_policy&, OutputIt first, Sentinal last, const T& value)
+{
+    cgs::fill(first, last, value);
+}
+
+/**
+ * @brief fill, splitting random access ranges into chunks filled on policy.pool.
+ *
+ * Other ranges, and constant evaluation, fill sequentially.
+ */
+template <typename OutputIt, typename Sentinal, typename T>
+constexpr void fill(const execution::parallel_policy& policy, OutputIt first, Sentinal last, const T& value)
+{
+    if constexpr(detail::is_random_access_range_v<OutputIt, Sentinal>) {
+        if(!cgs::is_constant_evaluated()) {
+            detail::parallel_fill(detail::policy_pool(policy), policy.min_chunk, first, last, value);
+            return;
+        }
+    }
+    cgs::fill(first, last, value);
+}
+
+/**
+ * @brief Same as fill with parallel_policy.
+ */
+template <typename OutputIt, typename Sentinal, typename T>
+constexpr void fill(const execution::parallel_unsequenced_policy& policy, OutputIt first, Sentinal last, const T& value)
+{
+    if constexpr(detail::is_random_access_range_v<OutputIt, Sentinal>) {
+        if(!cgs::is_constant_evaluated()) {
+            detail::parallel_fill(detail::policy_pool(policy), policy.min_chunk, first, last, value);
+            return;
+        }
+    }
+    cgs::fill(first, last, value);
+}
+
+template <typename InputIt, typename Sentinal, typename UnaryOp, typename BinaryOp,
+          typename T = std::remove_reference_t<
+              decltype(
+                std::declval<UnaryOp>()(*std::declval<InputIt>())
+              )
+          >>
+constexpr T transform_reduce(const execution::sequenced_policy&,
+    InputIt first, Sentinal last, UnaryOp unaryOp, BinaryOp binaryOp, T init = {})
+{
+    return cgs::transform_reduce(first, last, unaryOp, binaryOp, init);
+}
+
+/**
+ * @brief transform_reduce, splitting random access ranges into chunks reduced on policy.pool.
+ *
+ * Partial results are combined in order, so binaryOp must be associative.
+ * Other ranges, and constant evaluation, reduce sequentially.
+ */
+template <typename InputIt, typename Sentinal, typename UnaryOp, typename BinaryOp,
+          typename T = std::remove_reference_t<
+              decltype(
+                std::declval<UnaryOp>()(*std::declval<InputIt>())
+              )
+          >>
+constexpr T transform_reduce(const execution::parallel_policy& policy,
+    InputIt first, Sentinal last, UnaryOp unaryOp, BinaryOp binaryOp, T init = {})
+{
+    if constexpr(detail::is_random_access_range_v<InputIt, Sentinal>) {
+        if(!cgs::is_constant_evaluated()) {
+            return detail::parallel_transform_reduce<false>(detail::policy_pool(policy), policy.min_chunk,
+                first, last, unaryOp, binaryOp, init);
+        }
+    }
+    return cgs::transform_reduce(first, last, unaryOp, binaryOp, init);
+}
+
+/**
+ * @brief transform_reduce with parallel_policy, reducing each chunk with unsequenced_policy.
+ *
+ * binaryOp must be associative and commutative.
+ */
+template <typename InputIt, typename Sentinal, typename UnaryOp, typename BinaryOp,
+          typename T = std::remove_reference_t<
+              decltype(
+                std::declval<UnaryOp>()(*std::declval<InputIt>())
+              )
+          >>
+constexpr T transform_reduce(const execution::parallel_unsequenced_policy& policy,
+    InputIt first, Sentinal last, UnaryOp unaryOp, BinaryOp binaryOp, T init = {})
+{
+    if constexpr(detail::is_random_access_range_v<InputIt, Sentinal>) {
+        if(!cgs::is_constant_evaluated()) {
+            return detail::parallel_transform_reduce<true>(detail::policy_pool(policy), policy.min_chunk,
+                first, last, unaryOp, binaryOp, init);
+        }
+    }
+    return cgs::transform_reduce(first, last, unaryOp, binaryOp, init);
+}
+
 // std::min and std::max have various overloads,
 // making them tedious to use compositionally (need to static_cast to specify which overload).
 // We have min2 and max2, with no overloads.
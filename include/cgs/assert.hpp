@@ -18,24 +18,67 @@
 #define CGS_ASSERT_HPP
 
 #include "cgs/macro.hpp" // CGS_LINE
+#include "cgs/meta/constexpr.hpp" // is_constant_evaluated
 #include "cgs/optimize.hpp" // cgs_assume, cgs_likely
 
-#include <cstdio> // fputs, stderr
-#include <cstdlib> // abort
+#include <cstdint> // uint32_t
+#include <cstdio> // fputs, snprintf, stderr
+#include <cstdlib> // abort, getenv
+#include <cstring> // strchr, strcmp, strlen, strncmp
+#include <limits> // numeric_limits
 #include <stdexcept> // logic_error
+#include <type_traits>
 
 /*
 To customize how logic errors are handled, you can `#define` one of:
 * `CGS_VIOLATE_ABORT` print to stderr and abort if an assertion fails
 * `CGS_VIOLATE_IGNORE` do not evaluate asserted expressions
 * `CGS_VIOLATE_THROW` throw if an assertion fails
+* `CGS_VIOLATE_SAMPLE` evaluate every Nth hit of each assertion, abort if it fails
 
+SAMPLE keeps invariant checks running in production at a fraction of their cost.
+Each assertion site counts its hits per thread, and evaluates the first hit and every Nth after it.
+N is `CGS_SAMPLE_PERIOD` (default 16), and `cgs_assert_sample_every(expr, N)` sets it for one site.
+The environment variable `CGS_SAMPLE_PERIOD` overrides both when the program starts,
+as a comma separated list of a default N and `file:line=N` entries for single sites, e.g.
+`CGS_SAMPLE_PERIOD=1000,vector.hpp:120=1`. A period of 0 turns a site off, and entries that are not numbers are ignored.
+
+`cgs_assert_eq(a, b)`, `cgs_assert_lt(a, b)` and `cgs_assert_le(a, b)` assert `a == b`, `a < b` and `a <= b`,
+and add the values of a and b to the message if they fail.
+Failures are handled out of line, so an assertion adds only a compare and a cold call to the function it is in.
+
+`#define CGS_ASSERT_PROFILE` as well to record the cost of each assertion site, see cgs/assert_profile.hpp.
+
+Assertions have three levels, each with its own mode:
+* `cgs_assert_cheap(expr)` for O(1) checks, like bounds checks, set with `CGS_VIOLATE_CHEAP_*`
+* `cgs_assert(expr)` set with `CGS_VIOLATE_*`
+* `cgs_assert_expensive(expr)` for O(n) checks, like validating a structure, set with `CGS_VIOLATE_EXPENSIVE_*`
+The cheap and expensive levels use the `CGS_VIOLATE_*` mode unless their own is defined,
+so `NDEBUG` with `CGS_VIOLATE_CHEAP_ABORT` keeps only the cheap checks in a release build.
+
+The macros set the levels of the translation unit. Declare `cgs_assert_levels` in a namespace or class
+to set them for the code in it, assertions use the one found by unqualified lookup at their call site:
+
+    namespace parser {
+    constexpr cgs::assert_levels cgs_assert_levels { cgs::violation::throw_, cgs::violation::throw_,
+        cgs::violation::ignore };
+    }
+
+The throw mode needs exceptions. Without them, as with -fno-exceptions,
+a throw mode from `CGS_VIOLATE_*_THROW` or from a `cgs_assert_levels` does not compile.
+
+An assertion whose level is ignored never evaluates its expression.
+It is a `cgs_assume`, so a false one is undefined behavior,
+unless `CGS_ASSERT_NO_ASSUME` is defined to only check that it compiles.
+Assertions are expressions, usable in any initializer, so on GCC they only hint expressions without side effects,
+like cgs_assume before GCC 13.
 */
 
 // default if no option is set:
 // IGNORE on NDEBUG.
 // ABORT on debug
-#if !(defined(CGS_VIOLATE_ABORT) || defined(CGS_VIOLATE_IGNORE) || defined(CGS_VIOLATE_THROW))
+#if !(defined(CGS_VIOLATE_ABORT) || defined(CGS_VIOLATE_IGNORE) || defined(CGS_VIOLATE_THROW) \
+    || defined(CGS_VIOLATE_SAMPLE))
     #ifdef NDEBUG
         #define CGS_VIOLATE_IGNORE
     #else
@@ -43,32 +86,482 @@ To customize how logic errors are handled, you can `#define` one of:
     #endif
 #endif
 
-// validate option
-#if defined(CGS_VIOLATE_ABORT) + defined(CGS_VIOLATE_IGNORE) + defined(CGS_VIOLATE_THROW) != 1
+// validate options
+#if defined(CGS_VIOLATE_ABORT) + defined(CGS_VIOLATE_IGNORE) + defined(CGS_VIOLATE_THROW) \
+    + defined(CGS_VIOLATE_SAMPLE) != 1
     #error There can only be one CGS_VIOLATE_*
 #endif
 
-#define cgs_assert_abort(expression) ( cgs_likely(expression) \
+#if defined(CGS_VIOLATE_CHEAP_ABORT) + defined(CGS_VIOLATE_CHEAP_IGNORE) + defined(CGS_VIOLATE_CHEAP_THROW) \
+    + defined(CGS_VIOLATE_CHEAP_SAMPLE) > 1
+    #error There can only be one CGS_VIOLATE_CHEAP_*
+#endif
+
+#if defined(CGS_VIOLATE_EXPENSIVE_ABORT) + defined(CGS_VIOLATE_EXPENSIVE_IGNORE) \
+    + defined(CGS_VIOLATE_EXPENSIVE_THROW) + defined(CGS_VIOLATE_EXPENSIVE_SAMPLE) > 1
+    #error There can only be one CGS_VIOLATE_EXPENSIVE_*
+#endif
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+    #define CGS_DETAIL_EXCEPTIONS
+#elif defined(CGS_VIOLATE_THROW) || defined(CGS_VIOLATE_CHEAP_THROW) || defined(CGS_VIOLATE_EXPENSIVE_THROW)
+    #error CGS_VIOLATE_*THROW needs exceptions
+#endif
+
+#ifndef CGS_SAMPLE_PERIOD
+    #define CGS_SAMPLE_PERIOD 16
+#endif
+
+namespace cgs
+{
+
+/**
+ * @brief What an assertion does, like the CGS_VIOLATE_* options.
+ */
+enum class violation
+{
+    abort,
+    ignore,
+    throw_,
+    sample,
+};
+
+/**
+ * @brief The violation of each assertion level.
+ *
+ * Declare a `constexpr cgs::assert_levels cgs_assert_levels` in a namespace or class
+ * to set the levels for the assertions in it.
+ */
+struct assert_levels
+{
+    violation cheap;
+    violation normal;
+    violation expensive;
+};
+
+namespace detail
+{
+
+// one per assertion site and thread, so skipping a hit is a decrement
+struct assert_sample_counter
+{
+    // hits to skip before the next evaluation
+    std::uint32_t countdown;
+    // 0 until the site's period is looked up
+    std::uint32_t period;
+};
+
+// FNV-1a of a file name, to name a site in a template argument
+constexpr std::uint64_t assert_file_hash(const char* file) noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for(; *file; ++file) {
+        hash = (hash ^ static_cast<unsigned char>(*file)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+// the counter of the sites at File and Line, a variable instead of a static in a lambda,
+// so an assertion is an expression without a closure, and sites on one line share it
+template <std::uint64_t File, unsigned long Line>
+inline thread_local assert_sample_counter assert_sample_counter_at {};
+
+// the decimal number [first, last) in value, false if it is not one or does not fit
+inline bool assert_sample_parse(const char* first, const char* last, std::uint32_t& value) noexcept
+{
+    if(first == last) {
+        return false;
+    }
+    std::uint64_t number = 0;
+    for(; first != last; ++first) {
+        if(*first < '0' || *first > '9') {
+            return false;
+        }
+        number = 10 * number + static_cast<std::uint64_t>(*first - '0');
+        if(number > ~std::uint32_t{0}) {
+            return false;
+        }
+    }
+    value = static_cast<std::uint32_t>(number);
+    return true;
+}
+
+// site's period from the CGS_SAMPLE_PERIOD environment variable, or compiled if it is not set there,
+// entries that are not numbers are ignored
+inline std::uint32_t assert_sample_env_period(const char* site, std::uint32_t compiled) noexcept
+{
+    const char* entry = std::getenv("CGS_SAMPLE_PERIOD");
+    if(!entry) {
+        return compiled;
+    }
+
+    const std::size_t siteLength = std::strlen(site);
+    std::uint32_t period = compiled;
+    bool siteFound = false;
+    for(; *entry; ++entry) {
+        const char* comma = std::strchr(entry, ',');
+        const char* end = comma ? comma : entry + std::strlen(entry);
+        const char* equals = std::strchr(entry, '=');
+        if(equals && equals < end) {
+            // file:line=N, matching the end of site at a path separator
+            const auto patternLength = static_cast<std::size_t>(equals - entry);
+            if(patternLength <= siteLength) {
+                const char* tail = site + siteLength - patternLength;
+                if(std::strncmp(tail, entry, patternLength) == 0 && (tail == site || tail[-1] == '/' || tail[-1] == '\\')
+                    && assert_sample_parse(equals + 1, end, period)) {
+                    siteFound = true;
+                }
+            }
+        }
+        else if(!siteFound) {
+            assert_sample_parse(entry, end, period);
+        }
+        entry = end;
+        if(!*entry) {
+            break;
+        }
+    }
+    return period;
+}
+
+// slow path, once per period: starts the next countdown, and returns true to evaluate this hit
+inline bool assert_sample_reset(assert_sample_counter& counter, const char* site, std::uint32_t compiled) noexcept
+{
+    constexpr std::uint32_t off = ~std::uint32_t{0};
+    if(counter.period == 0) {
+        counter.period = assert_sample_env_period(site, compiled);
+        if(counter.period == 0) {
+            counter.period = off;
+        }
+    }
+    if(counter.period == off) {
+        // back here after 2^32 hits, still off
+        counter.countdown = off;
+        return false;
+    }
+    counter.countdown = counter.period - 1;
+    return true;
+}
+
+inline bool assert_sample_skip(assert_sample_counter& counter, const char* site, std::uint32_t compiled) noexcept
+{
+    if(cgs_likely(counter.countdown != 0)) {
+        --counter.countdown;
+        return true;
+    }
+    return !assert_sample_reset(counter, site, compiled);
+}
+
+// message is "Assertion failed (expression) at file:line"
+template <violation Violation>
+[[noreturn]] CGS_COLD void assert_failed(const char* message)
+{
+#ifdef CGS_DETAIL_EXCEPTIONS
+    if constexpr(Violation == violation::throw_) {
+        throw std::logic_error(message);
+    }
+#endif
+    // without exceptions the throw mode does not compile, but its arm is still instantiated
+    std::fputs(message, stderr);
+    std::fputc('\n', stderr);
+    std::fflush(stderr);
+    std::abort();
+}
+
+// does not compile a throw mode without exceptions, Throw is whether the mode is throw_
+template <bool Throw>
+constexpr void assert_throw_mode() noexcept
+{
+#ifndef CGS_DETAIL_EXCEPTIONS
+    static_assert(!Throw, "the throw mode of cgs_assert needs exceptions");
+#endif
+}
+
+// stands in for operands that can not be written
+struct assert_unprintable {};
+
+// operand as passed to the failure path, by value so a register operand is not spilled to memory
+template <typename T>
+constexpr auto assert_operand(const T& value) noexcept
+{
+    if constexpr(std::is_class_v<T> || std::is_union_v<T> || std::is_array_v<T>) {
+        return assert_unprintable{};
+    }
+    else {
+        // scalars, and __int128, which is not a scalar in strict ISO mode
+        return value;
+    }
+}
+
+// writes value as text, or "?" if it is not a number, pointer, bool or enum
+template <typename T>
+void assert_format_operand(char* buffer, std::size_t size, const T& value) noexcept
+{
+    if constexpr(std::is_same_v<T, bool>) {
+        std::snprintf(buffer, size, "%s", value ? "true" : "false");
+    }
+    else if constexpr(std::is_enum_v<T>) {
+        assert_format_operand(buffer, size, static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr(std::numeric_limits<T>::is_integer && sizeof(T) <= sizeof(long long)) {
+        if constexpr(std::numeric_limits<T>::is_signed) {
+            std::snprintf(buffer, size, "%lld", static_cast<long long>(value));
+        }
+        else {
+            std::snprintf(buffer, size, "%llu", static_cast<unsigned long long>(value));
+        }
+    }
+    else if constexpr(std::numeric_limits<T>::is_integer) {
+        // __int128, which printf can not write, from the last digit
+        char digits[48];
+        char* first = digits + sizeof(digits);
+        *--first = '\0';
+        T rest = value;
+        do {
+            const int digit = static_cast<int>(rest % 10);
+            *--first = static_cast<char>('0' + (digit < 0 ? -digit : digit));
+            rest /= 10;
+        } while(rest != 0);
+        if(value < T{}) {
+            *--first = '-';
+        }
+        std::snprintf(buffer, size, "%s", first);
+    }
+    else if constexpr(std::is_floating_point_v<T>) {
+        std::snprintf(buffer, size, "%.*Lg", std::numeric_limits<T>::max_digits10, static_cast<long double>(value));
+    }
+    else if constexpr(std::is_null_pointer_v<T>) {
+        std::snprintf(buffer, size, "nullptr");
+    }
+    else if constexpr(std::is_pointer_v<T> && !std::is_function_v<std::remove_pointer_t<T>>) {
+        std::snprintf(buffer, size, "%p", static_cast<const volatile void*>(value));
+    }
+    else {
+        std::snprintf(buffer, size, "?");
+    }
+}
+
+// message is "Assertion failed (lhs op rhs) at file:line\0lhs\0rhs", to pass the texts as one pointer
+template <violation Violation, typename Lhs, typename Rhs>
+[[noreturn]] CGS_COLD void assert_compare_failed(const char* message, Lhs lhs, Rhs rhs)
+{
+    const char* lhsText = message + std::strlen(message) + 1;
+    const char* rhsText = lhsText + std::strlen(lhsText) + 1;
+    char lhsValue[64];
+    char rhsValue[64];
+    assert_format_operand(lhsValue, sizeof(lhsValue), lhs);
+    assert_format_operand(rhsValue, sizeof(rhsValue), rhs);
+
+    // skip operands that are their own value, like literals
+    const bool showLhs = std::strcmp(lhsText, lhsValue) != 0;
+    const bool showRhs = std::strcmp(rhsText, rhsValue) != 0;
+    char full[1024];
+    std::snprintf(full, sizeof(full), "%s%s%s%s%s%s%s%s%s", message,
+        showLhs || showRhs ? " with " : "",
+        showLhs ? lhsText : "", showLhs ? " = " : "", showLhs ? lhsValue : "",
+        showLhs && showRhs ? ", " : "",
+        showRhs ? rhsText : "", showRhs ? " = " : "", showRhs ? rhsValue : "");
+    assert_failed<Violation>(full);
+}
+
+// the operands of `lhs op rhs` and its value, which the failure path writes
+template <typename Lhs, typename Rhs>
+struct assert_comparison
+{
+    const Lhs& lhs;
+    const Rhs& rhs;
+    bool value;
+};
+
+// lhs of `assert_lhs(lhs) op rhs`, whose comparison operators keep both operands
+template <typename Lhs>
+struct assert_lhs
+{
+    const Lhs& lhs;
+
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator==(const Rhs& rhs) const { return { lhs, rhs, lhs == rhs }; }
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator!=(const Rhs& rhs) const { return { lhs, rhs, lhs != rhs }; }
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator<(const Rhs& rhs) const { return { lhs, rhs, lhs < rhs }; }
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator<=(const Rhs& rhs) const { return { lhs, rhs, lhs <= rhs }; }
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator>(const Rhs& rhs) const { return { lhs, rhs, lhs > rhs }; }
+    template <typename Rhs>
+    constexpr assert_comparison<Lhs, Rhs> operator>=(const Rhs& rhs) const { return { lhs, rhs, lhs >= rhs }; }
+};
+
+template <typename Lhs>
+constexpr assert_lhs<Lhs> make_assert_lhs(const Lhs& lhs) noexcept
+{
+    return { lhs };
+}
+
+// true, or fails if the comparison is false
+template <violation Violation, typename Lhs, typename Rhs>
+constexpr bool assert_compare(const assert_comparison<Lhs, Rhs>& comparison, const char* message)
+{
+    if(cgs_unlikely(!comparison.value)) {
+        assert_compare_failed<Violation>(message, assert_operand(comparison.lhs), assert_operand(comparison.rhs));
+    }
+    return true;
+}
+
+} // namespace detail
+} // namespace cgs
+
+#ifdef CGS_ASSERT_PROFILE
+    #include "cgs/assert_profile.hpp"
+
+    // record the hit and cycles of this site in this thread, see cgs/assert_profile.hpp
+    #define cgs_detail_assert_evaluate(expression, text) ( ::cgs::is_constant_evaluated() \
+        ? static_cast<bool>(expression) \
+        : ::cgs::detail::assert_profile_timer{ []() -> ::cgs::detail::assert_site_stats& { \
+            static thread_local ::cgs::detail::assert_site_stats& stats \
+                = ::cgs::detail::assert_profile_register(__FILE__ ":" CGS_LINE, text); \
+            return stats; \
+        }() }.stop(static_cast<bool>(expression)) )
+#else
+    #define cgs_detail_assert_evaluate(expression, text) (expression)
+#endif
+
+#define cgs_detail_assert_failed(mode, expression) ::cgs::detail::assert_failed< \
+    ::cgs::violation::mode>("Assertion failed (" #expression ") at " __FILE__ ":" CGS_LINE)
+
+// evaluates lhs and rhs once, and adds their values to the message if `lhs op rhs` is false,
+// op is one of == != < <= > >=
+#define cgs_detail_assert_compare(mode, lhs, op, rhs) static_cast<void>(cgs_detail_assert_evaluate( \
+    ::cgs::detail::assert_compare<::cgs::violation::mode>(::cgs::detail::make_assert_lhs((lhs)) op (rhs), \
+        "Assertion failed (" #lhs " " #op " " #rhs ") at " __FILE__ ":" CGS_LINE "\0" #lhs "\0" #rhs), \
+    #lhs " " #op " " #rhs))
+
+// true to skip this hit of the site, always false in constant evaluation
+#define cgs_detail_assert_sample_skip(period) ( !::cgs::is_constant_evaluated() && ::cgs::detail::assert_sample_skip( \
+    ::cgs::detail::assert_sample_counter_at<::cgs::detail::assert_file_hash(__FILE__), __LINE__>, \
+    __FILE__ ":" CGS_LINE, (period)) )
+
+#define cgs_assert_abort(expression) ( cgs_likely(cgs_detail_assert_evaluate(expression, #expression)) \
+    ? static_cast<void>(0) \
+    : cgs_detail_assert_failed(abort, expression) \
+)
+
+#ifdef CGS_ASSERT_NO_ASSUME
+    #define cgs_assert_ignore(expr) static_cast<void>(sizeof(static_cast<bool>(expr)))
+#elif defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 13
+    // cgs_assume is a statement expression there, which is not allowed outside functions,
+    // so assertions use the hint of GCC before 13 to stay usable in any initializer
+    #define cgs_assert_ignore(expr) ( __builtin_constant_p((static_cast<void>(expr), 0)) && !static_cast<bool>(expr) \
+        ? __builtin_unreachable() : static_cast<void>(0) )
+#elif defined(__clang__)
+    // the ignore arm is compiled in every mode, so clang would warn about side effects in its assume
+    #define cgs_assert_ignore(expr) ( \
+        _Pragma("clang diagnostic push") \
+        _Pragma("clang diagnostic ignored \"-Wassume\"") \
+        cgs_assume(expr) \
+        _Pragma("clang diagnostic pop") \
+    )
+#else
+    #define cgs_assert_ignore(expr) cgs_assume(expr)
+#endif
+
+// the throw arm of cgs_assert, compiled in every mode
+#define cgs_detail_assert_throw(expression) ( cgs_likely(cgs_detail_assert_evaluate(expression, #expression)) \
+    ? static_cast<void>(0) \
+    : cgs_detail_assert_failed(throw_, expression) \
+)
+
+#define cgs_assert_throw(expression) ( ::cgs::detail::assert_throw_mode<true>(), cgs_detail_assert_throw(expression) )
+
+// period must be a constant expression
+#define cgs_assert_sample_every(expression, period) ( cgs_detail_assert_sample_skip(period) \
+    || cgs_likely(cgs_detail_assert_evaluate(expression, #expression)) \
     ? static_cast<void>(0) \
-    : (std::fputs("Assertion failed (" #expression ") at " __FILE__ ":" CGS_LINE "\n", stderr), \
-        std::fflush(stderr), \
-        std::abort() \
-    ) \
+    : cgs_detail_assert_failed(abort, expression) \
 )
 
-#define cgs_assert_ignore(expr) cgs_assume(expr)
+#define cgs_assert_sample(expr) cgs_assert_sample_every(expr, CGS_SAMPLE_PERIOD)
 
-#define cgs_assert_throw(expression) ( cgs_likely(expression) \
+// cgs_assert_compare_*(lhs, op, rhs) assert `lhs op rhs`, with the values of lhs and rhs in the message
+#define cgs_assert_compare_abort(lhs, op, rhs) cgs_detail_assert_compare(abort, lhs, op, rhs)
+#define cgs_assert_compare_ignore(lhs, op, rhs) cgs_assert_ignore((lhs) op (rhs))
+#define cgs_assert_compare_throw(lhs, op, rhs) ( ::cgs::detail::assert_throw_mode<true>(), \
+    cgs_detail_assert_compare(throw_, lhs, op, rhs) )
+#define cgs_assert_compare_sample(lhs, op, rhs) ( cgs_detail_assert_sample_skip(CGS_SAMPLE_PERIOD) \
     ? static_cast<void>(0) \
-    : throw std::logic_error("Assertion failed (" #expression ") at " __FILE__ ":" CGS_LINE) \
+    : cgs_detail_assert_compare(abort, lhs, op, rhs) \
 )
 
 #ifdef CGS_VIOLATE_ABORT
-    #define cgs_assert(expr) cgs_assert_abort(expr)
+    #define CGS_DETAIL_VIOLATE ::cgs::violation::abort
 #elif defined(CGS_VIOLATE_IGNORE)
-    #define cgs_assert(expr) cgs_assert_ignore(expr)
+    #define CGS_DETAIL_VIOLATE ::cgs::violation::ignore
 #elif defined(CGS_VIOLATE_THROW)
-    #define cgs_assert(expr) cgs_assert_throw(expr)
+    #define CGS_DETAIL_VIOLATE ::cgs::violation::throw_
+#elif defined(CGS_VIOLATE_SAMPLE)
+    #define CGS_DETAIL_VIOLATE ::cgs::violation::sample
+#endif
+
+#ifdef CGS_VIOLATE_CHEAP_ABORT
+    #define CGS_DETAIL_VIOLATE_CHEAP ::cgs::violation::abort
+#elif defined(CGS_VIOLATE_CHEAP_IGNORE)
+    #define CGS_DETAIL_VIOLATE_CHEAP ::cgs::violation::ignore
+#elif defined(CGS_VIOLATE_CHEAP_THROW)
+    #define CGS_DETAIL_VIOLATE_CHEAP ::cgs::violation::throw_
+#elif defined(CGS_VIOLATE_CHEAP_SAMPLE)
+    #define CGS_DETAIL_VIOLATE_CHEAP ::cgs::violation::sample
+#else
+    #define CGS_DETAIL_VIOLATE_CHEAP CGS_DETAIL_VIOLATE
+#endif
+
+#ifdef CGS_VIOLATE_EXPENSIVE_ABORT
+    #define CGS_DETAIL_VIOLATE_EXPENSIVE ::cgs::violation::abort
+#elif defined(CGS_VIOLATE_EXPENSIVE_IGNORE)
+    #define CGS_DETAIL_VIOLATE_EXPENSIVE ::cgs::violation::ignore
+#elif defined(CGS_VIOLATE_EXPENSIVE_THROW)
+    #define CGS_DETAIL_VIOLATE_EXPENSIVE ::cgs::violation::throw_
+#elif defined(CGS_VIOLATE_EXPENSIVE_SAMPLE)
+    #define CGS_DETAIL_VIOLATE_EXPENSIVE ::cgs::violation::sample
+#else
+    #define CGS_DETAIL_VIOLATE_EXPENSIVE CGS_DETAIL_VIOLATE
 #endif
 
+// levels of this translation unit, hidden by any cgs_assert_levels declared closer to an assertion
+constexpr ::cgs::assert_levels cgs_assert_levels {
+    CGS_DETAIL_VIOLATE_CHEAP,
+    CGS_DETAIL_VIOLATE,
+    CGS_DETAIL_VIOLATE_EXPENSIVE,
+};
+
+// a literal once substituted, unlike a read of cgs_assert_levels, so the optimizer drops the other modes' arms
+#define cgs_detail_assert_is(mode, which) ::std::integral_constant<bool, (mode) == ::cgs::violation::which>::value
+
+// the arm of mode. Every arm is compiled, and none has a closure, unless CGS_ASSERT_PROFILE is defined,
+// so an assertion works in any initializer and in decltype, and an ignored one hints the function it is in
+#define cgs_detail_assert_select(mode, on_ignore, on_throw, on_sample, on_abort) ( \
+    cgs_detail_assert_is(mode, ignore) ? on_ignore \
+    : cgs_detail_assert_is(mode, throw_) \
+        ? ( ::cgs::detail::assert_throw_mode<cgs_detail_assert_is(mode, throw_)>(), on_throw ) \
+    : cgs_detail_assert_is(mode, sample) ? on_sample \
+    : on_abort \
+)
+
+#define cgs_detail_assert_level(level, expression) cgs_detail_assert_select(cgs_assert_levels.level, \
+    cgs_assert_ignore(expression), cgs_detail_assert_throw(expression), \
+    cgs_assert_sample(expression), cgs_assert_abort(expression))
+
+#define cgs_assert_cheap(expr) cgs_detail_assert_level(cheap, expr)
+#define cgs_assert(expr) cgs_detail_assert_level(normal, expr)
+#define cgs_assert_expensive(expr) cgs_detail_assert_level(expensive, expr)
+
+// at the normal level
+#define cgs_assert_compare(lhs, op, rhs) cgs_detail_assert_select(cgs_assert_levels.normal, \
+    cgs_assert_compare_ignore(lhs, op, rhs), cgs_detail_assert_compare(throw_, lhs, op, rhs), \
+    cgs_assert_compare_sample(lhs, op, rhs), cgs_assert_compare_abort(lhs, op, rhs))
+
+#define cgs_assert_eq(lhs, rhs) cgs_assert_compare(lhs, ==, rhs)
+#define cgs_assert_lt(lhs, rhs) cgs_assert_compare(lhs, <, rhs)
+#define cgs_assert_le(lhs, rhs) cgs_assert_compare(lhs, <=, rhs)
+
 #endif // CGS_ASSERT_HPP
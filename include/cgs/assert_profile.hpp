@@ -0,0 +1,287 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_ASSERT_PROFILE_HPP
+#define CGS_ASSERT_PROFILE_HPP
+
+#include <algorithm> // sort
+#include <atomic>
+#include <cstdint> // uint64_t
+#include <cstdio> // FILE, fprintf
+#include <cstdlib> // atexit, getenv
+#include <cstring> // strcmp, strlen
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #ifdef _MSC_VER
+        #include <intrin.h> // __rdtsc
+    #else
+        #include <x86intrin.h> // __rdtsc
+    #endif
+    #define CGS_ASSERT_PROFILE_RDTSC
+#else
+    #include <chrono>
+#endif
+
+/*
+Per-site cost of cgs_assert, to find which assertions are worth sampling or removing.
+
+`#define CGS_ASSERT_PROFILE` before including cgs/assert.hpp, and every evaluated assertion
+records a hit and the cycles (TSC ticks, or nanoseconds off x86) its expression took,
+keyed by its `file:line`. Ignored assertions are not evaluated, so they record nothing.
+
+Each thread records into its own table, without locks or atomic read-modify-writes.
+Read the merged tables with `cgs::assert_profile()`, or write them with `cgs::write_assert_profile()`.
+If the environment variable `CGS_ASSERT_PROFILE` names a file when the first site is recorded,
+the profile is written there at exit, as JSON if the name ends with `.json`, CSV otherwise.
+`-` writes CSV to stderr.
+*/
+
+namespace cgs
+{
+
+/**
+ * @brief Cost of one assertion site, summed over all threads.
+ */
+struct assert_profile_entry
+{
+    // "file:line"
+    const char* site;
+    const char* expression;
+    std::uint64_t hits;
+    std::uint64_t cycles;
+};
+
+enum class assert_profile_format
+{
+    csv,
+    json,
+};
+
+namespace detail
+{
+
+// one site in one thread, only written by that thread
+struct assert_site_stats
+{
+    const char* site;
+    const char* expression;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> cycles;
+    assert_site_stats* next;
+};
+
+// one per thread, never freed, so the profile outlives the threads
+struct assert_profile_table
+{
+    std::atomic<assert_site_stats*> sites;
+    assert_profile_table* next;
+};
+
+inline std::atomic<assert_profile_table*>& assert_profile_tables() noexcept
+{
+    static std::atomic<assert_profile_table*> head {};
+    return head;
+}
+
+inline std::uint64_t assert_profile_now() noexcept
+{
+#ifdef CGS_ASSERT_PROFILE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline void assert_profile_at_exit();
+
+inline assert_profile_table& assert_profile_thread_table()
+{
+    static thread_local assert_profile_table* table = [] {
+        static const bool atExit = std::getenv("CGS_ASSERT_PROFILE") && std::atexit(&assert_profile_at_exit) == 0;
+        static_cast<void>(atExit);
+
+        auto* created = new assert_profile_table{ {}, nullptr };
+        std::atomic<assert_profile_table*>& head = assert_profile_tables();
+        created->next = head.load(std::memory_order_relaxed);
+        while(!head.compare_exchange_weak(created->next, created, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return created;
+    }();
+    return *table;
+}
+
+// this thread's stats for a site, called once per site and thread
+inline assert_site_stats& assert_profile_register(const char* site, const char* expression)
+{
+    assert_profile_table& table = assert_profile_thread_table();
+    auto* stats = new assert_site_stats{ site, expression, {}, {}, table.sites.load(std::memory_order_relaxed) };
+    table.sites.store(stats, std::memory_order_release);
+    return *stats;
+}
+
+/**
+ * @brief Times one evaluation of a site's expression.
+ *
+ * Constructed before the expression is evaluated, as the object of a call is sequenced before its arguments:
+ * `assert_profile_timer{ stats }.stop(expression)`
+ */
+class assert_profile_timer
+{
+private:
+
+    assert_site_stats& _stats;
+    std::uint64_t _start;
+
+public:
+
+    explicit assert_profile_timer(assert_site_stats& stats) noexcept
+        : _stats(stats)
+        , _start(assert_profile_now())
+    { }
+
+    bool stop(bool result) noexcept
+    {
+        const std::uint64_t elapsed = assert_profile_now() - _start;
+        // only this thread writes, so load and store instead of fetch_add
+        _stats.hits.store(_stats.hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        _stats.cycles.store(_stats.cycles.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+        return result;
+    }
+};
+
+inline void write_csv_field(std::FILE* out, const char* text)
+{
+    std::fputc('"', out);
+    for(; *text; ++text) {
+        if(*text == '"') {
+            std::fputc('"', out);
+        }
+        std::fputc(*text, out);
+    }
+    std::fputc('"', out);
+}
+
+inline void write_json_string(std::FILE* out, const char* text)
+{
+    std::fputc('"', out);
+    for(; *text; ++text) {
+        if(*text == '"' || *text == '\\') {
+            std::fputc('\\', out);
+        }
+        std::fputc(*text, out);
+    }
+    std::fputc('"', out);
+}
+
+} // namespace detail
+
+/**
+ * @brief Every recorded assertion site, merged over all threads, most total cycles first.
+ *
+ * Safe to call while other threads record, their latest hits may be missing.
+ */
+inline std::vector<assert_profile_entry> assert_profile()
+{
+    std::vector<assert_profile_entry> entries;
+    for(detail::assert_profile_table* table = detail::assert_profile_tables().load(std::memory_order_acquire);
+        table; table = table->next) {
+        for(detail::assert_site_stats* stats = table->sites.load(std::memory_order_acquire); stats; stats = stats->next) {
+            const std::uint64_t hits = stats->hits.load(std::memory_order_relaxed);
+            const std::uint64_t cycles = stats->cycles.load(std::memory_order_relaxed);
+            const auto same = std::find_if(entries.begin(), entries.end(), [&](const assert_profile_entry& entry) {
+                return std::strcmp(entry.site, stats->site) == 0;
+            });
+            if(same != entries.end()) {
+                same->hits += hits;
+                same->cycles += cycles;
+            }
+            else {
+                entries.push_back({ stats->site, stats->expression, hits, cycles });
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const assert_profile_entry& a, const assert_profile_entry& b) {
+        return a.cycles != b.cycles ? a.cycles > b.cycles : std::strcmp(a.site, b.site) < 0;
+    });
+    return entries;
+}
+
+/**
+ * @brief Write assert_profile() as CSV or JSON, with columns site, expression, hits, cycles and cycles_per_hit.
+ */
+inline void write_assert_profile(std::FILE* out, assert_profile_format format = assert_profile_format::csv)
+{
+    const std::vector<assert_profile_entry> entries = assert_profile();
+    if(format == assert_profile_format::csv) {
+        std::fputs("site,expression,hits,cycles,cycles_per_hit\n", out);
+    }
+    else {
+        std::fputs("[", out);
+    }
+
+    for(std::size_t i = 0; i < entries.size(); ++i) {
+        const assert_profile_entry& entry = entries[i];
+        const double perHit = entry.hits ? static_cast<double>(entry.cycles) / static_cast<double>(entry.hits) : 0;
+        if(format == assert_profile_format::csv) {
+            detail::write_csv_field(out, entry.site);
+            std::fputc(',', out);
+            detail::write_csv_field(out, entry.expression);
+            std::fprintf(out, ",%llu,%llu,%.1f\n", static_cast<unsigned long long>(entry.hits),
+                static_cast<unsigned long long>(entry.cycles), perHit);
+        }
+        else {
+            std::fputs(i ? ",\n  { \"site\": " : "\n  { \"site\": ", out);
+            detail::write_json_string(out, entry.site);
+            std::fputs(", \"expression\": ", out);
+            detail::write_json_string(out, entry.expression);
+            std::fprintf(out, ", \"hits\": %llu, \"cycles\": %llu, \"cycles_per_hit\": %.1f }",
+                static_cast<unsigned long long>(entry.hits), static_cast<unsigned long long>(entry.cycles), perHit);
+        }
+    }
+
+    if(format == assert_profile_format::json) {
+        std::fputs("\n]\n", out);
+    }
+    std::fflush(out);
+}
+
+namespace detail
+{
+
+inline void assert_profile_at_exit()
+{
+    const char* path = std::getenv("CGS_ASSERT_PROFILE");
+    if(!path || !*path) {
+        return;
+    }
+    if(std::strcmp(path, "-") == 0) {
+        write_assert_profile(stderr);
+        return;
+    }
+
+    const std::size_t length = std::strlen(path);
+    const bool json = length >= 5 && std::strcmp(path + length - 5, ".json") == 0;
+    if(std::FILE* out = std::fopen(path, "w")) {
+        write_assert_profile(out, json ? assert_profile_format::json : assert_profile_format::csv);
+        std::fclose(out);
+    }
+}
+
+} // namespace detail
+} // namespace cgs
+
+#endif // CGS_ASSERT_PROFILE_HPP
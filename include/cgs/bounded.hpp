@@ -0,0 +1,295 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_BOUNDED_HPP
+#define CGS_BOUNDED_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/math.hpp"
+#include "cgs/meta.hpp"
+#include "cgs/optimize.hpp" // cgs_assume
+
+#include <algorithm> // min, max
+#include <limits>
+#include <type_traits>
+
+/*
+bounded<Int, Min, Max> is an Int known to be in [Min, Max].
+
+The range is checked with cgs_assert where a value enters it: construction from an Int,
+narrowing from another bounded, and compound assignment.
+Reading the value gives the optimizer cgs_assume(Min <= value && value <= Max).
+
+Adding, subtracting or multiplying two bounded gives a bounded of the result's range, without a check,
+or, if that range does not fit Int, converts both to Int instead.
+
+cgs::div, mod and divmod, and their named forms, take bounded dividends and divisors,
+and choose simpler code from the ranges at compile time, see math.hpp.
+
+    // a constant power of two divisor, and a non-negative dividend: a shift and a mask
+    cgs::bounded<int, 0, 1023> index { i };
+    const auto [row, column] = cgs::divmod_floor(index, cgs::bounded<int, 16, 16>{});
+*/
+
+namespace cgs
+{
+
+namespace detail
+{
+
+// constructs a bounded from a value already known to be in range
+struct bounded_unchecked_t
+{
+    explicit bounded_unchecked_t() = default;
+};
+
+inline constexpr bounded_unchecked_t bounded_unchecked {};
+
+enum class bounded_op
+{
+    add,
+    sub,
+    mul,
+};
+
+template <typename Int>
+constexpr bool bounded_negative(Int value) noexcept
+{
+    if constexpr(is_signed_integer_v<Int>) {
+        return value < 0;
+    }
+    else {
+        static_cast<void>(value);
+        return false;
+    }
+}
+
+// a op b does not overflow Int
+template <bounded_op Op, typename Int>
+constexpr bool bounded_op_fits(Int a, Int b) noexcept
+{
+    constexpr Int min = std::numeric_limits<Int>::min();
+    constexpr Int max = std::numeric_limits<Int>::max();
+    if constexpr(Op == bounded_op::add) {
+        return bounded_negative(b) ? a >= min - b : a <= max - b;
+    }
+    else if constexpr(Op == bounded_op::sub) {
+        return bounded_negative(b) ? a <= max + b : a >= min + b;
+    }
+    else {
+        if(a == 0 || b == 0) {
+            return true;
+        }
+        if(!bounded_negative(a)) {
+            return !bounded_negative(b) ? a <= max / b : b >= min / a;
+        }
+        return !bounded_negative(b) ? a >= min / b : b >= max / a;
+    }
+}
+
+template <bounded_op Op, typename Int>
+constexpr Int bounded_apply(Int a, Int b) noexcept
+{
+    if constexpr(Op == bounded_op::add) {
+        return static_cast<Int>(a + b);
+    }
+    else if constexpr(Op == bounded_op::sub) {
+        return static_cast<Int>(a - b);
+    }
+    else {
+        return static_cast<Int>(a * b);
+    }
+}
+
+// range of [AMin, AMax] op [BMin, BMax], from the corners
+template <bounded_op Op, typename Int, Int AMin, Int AMax, Int BMin, Int BMax>
+struct bounded_result
+{
+    static constexpr bool fits = bounded_op_fits<Op>(AMin, BMin) && bounded_op_fits<Op>(AMin, BMax)
+        && bounded_op_fits<Op>(AMax, BMin) && bounded_op_fits<Op>(AMax, BMax);
+
+private:
+
+    static constexpr Int corner(Int a, Int b) noexcept
+    {
+        return fits ? bounded_apply<Op>(a, b) : Int{};
+    }
+
+    static constexpr Int c0 = corner(AMin, BMin);
+    static constexpr Int c1 = corner(AMin, BMax);
+    static constexpr Int c2 = corner(AMax, BMin);
+    static constexpr Int c3 = corner(AMax, BMax);
+
+public:
+
+    static constexpr Int min = std::min(std::min(c0, c1), std::min(c2, c3));
+    static constexpr Int max = std::max(std::max(c0, c1), std::max(c2, c3));
+};
+
+} // namespace detail
+
+template <typename Int, Int Min, Int Max>
+class bounded
+{
+    static_assert(detail::is_integer_v<Int>, "bounded needs an integer type");
+    static_assert(Min <= Max, "bounded needs Min <= Max");
+
+private:
+
+    Int _value;
+
+    template <Int OtherMin, Int OtherMax>
+    static constexpr bool contains_v = Min <= OtherMin && OtherMax <= Max;
+
+public:
+
+    using value_type = Int;
+
+    static constexpr Int min() noexcept
+    {
+        return Min;
+    }
+
+    static constexpr Int max() noexcept
+    {
+        return Max;
+    }
+
+    /**
+     * @brief The value in range closest to zero.
+     */
+    constexpr bounded() noexcept
+        : _value(Min > 0 ? Min : (Max < 0 ? Max : Int{}))
+    { }
+
+    /**
+     * @brief Asserts Min <= value <= Max.
+     */
+    constexpr explicit bounded(Int value)
+        : _value(value)
+    {
+        cgs_assert(is_between(value, Min, Max));
+    }
+
+    constexpr bounded(detail::bounded_unchecked_t, Int value) noexcept
+        : _value(value)
+    { }
+
+    /**
+     * @brief From a narrower range, unchecked.
+     */
+    template <Int OtherMin, Int OtherMax, enable_if_t<contains_v<OtherMin, OtherMax>, int> = 0>
+    constexpr /* implicit */ bounded(bounded<Int, OtherMin, OtherMax> other) noexcept
+        : _value(other.value())
+    { }
+
+    /**
+     * @brief From a range that is not inside this one, asserts the value is.
+     */
+    template <Int OtherMin, Int OtherMax, enable_if_t<!contains_v<OtherMin, OtherMax>, int> = 0>
+    constexpr explicit bounded(bounded<Int, OtherMin, OtherMax> other)
+        : bounded(other.value())
+    { }
+
+    constexpr Int value() const noexcept
+    {
+        cgs_assume_range(_value, Min, Max);
+        return _value;
+    }
+
+    constexpr /* implicit */ operator Int() const noexcept
+    {
+        return value();
+    }
+
+    // compound assignment asserts the result is in range, it must not overflow Int either
+
+    constexpr bounded& operator+=(Int rhs)
+    {
+        return *this = bounded{ static_cast<Int>(value() + rhs) };
+    }
+
+    constexpr bounded& operator-=(Int rhs)
+    {
+        return *this = bounded{ static_cast<Int>(value() - rhs) };
+    }
+
+    constexpr bounded& operator*=(Int rhs)
+    {
+        return *this = bounded{ static_cast<Int>(value() * rhs) };
+    }
+
+    constexpr bounded& operator++()
+    {
+        cgs_assert(_value != Max);
+        ++_value;
+        return *this;
+    }
+
+    constexpr bounded& operator--()
+    {
+        cgs_assert(_value != Min);
+        --_value;
+        return *this;
+    }
+
+    constexpr bounded operator++(int)
+    {
+        const bounded old = *this;
+        ++*this;
+        return old;
+    }
+
+    constexpr bounded operator--(int)
+    {
+        const bounded old = *this;
+        --*this;
+        return old;
+    }
+};
+
+template <typename Int, Int AMin, Int AMax, Int BMin, Int BMax,
+    typename Result = detail::bounded_result<detail::bounded_op::add, Int, AMin, AMax, BMin, BMax>,
+    typename = enable_if_t<Result::fits>>
+constexpr bounded<Int, Result::min, Result::max> operator+(bounded<Int, AMin, AMax> a, bounded<Int, BMin, BMax> b) noexcept
+{
+    return { detail::bounded_unchecked, static_cast<Int>(a.value() + b.value()) };
+}
+
+template <typename Int, Int AMin, Int AMax, Int BMin, Int BMax,
+    typename Result = detail::bounded_result<detail::bounded_op::sub, Int, AMin, AMax, BMin, BMax>,
+    typename = enable_if_t<Result::fits>>
+constexpr bounded<Int, Result::min, Result::max> operator-(bounded<Int, AMin, AMax> a, bounded<Int, BMin, BMax> b) noexcept
+{
+    return { detail::bounded_unchecked, static_cast<Int>(a.value() - b.value()) };
+}
+
+template <typename Int, Int AMin, Int AMax, Int BMin, Int BMax,
+    typename Result = detail::bounded_result<detail::bounded_op::mul, Int, AMin, AMax, BMin, BMax>,
+    typename = enable_if_t<Result::fits>>
+constexpr bounded<Int, Result::min, Result::max> operator*(bounded<Int, AMin, AMax> a, bounded<Int, BMin, BMax> b) noexcept
+{
+    return { detail::bounded_unchecked, static_cast<Int>(a.value() * b.value()) };
+}
+
+/**
+ * @brief A bounded of the single value Value, e.g. a divisor the divisions can shift by.
+ */
+template <auto Value>
+inline constexpr bounded<decltype(Value), Value, Value> constant {};
+
+} // namespace cgs
+
+#endif // CGS_BOUNDED_HPP
@@ -0,0 +1,296 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_DIVIDER_HPP
+#define CGS_DIVIDER_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/math.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/*
+divider<Int, RoundMode> divides by a divisor fixed at construction, with a multiply and shifts instead of a division.
+Hardware division takes 20 to 90 cycles, a multiply takes 3.
+
+The multiply-and-shift "magic numbers" are the round-up method from libdivide (https://libdivide.com),
+from Granlund and Montgomery, "Division by Invariant Integers using Multiplication".
+8 and 16 bit integers use the 32 bit magic numbers.
+__int128, where the standard traits admit it (GNU mode), multiplies and divides in 64 bit halves.
+*/
+
+namespace cgs
+{
+
+namespace detail
+{
+
+// high half of a * b, from the products of the half words
+template <typename UInt>
+constexpr UInt mulhi_halves(UInt a, UInt b)
+{
+    constexpr int half = std::numeric_limits<UInt>::digits / 2;
+    constexpr UInt loMask = (UInt{1} << half) - 1;
+    const UInt aLo = a & loMask, aHi = a >> half;
+    const UInt bLo = b & loMask, bHi = b >> half;
+    const UInt lo = aLo * bLo;
+    const UInt mid1 = aHi * bLo + (lo >> half);
+    const UInt mid2 = aLo * bHi + (mid1 & loMask);
+    return aHi * bHi + (mid1 >> half) + (mid2 >> half);
+}
+
+// high half of a * b
+template <typename UInt>
+constexpr UInt mulhi(UInt a, UInt b)
+{
+    constexpr int bits = std::numeric_limits<UInt>::digits;
+    if constexpr(bits <= 32) {
+        return static_cast<UInt>((std::uint64_t{a} * b) >> bits);
+    }
+#ifdef CGS_HAS_INT128
+    else if constexpr(bits <= 64) {
+        return static_cast<UInt>((uint128{a} * b) >> 64);
+    }
+#endif
+    else {
+        return mulhi_halves(a, b);
+    }
+}
+
+// high half of a * b, signed
+template <typename SInt>
+constexpr SInt mulhi_signed(SInt a, SInt b)
+{
+    constexpr int bits = std::numeric_limits<SInt>::digits + 1;
+    if constexpr(bits <= 32) {
+        return static_cast<SInt>((std::int64_t{a} * b) >> bits);
+    }
+#ifdef CGS_HAS_INT128
+    else if constexpr(bits <= 64) {
+        return static_cast<SInt>((int128{a} * b) >> 64);
+    }
+#endif
+    else {
+        // the unsigned product, minus b * 2^bits for negative a and a * 2^bits for negative b
+        using UInt = std::make_unsigned_t<SInt>;
+        UInt hi = mulhi(static_cast<UInt>(a), static_cast<UInt>(b));
+        hi -= a < 0 ? static_cast<UInt>(b) : 0;
+        hi -= b < 0 ? static_cast<UInt>(a) : 0;
+        return static_cast<SInt>(hi);
+    }
+}
+
+// floor(hi * 2^bits / d), and its remainder, for hi < d
+template <typename UInt>
+constexpr UInt div_wide(UInt hi, UInt d, UInt& rem)
+{
+    constexpr int bits = std::numeric_limits<UInt>::digits;
+    if constexpr(bits <= 32) {
+        const std::uint64_t n = std::uint64_t{hi} << bits;
+        rem = static_cast<UInt>(n % d);
+        return static_cast<UInt>(n / d);
+    }
+#ifdef CGS_HAS_INT128
+    else if constexpr(bits <= 64) {
+        const uint128 n = uint128{hi} << 64;
+        rem = static_cast<UInt>(n % d);
+        return static_cast<UInt>(n / d);
+    }
+#endif
+    else {
+        // long division, shifting in the zero low half
+        UInt quot = 0;
+        for(int i = 0; i < bits; ++i) {
+            const bool carry = hi >> (bits - 1);
+            hi <<= 1;
+            quot <<= 1;
+            if(carry || hi >= d) {
+                hi -= d;
+                quot |= 1;
+            }
+        }
+        rem = hi;
+        return quot;
+    }
+}
+
+// 8 and 16 bit integers divide as 32 bit
+template <typename Int>
+using divider_word_t = std::conditional_t<(sizeof(Int) >= 4), Int,
+    std::conditional_t<std::is_signed<Int>::value, std::int32_t, std::uint32_t>>;
+
+} // namespace detail
+
+/**
+ * @brief Divides by a divisor fixed at construction, using a multiply and shifts.
+ *
+ * Same results as div<RoundMode>, mod<RoundMode>, and divmod<RoundMode>.
+ * Build it once outside the loop, or at compile time:
+ *
+ *     constexpr cgs::divider<int, cgs::div_round_mode::euclid> tiles { 48 };
+ *     int tile = tiles.mod(x);
+ */
+template <typename Int, div_round_mode RoundMode>
+class divider
+{
+    static_assert(is_integral_v<Int> && !std::is_same<Int, bool>::value, "divider needs an integer type");
+
+private:
+
+    using word = detail::divider_word_t<Int>;
+    using uword = std::make_unsigned_t<word>;
+
+    static constexpr int bits = std::numeric_limits<uword>::digits;
+
+    // _magic == 0 divides by a power of 2 with a shift
+    uword _magic {};
+    std::uint8_t _shift {};
+    // one more bit of magic, added back after the multiply
+    bool _add {};
+    Int _divisor;
+
+    constexpr word div_trunc(word n) const noexcept
+    {
+        if constexpr(std::is_signed<word>::value) {
+            const word sign = _divisor < 0 ? -1 : 0;
+            if(!_magic) {
+                // round negative n toward zero by adding d - 1
+                const uword mask = (uword{1} << _shift) - 1;
+                word quot = static_cast<word>(static_cast<uword>(n) + (static_cast<uword>(n >> (bits - 1)) & mask));
+                quot >>= _shift;
+                return (quot ^ sign) - sign;
+            }
+            uword uquot = static_cast<uword>(detail::mulhi_signed(static_cast<word>(_magic), n));
+            if(_add) {
+                // + n, or - n for a negative divisor
+                uquot += (static_cast<uword>(n) ^ static_cast<uword>(sign)) - static_cast<uword>(sign);
+            }
+            word quot = static_cast<word>(uquot);
+            quot >>= _shift;
+            // round toward zero
+            return quot + (quot < 0);
+        }
+        else {
+            if(!_magic) {
+                return n >> _shift;
+            }
+            const uword quot = detail::mulhi(_magic, n);
+            if(_add) {
+                return (((n - quot) >> 1) + quot) >> _shift;
+            }
+            return quot >> _shift;
+        }
+    }
+
+public:
+
+    /**
+     * @brief Compute the magic numbers for d, which must not be 0.
+     */
+    constexpr explicit divider(Int d)
+        : _divisor(d)
+    {
+        cgs_assert(d != 0);
+
+        const uword absD = d < 0 ? uword{0} - static_cast<uword>(d) : static_cast<uword>(d);
+        const int log = detail::floor_log2(absD);
+        if((absD & (absD - 1)) == 0) {
+            _shift = static_cast<std::uint8_t>(log);
+            return;
+        }
+
+        // signed magic numbers have one bit less
+        const int magicLog = std::is_signed<word>::value ? log - 1 : log;
+        uword rem = 0;
+        uword magic = detail::div_wide(static_cast<uword>(uword{1} << magicLog), absD, rem);
+        if(absD - rem < (uword{1} << log)) {
+            _shift = static_cast<std::uint8_t>(magicLog);
+        }
+        else {
+            // needs bits + 1 bits of magic
+            magic += magic;
+            const uword twiceRem = rem + rem;
+            if(twiceRem >= absD || twiceRem < rem) {
+                magic += 1;
+            }
+            _shift = static_cast<std::uint8_t>(log);
+            _add = true;
+        }
+        magic += 1;
+        if constexpr(std::is_signed<word>::value) {
+            _magic = d < 0 ? uword{0} - magic : magic;
+        }
+        else {
+            _magic = magic;
+        }
+    }
+
+    constexpr Int divisor() const noexcept
+    {
+        return _divisor;
+    }
+
+    /**
+     * @brief Same as div<RoundMode>(n, divisor()).
+     */
+    constexpr Int div(Int n) const noexcept
+    {
+        if constexpr(RoundMode == div_round_mode::trunc || !is_signed_v<Int>) {
+            return static_cast<Int>(div_trunc(n));
+        }
+        else {
+            return divmod(n).quot;
+        }
+    }
+
+    /**
+     * @brief Same as mod<RoundMode>(n, divisor()).
+     */
+    constexpr Int mod(Int n) const noexcept
+    {
+        return divmod(n).rem;
+    }
+
+    /**
+     * @brief Same as divmod<RoundMode>(n, divisor()).
+     */
+    constexpr div_type<Int> divmod(Int n) const noexcept
+    {
+        Int quot = static_cast<Int>(div_trunc(n));
+        Int rem = static_cast<Int>(n - quot * _divisor);
+
+        // same adjustments as div and mod
+        detail::round_divmod<RoundMode>(quot, rem, _divisor);
+        return { quot, rem };
+    }
+};
+
+template <typename Int, div_round_mode RoundMode>
+constexpr Int operator/(Int n, const divider<Int, RoundMode>& d) noexcept
+{
+    return d.div(n);
+}
+
+template <typename Int, div_round_mode RoundMode>
+constexpr Int operator%(Int n, const divider<Int, RoundMode>& d) noexcept
+{
+    return d.mod(n);
+}
+
+} // namespace cgs
+
+#endif // CGS_DIVIDER_HPP
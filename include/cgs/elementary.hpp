@@ -0,0 +1,2016 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_ELEMENTARY_HPP
+#define CGS_ELEMENTARY_HPP
+
+#include "cgs/optimize.hpp" // cgs_unlikely
+#include "cgs/meta/constexpr.hpp" // is_constant_evaluated
+#include "cgs/meta/invocable.hpp" // enable_if_t
+
+#include <cmath>
+#include <cstdint>
+#include <cstring> // memcpy
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+/*
+constexpr sqrt, exp, exp2, log, log2, sin, cos, atan2 and pow, for float and double.
+They do not match other types, which find the standard library after `using namespace cgs`.
+
+Runtime cost: the default tier, cgs::accuracy::standard, evaluates constants with the code of accurate
+and calls the standard library at runtime, so hot code pays nothing over std::, but a runtime value can differ
+in the last bit from the same constant. Ask for cgs::accuracy::accurate to run the double-double code at runtime too,
+so a value does not change when it is no longer a constant, at 300 to 1400 ns a call, about 100 times
+the standard library (bench/elementary.cpp). sqrt is the hardware instruction at runtime in every tier.
+
+cgs::accuracy::standard, the default:
+    The results of accurate in constant evaluation, the standard library at runtime.
+
+cgs::accuracy::accurate:
+    Computed in double-double (106 bits, relative error under 2^-90) and rounded once.
+    sqrt, exp, exp2, log and log2 are correctly rounded. When the double-double result is within its error
+    of a midpoint between two results (Ziv's rounding test), such as e^(2^-53) = 1 + 2^-53 + 2^-107 + ...,
+    they recompute in triple-double, with an error under 2^-150. No double argument is known to come that close
+    to a midpoint, the closest found by Lefevre and Muller's exhaustive searches are much further.
+    pow rounds the results that are exact or exactly a midpoint, such as pow(134217727.0, 2.0) = 2^54 - 2^28 + 1,
+    from the exact value, ties to even.
+    sin, cos, atan2 and the other results of pow are not guaranteed correctly rounded, only when the exact result
+    is further than 2^-90 from a midpoint.
+
+cgs::accuracy::fast:
+    Inline code at compile time, float evaluated in double, exp and log from 128 entry tables.
+    At runtime the same code only where it is faster than glibc on x86-64 (bench/elementary.cpp):
+    double exp, exp2, sin and cos, and float atan2. The others call the standard library at runtime.
+    Runtime results of the inline code can differ in the last bit
+    where the compiler contracts a multiply and add into an fma (GCC does by default with FMA targets).
+    Special values (infinities, NaN, zeros, overflow, underflow) are the same as accurate.
+    Largest error in ULP, measured on random samples and near the table boundaries of atan2,
+    and checked against the unrounded double-double of the accurate tier by test/elementary.cpp:
+
+                    float   double
+        sqrt        0.5     0.5
+        exp, exp2   0.51    0.75   (0.51 for normal results)
+        log, log2   0.51    0.52
+        sin, cos    0.51    0.77   (|x| < 1.6e6, larger x calls the standard library at runtime)
+        atan2       0.51    1.91   (|y / x| or |x / y| near 1/8)
+        pow         0.51    0.53
+
+    The errors are of the inline code, the runtime error of the others is the standard library's.
+
+Constant evaluation cannot produce infinities or NaN from arithmetic, so the special values are returned explicitly.
+*/
+
+#if defined(__has_builtin)
+    #if __has_builtin(__builtin_bit_cast)
+        #define CGS_HAS_BUILTIN_BIT_CAST
+    #endif
+#endif
+#if !defined(CGS_HAS_BUILTIN_BIT_CAST) && defined(_MSC_VER) && _MSC_VER >= 1927
+    #define CGS_HAS_BUILTIN_BIT_CAST
+#endif
+
+namespace cgs
+{
+
+/**
+ * @brief Which implementation the elementary functions use.
+ */
+enum class accuracy
+{
+    // the default, accurate in constant evaluation and the standard library at runtime
+    standard,
+    // correctly rounded sqrt, exp, exp2, log and log2, the others nearly, see the top of this file.
+    // The same code at runtime, about 100 times slower than the standard library.
+    accurate,
+    // inline polynomials, under 2 ULP, see the table above
+    fast,
+};
+
+namespace detail
+{
+
+template <typename T>
+inline constexpr bool is_elementary_v = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+template <typename T>
+struct float_layout;
+
+template <>
+struct float_layout<float>
+{
+    using bits = std::uint32_t;
+    static constexpr int mantissa = 23;
+    static constexpr int bias = 127;
+};
+
+template <>
+struct float_layout<double>
+{
+    using bits = std::uint64_t;
+    static constexpr int mantissa = 52;
+    static constexpr int bias = 1023;
+};
+
+template <typename T>
+using float_bits_t = typename float_layout<T>::bits;
+
+template <typename T>
+constexpr T infinity = std::numeric_limits<T>::infinity();
+
+template <typename T>
+constexpr T quiet_nan = std::numeric_limits<T>::quiet_NaN();
+
+template <typename T>
+constexpr T fabs(T x) noexcept
+{
+    return x < 0 ? -x : x;
+}
+
+#ifndef CGS_HAS_BUILTIN_BIT_CAST
+
+// the bit pattern of x by arithmetic, for constant evaluation without a bit_cast builtin
+template <typename T>
+constexpr float_bits_t<T> to_bits_arithmetic(T x) noexcept
+{
+    using U = float_bits_t<T>;
+    constexpr int mantissa = float_layout<T>::mantissa;
+    constexpr int bias = float_layout<T>::bias;
+    constexpr U exponent_max = U{2 * bias + 1};
+
+    if(x != x) {
+        return (exponent_max << mantissa) | (U{1} << (mantissa - 1));
+    }
+#ifdef __GNUC__
+    const bool negative = __builtin_signbit(x);
+#else
+    const bool negative = x < 0;
+#endif
+    const U sign = U{negative} << (sizeof(U) * 8 - 1);
+    T a = negative ? -x : x;
+    if(a == 0) {
+        return sign;
+    }
+    if(a == infinity<T>) {
+        return sign | (exponent_max << mantissa);
+    }
+
+    // a = m 2^e, 1 <= m < 2
+    int e = 0;
+    while(a >= 2) {
+        a /= 2;
+        ++e;
+    }
+    while(a < 1) {
+        a *= 2;
+        --e;
+    }
+    int biased = e + bias;
+    if(biased <= 0) {
+        // subnormal, shift the implicit bit down
+        for(; biased <= 0; ++biased) {
+            a /= 2;
+        }
+        biased = 0;
+    }
+    T significand = a;
+    for(int i = 0; i < mantissa; ++i) {
+        significand *= 2;
+    }
+    const U fraction = static_cast<U>(significand) & ((U{1} << mantissa) - 1);
+    return sign | (U(biased) << mantissa) | fraction;
+}
+
+template <typename T>
+constexpr T from_bits_arithmetic(float_bits_t<T> u) noexcept
+{
+    using U = float_bits_t<T>;
+    constexpr int mantissa = float_layout<T>::mantissa;
+    constexpr int bias = float_layout<T>::bias;
+    constexpr U exponent_max = U{2 * bias + 1};
+
+    const bool negative = (u >> (sizeof(U) * 8 - 1)) != 0;
+    const int biased = static_cast<int>((u >> mantissa) & exponent_max);
+    const U fraction = u & ((U{1} << mantissa) - 1);
+    T a {};
+    if(biased == static_cast<int>(exponent_max)) {
+        a = fraction != 0 ? quiet_nan<T> : infinity<T>;
+    }
+    else {
+        a = static_cast<T>(biased == 0 ? fraction : fraction | (U{1} << mantissa));
+        for(int e = (biased == 0 ? 1 : biased) - bias - mantissa; e > 0; --e) {
+            a *= 2;
+        }
+        for(int e = (biased == 0 ? 1 : biased) - bias - mantissa; e < 0; ++e) {
+            a /= 2;
+        }
+    }
+    return negative ? -a : a;
+}
+
+#endif // CGS_HAS_BUILTIN_BIT_CAST
+
+template <typename T>
+constexpr float_bits_t<T> to_bits(T x) noexcept
+{
+#ifdef CGS_HAS_BUILTIN_BIT_CAST
+    return __builtin_bit_cast(float_bits_t<T>, x);
+#else
+    if(!is_constant_evaluated()) {
+        float_bits_t<T> u {};
+        std::memcpy(&u, &x, sizeof u);
+        return u;
+    }
+    return to_bits_arithmetic(x);
+#endif
+}
+
+template <typename T>
+constexpr T from_bits(float_bits_t<T> u) noexcept
+{
+#ifdef CGS_HAS_BUILTIN_BIT_CAST
+    return __builtin_bit_cast(T, u);
+#else
+    if(!is_constant_evaluated()) {
+        T x {};
+        std::memcpy(&x, &u, sizeof x);
+        return x;
+    }
+    return from_bits_arithmetic<T>(u);
+#endif
+}
+
+template <typename T>
+constexpr bool signbit(T x) noexcept
+{
+    return (to_bits(x) >> (sizeof(T) * 8 - 1)) != 0;
+}
+
+// 2^k, for k in the normal exponent range
+template <typename T>
+constexpr T pow2(int k) noexcept
+{
+    return from_bits<T>(float_bits_t<T>(k + float_layout<T>::bias) << float_layout<T>::mantissa);
+}
+
+// x 2^k, for |k| <= 2044, rounded once
+template <typename T>
+constexpr T scale(T x, int k) noexcept
+{
+    const int half = k / 2;
+    return x * pow2<T>(half) * pow2<T>(k - half);
+}
+
+// x = m 2^e, 1 <= m < 2, for finite x > 0
+template <typename T>
+struct float_parts
+{
+    T m;
+    int e;
+};
+
+template <typename T>
+constexpr float_parts<T> decompose(T x) noexcept
+{
+    using U = float_bits_t<T>;
+    constexpr int mantissa = float_layout<T>::mantissa;
+    constexpr int bias = float_layout<T>::bias;
+
+    int e = -bias;
+    if(x < std::numeric_limits<T>::min()) {
+        // subnormal
+        x *= pow2<T>(mantissa + 1);
+        e -= mantissa + 1;
+    }
+    const U u = to_bits(x);
+    e += static_cast<int>(u >> mantissa);
+    const T m = from_bits<T>((u & ((U{1} << mantissa) - 1)) | (U(bias) << mantissa));
+    return { m, e };
+}
+
+// x rounded to an integer, ties to even, for |x| < 2^(mantissa - 1)
+template <typename T>
+constexpr T nearest(T x) noexcept
+{
+    constexpr T shifter = T(3) * pow2<T>(float_layout<T>::mantissa - 1);
+    return (x + shifter) - shifter;
+}
+
+template <typename T>
+constexpr bool is_integer_valued(T x) noexcept
+{
+    return fabs(x) >= pow2<T>(float_layout<T>::mantissa) || x == nearest(x);
+}
+
+template <typename T>
+constexpr bool is_odd_integer(T x) noexcept
+{
+    return fabs(x) < pow2<T>(float_layout<T>::mantissa + 1) && is_integer_valued(x) && !is_integer_valued(x / 2);
+}
+
+// double-double arithmetic, after Dekker and Bailey's QD library:
+// a value hi + lo with |lo| <= ulp(hi) / 2, about 106 bits
+
+struct double_double
+{
+    double hi;
+    double lo;
+};
+
+constexpr double_double two_sum(double a, double b) noexcept
+{
+    const double s = a + b;
+    const double bb = s - a;
+    const double e = (a - (s - bb)) + (b - bb);
+    return { s, e };
+}
+
+// for |a| >= |b|
+constexpr double_double quick_two_sum(double a, double b) noexcept
+{
+    const double s = a + b;
+    return { s, b - (s - a) };
+}
+
+// a b exactly, for |a|, |b| < 2^996
+constexpr double_double two_prod(double a, double b) noexcept
+{
+    const double p = a * b;
+#ifdef __FP_FAST_FMA
+    // one instruction, and the compiler may contract the splitting below into fmas, which breaks it
+    if(!is_constant_evaluated()) {
+        return { p, std::fma(a, b, -p) };
+    }
+#endif
+    constexpr double splitter = 134217729.0; // 2^27 + 1
+    const double ta = splitter * a;
+    const double ahi = ta - (ta - a);
+    const double alo = a - ahi;
+    const double tb = splitter * b;
+    const double bhi = tb - (tb - b);
+    const double blo = b - bhi;
+    return { p, ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo };
+}
+
+constexpr double_double operator-(double_double a) noexcept
+{
+    return { -a.hi, -a.lo };
+}
+
+constexpr double_double operator+(double_double a, double_double b) noexcept
+{
+    double_double s = two_sum(a.hi, b.hi);
+    const double_double t = two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quick_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+constexpr double_double operator+(double_double a, double b) noexcept
+{
+    double_double s = two_sum(a.hi, b);
+    s.lo += a.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+constexpr double_double operator-(double_double a, double_double b) noexcept
+{
+    return a + -b;
+}
+
+constexpr double_double operator*(double_double a, double_double b) noexcept
+{
+    double_double p = two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+constexpr double_double operator*(double_double a, double b) noexcept
+{
+    double_double p = two_prod(a.hi, b);
+    p.lo += a.lo * b;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+constexpr double_double operator/(double_double a, double_double b) noexcept
+{
+    const double q1 = a.hi / b.hi;
+    double_double r = a - b * q1;
+    const double q2 = r.hi / b.hi;
+    r = r - b * q2;
+    const double q3 = r.hi / b.hi;
+    return quick_two_sum(q1, q2) + q3;
+}
+
+constexpr double_double operator/(double_double a, double b) noexcept
+{
+    const double q1 = a.hi / b;
+    const double_double p = two_prod(q1, b);
+    const double q2 = (((a.hi - p.hi) - p.lo) + a.lo) / b;
+    return quick_two_sum(q1, q2);
+}
+
+// sqrt(a) for a > 0, from the correctly rounded double
+constexpr double sqrt_accurate(double x) noexcept;
+
+constexpr double_double sqrt(double_double a) noexcept
+{
+    const double s = sqrt_accurate(a.hi);
+    const double_double r = a - two_prod(s, s);
+    return quick_two_sum(s, r.hi / (2 * s));
+}
+
+// constants to 159 bits, hi + mid + lo
+
+constexpr double ln2_hi = 0x1.62e42fefa39efp-1;
+constexpr double ln2_mid = 0x1.abc9e3b39803fp-56;
+constexpr double ln2_lo = 0x1.7b57a079a1934p-111;
+constexpr double_double ln2_dd { ln2_hi, ln2_mid };
+constexpr double_double inv_ln2_dd { 0x1.71547652b82fep+0, 0x1.777d0ffda0d24p-56 };
+constexpr double inv_ln2_lo = -0x1.60bb8a5442ab9p-110;
+
+constexpr double pio2_hi = 0x1.921fb54442d18p+0;
+constexpr double pio2_mid = 0x1.1a62633145c07p-54;
+constexpr double pio2_lo = -0x1.f1976b7ed8fbcp-110;
+constexpr double_double pio2_dd { pio2_hi, pio2_mid };
+
+// k ln2 in double-double, for integer |k| < 2^20
+constexpr double_double k_ln2(double k) noexcept
+{
+    return two_prod(k, ln2_hi) + two_prod(k, ln2_mid) + k * ln2_lo;
+}
+
+// x rounded to T, overflowing to infinity
+template <typename T>
+constexpr T narrow(double x) noexcept
+{
+    if constexpr(std::is_same<T, float>::value) {
+        // at or above max + ulp / 2 rounds to infinity
+        if(cgs_unlikely(fabs(x) >= 0x1.ffffffp127)) {
+            return x > 0 ? infinity<float> : -infinity<float>;
+        }
+        return static_cast<float>(x);
+    }
+    else {
+        return x;
+    }
+}
+
+// the double-double v 2^k rounded once to T
+template <typename T>
+constexpr T round_scaled(double_double v, int k) noexcept
+{
+    v = quick_two_sum(v.hi, v.lo);
+    if(v.hi == 0) {
+        return static_cast<T>(v.hi);
+    }
+    const bool negative = v.hi < 0;
+    if(negative) {
+        v = -v;
+    }
+
+    // v.hi in [1, 2), so k is the exponent of the result
+    const int e = decompose(v.hi).e;
+    v = { scale(v.hi, -e), scale(v.lo, -e) };
+    k += e;
+
+    T result {};
+    if constexpr(std::is_same<T, double>::value) {
+        if(k > 1023) {
+            // v.hi is v rounded, below 2, so there is no tie at max + ulp / 2
+            result = infinity<double>;
+        }
+        else if(k >= -1022) {
+            // normal, v.hi is the rounded v and scaling it is exact
+            result = scale(v.hi, k);
+        }
+        else if(k < -1075) {
+            // below half the smallest subnormal
+            result = 0;
+        }
+        else {
+            // subnormal: n = v 2^(k + 1074) < 2^52 exactly, rounded to an integer, ties to even, 2^-1074 apart
+            const double n_hi = scale(v.hi, k + 1074);
+            const double n_lo = scale(v.lo, k + 1074);
+            double n = (n_hi + 0x1p52) - 0x1p52;
+            // n_hi was a tie, which n_lo breaks
+            const double d = n_hi - n;
+            if(fabs(d) == 0.5 && n_lo != 0 && (n_lo > 0) == (d > 0)) {
+                n += 2 * d;
+            }
+            result = scale(n, -1074);
+        }
+    }
+    else {
+        if(k > 128) {
+            result = infinity<float>;
+        }
+        else if(k < -151) {
+            // below half the smallest subnormal
+            result = 0;
+        }
+        else {
+            // round to odd in double, then one rounding to float from at least 29 more bits is correct
+            double x = v.hi;
+            if(v.lo != 0) {
+                const auto u = to_bits(x);
+                if((u & 1) == 0) {
+                    x = from_bits<double>(v.lo > 0 ? u + 1 : u - 1);
+                }
+            }
+            result = narrow<float>(scale(x, k));
+        }
+    }
+    return negative ? -result : result;
+}
+
+template <typename T>
+constexpr T round_dd(double_double v) noexcept
+{
+    return round_scaled<T>(v, 0);
+}
+
+// a bound on the relative error of the double-double exp, exp2, log and log2, which measure under 2^-96
+constexpr double double_double_error = 0x1p-90;
+
+// Ziv's rounding test: whether v 2^k is within relative error of a midpoint between two Ts,
+// where rounding v may round the exact result the other way
+template <typename T>
+constexpr bool hard_to_round(double_double v, int k, double error) noexcept
+{
+    v = quick_two_sum(v.hi, v.lo);
+    if(v.hi == 0) {
+        return false;
+    }
+    const double lo = v.hi < 0 ? -v.lo : v.lo;
+    const double hi = fabs(v.hi);
+
+    // the exponent of T's last place at v 2^k, subnormals share the smallest normal's
+    constexpr int digits = std::numeric_limits<T>::digits;
+    constexpr int min_e = std::numeric_limits<T>::min_exponent - 1;
+    const int e = decompose(hi).e + k;
+    const int q = (e > min_e ? e : min_e) - (digits - 1);
+
+    // v 2^k in units of the last place, w < 2^53, and its distance past the nearest integer
+    const double w = scale(hi, k - q);
+    const double n = w >= 0x1p52 ? w : (w + 0x1p52) - 0x1p52;
+    const double offset = (w - n) + scale(lo, k - q);
+    return fabs(0.5 - fabs(offset)) <= error * w;
+}
+
+// triple-double arithmetic, about 159 bits, for the results double-double cannot round.
+// The components do not overlap after renormalize.
+
+struct triple_double
+{
+    double hi;
+    double mid;
+    double lo;
+};
+
+// a + b + c, exactly
+constexpr triple_double renormalize(double a, double b, double c) noexcept
+{
+    const double_double bc = two_sum(b, c);
+    const double_double abc = two_sum(a, bc.hi);
+    const double_double tail = two_sum(abc.lo, bc.lo);
+    const double_double hi = two_sum(abc.hi, tail.hi);
+    const double_double mid = two_sum(hi.lo, tail.lo);
+    return { hi.hi, mid.hi, mid.lo };
+}
+
+constexpr triple_double operator-(triple_double a) noexcept
+{
+    return { -a.hi, -a.mid, -a.lo };
+}
+
+constexpr triple_double operator+(triple_double a, triple_double b) noexcept
+{
+    const double_double hi = two_sum(a.hi, b.hi);
+    const double_double mid = two_sum(a.mid, b.mid);
+    const double_double carry = two_sum(hi.lo, mid.hi);
+    return renormalize(hi.hi, carry.hi, carry.lo + mid.lo + (a.lo + b.lo));
+}
+
+constexpr triple_double operator+(triple_double a, double_double b) noexcept
+{
+    return a + triple_double{ b.hi, b.lo, 0 };
+}
+
+constexpr triple_double operator-(triple_double a, triple_double b) noexcept
+{
+    return a + -b;
+}
+
+constexpr triple_double operator*(triple_double a, triple_double b) noexcept
+{
+    const double_double hi = two_prod(a.hi, b.hi);
+    const double_double mid1 = two_prod(a.hi, b.mid);
+    const double_double mid2 = two_prod(a.mid, b.hi);
+    const double_double mid = two_sum(mid1.hi, mid2.hi);
+    const double_double carry = two_sum(hi.lo, mid.hi);
+    const double lo = a.hi * b.lo + a.mid * b.mid + a.lo * b.hi + mid1.lo + mid2.lo;
+    return renormalize(hi.hi, carry.hi, carry.lo + mid.lo + lo);
+}
+
+constexpr triple_double operator*(triple_double a, double b) noexcept
+{
+    const double_double hi = two_prod(a.hi, b);
+    const double_double mid = two_prod(a.mid, b);
+    const double_double carry = two_sum(hi.lo, mid.hi);
+    return renormalize(hi.hi, carry.hi, carry.lo + mid.lo + a.lo * b);
+}
+
+// long division, one double of quotient a step
+constexpr triple_double operator/(triple_double a, triple_double b) noexcept
+{
+    const double q0 = a.hi / b.hi;
+    triple_double r = a - b * q0;
+    const double q1 = r.hi / b.hi;
+    r = r - b * q1;
+    const double q2 = r.hi / b.hi;
+    r = r - b * q2;
+    const double q3 = r.hi / b.hi;
+    return renormalize(q0, q1, q2) + double_double{ q3, 0 };
+}
+
+constexpr triple_double operator/(triple_double a, double b) noexcept
+{
+    return a / triple_double{ b, 0, 0 };
+}
+
+// the triple-double v 2^k rounded once to T
+template <typename T>
+constexpr T round_scaled(triple_double v, int k) noexcept
+{
+    // mid + lo rounded to odd: when inexact it is not half an ulp of hi, so rounding hi + mid makes no false tie
+    v = renormalize(v.hi, v.mid, v.lo);
+    double_double tail = two_sum(v.mid, v.lo);
+    if(tail.lo != 0) {
+        const auto u = to_bits(tail.hi);
+        if((u & 1) == 0) {
+            // away from zero when tail.lo adds to the magnitude of tail.hi
+            tail.hi = from_bits<double>((tail.lo > 0) == (tail.hi > 0) ? u + 1 : u - 1);
+        }
+    }
+    return round_scaled<T>(double_double{ v.hi, tail.hi }, k);
+}
+
+// sqrt
+
+constexpr double sqrt_accurate(double x) noexcept
+{
+    if(!is_constant_evaluated()) {
+        // the hardware instruction, also correctly rounded
+        return std::sqrt(x);
+    }
+    if(!(x > 0 && x < infinity<double>)) {
+        if(x != x || x == 0 || x == infinity<double>) {
+            return x;
+        }
+        return quiet_nan<double>;
+    }
+
+    // x = m 2^e, 1 <= m < 4, even e
+    auto [m, e] = decompose(x);
+    if(e % 2 != 0) {
+        m *= 2;
+        --e;
+    }
+
+    // Newton from (1 + m) / 2, within 25% of sqrt(m), quadratic convergence
+    double y = (1 + m) / 2;
+    for(int i = 0; i < 6; ++i) {
+        y = (y + m / y) / 2;
+    }
+
+    // y is within an ulp, choose among its neighbors by the exact residual m - c^2, never a tie
+    const auto u = to_bits(y);
+    double best = y;
+    double best_residual = infinity<double>;
+    for(const auto c : { u - 1, u, u + 1 }) {
+        const double candidate = from_bits<double>(c);
+        const double_double square = two_prod(candidate, candidate);
+        const double_double residual = two_sum(m, -square.hi) + -square.lo;
+        const double magnitude = fabs(residual.hi);
+        if(magnitude < best_residual) {
+            best = candidate;
+            best_residual = magnitude;
+        }
+    }
+    return scale(best, e / 2);
+}
+
+// exp
+
+// e^r - 1 for |r| <= 0.36, by its Taylor series
+constexpr double_double expm1_series(double_double r) noexcept
+{
+    double_double term = r;
+    double_double sum = r;
+    for(int n = 2; n < 40 && fabs(term.hi) > 0x1p-110 * fabs(sum.hi); ++n) {
+        term = term * r / static_cast<double>(n);
+        sum = sum + term;
+    }
+    return sum;
+}
+
+// e^x = v 2^k
+struct scaled_double_double
+{
+    double_double v;
+    int k;
+};
+
+struct scaled_triple_double
+{
+    triple_double v;
+    int k;
+};
+
+// e^x for |x| < 2^19 in double-double
+constexpr scaled_double_double exp_dd(double_double x) noexcept
+{
+    const double k = nearest(x.hi * inv_ln2_dd.hi);
+    const double_double r = x - k_ln2(k);
+    return { expm1_series(r) + 1.0, static_cast<int>(k) };
+}
+
+// e^r - 1 for |r| <= 0.36 in triple-double
+constexpr triple_double expm1_series(triple_double r) noexcept
+{
+    triple_double term = r;
+    triple_double sum = r;
+    for(int n = 2; n < 60 && fabs(term.hi) > 0x1p-165 * fabs(sum.hi); ++n) {
+        term = term * r / static_cast<double>(n);
+        sum = sum + term;
+    }
+    return sum;
+}
+
+// e^x for |x| < 2^11 in triple-double
+constexpr scaled_triple_double exp_td(double x) noexcept
+{
+    // k ln2 to 159 bits from exact products, so r keeps its absolute accuracy through the cancellation
+    const double k = nearest(x * inv_ln2_dd.hi);
+    const triple_double r = triple_double{ x, 0, 0 } + -two_prod(k, ln2_hi) + -two_prod(k, ln2_mid) + -two_prod(k, ln2_lo);
+    return { expm1_series(r) + double_double{ 1, 0 }, static_cast<int>(k) };
+}
+
+// beyond these, exp overflows to infinity or rounds to zero
+template <typename T>
+constexpr double exp_overflow = std::is_same<T, float>::value ? 88.8 : 709.8;
+
+template <typename T>
+constexpr double exp_underflow = std::is_same<T, float>::value ? -104.0 : -745.2;
+
+template <typename T>
+constexpr T exp_accurate(T x) noexcept
+{
+    if(!(x > exp_underflow<T> && x < exp_overflow<T>)) {
+        if(x != x) {
+            return x;
+        }
+        return x > 0 ? infinity<T> : T{};
+    }
+    const auto [v, k] = exp_dd(double_double{ x, 0 });
+    if(cgs_unlikely(hard_to_round<T>(v, k, double_double_error))) {
+        // such as e^(2^-53) = 1 + 2^-53 + 2^-107 + ..., which double-double rounds to the tie 1 + 2^-53
+        const auto [w, wk] = exp_td(x);
+        return round_scaled<T>(w, wk);
+    }
+    return round_scaled<T>(v, k);
+}
+
+// 2^x for |x| < 2^19 in double-double
+constexpr scaled_double_double exp2_dd(double x) noexcept
+{
+    const double k = nearest(x);
+    const double_double r = double_double{ ln2_hi, ln2_mid } * (x - k) + (x - k) * ln2_lo;
+    return { expm1_series(r) + 1.0, static_cast<int>(k) };
+}
+
+// 2^x for |x| < 2^19 in triple-double
+constexpr scaled_triple_double exp2_td(double x) noexcept
+{
+    const double k = nearest(x);
+    const triple_double r = triple_double{ ln2_hi, ln2_mid, ln2_lo } * (x - k);
+    return { expm1_series(r) + double_double{ 1, 0 }, static_cast<int>(k) };
+}
+
+template <typename T>
+constexpr T exp2_accurate(T x) noexcept
+{
+    constexpr double overflow = std::is_same<T, float>::value ? 128.0 : 1024.0;
+    constexpr double underflow = std::is_same<T, float>::value ? -151.0 : -1076.0;
+    if(!(x > underflow && x < overflow)) {
+        if(x != x) {
+            return x;
+        }
+        return x > 0 ? infinity<T> : T{};
+    }
+    const auto [v, k] = exp2_dd(x);
+    if(cgs_unlikely(hard_to_round<T>(v, k, double_double_error))) {
+        const auto [w, wk] = exp2_td(x);
+        return round_scaled<T>(w, wk);
+    }
+    return round_scaled<T>(v, k);
+}
+
+// log
+
+// ln(x) = e ln2 + 2 atanh(s) with s = (m - 1) / (m + 1), sqrt(1/2) <= m < sqrt(2)
+struct log_parts
+{
+    int e;
+    double_double atanh2; // 2 atanh(s) = ln(m)
+};
+
+constexpr log_parts log_dd_parts(double x) noexcept
+{
+    auto [m, e] = decompose(x);
+    if(m > 0x1.6a09e667f3bcdp+0) {
+        m /= 2;
+        ++e;
+    }
+    const double_double s = double_double{ m - 1, 0 } / two_sum(m, 1);
+    const double_double z = s * s;
+    double_double power = s;
+    double_double sum = s;
+    for(int n = 3; n < 80 && fabs(power.hi) > 0x1p-110 * fabs(sum.hi); n += 2) {
+        power = power * z;
+        sum = sum + power / static_cast<double>(n);
+    }
+    return { e, double_double{ 2 * sum.hi, 2 * sum.lo } };
+}
+
+// ln(x) for finite x > 0
+constexpr double_double log_dd(double x) noexcept
+{
+    const auto [e, atanh2] = log_dd_parts(x);
+    return k_ln2(e) + atanh2;
+}
+
+// log2(x) for finite x > 0
+constexpr double_double log2_dd(double x) noexcept
+{
+    const auto [e, atanh2] = log_dd_parts(x);
+    return atanh2 * inv_ln2_dd + static_cast<double>(e);
+}
+
+struct log_parts_td
+{
+    int e;
+    triple_double atanh2;
+};
+
+// log_dd_parts in triple-double
+constexpr log_parts_td log_td_parts(double x) noexcept
+{
+    auto [m, e] = decompose(x);
+    if(m > 0x1.6a09e667f3bcdp+0) {
+        m /= 2;
+        ++e;
+    }
+    const triple_double s = triple_double{ m - 1, 0, 0 } / (triple_double{ m, 0, 0 } + double_double{ 1, 0 });
+    const triple_double z = s * s;
+    triple_double power = s;
+    triple_double sum = s;
+    for(int n = 3; n < 140 && fabs(power.hi) > 0x1p-165 * fabs(sum.hi); n += 2) {
+        power = power * z;
+        sum = sum + power / static_cast<double>(n);
+    }
+    return { e, sum * 2.0 };
+}
+
+// ln(x) for finite x > 0 in triple-double
+constexpr triple_double log_td(double x) noexcept
+{
+    const auto [e, atanh2] = log_td_parts(x);
+    const double k = e;
+    return triple_double{ ln2_hi, ln2_mid, ln2_lo } * k + atanh2;
+}
+
+// log2(x) for finite x > 0 in triple-double
+constexpr triple_double log2_td(double x) noexcept
+{
+    const auto [e, atanh2] = log_td_parts(x);
+    return atanh2 * triple_double{ inv_ln2_dd.hi, inv_ln2_dd.lo, inv_ln2_lo } + double_double{ static_cast<double>(e), 0 };
+}
+
+template <typename T>
+constexpr bool log_special(T x, T& result) noexcept
+{
+    if(x > 0 && x < infinity<T>) {
+        return false;
+    }
+    if(x == 0) {
+        result = -infinity<T>;
+    }
+    else if(x == infinity<T> || x != x) {
+        result = x;
+    }
+    else {
+        result = quiet_nan<T>;
+    }
+    return true;
+}
+
+template <typename T>
+constexpr T log_accurate(T x) noexcept
+{
+    T result {};
+    if(log_special(x, result)) {
+        return result;
+    }
+    const double_double v = log_dd(x);
+    if(cgs_unlikely(hard_to_round<T>(v, 0, double_double_error))) {
+        return round_scaled<T>(log_td(x), 0);
+    }
+    return round_dd<T>(v);
+}
+
+template <typename T>
+constexpr T log2_accurate(T x) noexcept
+{
+    T result {};
+    if(log_special(x, result)) {
+        return result;
+    }
+    const double_double v = log2_dd(x);
+    if(cgs_unlikely(hard_to_round<T>(v, 0, double_double_error))) {
+        return round_scaled<T>(log2_td(x), 0);
+    }
+    return round_dd<T>(v);
+}
+
+// sin and cos
+
+// fraction bits of 2/pi, 32 per word
+constexpr std::uint32_t two_over_pi_bits[] {
+    0xa2f9836e, 0x4e441529, 0xfc2757d1, 0xf534ddc0, 0xdb629599, 0x3c439041, 0xfe5163ab, 0xdebbc561,
+    0xb7246e3a, 0x424dd2e0, 0x06492eea, 0x09d1921c, 0xfe1deb1c, 0xb129a73e, 0xe88235f5, 0x2ebb4484,
+    0xe99c7026, 0xb45f7e41, 0x3991d639, 0x835339f4, 0x9c845f8b, 0xbdf9283b, 0x1ff897ff, 0xde05980f,
+    0xef2f118b, 0x5a0a6d1f, 0x6d367ecf, 0x27cb09b7, 0x4f463f66, 0x9e5fea2d, 0x7527bac7, 0xebe5f17b,
+    0x3d0739f7, 0x8a5292ea, 0x6bfb5fb1, 0x1f8d5d08, 0x56033046, 0xfc7b6bab, 0xf0cfbc20, 0x9af4361d,
+};
+
+// x = r + q pi/2, |r| <= pi/4
+struct quadrant_reduction
+{
+    double_double r;
+    int q;
+};
+
+// Payne-Hanek reduction of finite x, exact integer arithmetic with enough bits of 2/pi for any double
+constexpr quadrant_reduction reduce_pio2(double x) noexcept
+{
+    const double a = fabs(x);
+    if(a <= 0x1.921fb54442d18p-1) {
+        return { { x, 0 }, 0 };
+    }
+
+    // a = M 2^(e - 52)
+    const std::uint64_t bits = to_bits(a);
+    const int e = static_cast<int>(bits >> 52) - 1023;
+    const std::uint64_t M = (bits & ((std::uint64_t{1} << 52) - 1)) | (std::uint64_t{1} << 52);
+
+    // words before s only add multiples of 4 to a 2/pi
+    const int s = e >= 86 ? (e - 54) / 32 : 0;
+    constexpr int words = 9;
+    constexpr std::uint64_t mask32 = 0xffffffff;
+
+    // P = M W, W the 288 bits from word s, 32 bit little endian limbs
+    std::uint64_t P[words + 2] {};
+    const std::uint64_t Mlo = M & mask32;
+    const std::uint64_t Mhi = M >> 32;
+    for(int j = 0; j < words; ++j) {
+        const std::uint64_t w = two_over_pi_bits[s + words - 1 - j];
+        const std::uint64_t lo = Mlo * w;
+        const std::uint64_t hi = Mhi * w;
+        P[j] += lo & mask32;
+        P[j + 1] += (lo >> 32) + (hi & mask32);
+        P[j + 2] += hi >> 32;
+    }
+    for(int j = 0; j + 1 < words + 2; ++j) {
+        P[j + 1] += P[j] >> 32;
+        P[j] &= mask32;
+    }
+
+    // a 2/pi = P 2^-F
+    const int F = 32 * (s + words) + 52 - e;
+
+    // count bits of P from position lsb up, count <= 53
+    const auto extract = [&P](int lsb, int count) {
+        std::uint64_t value = 0;
+        for(int i = lsb + count - 1; i >= lsb; --i) {
+            value = (value << 1) | ((P[i / 32] >> (i % 32)) & 1);
+        }
+        return static_cast<double>(value);
+    };
+
+    int q = static_cast<int>(extract(F, 2));
+    double_double f = double_double{ extract(F - 53, 53) * 0x1p-53, 0 }
+        + extract(F - 106, 53) * 0x1p-106
+        + extract(F - 159, 53) * 0x1p-159
+        + extract(F - 212, 53) * 0x1p-212;
+    if(f.hi > 0.5 || (f.hi == 0.5 && f.lo > 0)) {
+        f = f + -1.0;
+        ++q;
+    }
+    double_double r = f * pio2_dd + f.hi * pio2_lo;
+    if(x < 0) {
+        r = -r;
+        q = -q;
+    }
+    return { r, q & 3 };
+}
+
+// sin(r) and cos(r) for |r| <= pi/4, by their Taylor series
+constexpr double_double sin_series(double_double r) noexcept
+{
+    const double_double r2 = r * r;
+    double_double term = r;
+    double_double sum = r;
+    for(int n = 3; n < 60 && fabs(term.hi) > 0x1p-110 * fabs(sum.hi); n += 2) {
+        term = -(term * r2) / static_cast<double>(n * (n - 1));
+        sum = sum + term;
+    }
+    return sum;
+}
+
+constexpr double_double cos_series(double_double r) noexcept
+{
+    const double_double r2 = r * r;
+    double_double term { 1, 0 };
+    double_double sum { 1, 0 };
+    for(int n = 2; n < 60 && fabs(term.hi) > 0x1p-110; n += 2) {
+        term = -(term * r2) / static_cast<double>(n * (n - 1));
+        sum = sum + term;
+    }
+    return sum;
+}
+
+// sin(x + Shift pi/2) for finite x
+template <int Shift>
+constexpr double_double sin_dd(double x) noexcept
+{
+    const auto [r, q] = reduce_pio2(x);
+    switch((q + Shift) & 3) {
+    case 0:
+        return sin_series(r);
+    case 1:
+        return cos_series(r);
+    case 2:
+        return -sin_series(r);
+    default:
+        return -cos_series(r);
+    }
+}
+
+// sin(x + Shift pi/2)
+template <int Shift, typename T>
+constexpr T sin_accurate(T x) noexcept
+{
+    if(!(fabs(x) < infinity<T>)) {
+        return x != x ? x : quiet_nan<T>;
+    }
+    if(fabs(x) < 0x1p-27) {
+        // sin(x) = x - x^3 / 6 and cos(x) = 1 - x^2 / 2 round to x and 1
+        return Shift == 0 ? x : T{1};
+    }
+    return round_dd<T>(sin_dd<Shift>(x));
+}
+
+// atan2
+
+template <typename T>
+constexpr T copysign(T magnitude, T sign) noexcept
+{
+    return signbit(sign) ? -fabs(magnitude) : fabs(magnitude);
+}
+
+// atan2 of zeros, infinities and NaN, false otherwise
+template <typename T>
+constexpr bool atan2_special(T y, T x, T& result) noexcept
+{
+    constexpr double pi = 2 * pio2_hi;
+    const T ay = fabs(y);
+    const T ax = fabs(x);
+    if(y != y || x != x) {
+        result = quiet_nan<T>;
+    }
+    else if(y == 0) {
+        result = copysign(signbit(x) ? static_cast<T>(pi) : T{}, y);
+    }
+    else if(ay == infinity<T>) {
+        const double angle = ax != infinity<T> ? pio2_hi : (signbit(x) ? 3 * pio2_hi / 2 : pio2_hi / 2);
+        result = copysign(static_cast<T>(angle), y);
+    }
+    else if(x == 0) {
+        result = copysign(static_cast<T>(pio2_hi), y);
+    }
+    else if(ax == infinity<T>) {
+        result = copysign(signbit(x) ? static_cast<T>(pi) : T{}, y);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+// atan(t) for 0 <= t <= 1
+constexpr double_double atan_dd(double_double t) noexcept
+{
+    // atan(t) = 2 atan(t / (1 + sqrt(1 + t^2))), three times to |t| <= tan(pi/32)
+    for(int i = 0; i < 3 && t.hi != 0; ++i) {
+        t = t / (sqrt(t * t + 1.0) + 1.0);
+    }
+    const double_double t2 = t * t;
+    double_double power = t;
+    double_double sum = t;
+    for(int n = 3; n < 80 && fabs(power.hi) > 0x1p-110 * fabs(sum.hi); n += 2) {
+        power = -(power * t2);
+        sum = sum + power / static_cast<double>(n);
+    }
+    return { 8 * sum.hi, 8 * sum.lo };
+}
+
+// atan2(y, x) for finite nonzero y and x
+constexpr double_double atan2_dd(double y, double x) noexcept
+{
+    double ay = fabs(y);
+    double ax = fabs(x);
+
+    // scale the larger to [1, 2), so the division neither overflows nor splits past 2^996
+    const bool swap = ay > ax;
+    const int k = decompose(swap ? ay : ax).e;
+    ay = scale(ay, -k);
+    ax = scale(ax, -k);
+
+    double_double angle = swap ? atan_dd(double_double{ ax, 0 } / ay) : atan_dd(double_double{ ay, 0 } / ax);
+    if(swap) {
+        angle = pio2_dd - angle;
+    }
+    if(signbit(x)) {
+        angle = double_double{ 2 * pio2_hi, 2 * pio2_mid } - angle;
+    }
+    return signbit(y) ? -angle : angle;
+}
+
+template <typename T>
+constexpr T atan2_accurate(T y, T x) noexcept
+{
+    T result {};
+    if(atan2_special(y, x, result)) {
+        return result;
+    }
+    if(!signbit(x) && fabs(y) < 0x1p-60 * fabs(x)) {
+        // atan(t) = t - t^3 / 3 rounds to t, and y / x may be subnormal, where scaling would round twice
+        return y / x;
+    }
+    return round_dd<T>(atan2_dd(y, x));
+}
+
+// pow
+
+// pow where x or y is zero, infinite, NaN or x negative, false otherwise,
+// for negative x and integer y, x is replaced with |x| and negate is set for odd y
+template <typename T>
+constexpr bool pow_special(T& x, T y, T& result, bool& negate) noexcept
+{
+    negate = false;
+    if(y == 0 || x == 1) {
+        result = T{1};
+        return true;
+    }
+    if(x != x || y != y) {
+        result = quiet_nan<T>;
+        return true;
+    }
+    const T ax = fabs(x);
+    if(fabs(y) == infinity<T>) {
+        if(ax == 1) {
+            result = T{1};
+        }
+        else {
+            result = (ax > 1) == (y > 0) ? infinity<T> : T{};
+        }
+        return true;
+    }
+    const bool odd = is_odd_integer(y);
+    if(x == 0 || ax == infinity<T>) {
+        // 1/0 for y < 0, infinity for y > 0, mirrored for infinite x
+        const bool large = (x == 0) == (y < 0);
+        const T magnitude = large ? infinity<T> : T{};
+        result = odd && signbit(x) ? -magnitude : magnitude;
+        return true;
+    }
+    if(x < 0) {
+        if(!is_integer_valued(y)) {
+            result = quiet_nan<T>;
+            return true;
+        }
+        x = ax;
+        negate = odd;
+    }
+    return false;
+}
+
+template <typename T>
+constexpr T negate_if(T x, bool negate) noexcept
+{
+    return negate ? -x : x;
+}
+
+// x = m 2^e with m an odd integer, for finite x > 0
+struct odd_parts
+{
+    std::uint64_t m;
+    int e;
+};
+
+constexpr odd_parts decompose_odd(double x) noexcept
+{
+    const auto [f, e] = decompose(x);
+    odd_parts parts { static_cast<std::uint64_t>(scale(f, 52)), e - 52 };
+    while((parts.m & 1) == 0) {
+        parts.m >>= 1;
+        ++parts.e;
+    }
+    return parts;
+}
+
+// pow for finite x > 0 when x^y = m^n 2^(e n) exactly, with m^n < 2^63: y = n / 2^s, and x the 2^s-th power
+// of m 2^e. Every x^y that is a T, or a midpoint between two, is one of these, and rounding it from
+// the double-double exp(y log(x)) could go either way, so it is rounded once from the exact value.
+// Returns false for the others.
+template <typename T>
+constexpr bool pow_exact(double x, double y, T& result) noexcept
+{
+    odd_parts parts = decompose_odd(x);
+    // the 2^s-th root of x, while y is not an integer
+    while(!is_integer_valued(y)) {
+        const auto root = static_cast<std::uint64_t>(sqrt_accurate(static_cast<double>(parts.m)));
+        if(root * root != parts.m || parts.e % 2 != 0) {
+            return false;
+        }
+        parts = { root, parts.e / 2 };
+        y *= 2;
+    }
+    // larger n over- or underflow, unless x is 1
+    if(!(fabs(y) <= 4096)) {
+        return false;
+    }
+    const auto n = static_cast<int>(y);
+    if(n < 0 && parts.m != 1) {
+        // 1 / m^-n has no end in binary
+        return false;
+    }
+
+    std::uint64_t power = 1;
+    for(int i = 0; i < n && parts.m != 1; ++i) {
+        if(power > (std::uint64_t{1} << 63) / parts.m) {
+            return false;
+        }
+        power *= parts.m;
+    }
+    // power < 2^63 as an exact double-double, 52 and 11 bits
+    const double hi = static_cast<double>(power & ~std::uint64_t{0x7ff});
+    const double lo = static_cast<double>(power & 0x7ff);
+    result = round_scaled<T>(double_double{ hi, lo }, parts.e * n);
+    return true;
+}
+
+template <typename T>
+constexpr T pow_accurate(T x, T y) noexcept
+{
+    T result {};
+    bool negate = false;
+    if(pow_special(x, y, result, negate)) {
+        return result;
+    }
+    if(pow_exact(static_cast<double>(x), static_cast<double>(y), result)) {
+        return negate_if(result, negate);
+    }
+    const double_double t = log_dd(x) * static_cast<double>(y);
+    if(!(t.hi > exp_underflow<T> && t.hi < exp_overflow<T>)) {
+        return negate_if(t.hi > 0 ? infinity<T> : T{}, negate);
+    }
+    const auto [v, k] = exp_dd(t);
+    return negate_if(round_scaled<T>(v, k), negate);
+}
+
+// fast tier, evaluated in double
+
+// ln2 with 32 bits, so k ln2_32 is exact for |k| < 2^21
+constexpr double ln2_32 = 0x1.62e42feep-1;
+constexpr double ln2_32_lo = 0x1.a39ef35793c76p-33;
+
+struct exp_entry
+{
+    double hi;
+    double lo;
+};
+
+// 2^(j/128) in double-double
+constexpr exp_entry exp_table[128] {
+    { 0x1.0000000000000p+0, 0 }, { 0x1.0163da9fb3335p+0, 0x1.b61299ab8cdb7p-54 },
+    { 0x1.02c9a3e778061p+0, -0x1.19083535b085dp-56 }, { 0x1.04315e86e7f85p+0, -0x1.0a31c1977c96ep-54 },
+    { 0x1.059b0d3158574p+0, 0x1.d73e2a475b465p-55 }, { 0x1.0706b29ddf6dep+0, -0x1.c91dfe2b13c27p-55 },
+    { 0x1.0874518759bc8p+0, 0x1.186be4bb284ffp-57 }, { 0x1.09e3ecac6f383p+0, 0x1.1487818316136p-54 },
+    { 0x1.0b5586cf9890fp+0, 0x1.8a62e4adc610bp-54 }, { 0x1.0cc922b7247f7p+0, 0x1.01edc16e24f71p-54 },
+    { 0x1.0e3ec32d3d1a2p+0, 0x1.03a1727c57b53p-59 }, { 0x1.0fb66affed31bp+0, -0x1.b9bedc44ebd7bp-57 },
+    { 0x1.11301d0125b51p+0, -0x1.6c51039449b3ap-54 }, { 0x1.12abdc06c31ccp+0, -0x1.1b514b36ca5c7p-58 },
+    { 0x1.1429aaea92de0p+0, -0x1.32fbf9af1369ep-54 }, { 0x1.15a98c8a58e51p+0, 0x1.2406ab9eeab0ap-55 },
+    { 0x1.172b83c7d517bp+0, -0x1.19041b9d78a76p-55 }, { 0x1.18af9388c8deap+0, -0x1.11023d1970f6cp-54 },
+    { 0x1.1a35beb6fcb75p+0, 0x1.e5b4c7b4968e4p-55 }, { 0x1.1bbe084045cd4p+0, -0x1.95386352ef607p-54 },
+    { 0x1.1d4873168b9aap+0, 0x1.e016e00a2643cp-54 }, { 0x1.1ed5022fcd91dp+0, -0x1.1df98027bb78cp-54 },
+    { 0x1.2063b88628cd6p+0, 0x1.dc775814a8495p-55 }, { 0x1.21f49917ddc96p+0, 0x1.2a97e9494a5eep-55 },
+    { 0x1.2387a6e756238p+0, 0x1.9b07eb6c70573p-54 }, { 0x1.251ce4fb2a63fp+0, 0x1.ac155bef4f4a4p-55 },
+    { 0x1.26b4565e27cddp+0, 0x1.2bd339940e9d9p-55 }, { 0x1.284dfe1f56381p+0, -0x1.a4c3a8c3f0d7ep-54 },
+    { 0x1.29e9df51fdee1p+0, 0x1.612e8afad1255p-55 }, { 0x1.2b87fd0dad990p+0, -0x1.10adcd6381aa4p-59 },
+    { 0x1.2d285a6e4030bp+0, 0x1.0024754db41d5p-54 }, { 0x1.2ecafa93e2f56p+0, 0x1.1ca0f45d52383p-56 },
+    { 0x1.306fe0a31b715p+0, 0x1.6f46ad23182e4p-55 }, { 0x1.32170fc4cd831p+0, 0x1.a9ce78e18047cp-55 },
+    { 0x1.33c08b26416ffp+0, 0x1.32721843659a6p-54 }, { 0x1.356c55f929ff1p+0, -0x1.b5cee5c4e4628p-55 },
+    { 0x1.371a7373aa9cbp+0, -0x1.63aeabf42eae2p-54 }, { 0x1.38cae6d05d866p+0, -0x1.e958d3c9904bdp-54 },
+    { 0x1.3a7db34e59ff7p+0, -0x1.5e436d661f5e3p-56 }, { 0x1.3c32dc313a8e5p+0, -0x1.efff8375d29c3p-54 },
+    { 0x1.3dea64c123422p+0, 0x1.ada0911f09ebcp-55 }, { 0x1.3fa4504ac801cp+0, -0x1.7d023f956f9f3p-54 },
+    { 0x1.4160a21f72e2ap+0, -0x1.ef3691c309278p-58 }, { 0x1.431f5d950a897p+0, -0x1.1c7dde35f7999p-55 },
+    { 0x1.44e086061892dp+0, 0x1.89b7a04ef80d0p-59 }, { 0x1.46a41ed1d0057p+0, 0x1.c944bd1648a76p-54 },
+    { 0x1.486a2b5c13cd0p+0, 0x1.3c1a3b69062f0p-56 }, { 0x1.4a32af0d7d3dep+0, 0x1.9cb62f3d1be56p-54 },
+    { 0x1.4bfdad5362a27p+0, 0x1.d4397afec42e2p-56 }, { 0x1.4dcb299fddd0dp+0, 0x1.8ecdbbc6a7833p-54 },
+    { 0x1.4f9b2769d2ca7p+0, -0x1.4b309d25957e3p-54 }, { 0x1.516daa2cf6642p+0, -0x1.f768569bd93efp-55 },
+    { 0x1.5342b569d4f82p+0, -0x1.07abe1db13cadp-55 }, { 0x1.551a4ca5d920fp+0, -0x1.d689cefede59bp-55 },
+    { 0x1.56f4736b527dap+0, 0x1.9bb2c011d93adp-54 }, { 0x1.58d12d497c7fdp+0, 0x1.295e15b9a1de8p-55 },
+    { 0x1.5ab07dd485429p+0, 0x1.6324c054647adp-54 }, { 0x1.5c9268a5946b7p+0, 0x1.c4b1b816986a2p-60 },
+    { 0x1.5e76f15ad2148p+0, 0x1.ba6f93080e65ep-54 }, { 0x1.605e1b976dc09p+0, -0x1.3e2429b56de47p-54 },
+    { 0x1.6247eb03a5585p+0, -0x1.383c17e40b497p-54 }, { 0x1.6434634ccc320p+0, -0x1.c483c759d8933p-55 },
+    { 0x1.6623882552225p+0, -0x1.bb60987591c34p-54 }, { 0x1.68155d44ca973p+0, 0x1.038ae44f73e65p-57 },
+    { 0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54 }, { 0x1.6c012750bdabfp+0, -0x1.2895667ff0b0dp-56 },
+    { 0x1.6dfb23c651a2fp+0, -0x1.bbe3a683c88abp-57 }, { 0x1.6ff7df9519484p+0, -0x1.83c0f25860ef6p-55 },
+    { 0x1.71f75e8ec5f74p+0, -0x1.16e4786887a99p-55 }, { 0x1.73f9a48a58174p+0, -0x1.0a8d96c65d53cp-54 },
+    { 0x1.75feb564267c9p+0, -0x1.0245957316dd3p-54 }, { 0x1.780694fde5d3fp+0, 0x1.866b80a02162dp-54 },
+    { 0x1.7a11473eb0187p+0, -0x1.41577ee04992fp-55 }, { 0x1.7c1ed0130c132p+0, 0x1.f124cd1164dd6p-54 },
+    { 0x1.7e2f336cf4e62p+0, 0x1.05d02ba15797ep-56 }, { 0x1.80427543e1a12p+0, -0x1.27c86626d972bp-54 },
+    { 0x1.82589994cce13p+0, -0x1.d4c1dd41532d8p-54 }, { 0x1.8471a4623c7adp+0, -0x1.8d684a341cdfbp-55 },
+    { 0x1.868d99b4492edp+0, -0x1.fc6f89bd4f6bap-54 }, { 0x1.88ac7d98a6699p+0, 0x1.994c2f37cb53ap-54 },
+    { 0x1.8ace5422aa0dbp+0, 0x1.6e9f156864b27p-54 }, { 0x1.8cf3216b5448cp+0, -0x1.0d55e32e9e3aap-56 },
+    { 0x1.8f1ae99157736p+0, 0x1.5cc13a2e3976cp-55 }, { 0x1.9145b0b91ffc6p+0, -0x1.dd6792e582524p-54 },
+    { 0x1.93737b0cdc5e5p+0, -0x1.75fc781b57ebcp-57 }, { 0x1.95a44cbc8520fp+0, -0x1.64b7c96a5f039p-56 },
+    { 0x1.97d829fde4e50p+0, -0x1.d185b7c1b85d1p-54 }, { 0x1.9a0f170ca07bap+0, -0x1.173bd91cee632p-54 },
+    { 0x1.9c49182a3f090p+0, 0x1.c7c46b071f2bep-56 }, { 0x1.9e86319e32323p+0, 0x1.824ca78e64c6ep-56 },
+    { 0x1.a0c667b5de565p+0, -0x1.359495d1cd533p-54 }, { 0x1.a309bec4a2d33p+0, 0x1.6305c7ddc36abp-54 },
+    { 0x1.a5503b23e255dp+0, -0x1.d2f6edb8d41e1p-54 }, { 0x1.a799e1330b358p+0, 0x1.bcb7ecac563c7p-54 },
+    { 0x1.a9e6b5579fdbfp+0, 0x1.0fac90ef7fd31p-54 }, { 0x1.ac36bbfd3f37ap+0, -0x1.f9234cae76cd0p-55 },
+    { 0x1.ae89f995ad3adp+0, 0x1.7a1cd345dcc81p-54 }, { 0x1.b0e07298db666p+0, -0x1.bdef54c80e425p-54 },
+    { 0x1.b33a2b84f15fbp+0, -0x1.2805e3084d708p-57 }, { 0x1.b59728de5593ap+0, -0x1.c71dfbbba6de3p-54 },
+    { 0x1.b7f76f2fb5e47p+0, -0x1.5584f7e54ac3bp-56 }, { 0x1.ba5b030a1064ap+0, -0x1.efcd30e54292ep-54 },
+    { 0x1.bcc1e904bc1d2p+0, 0x1.23dd07a2d9e84p-55 }, { 0x1.bf2c25bd71e09p+0, -0x1.efdca3f6b9c73p-54 },
+    { 0x1.c199bdd85529cp+0, 0x1.11065895048ddp-55 }, { 0x1.c40ab5fffd07ap+0, 0x1.b4537e083c60ap-54 },
+    { 0x1.c67f12e57d14bp+0, 0x1.2884dff483cadp-54 }, { 0x1.c8f6d9406e7b5p+0, 0x1.1acbc48805c44p-56 },
+    { 0x1.cb720dcef9069p+0, 0x1.503cbd1e949dbp-56 }, { 0x1.cdf0b555dc3fap+0, -0x1.dd83b53829d72p-55 },
+    { 0x1.d072d4a07897cp+0, -0x1.cbc3743797a9cp-54 }, { 0x1.d2f87080d89f2p+0, -0x1.d487b719d8578p-54 },
+    { 0x1.d5818dcfba487p+0, 0x1.2ed02d75b3707p-55 }, { 0x1.d80e316c98398p+0, -0x1.11ec18beddfe8p-54 },
+    { 0x1.da9e603db3285p+0, 0x1.c2300696db532p-54 }, { 0x1.dd321f301b460p+0, 0x1.2da5778f018c3p-54 },
+    { 0x1.dfc97337b9b5fp+0, -0x1.1a5cd4f184b5cp-54 }, { 0x1.e264614f5a129p+0, -0x1.7b627817a1496p-54 },
+    { 0x1.e502ee78b3ff6p+0, 0x1.39e8980a9cc8fp-55 }, { 0x1.e7a51fbc74c83p+0, 0x1.2d522ca0c8de2p-54 },
+    { 0x1.ea4afa2a490dap+0, -0x1.e9c23179c2893p-54 }, { 0x1.ecf482d8e67f1p+0, -0x1.c93f3b411ad8cp-54 },
+    { 0x1.efa1bee615a27p+0, 0x1.dc7f486a4b6b0p-54 }, { 0x1.f252b376bba97p+0, 0x1.3a1a5bf0d8e43p-54 },
+    { 0x1.f50765b6e4540p+0, 0x1.9d3e12dd8a18bp-54 }, { 0x1.f7bfdad9cbe14p+0, -0x1.dbb12d006350ap-54 },
+    { 0x1.fa7c1819e90d8p+0, 0x1.74853f3a5931ep-55 }, { 0x1.fd3c22b8f71f1p+0, 0x1.2eb74966579e7p-57 }
+};
+
+// e^(x + x_lo) for x in (exp_underflow<T>, exp_overflow<T>), |x_lo| <= ulp(x), with the polynomial degree for T
+template <typename T>
+constexpr double exp_fast_core(double x, double x_lo = 0) noexcept
+{
+    constexpr double inv_ln2_128 = 0x1.71547652b82fep+7;
+    constexpr double ln2_128 = ln2_32 / 128;
+    constexpr double ln2_128_lo = ln2_32_lo / 128;
+
+    // x = (128 k + j) ln2 / 128 + r + c, |r| <= ln2 / 256
+    const double n = nearest(x * inv_ln2_128);
+    const double a = x - n * ln2_128;
+    const double b = n * ln2_128_lo;
+    const double r = a - b;
+    const double c = ((a - r) - b) + x_lo;
+    const int ni = static_cast<int>(n);
+    const int j = ni & 127;
+    const int k = (ni - j) / 128;
+    const exp_entry& entry = exp_table[j];
+
+    double value {};
+    if constexpr(std::is_same<T, float>::value) {
+        // e^r - 1 to 2^-38
+        const double q = r + r * r * (1. / 2 + r * (1. / 6));
+        value = entry.hi + entry.hi * q;
+    }
+    else {
+        // e^(r + c) - 1 = e^r - 1 + c (1 + r) to 2^-63
+        const double q = r + r * r * (1. / 2 + r * (1. / 6 + r * (1. / 24 + r * (1. / 120)))) + (c + c * r);
+        value = entry.hi + (entry.lo + entry.hi * q);
+    }
+    if(cgs_unlikely(k < -1021 || k > 1023)) {
+        // the result or 2^k is subnormal or the result is near overflow, scale in two steps
+        return scale(value, k);
+    }
+    return value * pow2<double>(k);
+}
+
+// the result of T exp(x), exp2(x) or pow for an argument that over- or underflows
+template <typename T>
+constexpr T exp_saturate(double x) noexcept
+{
+    if(x != x) {
+        return static_cast<T>(x);
+    }
+    return x > 0 ? infinity<T> : T{};
+}
+
+template <typename T>
+constexpr T exp_fast(T x) noexcept
+{
+    if(cgs_unlikely(!(x > exp_underflow<T> && x < exp_overflow<T>))) {
+        return exp_saturate<T>(x);
+    }
+    if constexpr(std::is_same<T, float>::value) {
+        return narrow<float>(exp_fast_core<float>(x));
+    }
+    else {
+        // e^x at the top of the range is finite only until max + ulp / 2
+        if(cgs_unlikely(x > 0x1.62e42fefa39efp+9)) {
+            return infinity<double>;
+        }
+        return exp_fast_core<double>(x);
+    }
+}
+
+template <typename T>
+constexpr T exp2_fast(T x) noexcept
+{
+    constexpr double overflow = std::is_same<T, float>::value ? 128.0 : 1024.0;
+    constexpr double underflow = std::is_same<T, float>::value ? -151.0 : -1076.0;
+    if(cgs_unlikely(!(x > underflow && x < overflow))) {
+        return exp_saturate<T>(x);
+    }
+    // 2^x = e^(x ln2)
+    if constexpr(std::is_same<T, float>::value) {
+        return narrow<float>(exp_fast_core<float>(x * ln2_hi));
+    }
+    else {
+        const double_double t = two_prod(x, ln2_hi);
+        return exp_fast_core<double>(t.hi, t.lo + x * ln2_mid);
+    }
+}
+
+struct log_entry
+{
+    double invc;
+    double logc_hi;
+    double logc_lo;
+};
+
+// for c = i / 128, i in [91, 181]: 1 / c rounded, and -ln of that in double-double
+constexpr log_entry log_table[91] {
+    { 0x1.6816816816817p+0, -0x1.5d5bddf595f31p-2, -0x1.d5f75b9a23ae4p-59 },
+    { 0x1.642c8590b2164p+0, -0x1.522ae0738a3d7p-2, -0x1.3840b263acb43p-56 },
+    { 0x1.6058160581606p+0, -0x1.4718dc271c41cp-2, -0x1.d8fb4c14c56eep-56 },
+    { 0x1.5c9882b931057p+0, -0x1.3c25277333183p-2, -0x1.152d81af5713ap-56 },
+    { 0x1.58ed2308158edp+0, -0x1.314f1e1d35ce3p-2, -0x1.22966f61a3c23p-56 },
+    { 0x1.5555555555555p+0, -0x1.269621134db91p-2, -0x1.e0efadd9db02ap-56 },
+    { 0x1.51d07eae2f815p+0, -0x1.1bf99635a6b95p-2, 0x1.e9575c2124912p-56 },
+    { 0x1.4e5e0a72f0539p+0, -0x1.1178e8227e47ap-2, -0x1.b8ce2d07f1cb7p-56 },
+    { 0x1.4afd6a052bf5bp+0, -0x1.07138604d5864p-2, 0x1.24e912b16ec8bp-60 },
+    { 0x1.47ae147ae147bp+0, -0x1.f991c6cb3b37ap-3, -0x1.ecca0cdf30143p-58 },
+    { 0x1.446f86562d9fbp+0, -0x1.e530effe71013p-3, 0x1.f7627ef82f3f0p-57 },
+    { 0x1.4141414141414p+0, -0x1.d1037f2655e7bp-3, 0x1.3f3adb7b71cbcp-58 },
+    { 0x1.3e22cbce4a902p+0, -0x1.bd087383bd8aap-3, 0x1.1165504ad749ep-59 },
+    { 0x1.3b13b13b13b14p+0, -0x1.a93ed3c8ad9e5p-3, -0x1.bcafa9de97202p-57 },
+    { 0x1.3813813813814p+0, -0x1.95a5adcf70182p-3, -0x1.8a16283fdbd1cp-57 },
+    { 0x1.3521cfb2b78c1p+0, -0x1.823c16551a3c0p-3, -0x1.6dcd318f4187ep-57 },
+    { 0x1.323e34a2b10bfp+0, -0x1.6f0128b756ab9p-3, 0x1.37967087859b9p-59 },
+    { 0x1.2f684bda12f68p+0, -0x1.5bf406b543db0p-3, 0x1.1f5b44c0df7f7p-61 },
+    { 0x1.2c9fb4d812ca0p+0, -0x1.4913d8333b563p-3, 0x1.0d5604930f137p-58 },
+    { 0x1.29e4129e4129ep+0, -0x1.365fcb0159014p-3, -0x1.bea08d2dca256p-57 },
+    { 0x1.27350b8812735p+0, -0x1.23d712a49c201p-3, -0x1.51c7e9efae297p-57 },
+    { 0x1.2492492492492p+0, -0x1.1178e8227e47ap-3, 0x1.0e63a5f01c693p-58 },
+    { 0x1.21fb78121fb78p+0, -0x1.fe89139dbd565p-4, 0x1.ac9f4215f9394p-58 },
+    { 0x1.1f7047dc11f70p+0, -0x1.da7276384469ep-4, -0x1.401fa71733017p-58 },
+    { 0x1.1cf06ada2811dp+0, -0x1.b6ac88dad5b1dp-4, 0x1.002bf768e52d0p-58 },
+    { 0x1.1a7b9611a7b96p+0, -0x1.9335e5d594988p-4, 0x1.478a85704ccb7p-58 },
+    { 0x1.1811811811812p+0, -0x1.700d30aeac0e8p-4, -0x1.a36a677b4c8b2p-59 },
+    { 0x1.15b1e5f75270dp+0, -0x1.4d3115d207eacp-4, -0x1.da7d0b1e10b2fp-60 },
+    { 0x1.135c81135c811p+0, -0x1.2aa04a44717a1p-4, -0x1.aea2c72d05c08p-58 },
+    { 0x1.1111111111111p+0, -0x1.08598b59e3a06p-4, 0x1.dd7009902bf32p-58 },
+    { 0x1.0ecf56be69c90p+0, -0x1.ccb73cdddb2d0p-5, 0x1.e48fb0500efd5p-59 },
+    { 0x1.0c9714fbcda3bp+0, -0x1.894aa149fb34bp-5, 0x1.2ba0b44cfaee5p-59 },
+    { 0x1.0a6810a6810a7p+0, -0x1.466aed42de3f9p-5, 0x1.9badefe942718p-60 },
+    { 0x1.0842108421084p+0, -0x1.0415d89e74440p-5, -0x1.c05cf1d753621p-59 },
+    { 0x1.0624dd2f1a9fcp+0, -0x1.8492528c8cac5p-6, 0x1.d192d0619fa68p-60 },
+    { 0x1.0410410410410p+0, -0x1.0205658935837p-6, -0x1.27c8e8416e717p-60 },
+    { 0x1.0204081020408p+0, -0x1.010157588de69p-7, -0x1.46662d417cecep-62 },
+    { 0x1.0000000000000p+0, 0, 0 },
+    { 0x1.fc07f01fc07f0p-1, 0x1.fe02a6b106799p-8, -0x1.e44b7e3711e7fp-67 },
+    { 0x1.f81f81f81f820p-1, 0x1.fc0a8b0fc03c4p-7, -0x1.83092c5964281p-62 },
+    { 0x1.f44659e4a4271p-1, 0x1.7b91b07d5b126p-6, -0x1.6d80ab38e9430p-62 },
+    { 0x1.f07c1f07c1f08p-1, 0x1.f829b0e7832f8p-6, 0x1.33e3f04f1ef25p-60 },
+    { 0x1.ecc07b301ecc0p-1, 0x1.39e87b9febd68p-5, -0x1.5bfa937f551b7p-59 },
+    { 0x1.e9131abf0b767p-1, 0x1.77458f632dcffp-5, 0x1.8d3ca87b92968p-63 },
+    { 0x1.e573ac901e574p-1, 0x1.b42dd711971b9p-5, 0x1.0a34531f67db5p-59 },
+    { 0x1.e1e1e1e1e1e1ep-1, 0x1.f0a30c01162a8p-5, 0x1.85f325c5bbacdp-59 },
+    { 0x1.de5d6e3f8868ap-1, 0x1.16536eea37ae3p-4, 0x1.2189705cf74cap-58 },
+    { 0x1.dae6076b981dbp-1, 0x1.341d7961bd1d0p-4, -0x1.3599f227becbbp-58 },
+    { 0x1.d77b654b82c34p-1, 0x1.51b073f06183cp-4, -0x1.5b61c65e5741ap-58 },
+    { 0x1.d41d41d41d41dp-1, 0x1.6f0d28ae56b4ep-4, -0x1.20db323097324p-59 },
+    { 0x1.d0cb58f6ec074p-1, 0x1.8c345d6319b23p-4, -0x1.294d2f5668495p-58 },
+    { 0x1.cd85689039b0bp-1, 0x1.a926d3a4ad562p-4, -0x1.d7a16eab1e2adp-59 },
+    { 0x1.ca4b3055ee191p-1, 0x1.c5e548f5bc743p-4, 0x1.2eb0bf7c0b0d9p-59 },
+    { 0x1.c71c71c71c71cp-1, 0x1.e27076e2af2eap-4, -0x1.61578001e015ap-60 },
+    { 0x1.c3f8f01c3f8f0p-1, 0x1.fec9131dbeabcp-4, -0x1.5746b9981b36cp-58 },
+    { 0x1.c0e070381c0e0p-1, 0x1.0d77e7cd08e5bp-3, 0x1.9a5dc5e9030adp-57 },
+    { 0x1.bdd2b899406f7p-1, 0x1.1b72ad52f67a2p-3, -0x1.fbe7ee5c69946p-57 },
+    { 0x1.bacf914c1bad0p-1, 0x1.29552f81ff521p-3, 0x1.301771c407dc0p-57 },
+    { 0x1.b7d6c3dda338bp-1, 0x1.371fc201e8f75p-3, 0x1.e6cb62af18a02p-62 },
+    { 0x1.b4e81b4e81b4fp-1, 0x1.44d2b6ccb7d1cp-3, 0x1.7d3d950f87e23p-59 },
+    { 0x1.b2036406c80d9p-1, 0x1.526e5e3a1b438p-3, -0x1.546ff8a470d3ap-57 },
+    { 0x1.af286bca1af28p-1, 0x1.5ff3070a793d6p-3, -0x1.bc60efafc6f6cp-58 },
+    { 0x1.ac5701ac5701bp-1, 0x1.6d60fe719d21bp-3, 0x1.d551d97132e87p-57 },
+    { 0x1.a98ef606a63bep-1, 0x1.7ab890210d907p-3, -0x1.1072534a57e7dp-57 },
+    { 0x1.a6d01a6d01a6dp-1, 0x1.87fa06520c911p-3, -0x1.9f7fdbfa08d9ap-57 },
+    { 0x1.a41a41a41a41ap-1, 0x1.9525a9cf456b6p-3, -0x1.26fb3e2b1d1dap-57 },
+    { 0x1.a16d3f97a4b02p-1, 0x1.a23bc1fe2b561p-3, 0x1.24dc46c1ea664p-57 },
+    { 0x1.9ec8e951033d9p-1, 0x1.af3c94e80bff3p-3, 0x1.a3398064df33ep-57 },
+    { 0x1.9c2d14ee4a102p-1, 0x1.bc286742d8cd4p-3, 0x1.cfce744870f57p-58 },
+    { 0x1.999999999999ap-1, 0x1.c8ff7c79a9a20p-3, -0x1.4f689f8434011p-57 },
+    { 0x1.970e4f80cb872p-1, 0x1.d5c216b4fbb94p-3, -0x1.a37794d03657dp-58 },
+    { 0x1.948b0fcd6e9e0p-1, 0x1.e27076e2af2e8p-3, -0x1.61578001e015ep-59 },
+    { 0x1.920fb49d0e229p-1, 0x1.ef0adcbdc5935p-3, 0x1.e8637950dc20dp-57 },
+    { 0x1.8f9c18f9c18fap-1, 0x1.fb9186d5e3e29p-3, 0x1.355519b0de535p-57 },
+    { 0x1.8d3018d3018d3p-1, 0x1.0402594b4d041p-2, -0x1.08ec217a5022dp-57 },
+    { 0x1.8acb90f6bf3aap-1, 0x1.0a324e27390e2p-2, 0x1.bdcfde8061c03p-56 },
+    { 0x1.886e5f0abb04ap-1, 0x1.1058bf9ae4ad4p-2, 0x1.3f415699663ecp-63 },
+    { 0x1.8618618618618p-1, 0x1.1675cababa60fp-2, 0x1.ce63eab883727p-61 },
+    { 0x1.83c977ab2beddp-1, 0x1.1c898c16999fbp-2, 0x1.9f1a39d500e3cp-56 },
+    { 0x1.8181818181818p-1, 0x1.22941fbcf7966p-2, -0x1.dbd7ac258a2bdp-58 },
+    { 0x1.7f405fd017f40p-1, 0x1.2895a13de86a4p-2, 0x1.7ad24c13f040fp-56 },
+    { 0x1.7d05f417d05f4p-1, 0x1.2e8e2bae11d31p-2, -0x1.1e99b72bd7bf2p-57 },
+    { 0x1.7ad2208e0ecc3p-1, 0x1.347dd9a987d56p-2, -0x1.16ea62c048cfbp-56 },
+    { 0x1.78a4c8178a4c8p-1, 0x1.3a64c556945eap-2, 0x1.cbcd735d03424p-60 },
+    { 0x1.767dce434a9b1p-1, 0x1.404308686a7e4p-2, -0x1.f79f6c1059cdbp-57 },
+    { 0x1.745d1745d1746p-1, 0x1.4618bc21c5ec2p-2, -0x1.7a42642661c62p-61 },
+    { 0x1.724287f46debcp-1, 0x1.4be5f957778a1p-2, -0x1.4b366b609027ap-58 },
+    { 0x1.702e05c0b8170p-1, 0x1.51aad872df82ep-2, -0x1.d8db0a7cc1543p-56 },
+    { 0x1.6e1f76b4337c7p-1, 0x1.5767717455a6cp-2, -0x1.fb2a49af933e8p-57 },
+    { 0x1.6c16c16c16c17p-1, 0x1.5d1bdbf5809cap-2, -0x1.7dc9c7c23801fp-56 },
+    { 0x1.6a13cd1537290p-1, 0x1.62c82f2b9c796p-2, -0x1.090a0dd59fe35p-58 }
+};
+
+// ln(x) = e ln2 + hi + lo
+struct log_fast_parts
+{
+    double e;
+    double hi;
+    double lo;
+};
+
+// x = 2^e m, m in [sqrt(1/2), sqrt(2)), and ln(m) = ln(m invc) - ln(invc) for the invc closest to 1 / m,
+// m invc - 1 is small enough for a short polynomial
+template <typename T>
+constexpr log_fast_parts log_fast_reduce(double x) noexcept
+{
+    auto [m, e] = decompose(x);
+    if(m > 0x1.6a09e667f3bcdp+0) {
+        m /= 2;
+        ++e;
+    }
+    const log_entry& entry = log_table[static_cast<int>(nearest(m * 128)) - 91];
+    if constexpr(std::is_same<T, float>::value) {
+        // ln(1 + r) to 2^-34
+        const double r = m * entry.invc - 1;
+        const double q = r * r * (-1. / 2 + r * (1. / 3 + r * (-1. / 4)));
+        return { static_cast<double>(e), entry.logc_hi + (r + q), 0 };
+    }
+    else {
+        // m invc - 1 exactly as r + r_lo, |r| < 2^-7.5, and ln(1 + r + r_lo) = r + q + r_lo / (1 + r) to 2^-68,
+        // precise enough for pow to multiply by up to 2^10
+        const double_double product = two_prod(m, entry.invc);
+        const double r = product.hi - 1;
+        const double q = r * r * (-1. / 2 + r * (1. / 3 + r * (-1. / 4 + r * (1. / 5 + r * (-1. / 6 + r * (1. / 7 + r * (-1. / 8)))))));
+        const double_double sum = two_sum(entry.logc_hi, r);
+        return { static_cast<double>(e), sum.hi, sum.lo + (entry.logc_lo + (product.lo - product.lo * r + q)) };
+    }
+}
+
+template <typename T>
+constexpr T log_fast(T x) noexcept
+{
+    T result {};
+    if(cgs_unlikely(log_special(x, result))) {
+        return result;
+    }
+    const auto [e, hi, lo] = log_fast_reduce<T>(x);
+    if constexpr(std::is_same<T, float>::value) {
+        return static_cast<float>(e * 0x1.62e42fefa39efp-1 + hi);
+    }
+    else {
+        const double_double sum = two_sum(e * ln2_32, hi);
+        return sum.hi + (sum.lo + (lo + e * ln2_32_lo));
+    }
+}
+
+template <typename T>
+constexpr T log2_fast(T x) noexcept
+{
+    T result {};
+    if(cgs_unlikely(log_special(x, result))) {
+        return result;
+    }
+    const auto [e, hi, lo] = log_fast_reduce<T>(x);
+    if constexpr(std::is_same<T, float>::value) {
+        return static_cast<float>(e + hi * 0x1.71547652b82fep+0);
+    }
+    else {
+        const double_double value = quick_two_sum(hi, lo) * inv_ln2_dd;
+        const double_double sum = two_sum(e, value.hi);
+        return sum.hi + (sum.lo + value.lo);
+    }
+}
+
+// pi/2 in 33, 33, 33 and 53 bits, so k times each of the first three is exact for |k| < 2^20
+constexpr double pio2_33_1 = 0x1.921fb544p+0;
+constexpr double pio2_33_2 = 0x1.0b4611a6p-34;
+constexpr double pio2_33_3 = 0x1.3198a2ep-69;
+constexpr double pio2_33_4 = 0x1.b839a252049c1p-104;
+
+// the fast tier reduces |x| < 1.6e6 by Cody and Waite, larger x falls back to the accurate tier
+constexpr double sin_fast_limit = 1.6e6;
+
+// sin(x + Shift pi/2) for |x| < sin_fast_limit
+template <int Shift, typename T>
+constexpr T sin_fast_core(T x) noexcept
+{
+    constexpr double two_over_pi = 0x1.45f306dc9c883p-1;
+    const double k = nearest(x * two_over_pi);
+    const int q = (static_cast<int>(k) + Shift) & 3;
+
+    if constexpr(std::is_same<T, float>::value) {
+        const double r = (x - k * pio2_33_1) - k * (pio2_33_2 + pio2_33_3);
+        const double z = r * r;
+        double value {};
+        if(q % 2 == 0) {
+            value = r + r * z * (-1. / 6 + z * (1. / 120 + z * (-1. / 5040 + z * (1. / 362880 + z * (-1. / 39916800)))));
+        }
+        else {
+            value = 1 - z / 2 + z * z * (1. / 24 + z * (-1. / 720 + z * (1. / 40320 + z * (-1. / 3628800
+                + z * (1. / 479001600)))));
+        }
+        return static_cast<float>(q >= 2 ? -value : value);
+    }
+    else {
+        // r = hi + lo
+        const double a = x - k * pio2_33_1;
+        double_double r = two_sum(a, -k * pio2_33_2) + -k * pio2_33_3;
+        r = quick_two_sum(r.hi, r.lo - k * pio2_33_4);
+        const double hi = r.hi;
+        const double lo = r.lo;
+        const double z = hi * hi;
+        double value {};
+        if(q % 2 == 0) {
+            // from fdlibm's k_sin.c, sin(hi + lo) = sin(hi) + lo cos(hi)
+            const double v = z * hi;
+            const double S = 1. / 120 + z * (-1. / 5040 + z * (1. / 362880 + z * (-1. / 39916800
+                + z * (1. / 6227020800 + z * (-1. / 1307674368000 + z * (1. / 355687428096000))))));
+            value = hi - (((z * (lo / 2 - v * S) - lo) + v / 6));
+        }
+        else {
+            // from fdlibm's k_cos.c, cos(hi + lo) = cos(hi) - lo sin(hi)
+            const double C = 1. / 24 + z * (-1. / 720 + z * (1. / 40320 + z * (-1. / 3628800 + z * (1. / 479001600
+                + z * (-1. / 87178291200 + z * (1. / 20922789888000))))));
+            const double hz = z / 2;
+            const double w = 1 - hz;
+            value = w + (((1 - w) - hz) + (z * z * C - hi * lo));
+        }
+        return q >= 2 ? -value : value;
+    }
+}
+
+template <int Shift, typename T>
+constexpr T sin_fast(T x) noexcept
+{
+    if(cgs_unlikely(!(fabs(x) < sin_fast_limit))) {
+        if(is_constant_evaluated()) {
+            return sin_accurate<Shift>(x);
+        }
+        return Shift == 0 ? std::sin(x) : std::cos(x);
+    }
+    if(Shift == 0 && x == 0) {
+        // keep the sign of zero
+        return x;
+    }
+    return sin_fast_core<Shift>(x);
+}
+
+// atan(j/4) in double-double
+constexpr double atan_quarters_hi[] {
+    0, 0.24497866312686414, 0.4636476090008061, 0.6435011087932844, 0.7853981633974483,
+};
+constexpr double atan_quarters_lo[] {
+    0, 1.0698755618734451e-17, 2.2698777452961687e-17, 1.5834785051444286e-17, 3.061616997868383e-17,
+};
+
+template <typename T>
+constexpr T atan2_fast(T y, T x) noexcept
+{
+    T result {};
+    if(cgs_unlikely(atan2_special(y, x, result))) {
+        return result;
+    }
+    double ay = fabs(y);
+    double ax = fabs(x);
+    const bool swap = ay > ax;
+    double numerator = swap ? ax : ay;
+    double denominator = swap ? ay : ax;
+    if constexpr(std::is_same<T, double>::value) {
+        if(cgs_unlikely(denominator > 0x1p995)) {
+            // keep two_prod from overflowing
+            numerator *= 0x1p-100;
+            denominator *= 0x1p-100;
+        }
+    }
+
+    // atan(t) = atan(j/4) + atan(u), |u| <= 1/8
+    const double t = numerator / denominator;
+    const double j = nearest(4 * t);
+    const int index = static_cast<int>(j);
+    const double c = j / 4;
+    const double u = (t - c) / (1 + t * c);
+    const double u2 = u * u;
+
+    if constexpr(std::is_same<T, float>::value) {
+        double angle = atan_quarters_hi[index]
+            + (u + u * u2 * (-1. / 3 + u2 * (1. / 5 + u2 * (-1. / 7 + u2 * (1. / 9 + u2 * (-1. / 11))))));
+        if(swap) {
+            angle = pio2_hi - angle;
+        }
+        if(signbit(x)) {
+            angle = 2 * pio2_hi - angle;
+        }
+        return static_cast<float>(signbit(y) ? -angle : angle);
+    }
+    else {
+        // t's rounding error, atan'(t) = 1 / (1 + t^2)
+        const double_double product = two_prod(t, denominator);
+        const double t_error = ((numerator - product.hi) - product.lo) / denominator;
+        const double series = u * u2 * (-1. / 3 + u2 * (1. / 5 + u2 * (-1. / 7 + u2 * (1. / 9 + u2 * (-1. / 11
+            + u2 * (1. / 13 + u2 * (-1. / 15 + u2 * (1. / 17 + u2 * (-1. / 19)))))))));
+        double_double angle = two_sum(atan_quarters_hi[index], u);
+        angle.lo += atan_quarters_lo[index] + series + t_error / (1 + t * t);
+        if(swap) {
+            const double lo = angle.lo;
+            angle = two_sum(pio2_hi, -angle.hi);
+            angle.lo += pio2_mid - lo;
+        }
+        if(signbit(x)) {
+            const double lo = angle.lo;
+            angle = two_sum(2 * pio2_hi, -angle.hi);
+            angle.lo += 2 * pio2_mid - lo;
+        }
+        const double value = angle.hi + angle.lo;
+        return signbit(y) ? -value : value;
+    }
+}
+
+template <typename T>
+constexpr T pow_fast(T x, T y) noexcept
+{
+    T result {};
+    bool negate = false;
+    if(cgs_unlikely(pow_special(x, y, result, negate))) {
+        return result;
+    }
+    if constexpr(std::is_same<T, float>::value) {
+        const auto [e, hi, lo] = log_fast_reduce<float>(x);
+        const double t = y * (e * 0x1.62e42fefa39efp-1 + hi);
+        if(cgs_unlikely(!(t > exp_underflow<float> && t < exp_overflow<float>))) {
+            return negate_if(exp_saturate<float>(t), negate);
+        }
+        return negate_if(narrow<float>(exp_fast_core<float>(t)), negate);
+    }
+    else {
+        // e^(y ln(x)) with ln(x) in double-double
+        const auto [e, hi, lo] = log_fast_reduce<double>(x);
+        const double_double L = two_sum(e * ln2_32, hi) + (lo + e * ln2_32_lo);
+        const double_double t = L * y;
+        if(cgs_unlikely(!(t.hi > exp_underflow<double> && t.hi < exp_overflow<double>))) {
+            return negate_if(exp_saturate<double>(t.hi), negate);
+        }
+        if(cgs_unlikely(t.hi > 0x1.62e42fefa39efp+9)) {
+            return negate_if(infinity<double>, negate);
+        }
+        return negate_if(exp_fast_core<double>(t.hi, t.lo), negate);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief sqrt(x), constexpr.
+ *
+ * All tiers are correctly rounded, at runtime the hardware instruction.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T sqrt(T x) noexcept
+{
+    if(!is_constant_evaluated()) {
+        return std::sqrt(x);
+    }
+    // double rounding the correctly rounded double sqrt to float is exact
+    return static_cast<T>(detail::sqrt_accurate(x));
+}
+
+/**
+ * @brief e^x, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T exp(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is faster than the standard library at runtime only for double
+        if(std::is_same<T, float>::value && !is_constant_evaluated()) {
+            return std::exp(x);
+        }
+        return detail::exp_fast(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::exp(x);
+        }
+        return detail::exp_accurate(x);
+    }
+}
+
+/**
+ * @brief 2^x, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T exp2(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is faster than the standard library at runtime only for double
+        if(std::is_same<T, float>::value && !is_constant_evaluated()) {
+            return std::exp2(x);
+        }
+        return detail::exp2_fast(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::exp2(x);
+        }
+        return detail::exp2_accurate(x);
+    }
+}
+
+/**
+ * @brief Natural logarithm, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T log(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is slower than the standard library at runtime
+        if(!is_constant_evaluated()) {
+            return std::log(x);
+        }
+        return detail::log_fast(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::log(x);
+        }
+        return detail::log_accurate(x);
+    }
+}
+
+/**
+ * @brief Base 2 logarithm, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T log2(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is slower than the standard library at runtime
+        if(!is_constant_evaluated()) {
+            return std::log2(x);
+        }
+        return detail::log2_fast(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::log2(x);
+        }
+        return detail::log2_accurate(x);
+    }
+}
+
+/**
+ * @brief sin(x) in radians, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T sin(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is faster than the standard library at runtime only for double
+        if(std::is_same<T, float>::value && !is_constant_evaluated()) {
+            return std::sin(x);
+        }
+        return detail::sin_fast<0>(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::sin(x);
+        }
+        return detail::sin_accurate<0>(x);
+    }
+}
+
+/**
+ * @brief cos(x) in radians, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T cos(T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is faster than the standard library at runtime only for double
+        if(std::is_same<T, float>::value && !is_constant_evaluated()) {
+            return std::cos(x);
+        }
+        return detail::sin_fast<1>(x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::cos(x);
+        }
+        return detail::sin_accurate<1>(x);
+    }
+}
+
+/**
+ * @brief The angle of (x, y) in radians, in [-pi, pi], constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T atan2(T y, T x) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is faster than the standard library at runtime only for float
+        if(std::is_same<T, double>::value && !is_constant_evaluated()) {
+            return std::atan2(y, x);
+        }
+        return detail::atan2_fast(y, x);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::atan2(y, x);
+        }
+        return detail::atan2_accurate(y, x);
+    }
+}
+
+/**
+ * @brief x^y, constexpr.
+ */
+template <accuracy Accuracy = accuracy::standard, typename T, typename = enable_if_t<detail::is_elementary_v<T>>>
+constexpr T pow(T x, T y) noexcept
+{
+    if constexpr(Accuracy == accuracy::fast) {
+        // the inline code is slower than the standard library at runtime
+        if(!is_constant_evaluated()) {
+            return std::pow(x, y);
+        }
+        return detail::pow_fast(x, y);
+    }
+    else {
+        if(Accuracy == accuracy::standard && !is_constant_evaluated()) {
+            return std::pow(x, y);
+        }
+        return detail::pow_accurate(x, y);
+    }
+}
+
+} // namespace cgs
+
+#endif // CGS_ELEMENTARY_HPP
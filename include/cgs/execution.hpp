@@ -0,0 +1,101 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_EXECUTION_HPP
+#define CGS_EXECUTION_HPP
+
+#include <cstddef> // size_t
+#include <type_traits>
+
+// Execution policies for the cgs algorithms, similar to standard <execution>.
+
+namespace cgs
+{
+
+class thread_pool;
+
+namespace execution
+{
+
+/**
+ * @brief One element at a time, in order. Same as calling the algorithm without a policy.
+ */
+struct sequenced_policy
+{ };
+
+inline constexpr sequenced_policy seq {};
+
+/**
+ * @brief Elements may be combined in any order, and several at once in SIMD lanes.
+ *
+ * Only use with associative and commutative operations.
+ * Reductions of floating point values may round differently than the sequential version.
+ */
+struct unsequenced_policy
+{ };
+
+inline constexpr unsequenced_policy unseq {};
+
+/**
+ * @brief Split random access ranges into chunks, and process the chunks on a thread_pool.
+ *
+ * Each chunk is processed in order.
+ * Reductions combine the chunks' partial results in order with binaryOp,
+ * so binaryOp must be associative.
+ */
+struct parallel_policy
+{
+    // null uses thread_pool::global()
+    thread_pool* pool = nullptr;
+
+    // ranges are not split into chunks smaller than this
+    std::size_t min_chunk = std::size_t{1} << 15;
+};
+
+inline constexpr parallel_policy par {};
+
+/**
+ * @brief parallel_policy, where each chunk is processed with unsequenced_policy.
+ */
+struct parallel_unsequenced_policy
+{
+    // null uses thread_pool::global()
+    thread_pool* pool = nullptr;
+
+    // ranges are not split into chunks smaller than this
+    std::size_t min_chunk = std::size_t{1} << 15;
+};
+
+inline constexpr parallel_unsequenced_policy par_unseq {};
+
+template <typename T>
+inline constexpr bool is_execution_policy_v = false;
+
+template <>
+inline constexpr bool is_execution_policy_v<sequenced_policy> = true;
+
+template <>
+inline constexpr bool is_execution_policy_v<unsequenced_policy> = true;
+
+template <>
+inline constexpr bool is_execution_policy_v<parallel_policy> = true;
+
+template <>
+inline constexpr bool is_execution_policy_v<parallel_unsequenced_policy> = true;
+
+} // namespace execution
+} // namespace cgs
+
+#endif // CGS_EXECUTION_HPP
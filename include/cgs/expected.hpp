@@ -0,0 +1,670 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_EXPECTED_HPP
+#define CGS_EXPECTED_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/macro.hpp" // CGS_LINE
+#include "cgs/meta.hpp"
+
+#include <memory> // addressof
+#include <new> // placement new
+#include <type_traits>
+#include <utility> // forward, move, in_place
+
+/*
+`cgs::expected<T, E>` holds a T, or an E describing why there is no T, like C++23's std::expected.
+It reports errors without exceptions: using the wrong one is a cgs_assert, not a throw.
+
+If T and E are trivially copyable, so is expected, and it is a union and a bool,
+so it is returned in registers and reading the value is a load.
+
+`cgs_assert_return(expr)` in a function returning `expected<T, E>`, where E can be made from a `cgs::assert_error`,
+returns an error if expr is false, instead of aborting or throwing:
+
+    cgs::expected<int, cgs::assert_error> parse_digit(char c)
+    {
+        cgs_assert_return(c >= '0' && c <= '9');
+        return c - '0';
+    }
+*/
+
+namespace cgs
+{
+
+/**
+ * @brief An error, to make an expected that has no value.
+ */
+template <typename E>
+class unexpected
+{
+private:
+
+    E _error;
+
+public:
+
+    constexpr explicit unexpected(const E& error)
+        : _error(error)
+    { }
+
+    constexpr explicit unexpected(E&& error)
+        : _error(std::move(error))
+    { }
+
+    constexpr const E& error() const& noexcept
+    {
+        return _error;
+    }
+
+    constexpr E& error() & noexcept
+    {
+        return _error;
+    }
+
+    constexpr E&& error() && noexcept
+    {
+        return std::move(_error);
+    }
+};
+
+template <typename E>
+unexpected(E) -> unexpected<E>;
+
+/**
+ * @brief Tag to construct the error of an expected in place.
+ */
+struct unexpect_t
+{
+    explicit unexpect_t() = default;
+};
+
+inline constexpr unexpect_t unexpect {};
+
+/**
+ * @brief Error of a failed cgs_assert_return.
+ */
+struct assert_error
+{
+    // "Assertion failed (expression) at file:line"
+    const char* message;
+};
+
+namespace detail
+{
+
+// stands in for the value of expected<void, E>
+struct expected_void {};
+
+template <typename T>
+struct is_unexpected : std::false_type {};
+
+template <typename E>
+struct is_unexpected<unexpected<E>> : std::true_type {};
+
+template <typename T, typename E,
+    bool Trivial = std::is_trivially_copyable<T>::value && std::is_trivially_copyable<E>::value>
+class expected_storage
+{
+protected:
+
+    union
+    {
+        T _value;
+        E _error;
+    };
+    bool _hasValue;
+
+    template <typename... Args>
+    constexpr explicit expected_storage(std::in_place_t, Args&&... args)
+        : _value(std::forward<Args>(args)...)
+        , _hasValue(true)
+    { }
+
+    template <typename... Args>
+    constexpr explicit expected_storage(unexpect_t, Args&&... args)
+        : _error(std::forward<Args>(args)...)
+        , _hasValue(false)
+    { }
+};
+
+// copies, moves and destroys the active member
+template <typename T, typename E>
+class expected_storage<T, E, false>
+{
+protected:
+
+    union
+    {
+        T _value;
+        E _error;
+    };
+    bool _hasValue;
+
+    template <typename... Args>
+    constexpr explicit expected_storage(std::in_place_t, Args&&... args)
+        : _value(std::forward<Args>(args)...)
+        , _hasValue(true)
+    { }
+
+    template <typename... Args>
+    constexpr explicit expected_storage(unexpect_t, Args&&... args)
+        : _error(std::forward<Args>(args)...)
+        , _hasValue(false)
+    { }
+
+    expected_storage(const expected_storage& other)
+        : _hasValue(other._hasValue)
+    {
+        construct_from(other);
+    }
+
+    expected_storage(expected_storage&& other) noexcept(
+        std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_constructible<E>::value)
+        : _hasValue(other._hasValue)
+    {
+        construct_from(std::move(other));
+    }
+
+    expected_storage& operator=(const expected_storage& other)
+    {
+        assign_from(other);
+        return *this;
+    }
+
+    expected_storage& operator=(expected_storage&& other) noexcept(
+        std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value
+        && std::is_nothrow_move_constructible<E>::value && std::is_nothrow_move_assignable<E>::value)
+    {
+        assign_from(std::move(other));
+        return *this;
+    }
+
+    ~expected_storage()
+    {
+        destroy();
+    }
+
+private:
+
+    // construct the member _hasValue selects from other's, as const& or &&
+    template <typename Other>
+    void construct_from(Other&& other)
+    {
+        if(_hasValue) {
+            ::new(static_cast<void*>(std::addressof(_value))) T(std::forward<Other>(other)._value);
+        }
+        else {
+            ::new(static_cast<void*>(std::addressof(_error))) E(std::forward<Other>(other)._error);
+        }
+    }
+
+    // assign the same member, or switch members leaving *this unchanged if the copy or move throws
+    template <typename Other>
+    void assign_from(Other&& other)
+    {
+        if(_hasValue && other._hasValue) {
+            _value = std::forward<Other>(other)._value;
+        }
+        else if(!_hasValue && !other._hasValue) {
+            _error = std::forward<Other>(other)._error;
+        }
+        else if(other._hasValue) {
+            reinit(_value, _error, std::forward<Other>(other)._value);
+            _hasValue = true;
+        }
+        else {
+            reinit(_error, _value, std::forward<Other>(other)._error);
+            _hasValue = false;
+        }
+    }
+
+    // replace old with a New from arg, like std::expected
+    template <typename New, typename Old, typename Arg>
+    static void reinit(New& member, Old& old, Arg&& arg)
+    {
+        if constexpr(std::is_nothrow_constructible<New, Arg&&>::value) {
+            old.~Old();
+            ::new(static_cast<void*>(std::addressof(member))) New(std::forward<Arg>(arg));
+        }
+        else if constexpr(std::is_nothrow_move_constructible<New>::value) {
+            // may throw before old is touched
+            New temporary(std::forward<Arg>(arg));
+            old.~Old();
+            ::new(static_cast<void*>(std::addressof(member))) New(std::move(temporary));
+        }
+        else {
+            static_assert(std::is_nothrow_move_constructible<Old>::value,
+                "expected<T, E> assignment needs T or E to be nothrow move constructible");
+#ifdef CGS_DETAIL_EXCEPTIONS
+            Old saved(std::move(old));
+            old.~Old();
+            try {
+                ::new(static_cast<void*>(std::addressof(member))) New(std::forward<Arg>(arg));
+            }
+            catch(...) {
+                ::new(static_cast<void*>(std::addressof(old))) Old(std::move(saved));
+                throw;
+            }
+#else
+            // without exceptions the constructor can not fail
+            old.~Old();
+            ::new(static_cast<void*>(std::addressof(member))) New(std::forward<Arg>(arg));
+#endif
+        }
+    }
+
+    void destroy() noexcept
+    {
+        if(_hasValue) {
+            _value.~T();
+        }
+        else {
+            _error.~E();
+        }
+    }
+};
+
+// an empty base deleting the copy and move constructors expected cannot have
+template <bool Copy, bool Move>
+struct expected_construct_base {};
+
+template <>
+struct expected_construct_base<false, true>
+{
+    expected_construct_base() = default;
+    expected_construct_base(const expected_construct_base&) = delete;
+    expected_construct_base(expected_construct_base&&) = default;
+    expected_construct_base& operator=(const expected_construct_base&) = default;
+    expected_construct_base& operator=(expected_construct_base&&) = default;
+};
+
+template <>
+struct expected_construct_base<false, false>
+{
+    expected_construct_base() = default;
+    expected_construct_base(const expected_construct_base&) = delete;
+    expected_construct_base(expected_construct_base&&) = delete;
+    expected_construct_base& operator=(const expected_construct_base&) = default;
+    expected_construct_base& operator=(expected_construct_base&&) = default;
+};
+
+// an empty base deleting the copy and move assignments expected cannot have
+template <bool Copy, bool Move>
+struct expected_assign_base {};
+
+template <>
+struct expected_assign_base<false, true>
+{
+    expected_assign_base() = default;
+    expected_assign_base(const expected_assign_base&) = default;
+    expected_assign_base(expected_assign_base&&) = default;
+    expected_assign_base& operator=(const expected_assign_base&) = delete;
+    expected_assign_base& operator=(expected_assign_base&&) = default;
+};
+
+template <>
+struct expected_assign_base<false, false>
+{
+    expected_assign_base() = default;
+    expected_assign_base(const expected_assign_base&) = default;
+    expected_assign_base(expected_assign_base&&) = default;
+    expected_assign_base& operator=(const expected_assign_base&) = delete;
+    expected_assign_base& operator=(expected_assign_base&&) = delete;
+};
+
+// copyable if T and E are, and movable if T and E are, like std::expected
+template <typename T, typename E>
+using expected_construct = expected_construct_base<
+    std::is_copy_constructible<T>::value && std::is_copy_constructible<E>::value,
+    std::is_move_constructible<T>::value && std::is_move_constructible<E>::value>;
+
+// assignment also constructs when it switches members, which reinit makes safe
+// only if T or E is nothrow move constructible
+template <typename T, typename E>
+using expected_assign = expected_assign_base<
+    std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value
+        && std::is_copy_constructible<E>::value && std::is_copy_assignable<E>::value
+        && (std::is_nothrow_move_constructible<T>::value || std::is_nothrow_move_constructible<E>::value),
+    std::is_move_constructible<T>::value && std::is_move_assignable<T>::value
+        && std::is_move_constructible<E>::value && std::is_move_assignable<E>::value
+        && (std::is_nothrow_move_constructible<T>::value || std::is_nothrow_move_constructible<E>::value)>;
+
+} // namespace detail
+
+/**
+ * @brief A T, or an E explaining why there is none.
+ *
+ * Reading the one that is not there is a cgs_assert.
+ */
+template <typename T, typename E>
+class expected : private detail::expected_storage<T, E>
+    , private detail::expected_construct<T, E>
+    , private detail::expected_assign<T, E>
+{
+private:
+
+    using storage = detail::expected_storage<T, E>;
+
+    template <typename U>
+    static constexpr bool is_value_v = std::is_constructible<T, U&&>::value
+        && !std::is_same<std::decay_t<U>, expected>::value
+        && !std::is_same<std::decay_t<U>, std::in_place_t>::value
+        && !std::is_same<std::decay_t<U>, unexpect_t>::value
+        && !detail::is_unexpected<std::decay_t<U>>::value;
+
+public:
+
+    using value_type = T;
+    using error_type = E;
+
+    /**
+     * @brief A value initialized T.
+     */
+    constexpr expected()
+        : storage(std::in_place)
+    { }
+
+    template <typename U = T, typename = enable_if_t<is_value_v<U>>>
+    constexpr /* implicit */ expected(U&& value)
+        : storage(std::in_place, std::forward<U>(value))
+    { }
+
+    template <typename G, typename = enable_if_t<std::is_constructible<E, const G&>::value>>
+    constexpr /* implicit */ expected(const unexpected<G>& error)
+        : storage(unexpect, error.error())
+    { }
+
+    template <typename G, typename = enable_if_t<std::is_constructible<E, G&&>::value>>
+    constexpr /* implicit */ expected(unexpected<G>&& error)
+        : storage(unexpect, std::move(error).error())
+    { }
+
+    template <typename... Args>
+    constexpr explicit expected(std::in_place_t, Args&&... args)
+        : storage(std::in_place, std::forward<Args>(args)...)
+    { }
+
+    template <typename... Args>
+    constexpr explicit expected(unexpect_t, Args&&... args)
+        : storage(unexpect, std::forward<Args>(args)...)
+    { }
+
+    constexpr bool has_value() const noexcept
+    {
+        return this->_hasValue;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return this->_hasValue;
+    }
+
+    /**
+     * @brief The value, there must be one.
+     */
+    constexpr const T& value() const&
+    {
+        cgs_assert(this->_hasValue);
+        return this->_value;
+    }
+
+    /**
+     * @brief The value, there must be one.
+     */
+    constexpr T& value() &
+    {
+        cgs_assert(this->_hasValue);
+        return this->_value;
+    }
+
+    /**
+     * @brief The value, there must be one.
+     */
+    constexpr T&& value() &&
+    {
+        cgs_assert(this->_hasValue);
+        return std::move(this->_value);
+    }
+
+    constexpr const T& operator*() const&
+    {
+        return value();
+    }
+
+    constexpr T& operator*() &
+    {
+        return value();
+    }
+
+    constexpr T&& operator*() &&
+    {
+        return std::move(*this).value();
+    }
+
+    constexpr const T* operator->() const
+    {
+        return std::addressof(value());
+    }
+
+    constexpr T* operator->()
+    {
+        return std::addressof(value());
+    }
+
+    /**
+     * @brief The error, there must be no value.
+     */
+    constexpr const E& error() const&
+    {
+        cgs_assert(!this->_hasValue);
+        return this->_error;
+    }
+
+    /**
+     * @brief The error, there must be no value.
+     */
+    constexpr E& error() &
+    {
+        cgs_assert(!this->_hasValue);
+        return this->_error;
+    }
+
+    /**
+     * @brief The error, there must be no value.
+     */
+    constexpr E&& error() &&
+    {
+        cgs_assert(!this->_hasValue);
+        return std::move(this->_error);
+    }
+
+    /**
+     * @brief The value, or fallback if there is none.
+     */
+    template <typename U>
+    constexpr T value_or(U&& fallback) const&
+    {
+        return this->_hasValue ? this->_value : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template <typename U>
+    constexpr T value_or(U&& fallback) &&
+    {
+        return this->_hasValue ? std::move(this->_value) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    /**
+     * @brief Equal if both have equal values, or both have equal errors.
+     */
+    friend constexpr bool operator==(const expected& lhs, const expected& rhs)
+    {
+        return lhs._hasValue == rhs._hasValue
+            && (lhs._hasValue ? lhs._value == rhs._value : lhs._error == rhs._error);
+    }
+
+    friend constexpr bool operator!=(const expected& lhs, const expected& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend constexpr bool operator==(const expected& lhs, const T& rhs)
+    {
+        return lhs._hasValue && lhs._value == rhs;
+    }
+
+    friend constexpr bool operator!=(const expected& lhs, const T& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <typename G>
+    friend constexpr bool operator==(const expected& lhs, const unexpected<G>& rhs)
+    {
+        return !lhs._hasValue && lhs._error == rhs.error();
+    }
+
+    template <typename G>
+    friend constexpr bool operator!=(const expected& lhs, const unexpected<G>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+/**
+ * @brief Success, or an E explaining the failure.
+ */
+template <typename E>
+class expected<void, E> : private detail::expected_storage<detail::expected_void, E>
+    , private detail::expected_construct<detail::expected_void, E>
+    , private detail::expected_assign<detail::expected_void, E>
+{
+private:
+
+    using storage = detail::expected_storage<detail::expected_void, E>;
+
+public:
+
+    using value_type = void;
+    using error_type = E;
+
+    /**
+     * @brief Success.
+     */
+    constexpr expected()
+        : storage(std::in_place)
+    { }
+
+    template <typename G, typename = enable_if_t<std::is_constructible<E, const G&>::value>>
+    constexpr /* implicit */ expected(const unexpected<G>& error)
+        : storage(unexpect, error.error())
+    { }
+
+    template <typename G, typename = enable_if_t<std::is_constructible<E, G&&>::value>>
+    constexpr /* implicit */ expected(unexpected<G>&& error)
+        : storage(unexpect, std::move(error).error())
+    { }
+
+    template <typename... Args>
+    constexpr explicit expected(unexpect_t, Args&&... args)
+        : storage(unexpect, std::forward<Args>(args)...)
+    { }
+
+    constexpr bool has_value() const noexcept
+    {
+        return this->_hasValue;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return this->_hasValue;
+    }
+
+    /**
+     * @brief Asserts there was no error.
+     */
+    constexpr void value() const
+    {
+        cgs_assert(this->_hasValue);
+    }
+
+    /**
+     * @brief The error, there must be one.
+     */
+    constexpr const E& error() const&
+    {
+        cgs_assert(!this->_hasValue);
+        return this->_error;
+    }
+
+    /**
+     * @brief The error, there must be one.
+     */
+    constexpr E& error() &
+    {
+        cgs_assert(!this->_hasValue);
+        return this->_error;
+    }
+
+    /**
+     * @brief The error, there must be one.
+     */
+    constexpr E&& error() &&
+    {
+        cgs_assert(!this->_hasValue);
+        return std::move(this->_error);
+    }
+
+    friend constexpr bool operator==(const expected& lhs, const expected& rhs)
+    {
+        return lhs._hasValue == rhs._hasValue && (lhs._hasValue || lhs._error == rhs._error);
+    }
+
+    friend constexpr bool operator!=(const expected& lhs, const expected& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <typename G>
+    friend constexpr bool operator==(const expected& lhs, const unexpected<G>& rhs)
+    {
+        return !lhs._hasValue && lhs._error == rhs.error();
+    }
+
+    template <typename G>
+    friend constexpr bool operator!=(const expected& lhs, const unexpected<G>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+} // namespace cgs
+
+/**
+ * cgs_assert_return(expression)
+ *
+ * @brief Return a cgs::assert_error from the enclosing function if expression is false.
+ *
+ * Always evaluated, whatever the CGS_VIOLATE_* mode, as it is error handling, not a debug check.
+ */
+#define cgs_assert_return(expression) do { \
+    if(cgs_unlikely(!cgs_detail_assert_evaluate(expression, #expression))) { \
+        return ::cgs::unexpected<::cgs::assert_error>(::cgs::assert_error{ \
+            "Assertion failed (" #expression ") at " __FILE__ ":" CGS_LINE }); \
+    } \
+} while(false)
+
+#endif // CGS_EXPECTED_HPP
@@ -0,0 +1,452 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_EYTZINGER_HPP
+#define CGS_EYTZINGER_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/optimize.hpp" // cache_line_size, prefetch
+
+#include <array>
+#include <cstddef> // size_t
+#include <functional> // less
+#include <limits>
+#include <new> // align_val_t
+#include <type_traits>
+#include <utility> // pair
+#include <vector>
+
+/*
+Read-only sorted sets and maps in Eytzinger (BFS) order: the root at index 1, the children of k at 2k and 2k + 1.
+
+    // built at compile time, N keys in read-only data
+    constexpr auto primes = cgs::make_eytzinger_set(std::array<int, 6>{ 2, 3, 5, 7, 11, 13 });
+    static_assert(primes.contains(7));
+
+    // built at runtime, from any sorted range
+    cgs::eytzinger_map<std::uint32_t, float> prices(sortedPairs.begin(), sortedPairs.end());
+    const float* price = prices.find(id);
+
+A search reads one key per level, at indices only its own comparisons choose, so it has no branches to mispredict.
+The top levels share a few cache lines, and the 2^L descendants L levels below a key are contiguous,
+so every step prefetches the line of the nodes L levels down, L such that 2^L keys fill a line.
+The batched searches interleave many queries level by level, so their misses overlap.
+
+Compared to std::lower_bound on a sorted array, for keys beyond the cache,
+a search has the misses of its next L levels in flight while std::lower_bound waits on one at a time,
+and batched searches overlap each other's misses too.
+In order iteration would jump around memory, so there is none.
+*/
+
+namespace cgs
+{
+
+/**
+ * @brief The size of a container whose size is set at runtime, like std::dynamic_extent.
+ */
+inline constexpr std::size_t dynamic_extent = std::numeric_limits<std::size_t>::max();
+
+namespace detail
+{
+
+// allocations aligned to a cache line
+template <typename T>
+struct cache_aligned_allocator
+{
+    using value_type = T;
+
+    cache_aligned_allocator() = default;
+
+    template <typename U>
+    constexpr cache_aligned_allocator(const cache_aligned_allocator<U>&) noexcept
+    { }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{cache_line_size}));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{cache_line_size});
+    }
+
+    template <typename U>
+    constexpr bool operator==(const cache_aligned_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    constexpr bool operator!=(const cache_aligned_allocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+// n elements and the unused index 0, aligned to a cache line
+template <typename T, std::size_t N>
+using eytzinger_storage = std::conditional_t<N == dynamic_extent,
+    std::vector<T, cache_aligned_allocator<T>>,
+    std::array<T, N + 1>>;
+
+template <typename T, std::size_t N>
+inline constexpr std::size_t eytzinger_alignment = N == dynamic_extent ? alignof(eytzinger_storage<T, N>) : cache_line_size;
+
+// levels between a node and the descendants prefetched for it, 2^L keys fill a cache line
+template <typename T>
+constexpr std::size_t eytzinger_prefetch_levels()
+{
+    std::size_t levels = 0;
+    while((std::size_t{2} << levels) * sizeof(T) <= cache_line_size) {
+        ++levels;
+    }
+    return levels;
+}
+
+// queries interleaved by the batched searches
+constexpr std::size_t eytzinger_batch = 16;
+
+// complete levels of a tree of n nodes, floor(log2(n + 1))
+constexpr std::size_t eytzinger_levels(std::size_t n) noexcept
+{
+    std::size_t levels = 0;
+    for(; (std::size_t{2} << levels) - 1 <= n; ++levels) { }
+    return levels;
+}
+
+// index of the next node in order after k, 0 after the last
+constexpr std::size_t eytzinger_next(std::size_t k, std::size_t n) noexcept
+{
+    if(2 * k + 1 <= n) {
+        for(k = 2 * k + 1; 2 * k <= n; k *= 2) { }
+        return k;
+    }
+    // up from right children, then up once more from a left child
+    for(; k & 1; k /= 2) { }
+    return k / 2;
+}
+
+// index of the first node in order
+constexpr std::size_t eytzinger_first(std::size_t n) noexcept
+{
+    std::size_t k = n == 0 ? 0 : 1;
+    for(; k != 0 && 2 * k <= n; k *= 2) { }
+    return k;
+}
+
+// A search ends past the tree at k, whose bits from the root are its turns, 1 for right.
+// The lower bound is where it last turned left: drop the trailing right turns and that left turn.
+// 0 when it never turned left
+constexpr std::size_t eytzinger_resolve(std::size_t k) noexcept
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+    for(; k & 1; k /= 2) { }
+    return k / 2;
+#endif
+}
+
+template <typename Key, std::size_t N, typename Compare>
+class eytzinger_tree
+{
+    static constexpr std::size_t prefetch_levels = eytzinger_prefetch_levels<Key>();
+
+    alignas(eytzinger_alignment<Key, N>) eytzinger_storage<Key, N> _keys;
+    std::size_t _size;
+    std::size_t _levels;
+    Compare _comp;
+
+protected:
+    template <typename It, typename Sentinal, typename F>
+    constexpr eytzinger_tree(std::size_t size, It first, Sentinal last, const Compare& comp, F&& keyOf)
+        : _keys {}
+        , _size { size }
+        , _levels { eytzinger_levels(size) }
+        , _comp { comp }
+    {
+        if constexpr(N == dynamic_extent) {
+            _keys.resize(size + 1);
+        }
+        else {
+            cgs_assert(size == N);
+        }
+        // in order, so the input is read once
+        std::size_t previous = 0;
+        for(std::size_t k = eytzinger_first(size); k != 0; k = eytzinger_next(k, size), ++first) {
+            cgs_assert(first != last);
+            _keys[k] = keyOf(*first);
+            cgs_assert_expensive(previous == 0 || !_comp(_keys[k], _keys[previous]));
+            previous = k;
+        }
+        cgs_assert(first == last);
+    }
+
+    constexpr const Key& key(std::size_t k) const
+    {
+        return _keys[k];
+    }
+
+    // eytzinger index of the first key not less than key, 0 if none
+    template <typename K>
+    constexpr std::size_t lower_bound_index(const K& key) const
+    {
+        const Key* keys = _keys.data();
+        std::size_t k = 1;
+        for(std::size_t level = 0; level < _levels; ++level) {
+            cgs::prefetch(keys + min_index(k << prefetch_levels));
+            k = 2 * k + static_cast<std::size_t>(_comp(keys[k], key));
+        }
+        // the last level, which may be partial. Past it, compare to the parent and discard the result
+        const bool inside = k <= _size;
+        const bool right = _comp(keys[inside ? k : k / 2], key);
+        k = inside ? 2 * k + right : k;
+        return eytzinger_resolve(k);
+    }
+
+    // whether the key at eytzinger index k is equivalent to key, k from lower_bound_index
+    template <typename K>
+    constexpr bool equivalent(std::size_t k, const K& key) const
+    {
+        return k != 0 && !_comp(key, _keys[k]);
+    }
+
+    // out = result(lower_bound_index(query)) for each query in [first, last),
+    // interleaving eytzinger_batch queries at a time
+    template <typename ForwardIt, typename Sentinal, typename OutputIt, typename F>
+    constexpr OutputIt lower_bound_indices(ForwardIt first, Sentinal last, OutputIt out, F&& result) const
+    {
+        const Key* keys = _keys.data();
+        while(first != last) {
+            std::array<ForwardIt, eytzinger_batch> queries {};
+            std::array<std::size_t, eytzinger_batch> k {};
+            std::size_t count = 0;
+            for(; count < eytzinger_batch && first != last; ++count, ++first) {
+                queries[count] = first;
+                k[count] = 1;
+            }
+            for(std::size_t level = 0; level < _levels; ++level) {
+                for(std::size_t q = 0; q < count; ++q) {
+                    k[q] = 2 * k[q] + static_cast<std::size_t>(_comp(keys[k[q]], *queries[q]));
+                    // needed after the other queries of this level
+                    cgs::prefetch(keys + min_index(k[q]));
+                }
+            }
+            for(std::size_t q = 0; q < count; ++q) {
+                const bool inside = k[q] <= _size;
+                const bool right = _comp(keys[inside ? k[q] : k[q] / 2], *queries[q]);
+                k[q] = inside ? 2 * k[q] + right : k[q];
+                *out = result(eytzinger_resolve(k[q]), *queries[q]);
+                ++out;
+            }
+        }
+        return out;
+    }
+
+private:
+    // index clamped to the storage, so prefetch addresses are in bounds
+    constexpr std::size_t min_index(std::size_t k) const noexcept
+    {
+        return k < _size ? k : _size;
+    }
+
+public:
+    /**
+     * @brief Number of keys.
+     */
+    constexpr std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+};
+
+template <typename It, typename Sentinal>
+constexpr std::size_t eytzinger_count(It first, Sentinal last)
+{
+    std::size_t count = 0;
+    for(; first != last; ++first) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace detail
+
+/**
+ * @brief Read-only sorted set in Eytzinger order, searched without branches, constexpr.
+ *
+ * N keys in an array, or dynamic_extent keys in a vector.
+ * Keys and Compare must be default constructible, and Compare may be transparent.
+ */
+template <typename Key, std::size_t N = dynamic_extent, typename Compare = std::less<>>
+class eytzinger_set : public detail::eytzinger_tree<Key, N, Compare>
+{
+    using base = detail::eytzinger_tree<Key, N, Compare>;
+
+public:
+    using key_type = Key;
+
+    /**
+     * @brief The keys of [first, last), sorted by comp, read once in order.
+     *
+     * With a fixed N, there must be N keys.
+     */
+    template <typename It, typename Sentinal>
+    constexpr eytzinger_set(It first, Sentinal last, const Compare& comp = {})
+        : base(N == dynamic_extent ? detail::eytzinger_count(first, last) : N, first, last, comp,
+            [](const auto& key) -> const auto& { return key; })
+    { }
+
+    /**
+     * @brief The first key not less than key, or null if there is none.
+     */
+    template <typename K>
+    constexpr const Key* lower_bound(const K& key) const
+    {
+        const std::size_t k = this->lower_bound_index(key);
+        return k ? &this->key(k) : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K& key) const
+    {
+        return this->equivalent(this->lower_bound_index(key), key);
+    }
+
+    /**
+     * @brief out = contains(key) for each key of [first, last), interleaving several searches.
+     */
+    template <typename ForwardIt, typename Sentinal, typename OutputIt>
+    constexpr OutputIt contains(ForwardIt first, Sentinal last, OutputIt out) const
+    {
+        return this->lower_bound_indices(first, last, out, [this](std::size_t k, const auto& key) {
+            return this->equivalent(k, key);
+        });
+    }
+
+    /**
+     * @brief out = lower_bound(key) for each key of [first, last), interleaving several searches.
+     */
+    template <typename ForwardIt, typename Sentinal, typename OutputIt>
+    constexpr OutputIt lower_bound(ForwardIt first, Sentinal last, OutputIt out) const
+    {
+        return this->lower_bound_indices(first, last, out, [this](std::size_t k, const auto&) -> const Key* {
+            return k ? &this->key(k) : nullptr;
+        });
+    }
+};
+
+/**
+ * @brief Read-only sorted map in Eytzinger order, searched without branches, constexpr.
+ *
+ * Built from pairs, sorted by key. Values are stored apart from the keys, so searches only touch keys.
+ */
+template <typename Key, typename Value, std::size_t N = dynamic_extent, typename Compare = std::less<>>
+class eytzinger_map : public detail::eytzinger_tree<Key, N, Compare>
+{
+    using base = detail::eytzinger_tree<Key, N, Compare>;
+
+    detail::eytzinger_storage<Value, N> _values;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+
+    /**
+     * @brief The pairs of [first, last), sorted by first with comp.
+     *
+     * With a fixed N, there must be N pairs. Forward iterators, they are read twice.
+     */
+    template <typename ForwardIt, typename Sentinal>
+    constexpr eytzinger_map(ForwardIt first, Sentinal last, const Compare& comp = {})
+        : base(N == dynamic_extent ? detail::eytzinger_count(first, last) : N, first, last, comp,
+            [](const auto& pair) -> const auto& { return pair.first; })
+        , _values {}
+    {
+        if constexpr(N == dynamic_extent) {
+            _values.resize(this->size() + 1);
+        }
+        for(std::size_t k = detail::eytzinger_first(this->size()); k != 0; k = detail::eytzinger_next(k, this->size()), ++first) {
+            _values[k] = first->second;
+        }
+    }
+
+    /**
+     * @brief The value of key, or null if there is none.
+     */
+    template <typename K>
+    constexpr const Value* find(const K& key) const
+    {
+        const std::size_t k = this->lower_bound_index(key);
+        return this->equivalent(k, key) ? &_values[k] : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K& key) const
+    {
+        return this->equivalent(this->lower_bound_index(key), key);
+    }
+
+    /**
+     * @brief The value of key, which must be in the map.
+     */
+    template <typename K>
+    constexpr const Value& at(const K& key) const
+    {
+        const Value* value = find(key);
+        cgs_assert(value);
+        return *value;
+    }
+
+    /**
+     * @brief out = find(key) for each key of [first, last), interleaving several searches.
+     */
+    template <typename ForwardIt, typename Sentinal, typename OutputIt>
+    constexpr OutputIt find(ForwardIt first, Sentinal last, OutputIt out) const
+    {
+        return this->lower_bound_indices(first, last, out, [this](std::size_t k, const auto& key) -> const Value* {
+            return this->equivalent(k, key) ? &_values[k] : nullptr;
+        });
+    }
+};
+
+/**
+ * @brief eytzinger_set of the sorted keys, for building at compile time.
+ */
+template <typename Key, std::size_t N, typename Compare = std::less<>>
+constexpr eytzinger_set<Key, N, Compare> make_eytzinger_set(const std::array<Key, N>& sorted, const Compare& comp = {})
+{
+    return { sorted.begin(), sorted.end(), comp };
+}
+
+/**
+ * @brief eytzinger_map of the pairs sorted by key, for building at compile time.
+ */
+template <typename Key, typename Value, std::size_t N, typename Compare = std::less<>>
+constexpr eytzinger_map<Key, Value, N, Compare> make_eytzinger_map(const std::array<std::pair<Key, Value>, N>& sorted,
+    const Compare& comp = {})
+{
+    return { sorted.begin(), sorted.end(), comp };
+}
+
+} // namespace cgs
+
+#endif // CGS_EYTZINGER_HPP
@@ -17,9 +17,14 @@
 #define CGS_MATH_HPP
 
 #include "cgs/assert.hpp"
+#include "cgs/expected.hpp"
 #include "cgs/meta/constexpr.hpp"
+#include "cgs/simd/dispatch.hpp"
+#include "cgs/simd/pack.hpp"
 
-#include <cmath> // isnan, abs, tons of non constexpr stuff :(
+#include <cmath> // isnan, abs, constexpr elementary functions are in elementary.hpp
+#include <cstddef> // size_t
+#include <cstdint> // int32_t, int64_t
 #include <limits> // numeric_limits
 #include <type_traits>
 #include <utility> // pair
@@ -47,6 +52,47 @@ inline constexpr bool is_floating_point_v = std::is_floating_point<T>::value;
 template <typename T>
 inline constexpr bool is_signed_v = std::is_signed<T>::value;
 
+#ifdef __SIZEOF_INT128__
+    #define CGS_HAS_INT128
+#endif
+
+namespace detail
+{
+
+#ifdef CGS_HAS_INT128
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+#endif
+
+// is_integral and is_signed, including __int128 in strict ISO mode, where the standard traits exclude it
+
+template <typename T>
+inline constexpr bool is_integer_v = is_integral_v<T>
+#ifdef CGS_HAS_INT128
+    || std::is_same<std::remove_cv_t<T>, int128>::value
+    || std::is_same<std::remove_cv_t<T>, uint128>::value
+#endif
+    ;
+
+template <typename T>
+inline constexpr bool is_signed_integer_v = (is_integral_v<T> && is_signed_v<T>)
+#ifdef CGS_HAS_INT128
+    || std::is_same<std::remove_cv_t<T>, int128>::value
+#endif
+    ;
+
+// T, in a parameter that is not deduced from, like C++20's std::type_identity_t
+template <typename T>
+struct type_identity
+{
+    using type = T;
+};
+
+template <typename T>
+using type_identity_t = typename type_identity<T>::type;
+
+} // namespace detail
+
 namespace detail
 {
 
@@ -127,13 +173,47 @@ constexpr T abs(T value)
 template <typename T, typename F>
 constexpr T lerp(const T& a, const T& b, F amount)
 {
-    // TODO which is faster?
-    //return cgs_likely(cgs::isfinite(b - a))
     return cgs_likely(cgs::isfinite(a) && cgs::isfinite(b))
         ? a + (b - a) * amount
         : std::numeric_limits<T>::quiet_NaN();
 }
 
+/**
+ * @brief How lerp treats infinite and NaN inputs.
+ */
+enum class finite_check
+{
+    // NaN unless a and b are both finite, like lerp(a, b, amount)
+    inputs,
+    // NaN unless b - a is finite, one test instead of two,
+    // which also gives NaN when b - a overflows
+    difference,
+    // no test, whatever the arithmetic gives
+    none,
+};
+
+/**
+ * @brief lerp(a, b, amount), with the check on infinite and NaN inputs chosen by Check.
+ *
+ * Called as lerp<finite_check::difference>(a, b, amount).
+ */
+template <finite_check Check, typename T, typename F>
+constexpr T lerp(const T& a, const T& b, F amount)
+{
+    if constexpr(Check == finite_check::inputs) {
+        return cgs::lerp(a, b, amount);
+    }
+    else {
+        const T difference = b - a;
+        if constexpr(Check == finite_check::difference) {
+            if(cgs_unlikely(!cgs::isfinite(difference))) {
+                return std::numeric_limits<T>::quiet_NaN();
+            }
+        }
+        return a + difference * amount;
+    }
+}
+
 template <typename T>
 constexpr const T& clamp(const T& val, const T& min, const T& max)
 {
@@ -159,112 +239,1199 @@ struct div_type
     Int quot, rem;
 };
 
-template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
-constexpr Int div(Int n, Int d)
+namespace detail
 {
-    cgs_assert(d != 0);
 
-    if constexpr(RoundMode == div_round_mode::trunc || !is_signed_v<Int>) {
-        return n / d;
-    }
-    else if constexpr(RoundMode == div_round_mode::floor) {
-        if((n < 0) != (d < 0)) {
-            n -= d - 1;
-        }
-        return n / d;
+// turn the truncated quot and rem into RoundMode's
+template <div_round_mode RoundMode, typename Int>
+constexpr void round_divmod(Int& quot, Int& rem, Int d) noexcept
+{
+    // masks instead of branches, the signs of n and d are often unpredictable
+    if constexpr(RoundMode == div_round_mode::floor && is_signed_integer_v<Int>) {
+        // rem is not zero, and its sign differs from d
+        const Int adjust = static_cast<Int>(-static_cast<Int>(rem != 0 && (rem < 0) != (d < 0)));
+        quot = static_cast<Int>(quot + adjust);
+        rem = static_cast<Int>(rem + (d & adjust));
     }
-    else if constexpr(RoundMode == div_round_mode::euclid) {
-        if(n < 0) {
-            n -= cgs::abs(d) - 1;
-        }
-        return n / d;
+    else if constexpr(RoundMode == div_round_mode::euclid && is_signed_integer_v<Int>) {
+        // rem += abs(d) and quot -= sign(d), without overflowing abs
+        const Int adjust = static_cast<Int>(-static_cast<Int>(rem < 0));
+        const Int negative = static_cast<Int>(-static_cast<Int>(d < 0));
+        quot = static_cast<Int>(quot - ((negative | 1) & adjust));
+        rem = static_cast<Int>(rem + (d & (adjust & ~negative)) - (d & (adjust & negative)));
     }
 }
 
-template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
-constexpr Int mod(Int n, Int d)
+} // namespace detail
+
+/**
+ * @brief Quotient and remainder of n / d, rounded by RoundMode, so n == d * quot + rem.
+ *
+ * One division, the remainder follows from the quotient.
+ * Int may be unsigned, where every mode is trunc, or __int128.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr div_type<Int> divmod(Int n, Int d)
 {
     cgs_assert(d != 0);
 
-    const Int builtin = n % d;
+    Int quot = static_cast<Int>(n / d);
+    Int rem = static_cast<Int>(n - quot * d);
+
+    // adjusting n before dividing could overflow
+    detail::round_divmod<RoundMode>(quot, rem, d);
+    return { quot, rem };
+}
+
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr Int div(Int n, Int d)
+{
+    return divmod<RoundMode>(n, d).quot;
+}
+
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr Int mod(Int n, Int d)
+{
+    return divmod<RoundMode>(n, d).rem;
+}
+
+template <typename Int, Int Min, Int Max>
+class bounded;
+
+namespace detail
+{
 
-    if constexpr(RoundMode == div_round_mode::trunc || !is_signed_v<Int>) {
-        return builtin;
+template <typename UInt>
+constexpr int floor_log2(UInt x)
+{
+    int log = -1;
+    for(; x; x >>= 1) {
+        ++log;
     }
-    else if constexpr(RoundMode == div_round_mode::floor) {
-        if((n < 0) != (d < 0) && builtin != 0) {
-            return builtin + d;
-        }
-        return builtin;
+    return log;
+}
+
+// the integer type and range of an integer or a bounded, see cgs/bounded.hpp
+template <typename T, typename = void>
+struct integer_range
+{
+    static constexpr bool valid = false;
+};
+
+template <typename Int>
+struct integer_range<Int, enable_if_t<is_integer_v<Int>>>
+{
+    static constexpr bool valid = true;
+    static constexpr bool bounded = false;
+    using type = Int;
+    static constexpr Int min = std::numeric_limits<Int>::min();
+    static constexpr Int max = std::numeric_limits<Int>::max();
+};
+
+template <typename Int, Int Min, Int Max>
+struct integer_range<cgs::bounded<Int, Min, Max>>
+{
+    static constexpr bool valid = true;
+    static constexpr bool bounded = true;
+    using type = Int;
+    static constexpr Int min = Min;
+    static constexpr Int max = Max;
+};
+
+// N or D is a bounded, of the same integer type as the other
+template <typename N, typename D, typename = void>
+struct is_bounded_division : std::false_type {};
+
+template <typename N, typename D>
+struct is_bounded_division<N, D, enable_if_t<integer_range<N>::valid && integer_range<D>::valid>>
+    : std::integral_constant<bool, (integer_range<N>::bounded || integer_range<D>::bounded)
+        && std::is_same<typename integer_range<N>::type, typename integer_range<D>::type>::value>
+{};
+
+template <typename N, typename D>
+inline constexpr bool is_bounded_division_v = is_bounded_division<N, D>::value;
+
+} // namespace detail
+
+/**
+ * @brief divmod of a bounded dividend or divisor, simplified by their ranges at compile time.
+ *
+ * A divisor range without zero skips the zero check.
+ * A divisor of known sign rounds with one compare, none for a non-negative dividend and positive divisor.
+ * A constant divisor divides by the constant, and a power of two shifts and masks,
+ * for floor and euclid, or any mode with a non-negative dividend.
+ */
+template <div_round_mode RoundMode, typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr div_type<typename detail::integer_range<N>::type> divmod(N n, D d)
+{
+    using Int = typename detail::integer_range<N>::type;
+    constexpr Int nMin = detail::integer_range<N>::min;
+    constexpr Int dMin = detail::integer_range<D>::min;
+    constexpr Int dMax = detail::integer_range<D>::max;
+    static_assert(dMin != 0 || dMax != 0, "the divisor is always zero");
+
+    const Int dividend = static_cast<Int>(n);
+    if constexpr(dMin <= 0 && 0 <= dMax) {
+        return divmod<RoundMode>(dividend, static_cast<Int>(d));
     }
-    else if constexpr(RoundMode == div_round_mode::euclid) {
-        if(n < 0 && builtin != 0) {
-            return builtin + cgs::abs(d);
+    else if constexpr(dMin == dMax && dMin > 0 && (dMin & (dMin - 1)) == 0
+        && (nMin >= 0 || RoundMode != div_round_mode::trunc)) {
+        // for a negative dividend, relies on >> being arithmetic, as it is on every supported compiler
+        constexpr int shift = detail::floor_log2(dMin);
+        return { static_cast<Int>(dividend >> shift), static_cast<Int>(dividend & (dMin - 1)) };
+    }
+    else {
+        const Int divisor = dMin == dMax ? dMin : static_cast<Int>(d);
+        Int quot = static_cast<Int>(dividend / divisor);
+        Int rem = static_cast<Int>(dividend - quot * divisor);
+
+        if constexpr(RoundMode == div_round_mode::trunc || !detail::is_signed_integer_v<Int>) {
+            // already rounded, unsigned is always trunc
+        }
+        else if constexpr(dMin > 0) {
+            // floor and euclid both move a negative rem up by d
+            if constexpr(nMin < 0) {
+                const Int adjust = static_cast<Int>(-static_cast<Int>(rem < 0));
+                quot = static_cast<Int>(quot + adjust);
+                rem = static_cast<Int>(rem + (divisor & adjust));
+            }
+        }
+        else if constexpr(RoundMode == div_round_mode::floor) {
+            // negative d, floor moves a positive rem down by |d|
+            const Int adjust = static_cast<Int>(-static_cast<Int>(rem > 0));
+            quot = static_cast<Int>(quot + adjust);
+            rem = static_cast<Int>(rem + (divisor & adjust));
+        }
+        else if constexpr(nMin < 0) {
+            // negative d, euclid moves a negative rem up by |d|
+            const Int adjust = static_cast<Int>(-static_cast<Int>(rem < 0));
+            quot = static_cast<Int>(quot - adjust);
+            rem = static_cast<Int>(rem - (divisor & adjust));
         }
-        return builtin;
+        return { quot, rem };
     }
 }
 
-template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
-div_type<Int> divmod(Int n, Int d)
+template <div_round_mode RoundMode, typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type div(N n, D d)
 {
-    return { div<RoundMode>(n, d), mod<RoundMode>(n, d) };
+    return divmod<RoundMode>(n, d).quot;
 }
 
-template <typename Int>
+template <div_round_mode RoundMode, typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type mod(N n, D d)
+{
+    return divmod<RoundMode>(n, d).rem;
+}
+
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int div_trunc(Int n, Int d)
 {
     return div<div_round_mode::trunc>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int div_floor(Int n, Int d)
 {
     return div<div_round_mode::floor>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int div_euclid(Int n, Int d)
 {
     return div<div_round_mode::euclid>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int mod_trunc(Int n, Int d)
 {
     return mod<div_round_mode::trunc>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int mod_floor(Int n, Int d)
 {
     return mod<div_round_mode::floor>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr Int mod_euclid(Int n, Int d)
 {
     return mod<div_round_mode::euclid>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr div_type<Int> divmod_trunc(Int n, Int d)
 {
     return divmod<div_round_mode::trunc>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr div_type<Int> divmod_floor(Int n, Int d)
 {
     return divmod<div_round_mode::floor>(n, d);
 }
 
-template <typename Int>
+template <typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
 constexpr div_type<Int> divmod_euclid(Int n, Int d)
 {
     return divmod<div_round_mode::euclid>(n, d);
 }
 
+// a bounded dividend or divisor, of the same integer type as the other
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type div_trunc(N n, D d)
+{
+    return div<div_round_mode::trunc>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type div_floor(N n, D d)
+{
+    return div<div_round_mode::floor>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type div_euclid(N n, D d)
+{
+    return div<div_round_mode::euclid>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type mod_trunc(N n, D d)
+{
+    return mod<div_round_mode::trunc>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type mod_floor(N n, D d)
+{
+    return mod<div_round_mode::floor>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr typename detail::integer_range<N>::type mod_euclid(N n, D d)
+{
+    return mod<div_round_mode::euclid>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr div_type<typename detail::integer_range<N>::type> divmod_trunc(N n, D d)
+{
+    return divmod<div_round_mode::trunc>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr div_type<typename detail::integer_range<N>::type> divmod_floor(N n, D d)
+{
+    return divmod<div_round_mode::floor>(n, d);
+}
+
+template <typename N, typename D, typename = enable_if_t<detail::is_bounded_division_v<N, D>>>
+constexpr div_type<typename detail::integer_range<N>::type> divmod_euclid(N n, D d)
+{
+    return divmod<div_round_mode::euclid>(n, d);
+}
+
+/**
+ * @brief Why a division has no result.
+ */
+enum class div_error
+{
+    // d == 0
+    zero_divisor,
+    // the minimum signed integer divided by -1
+    overflow,
+};
+
+/**
+ * @brief Selects the div and mod overloads that return an error instead of asserting, e.g.
+ * `cgs::div_floor(n, d, cgs::as_expected)`
+ */
+struct as_expected_t
+{
+    explicit as_expected_t() = default;
+};
+
+inline constexpr as_expected_t as_expected {};
+
+/**
+ * @brief divmod, or an error for a zero divisor or an overflowing quotient.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr expected<div_type<Int>, div_error> divmod(Int n, Int d, as_expected_t)
+{
+    if(cgs_unlikely(d == 0)) {
+        return unexpected(div_error::zero_divisor);
+    }
+    if constexpr(detail::is_signed_integer_v<Int>) {
+        if(cgs_unlikely(d == -1 && n == std::numeric_limits<Int>::min())) {
+            return unexpected(div_error::overflow);
+        }
+    }
+    return divmod<RoundMode>(n, d);
+}
+
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr expected<Int, div_error> div(Int n, Int d, as_expected_t)
+{
+    const expected<div_type<Int>, div_error> result = divmod<RoundMode>(n, d, as_expected);
+    if(cgs_unlikely(!result)) {
+        return unexpected(result.error());
+    }
+    return result->quot;
+}
+
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<detail::is_integer_v<Int>>>
+constexpr expected<Int, div_error> mod(Int n, Int d, as_expected_t)
+{
+    const expected<div_type<Int>, div_error> result = divmod<RoundMode>(n, d, as_expected);
+    if(cgs_unlikely(!result)) {
+        return unexpected(result.error());
+    }
+    return result->rem;
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> div_trunc(Int n, Int d, as_expected_t)
+{
+    return div<div_round_mode::trunc>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> div_floor(Int n, Int d, as_expected_t)
+{
+    return div<div_round_mode::floor>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> div_euclid(Int n, Int d, as_expected_t)
+{
+    return div<div_round_mode::euclid>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> mod_trunc(Int n, Int d, as_expected_t)
+{
+    return mod<div_round_mode::trunc>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> mod_floor(Int n, Int d, as_expected_t)
+{
+    return mod<div_round_mode::floor>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<Int, div_error> mod_euclid(Int n, Int d, as_expected_t)
+{
+    return mod<div_round_mode::euclid>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<div_type<Int>, div_error> divmod_trunc(Int n, Int d, as_expected_t)
+{
+    return divmod<div_round_mode::trunc>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<div_type<Int>, div_error> divmod_floor(Int n, Int d, as_expected_t)
+{
+    return divmod<div_round_mode::floor>(n, d, as_expected);
+}
+
+template <typename Int>
+constexpr expected<div_type<Int>, div_error> divmod_euclid(Int n, Int d, as_expected_t)
+{
+    return divmod<div_round_mode::euclid>(n, d, as_expected);
+}
+
+namespace detail
+{
+
+// turn the truncated quot and rem into RoundMode's, without branches
+template <div_round_mode RoundMode, typename Int, std::size_t N>
+constexpr void round_divmod_packs(simd::pack<Int, N>& quot, simd::pack<Int, N>& rem, const simd::pack<Int, N>& d)
+{
+    using pack = simd::pack<Int, N>;
+    const pack zero {};
+    const pack one { 1 };
+
+    if constexpr(RoundMode == div_round_mode::floor) {
+        // rem is not zero, and its sign differs from d.
+        // one compare, GCC scalarizes ANDed masks of 512 bit packs
+        const auto adjust = select(rem != zero, rem ^ d, zero) < zero;
+        // the lanes that are not adjusted add zero, so none overflows
+        quot = quot - select(adjust, one, zero);
+        rem = rem + select(adjust, d, zero);
+    }
+    else if constexpr(RoundMode == div_round_mode::euclid) {
+        // rem += abs(d) and quot -= sign(d) in the adjusted lanes, like round_divmod
+        const auto adjust = rem < zero;
+        const auto negative = d < zero;
+        const pack oneAdjust = select(adjust, one, zero);
+        const pack dAdjust = select(adjust, d, zero);
+        quot = quot + select(negative, oneAdjust, zero) - select(negative, zero, oneAdjust);
+        rem = rem + select(negative, zero, dAdjust) - select(negative, dAdjust, zero);
+    }
+}
+
+// [n, n + count) divided by d[0] (ScalarDivisor) or d[i], into quot and rem when Quot and Rem
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, std::size_t Width, typename Int>
+void divmod_packs(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    using pack = simd::pack<Int, Width>;
+    constexpr div_round_mode packMode = is_signed_v<Int> ? RoundMode : div_round_mode::trunc;
+
+    pack divisor {};
+    if constexpr(ScalarDivisor) {
+        divisor = pack{ *d };
+    }
+
+    std::size_t i = 0;
+    for(; i + Width <= count; i += Width) {
+        if constexpr(!ScalarDivisor) {
+            divisor = pack::loadu(d + i);
+            cgs_assert(!any(divisor == pack{}));
+        }
+        const pack dividend = pack::loadu(n + i);
+        pack q = dividend / divisor;
+        pack r = dividend - q * divisor;
+        round_divmod_packs<packMode>(q, r, divisor);
+        if constexpr(Quot) {
+            q.storeu(quot + i);
+        }
+        if constexpr(Rem) {
+            r.storeu(rem + i);
+        }
+    }
+
+    // a partial pack would divide by zero in the unused lanes
+    for(; i < count; ++i) {
+        const auto result = cgs::divmod<RoundMode>(n[i], ScalarDivisor ? *d : d[i]);
+        if constexpr(Quot) {
+            quot[i] = result.quot;
+        }
+        if constexpr(Rem) {
+            rem[i] = result.rem;
+        }
+    }
+}
+
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, typename Int>
+void divmod_span_baseline(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    divmod_packs<RoundMode, Quot, Rem, ScalarDivisor, simd::native_width_v<Int>>(n, count, d, quot, rem);
+}
+
+#ifdef CGS_SIMD_DISPATCH
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, typename Int>
+CGS_TARGET_SSE2 void divmod_span_sse2(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    divmod_packs<RoundMode, Quot, Rem, ScalarDivisor, simd::sse2_width_v<Int>>(n, count, d, quot, rem);
+}
+
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, typename Int>
+CGS_TARGET_AVX2 void divmod_span_avx2(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    divmod_packs<RoundMode, Quot, Rem, ScalarDivisor, simd::avx2_width_v<Int>>(n, count, d, quot, rem);
+}
+
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, typename Int>
+CGS_TARGET_AVX512 void divmod_span_avx512(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    divmod_packs<RoundMode, Quot, Rem, ScalarDivisor, simd::avx512_width_v<Int>>(n, count, d, quot, rem);
+}
+#endif
+
+template <div_round_mode RoundMode, bool Quot, bool Rem, bool ScalarDivisor, typename Int>
+void divmod_span(const Int* n, std::size_t count, const Int* d, Int* quot, Int* rem)
+{
+    static const simd::dispatch<void(const Int*, std::size_t, const Int*, Int*, Int*)> table {
+        &divmod_span_baseline<RoundMode, Quot, Rem, ScalarDivisor, Int>,
+#ifdef CGS_SIMD_DISPATCH
+        &divmod_span_sse2<RoundMode, Quot, Rem, ScalarDivisor, Int>,
+        &divmod_span_avx2<RoundMode, Quot, Rem, ScalarDivisor, Int>,
+        &divmod_span_avx512<RoundMode, Quot, Rem, ScalarDivisor, Int>,
+#endif
+    };
+    table(n, count, d, quot, rem);
+}
+
+// divisor of element i
+template <typename Int>
+constexpr Int divisor_at(Int d, std::size_t)
+{
+    return d;
+}
+
+template <typename Int>
+constexpr Int divisor_at(const Int* d, std::size_t i)
+{
+    return d[i];
+}
+
+template <div_round_mode RoundMode, bool Quot, bool Rem, typename Int, typename Divisor>
+constexpr void divmod_range(const Int* first, const Int* last, Divisor d, Int* quot, Int* rem)
+{
+    const auto count = static_cast<std::size_t>(last - first);
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        if constexpr(!std::is_pointer<Divisor>::value) {
+            cgs_assert(d != 0);
+            detail::divmod_span<RoundMode, Quot, Rem, true>(first, count, &d, quot, rem);
+        }
+        else {
+            detail::divmod_span<RoundMode, Quot, Rem, false>(first, count, d, quot, rem);
+        }
+        return;
+    }
+#endif
+
+    for(std::size_t i = 0; i < count; ++i) {
+        const auto result = cgs::divmod<RoundMode>(first[i], divisor_at(d, i));
+        if constexpr(Quot) {
+            quot[i] = result.quot;
+        }
+        if constexpr(Rem) {
+            rem[i] = result.rem;
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief out[i] = div<RoundMode>(first[i], d), for a whole array.
+ *
+ * At runtime, divides a SIMD pack at a time, with the rounding adjusted by selects instead of branches.
+ * 32 bit and smaller integers divide in floating point, which is exact for them.
+ * out may be first. Int is deduced from the arrays only, so d may be a literal of another integer type.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void div(const Int* first, const Int* last, detail::type_identity_t<Int> d, Int* out)
+{
+    detail::divmod_range<RoundMode, true, false>(first, last, d, out, static_cast<Int*>(nullptr));
+}
+
+/**
+ * @brief out[i] = div<RoundMode>(first[i], d[i]), for a whole array.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void div(const Int* first, const Int* last, const Int* d, Int* out)
+{
+    detail::divmod_range<RoundMode, true, false>(first, last, d, out, static_cast<Int*>(nullptr));
+}
+
+/**
+ * @brief out[i] = mod<RoundMode>(first[i], d), for a whole array.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void mod(const Int* first, const Int* last, detail::type_identity_t<Int> d, Int* out)
+{
+    detail::divmod_range<RoundMode, false, true>(first, last, d, static_cast<Int*>(nullptr), out);
+}
+
+/**
+ * @brief out[i] = mod<RoundMode>(first[i], d[i]), for a whole array.
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void mod(const Int* first, const Int* last, const Int* d, Int* out)
+{
+    detail::divmod_range<RoundMode, false, true>(first, last, d, static_cast<Int*>(nullptr), out);
+}
+
+/**
+ * @brief Both div and mod of first[i] and d, into quot[i] and rem[i].
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void divmod(const Int* first, const Int* last, detail::type_identity_t<Int> d, Int* quot, Int* rem)
+{
+    detail::divmod_range<RoundMode, true, true>(first, last, d, quot, rem);
+}
+
+/**
+ * @brief Both div and mod of first[i] and d[i], into quot[i] and rem[i].
+ */
+template <div_round_mode RoundMode, typename Int, typename = enable_if_t<is_integral_v<Int>>>
+constexpr void divmod(const Int* first, const Int* last, const Int* d, Int* quot, Int* rem)
+{
+    detail::divmod_range<RoundMode, true, true>(first, last, d, quot, rem);
+}
+
+// Divisor is an integer, converted to Int, or const Int*
+
+template <typename Int, typename Divisor>
+constexpr void div_trunc(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    div<div_round_mode::trunc>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void div_floor(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    div<div_round_mode::floor>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void div_euclid(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    div<div_round_mode::euclid>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void mod_trunc(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    mod<div_round_mode::trunc>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void mod_floor(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    mod<div_round_mode::floor>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void mod_euclid(const Int* first, const Int* last, Divisor d, Int* out)
+{
+    mod<div_round_mode::euclid>(first, last, d, out);
+}
+
+template <typename Int, typename Divisor>
+constexpr void divmod_trunc(const Int* first, const Int* last, Divisor d, Int* quot, Int* rem)
+{
+    divmod<div_round_mode::trunc>(first, last, d, quot, rem);
+}
+
+template <typename Int, typename Divisor>
+constexpr void divmod_floor(const Int* first, const Int* last, Divisor d, Int* quot, Int* rem)
+{
+    divmod<div_round_mode::floor>(first, last, d, quot, rem);
+}
+
+template <typename Int, typename Divisor>
+constexpr void divmod_euclid(const Int* first, const Int* last, Divisor d, Int* quot, Int* rem)
+{
+    divmod<div_round_mode::euclid>(first, last, d, quot, rem);
+}
+
+namespace detail
+{
+
+// IEEE 754 bit patterns of T, to test a pack of them with integer compares
+template <typename T>
+struct float_bits;
+
+template <>
+struct float_bits<float>
+{
+    using type = std::int32_t;
+    // every exponent bit set: infinite or NaN
+    static constexpr type exponent = 0x7f800000;
+    static constexpr type magnitude = 0x7fffffff;
+};
+
+template <>
+struct float_bits<double>
+{
+    using type = std::int64_t;
+    static constexpr type exponent = 0x7ff0000000000000;
+    static constexpr type magnitude = 0x7fffffffffffffff;
+};
+
+template <typename T>
+inline constexpr bool is_float_scan_v = std::is_same<T, float>::value || std::is_same<T, double>::value;
+
+// ignoring the sign, NaNs are above infinity, and non-finite values at least infinity
+template <bool NanOnly, typename T>
+constexpr typename float_bits<T>::type nonfinite_above = NanOnly ? float_bits<T>::exponent : float_bits<T>::exponent - 1;
+
+template <typename Bits, std::size_t N>
+simd::pack<Bits, N> magnitude_bits(const Bits* p)
+{
+    using traits = float_bits<std::conditional_t<sizeof(Bits) == sizeof(float), float, double>>;
+    return simd::pack<Bits, N>::loadu(p) & simd::pack<Bits, N>{ traits::magnitude };
+}
+
+template <bool NanOnly, typename T>
+bool is_nonfinite_bits(const T* p)
+{
+    using Bits = typename float_bits<T>::type;
+    Bits bits {};
+    __builtin_memcpy(&bits, p, sizeof(bits));
+    return (bits & float_bits<T>::magnitude) > nonfinite_above<NanOnly, T>;
+}
+
+template <bool NanOnly, std::size_t Width, typename T>
+std::size_t find_nonfinite_packs(const T* p, std::size_t count)
+{
+    using Bits = typename float_bits<T>::type;
+    using pack = simd::pack<Bits, Width>;
+    const Bits* bits = reinterpret_cast<const Bits*>(p);
+
+    // test 4 packs per branch, then find the lane one by one.
+    // The largest magnitude decides, or-ing 4 compare masks makes GCC scalarize them.
+    const pack above { nonfinite_above<NanOnly, T> };
+    constexpr std::size_t block = 4 * Width;
+    std::size_t i = 0;
+    for(; i + block <= count; i += block) {
+        const pack largest = max(
+            max(magnitude_bits<Bits, Width>(bits + i), magnitude_bits<Bits, Width>(bits + i + Width)),
+            max(magnitude_bits<Bits, Width>(bits + i + 2 * Width), magnitude_bits<Bits, Width>(bits + i + 3 * Width)));
+        if(any(largest > above)) {
+            break;
+        }
+    }
+    for(; i < count; ++i) {
+        if(is_nonfinite_bits<NanOnly>(p + i)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+// how many elements of [p, p + count) are NaN (NanOnly) or non-finite
+template <bool NanOnly, std::size_t Width, typename T>
+std::size_t count_nonfinite_packs(const T* p, std::size_t count)
+{
+    using Bits = typename float_bits<T>::type;
+    using pack = simd::pack<Bits, Width>;
+    const Bits* bits = reinterpret_cast<const Bits*>(p);
+
+    // each lane counts up to flush packs, then adds to total
+    const pack above { nonfinite_above<NanOnly, T> };
+    constexpr std::size_t flush = std::size_t{1} << 16;
+    std::size_t total = 0;
+    std::size_t i = 0;
+    while(i < count) {
+        pack lanes {};
+        const std::size_t blockEnd = count - i > flush * Width ? i + flush * Width : count;
+        for(; i + 2 * Width <= blockEnd; i += 2 * Width) {
+            // masks are -1
+            lanes = lanes - ((magnitude_bits<Bits, Width>(bits + i) > above)
+                + (magnitude_bits<Bits, Width>(bits + i + Width) > above));
+        }
+        for(; i + Width <= blockEnd; i += Width) {
+            lanes = lanes - (magnitude_bits<Bits, Width>(bits + i) > above);
+        }
+        for(; i < blockEnd; ++i) {
+            total += is_nonfinite_bits<NanOnly>(p + i);
+        }
+        // sum the lanes through memory, simd::reduce keeps lanes on the stack in the loop
+        Bits laneCounts[Width];
+        lanes.storeu(laneCounts);
+        for(Bits laneCount : laneCounts) {
+            total += static_cast<std::size_t>(laneCount);
+        }
+    }
+    return total;
+}
+
+template <bool NanOnly, typename T>
+std::size_t find_nonfinite_baseline(const T* p, std::size_t count)
+{
+    return find_nonfinite_packs<NanOnly, simd::native_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+std::size_t count_nonfinite_baseline(const T* p, std::size_t count)
+{
+    return count_nonfinite_packs<NanOnly, simd::native_width_v<T>>(p, count);
+}
+
+#ifdef CGS_SIMD_DISPATCH
+template <bool NanOnly, typename T>
+CGS_TARGET_SSE2 std::size_t find_nonfinite_sse2(const T* p, std::size_t count)
+{
+    return find_nonfinite_packs<NanOnly, simd::sse2_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+CGS_TARGET_AVX2 std::size_t find_nonfinite_avx2(const T* p, std::size_t count)
+{
+    return find_nonfinite_packs<NanOnly, simd::avx2_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+CGS_TARGET_AVX512 std::size_t find_nonfinite_avx512(const T* p, std::size_t count)
+{
+    return find_nonfinite_packs<NanOnly, simd::avx512_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+CGS_TARGET_SSE2 std::size_t count_nonfinite_sse2(const T* p, std::size_t count)
+{
+    return count_nonfinite_packs<NanOnly, simd::sse2_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+CGS_TARGET_AVX2 std::size_t count_nonfinite_avx2(const T* p, std::size_t count)
+{
+    return count_nonfinite_packs<NanOnly, simd::avx2_width_v<T>>(p, count);
+}
+
+template <bool NanOnly, typename T>
+CGS_TARGET_AVX512 std::size_t count_nonfinite_avx512(const T* p, std::size_t count)
+{
+    return count_nonfinite_packs<NanOnly, simd::avx512_width_v<T>>(p, count);
+}
+#endif
+
+template <bool NanOnly, typename T>
+std::size_t find_nonfinite_span(const T* p, std::size_t count)
+{
+    static const simd::dispatch<std::size_t(const T*, std::size_t)> table {
+        &find_nonfinite_baseline<NanOnly, T>,
+#ifdef CGS_SIMD_DISPATCH
+        &find_nonfinite_sse2<NanOnly, T>,
+        &find_nonfinite_avx2<NanOnly, T>,
+        &find_nonfinite_avx512<NanOnly, T>,
+#endif
+    };
+    return table(p, count);
+}
+
+template <bool NanOnly, typename T>
+std::size_t count_nonfinite_span(const T* p, std::size_t count)
+{
+    static const simd::dispatch<std::size_t(const T*, std::size_t)> table {
+        &count_nonfinite_baseline<NanOnly, T>,
+#ifdef CGS_SIMD_DISPATCH
+        &count_nonfinite_sse2<NanOnly, T>,
+        &count_nonfinite_avx2<NanOnly, T>,
+        &count_nonfinite_avx512<NanOnly, T>,
+#endif
+    };
+    return table(p, count);
+}
+
+template <bool NanOnly, typename T>
+constexpr bool is_nonfinite(const T& value)
+{
+    return NanOnly ? cgs::isnan(value) : !cgs::isfinite(value);
+}
+
+template <bool NanOnly, typename T>
+constexpr const T* find_nonfinite(const T* first, const T* last)
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if constexpr(is_float_scan_v<T>) {
+        if(!cgs::is_constant_evaluated()) {
+            return first + find_nonfinite_span<NanOnly>(first, static_cast<std::size_t>(last - first));
+        }
+    }
+#endif
+    for(; first != last; ++first) {
+        if(is_nonfinite<NanOnly>(*first)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+template <bool NanOnly, typename T>
+constexpr std::size_t count_nonfinite(const T* first, const T* last)
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if constexpr(is_float_scan_v<T>) {
+        if(!cgs::is_constant_evaluated()) {
+            return count_nonfinite_span<NanOnly>(first, static_cast<std::size_t>(last - first));
+        }
+    }
+#endif
+    std::size_t count = 0;
+    for(; first != last; ++first) {
+        count += is_nonfinite<NanOnly>(*first);
+    }
+    return count;
+}
+
+} // namespace detail
+
+/**
+ * @brief First element of [first, last) that is NaN or infinite, or last if there is none.
+ *
+ * Same as testing each element with !cgs::isfinite.
+ * At runtime, float and double arrays test whole SIMD packs by their exponent bits,
+ * and stop at the first block containing a NaN or infinity.
+ */
+template <typename T>
+constexpr const T* find_first_nonfinite(const T* first, const T* last)
+{
+    return detail::find_nonfinite<false>(first, last);
+}
+
+/**
+ * @brief First NaN element of [first, last), or last if there is none.
+ *
+ * Same as testing each element with cgs::isnan.
+ */
+template <typename T>
+constexpr const T* find_first_nan(const T* first, const T* last)
+{
+    return detail::find_nonfinite<true>(first, last);
+}
+
+/**
+ * @brief Are all elements of [first, last) finite?
+ */
+template <typename T>
+constexpr bool all_finite(const T* first, const T* last)
+{
+    return find_first_nonfinite(first, last) == last;
+}
+
+/**
+ * @brief How many elements of [first, last) are NaN or infinite.
+ */
+template <typename T>
+constexpr std::size_t count_nonfinite(const T* first, const T* last)
+{
+    return detail::count_nonfinite<false>(first, last);
+}
+
+/**
+ * @brief How many elements of [first, last) are NaN.
+ */
+template <typename T>
+constexpr std::size_t count_nan(const T* first, const T* last)
+{
+    return detail::count_nonfinite<true>(first, last);
+}
+
+namespace detail
+{
+
+// lanes where every x is finite: x - x is zero, or NaN for infinity and NaN,
+// summed so there is one compare and no mask ANDs, which GCC scalarizes for 512 bit packs
+template <typename T, std::size_t N, typename... Packs>
+constexpr auto finite_lanes(const simd::pack<T, N>& x, const Packs&... xs)
+{
+    return ((x - x) + ... + (xs - xs)) == simd::pack<T, N>{};
+}
+
+// out[i] = lerp<Check>(a[i], b[i], amount[0] (ScalarAmount) or amount[i])
+template <finite_check Check, bool ScalarAmount, std::size_t Width, typename T>
+void lerp_packs(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    using pack = simd::pack<T, Width>;
+    const pack nan { std::numeric_limits<T>::quiet_NaN() };
+
+    pack t {};
+    if constexpr(ScalarAmount) {
+        t = pack{ *amount };
+    }
+
+    std::size_t i = 0;
+    for(; i + Width <= count; i += Width) {
+        if constexpr(!ScalarAmount) {
+            t = pack::loadu(amount + i);
+        }
+        const pack from = pack::loadu(a + i);
+        const pack to = pack::loadu(b + i);
+        const pack difference = to - from;
+        // contracted to one FMA when the target has it
+        pack result = difference * t + from;
+        if constexpr(Check == finite_check::inputs) {
+            result = select(finite_lanes(from, to), result, nan);
+        }
+        else if constexpr(Check == finite_check::difference) {
+            result = select(finite_lanes(difference), result, nan);
+        }
+        result.storeu(out + i);
+    }
+    for(; i < count; ++i) {
+        out[i] = cgs::lerp<Check>(a[i], b[i], ScalarAmount ? *amount : amount[i]);
+    }
+}
+
+template <finite_check Check, bool ScalarAmount, typename T>
+void lerp_span_baseline(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    lerp_packs<Check, ScalarAmount, simd::native_width_v<T>>(a, b, amount, count, out);
+}
+
+// out[i] = clamp(val[i], min, max)
+template <std::size_t Width, typename T>
+void clamp_packs(const T* val, std::size_t count, T min, T max, T* out)
+{
+    using pack = simd::pack<T, Width>;
+    const pack low { min };
+    const pack high { max };
+
+    std::size_t i = 0;
+    for(; i + Width <= count; i += Width) {
+        const pack x = pack::loadu(val + i);
+        // same comparisons as cgs::clamp, so NaN gives max
+        select(x < high, select(x > low, x, low), high).storeu(out + i);
+    }
+    for(; i < count; ++i) {
+        out[i] = cgs::clamp(val[i], min, max);
+    }
+}
+
+template <typename T>
+void clamp_span_baseline(const T* val, std::size_t count, T min, T max, T* out)
+{
+    clamp_packs<simd::native_width_v<T>>(val, count, min, max, out);
+}
+
+#ifdef CGS_SIMD_DISPATCH
+template <finite_check Check, bool ScalarAmount, typename T>
+CGS_TARGET_SSE2 void lerp_span_sse2(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    lerp_packs<Check, ScalarAmount, simd::sse2_width_v<T>>(a, b, amount, count, out);
+}
+
+template <finite_check Check, bool ScalarAmount, typename T>
+CGS_TARGET_AVX2 void lerp_span_avx2(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    lerp_packs<Check, ScalarAmount, simd::avx2_width_v<T>>(a, b, amount, count, out);
+}
+
+template <finite_check Check, bool ScalarAmount, typename T>
+CGS_TARGET_AVX512 void lerp_span_avx512(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    lerp_packs<Check, ScalarAmount, simd::avx512_width_v<T>>(a, b, amount, count, out);
+}
+
+template <typename T>
+CGS_TARGET_SSE2 void clamp_span_sse2(const T* val, std::size_t count, T min, T max, T* out)
+{
+    clamp_packs<simd::sse2_width_v<T>>(val, count, min, max, out);
+}
+
+template <typename T>
+CGS_TARGET_AVX2 void clamp_span_avx2(const T* val, std::size_t count, T min, T max, T* out)
+{
+    clamp_packs<simd::avx2_width_v<T>>(val, count, min, max, out);
+}
+
+template <typename T>
+CGS_TARGET_AVX512 void clamp_span_avx512(const T* val, std::size_t count, T min, T max, T* out)
+{
+    clamp_packs<simd::avx512_width_v<T>>(val, count, min, max, out);
+}
+#endif
+
+template <finite_check Check, bool ScalarAmount, typename T>
+void lerp_span(const T* a, const T* b, const T* amount, std::size_t count, T* out)
+{
+    static const simd::dispatch<void(const T*, const T*, const T*, std::size_t, T*)> table {
+        &lerp_span_baseline<Check, ScalarAmount, T>,
+#ifdef CGS_SIMD_DISPATCH
+        &lerp_span_sse2<Check, ScalarAmount, T>,
+        &lerp_span_avx2<Check, ScalarAmount, T>,
+        &lerp_span_avx512<Check, ScalarAmount, T>,
+#endif
+    };
+    table(a, b, amount, count, out);
+}
+
+template <typename T>
+void clamp_span(const T* val, std::size_t count, T min, T max, T* out)
+{
+    static const simd::dispatch<void(const T*, std::size_t, T, T, T*)> table {
+        &clamp_span_baseline<T>,
+#ifdef CGS_SIMD_DISPATCH
+        &clamp_span_sse2<T>,
+        &clamp_span_avx2<T>,
+        &clamp_span_avx512<T>,
+#endif
+    };
+    table(val, count, min, max, out);
+}
+
+// amount of element i
+template <typename T>
+constexpr T amount_at(T amount, std::size_t)
+{
+    return amount;
+}
+
+template <typename T>
+constexpr T amount_at(const T* amount, std::size_t i)
+{
+    return amount[i];
+}
+
+template <finite_check Check, typename T, typename Amount>
+constexpr void lerp_range(const T* first, const T* last, const T* b, Amount amount, T* out)
+{
+    const auto count = static_cast<std::size_t>(last - first);
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if constexpr(is_float_scan_v<T>) {
+        if(!cgs::is_constant_evaluated()) {
+            if constexpr(!std::is_pointer<Amount>::value) {
+                detail::lerp_span<Check, true>(first, b, &amount, count, out);
+            }
+            else {
+                detail::lerp_span<Check, false>(first, b, amount, count, out);
+            }
+            return;
+        }
+    }
+#endif
+
+    for(std::size_t i = 0; i < count; ++i) {
+        out[i] = cgs::lerp<Check>(first[i], b[i], amount_at(amount, i));
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief out[i] = lerp<Check>(first[i], b[i], amount), for a whole array.
+ *
+ * At runtime, float and double arrays use SIMD packs and FMA where the CPU has it,
+ * so results may differ from the scalar lerp by one rounding.
+ * `out` may alias `first` or `b`.
+ */
+template <finite_check Check = finite_check::inputs, typename T, typename F,
+          std::enable_if_t<std::is_arithmetic<F>::value, int> = 0>
+constexpr void lerp(const T* first, const T* last, const T* b, F amount, T* out)
+{
+    detail::lerp_range<Check>(first, last, b, static_cast<T>(amount), out);
+}
+
+/**
+ * @brief out[i] = lerp<Check>(first[i], b[i], amount[i]), for a whole array.
+ */
+template <finite_check Check = finite_check::inputs, typename T>
+constexpr void lerp(const T* first, const T* last, const T* b, const T* amount, T* out)
+{
+    detail::lerp_range<Check>(first, last, b, amount, out);
+}
+
+/**
+ * @brief out[i] = clamp(first[i], min, max), for a whole array.
+ *
+ * Vector compares at runtime, with the same results as cgs::clamp, NaN included.
+ * `out` may alias `first`.
+ */
+template <typename T>
+constexpr void clamp(const T* first, const T* last, T min, T max, T* out)
+{
+    cgs_assert(min <= max);
+    const auto count = static_cast<std::size_t>(last - first);
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if constexpr(simd::detail::is_pack_element_v<T>) {
+        if(!cgs::is_constant_evaluated()) {
+            detail::clamp_span(first, count, min, max, out);
+            return;
+        }
+    }
+#endif
+
+    for(std::size_t i = 0; i < count; ++i) {
+        out[i] = cgs::clamp(first[i], min, max);
+    }
+}
+
 } // namespace cgs
 
 #endif // CGS_MATH_HPP
@@ -58,6 +58,32 @@ constexpr bool is_constexpr()
     return detail::constexpr_check<Func, Args...>(false);
 }
 
+#if defined(__has_builtin)
+    #if __has_builtin(__builtin_is_constant_evaluated)
+        #define CGS_HAS_IS_CONSTANT_EVALUATED
+    #endif
+#endif
+#if !defined(CGS_HAS_IS_CONSTANT_EVALUATED) \
+    && ((defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+    #define CGS_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+/**
+ * @brief Is the enclosing call being evaluated at compile time?
+ *
+ * Same as C++20 `std::is_constant_evaluated`, using the compiler builtin.
+ * Without the builtin, always returns true,
+ * so callers always take their constexpr-safe path.
+ */
+constexpr bool is_constant_evaluated() noexcept
+{
+#ifdef CGS_HAS_IS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
 } // namespace cgs
 
 #endif // CGS_META_CONSTEXPR_HPP
@@ -16,19 +16,97 @@
 #ifndef CGS_OPTIMIZE_HPP
 #define CGS_OPTIMIZE_HPP
 
+#include "cgs/meta/constexpr.hpp" // is_constant_evaluated
+
+#include <cstddef> // size_t
+#include <cstdint> // uintptr_t
+
 /**
  * cgs_assume(expr)
  *
  * @brief Optimizer hint, do not evaluate.
+ *
+ * expr must be true, it is undefined behavior otherwise.
+ * Its side effects never happen, and an expression with side effects may be no hint at all.
+ * GCC before 13 has no assume builtin, so the hint is a branch to __builtin_unreachable,
+ * taken only if expr has no side effects (including calls to functions),
+ * which the optimizer then removes.
  */
 #ifdef __clang__
     #define cgs_assume(expr) __builtin_assume(static_cast<bool>(expr))
 #elif defined(_MSC_VER)
     #define cgs_assume(expr) __assume(static_cast<bool>(expr))
+#elif defined(__GNUC__) && __GNUC__ >= 13
+    #define cgs_assume(expr) (__extension__ ({ __attribute__((__assume__(static_cast<bool>(expr)))); }))
+#elif defined(__GNUC__)
+    // __builtin_constant_p is false for an expression with side effects, without evaluating it
+    #define cgs_assume(expr) ( __builtin_constant_p((static_cast<void>(expr), 0)) && !static_cast<bool>(expr) \
+        ? __builtin_unreachable() : static_cast<void>(0) )
 #else
     #define cgs_assume(expr) static_cast<void>(sizeof(static_cast<bool>(expr)))
 #endif
 
+/**
+ * cgs_assume_range(x, lo, hi)
+ *
+ * @brief Optimizer hint that lo <= x <= hi, do not evaluate.
+ */
+#define cgs_assume_range(x, lo, hi) cgs_assume((lo) <= (x) && (x) <= (hi))
+
+namespace cgs
+{
+
+/**
+ * @brief The cache line size of current x86 and ARM cores, for alignment and prefetch distances.
+ */
+inline constexpr std::size_t cache_line_size = 64;
+
+/**
+ * @brief Hint that the cache line holding p will be read soon. Does nothing at compile time.
+ *
+ * p is not dereferenced, a prefetch never faults.
+ */
+constexpr void prefetch(const void* p) noexcept
+{
+    if(is_constant_evaluated()) {
+        return;
+    }
+#if defined(__clang__) || defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    static_cast<void>(p);
+#endif
+}
+
+/**
+ * @brief p, which the optimizer may assume is aligned to Alignment bytes, like C++20 `std::assume_aligned`.
+ *
+ * Only the returned pointer carries the hint.
+ */
+template <std::size_t Alignment, typename T>
+constexpr T* assume_aligned(T* p) noexcept
+{
+    static_assert(Alignment && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    if(is_constant_evaluated()) {
+        return p;
+    }
+#if defined(__clang__) || defined(__GNUC__)
+    return static_cast<T*>(__builtin_assume_aligned(p, Alignment));
+#else
+    cgs_assume(reinterpret_cast<std::uintptr_t>(p) % Alignment == 0);
+    return p;
+#endif
+}
+
+} // namespace cgs
+
+/**
+ * cgs_assume_aligned(ptr, N)
+ *
+ * @brief ptr, which the optimizer may assume is aligned to N bytes, see cgs::assume_aligned.
+ */
+#define cgs_assume_aligned(ptr, N) ::cgs::assume_aligned<(N)>(ptr)
+
 #if defined(__clang__) || defined(__GNUC__)
     #define cgs_expect(expr, val) __builtin_expect(static_cast<long>(expr), val)
     #define cgs_unreachable() __builtin_unreachable()
@@ -51,4 +129,18 @@
  */
 #define cgs_unlikely(expr) static_cast<bool>(cgs_expect(static_cast<bool>(expr), 0))
 
+/**
+ * CGS_COLD
+ *
+ * @brief Function attribute for rarely called code, like error handlers,
+ * so it is not inlined and is placed away from hot code.
+ */
+#if defined(__clang__) || defined(__GNUC__)
+    #define CGS_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+    #define CGS_COLD __declspec(noinline)
+#else
+    #define CGS_COLD
+#endif
+
 #endif // CGS_OPTIMIZE_HPP
@@ -0,0 +1,457 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_RADIX_SORT_HPP
+#define CGS_RADIX_SORT_HPP
+
+#include "cgs/algorithm.hpp" // parallel_chunks
+#include "cgs/execution.hpp"
+#include "cgs/sort.hpp"
+#include "cgs/thread_pool.hpp"
+
+#include <array>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <cstring> // memcpy
+#include <iterator> // iterator_traits
+#include <limits>
+#include <memory> // allocator, destroy
+#include <new> // placement new
+#include <type_traits>
+#include <utility> // move
+#include <vector>
+
+/*
+LSD radix sort, by a key projected from each element: an integer, enum, float or double.
+
+Keys are mapped to unsigned integers in the same order, then sorted 8 bits at a time, least significant first.
+Each pass is stable, so the sort is too.
+
+    unsigned    as is
+    signed      flip the sign bit, so negative numbers come first
+    floating    flip the sign bit of positive numbers and every bit of negative numbers,
+                so -inf < -1 < -0 < +0 < 1 < inf. NaNs with the sign bit come first, others last.
+
+One pass over the input counts every digit, and passes where all keys share the digit are skipped,
+e.g. the high bytes of small integers.
+Not constexpr: the scatter needs a buffer of n elements, and float keys their bits.
+*/
+
+namespace cgs
+{
+
+namespace detail
+{
+
+struct radix_identity
+{
+    template <typename T>
+    constexpr T&& operator()(T&& value) const noexcept
+    {
+        return std::forward<T>(value);
+    }
+};
+
+constexpr std::size_t radix_digit_bits = 8;
+constexpr std::size_t radix_buckets = std::size_t{1} << radix_digit_bits;
+
+// at most this many elements are insertion sorted
+constexpr std::size_t radix_sort_min = 64;
+
+template <typename K, typename = void>
+struct radix_bits
+{ };
+
+template <typename K>
+struct radix_bits<K, std::enable_if_t<std::is_enum<K>::value>> : radix_bits<std::underlying_type_t<K>>
+{ };
+
+template <typename K>
+struct radix_bits<K, std::enable_if_t<std::is_arithmetic<K>::value>>
+{
+    using type = std::conditional_t<sizeof(K) == 1, std::uint8_t,
+                 std::conditional_t<sizeof(K) == 2, std::uint16_t,
+                 std::conditional_t<sizeof(K) == 4, std::uint32_t,
+                 std::conditional_t<sizeof(K) == 8, std::uint64_t, void>>>>;
+};
+
+// the unsigned integer a key is sorted as
+template <typename K>
+using radix_bits_t = typename radix_bits<K>::type;
+
+template <typename K>
+inline constexpr bool is_radix_key_v = !std::is_void<radix_bits_t<K>>::value
+    && (!std::is_floating_point<K>::value || std::numeric_limits<K>::is_iec559);
+
+// key mapped to an unsigned integer, in the same order
+template <typename K>
+radix_bits_t<K> radix_key(K key) noexcept
+{
+    using bits_t = radix_bits_t<K>;
+    constexpr bits_t sign = static_cast<bits_t>(bits_t{1} << (std::numeric_limits<bits_t>::digits - 1));
+    if constexpr(std::is_enum<K>::value) {
+        return radix_key(static_cast<std::underlying_type_t<K>>(key));
+    }
+    else if constexpr(std::is_floating_point<K>::value) {
+        bits_t bits;
+        std::memcpy(&bits, &key, sizeof bits);
+        const bits_t negative = static_cast<bits_t>(bits_t{0} - (bits >> (std::numeric_limits<bits_t>::digits - 1)));
+        return static_cast<bits_t>(bits ^ (negative | sign));
+    }
+    else if constexpr(std::is_signed<K>::value) {
+        return static_cast<bits_t>(static_cast<bits_t>(key) ^ sign);
+    }
+    else {
+        return static_cast<bits_t>(key);
+    }
+}
+
+template <typename Bits>
+constexpr std::size_t radix_digit(Bits bits, std::size_t d) noexcept
+{
+    return static_cast<std::size_t>(bits >> (d * radix_digit_bits)) & (radix_buckets - 1);
+}
+
+using radix_histogram = std::array<std::size_t, radix_buckets>;
+
+template <typename K>
+using radix_histograms = std::array<radix_histogram, sizeof(radix_bits_t<K>)>;
+
+// every key of the n has the same digit, so the pass would not move anything
+inline bool radix_trivial(const radix_histogram& counts, std::size_t n) noexcept
+{
+    for(std::size_t count : counts) {
+        if(count != 0) {
+            return count == n;
+        }
+    }
+    return true;
+}
+
+// counts of every digit of [first, last)
+template <typename K, typename It, typename Projection>
+void radix_count(It first, It last, Projection& proj, radix_histograms<K>& counts)
+{
+    for(; first != last; ++first) {
+        const auto bits = radix_key<K>(proj(*first));
+        for(std::size_t d = 0; d < counts.size(); ++d) {
+            ++counts[d][radix_digit(bits, d)];
+        }
+    }
+}
+
+// counts of digit d of [first, last)
+template <typename K, typename It, typename Projection>
+void radix_count_digit(It first, It last, Projection& proj, std::size_t d, radix_histogram& counts)
+{
+    counts = {};
+    for(; first != last; ++first) {
+        ++counts[radix_digit(radix_key<K>(proj(*first)), d)];
+    }
+}
+
+// move [first, last) to dest by digit d, offsets[digit] is the next position of each digit
+template <typename K, typename It, typename OutIt, typename Projection>
+void radix_scatter(It first, It last, OutIt dest, Projection& proj, std::size_t d, radix_histogram& offsets)
+{
+    for(; first != last; ++first) {
+        const std::size_t digit = radix_digit(radix_key<K>(proj(*first)), d);
+        dest[static_cast<std::ptrdiff_t>(offsets[digit]++)] = std::move(*first);
+    }
+}
+
+// radix_scatter into uninitialized storage, move constructing.
+// If a constructor throws, each digit's elements constructed so far end at offsets[digit].
+template <typename K, typename It, typename T, typename Projection>
+void radix_scatter_construct(It first, It last, T* dest, Projection& proj, std::size_t d, radix_histogram& offsets)
+{
+    for(; first != last; ++first) {
+        const std::size_t digit = radix_digit(radix_key<K>(proj(*first)), d);
+        ::new(static_cast<void*>(dest + offsets[digit])) T(std::move(*first));
+        ++offsets[digit];
+    }
+}
+
+template <typename T>
+void radix_destroy_scattered(T* dest, const radix_histogram& starts, const radix_histogram& offsets) noexcept
+{
+    for(std::size_t b = 0; b < radix_buckets; ++b) {
+        std::destroy(dest + starts[b], dest + offsets[b]);
+    }
+}
+
+// n elements of storage, constructed by the first scatter into it, so T is never default constructed
+template <typename T>
+class radix_buffer
+{
+public:
+    explicit radix_buffer(std::size_t n)
+        : _data { std::allocator<T>{}.allocate(n) }, _size { n }, _constructed { false }
+    {}
+
+    radix_buffer(const radix_buffer&) = delete;
+    radix_buffer& operator=(const radix_buffer&) = delete;
+
+    ~radix_buffer()
+    {
+        if(_constructed) {
+            std::destroy(_data, _data + _size);
+        }
+        std::allocator<T>{}.deallocate(_data, _size);
+    }
+
+    T* begin() const noexcept { return _data; }
+    T* end() const noexcept { return _data + _size; }
+
+    bool constructed() const noexcept { return _constructed; }
+    void set_constructed() noexcept { _constructed = true; }
+
+private:
+    T* _data;
+    std::size_t _size;
+    bool _constructed;
+};
+
+template <typename K, typename RandomIt, typename Projection>
+void radix_insertion_sort(RandomIt first, RandomIt last, Projection& proj)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto less = [&proj](const T& a, const T& b) {
+        return radix_key<K>(proj(a)) < radix_key<K>(proj(b));
+    };
+    insertion_sort(first, last, less);
+}
+
+template <typename K, typename RandomIt, typename Projection>
+void radix_sort_sequential(RandomIt first, RandomIt last, Projection& proj)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    if(n <= radix_sort_min) {
+        radix_insertion_sort<K>(first, last, proj);
+        return;
+    }
+
+    radix_histograms<K> counts {};
+    radix_count<K>(first, last, proj, counts);
+
+    radix_buffer<T> buffer(n);
+    bool inBuffer = false;
+    for(std::size_t d = 0; d < counts.size(); ++d) {
+        if(radix_trivial(counts[d], n)) {
+            continue;
+        }
+        radix_histogram offsets;
+        std::size_t offset = 0;
+        for(std::size_t b = 0; b < radix_buckets; ++b) {
+            offsets[b] = offset;
+            offset += counts[d][b];
+        }
+        if(inBuffer) {
+            radix_scatter<K>(buffer.begin(), buffer.end(), first, proj, d, offsets);
+        }
+        else if(buffer.constructed()) {
+            radix_scatter<K>(first, last, buffer.begin(), proj, d, offsets);
+        }
+        else {
+#ifdef CGS_DETAIL_EXCEPTIONS
+            const radix_histogram starts = offsets;
+            try {
+                radix_scatter_construct<K>(first, last, buffer.begin(), proj, d, offsets);
+            }
+            catch(...) {
+                radix_destroy_scattered(buffer.begin(), starts, offsets);
+                throw;
+            }
+#else
+            // without exceptions the constructors can not fail
+            radix_scatter_construct<K>(first, last, buffer.begin(), proj, d, offsets);
+#endif
+            buffer.set_constructed();
+        }
+        inBuffer = !inBuffer;
+    }
+    if(inBuffer) {
+        std::move(buffer.begin(), buffer.end(), first);
+    }
+}
+
+// Each chunk counts its digits, then scatters its elements after the same digit of the chunks before it,
+// so the passes stay stable
+template <typename K, typename RandomIt, typename Projection>
+void parallel_radix_sort(thread_pool& pool, std::size_t minChunk, RandomIt first, RandomIt last, Projection& proj)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    const auto n = static_cast<std::size_t>(last - first);
+    const std::size_t chunks = parallel_chunks(pool, minChunk, n);
+    if(chunks <= 1) {
+        radix_sort_sequential<K>(first, last, proj);
+        return;
+    }
+
+    std::vector<radix_histograms<K>> chunkCounts(chunks);
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        const auto chunk = parallel_chunk(first, n, chunks, c);
+        chunkCounts[c] = {};
+        radix_count<K>(chunk.first, chunk.second, proj, chunkCounts[c]);
+    });
+
+    // the digits of all keys, whatever their order
+    radix_histograms<K> counts {};
+    for(const auto& chunkCount : chunkCounts) {
+        for(std::size_t d = 0; d < counts.size(); ++d) {
+            for(std::size_t b = 0; b < radix_buckets; ++b) {
+                counts[d][b] += chunkCount[d][b];
+            }
+        }
+    }
+
+    radix_buffer<T> buffer(n);
+    std::vector<radix_histogram> offsets(chunks);
+    bool inBuffer = false;
+    // each chunk's counts are of the input order, until the first pass moves elements between chunks
+    bool moved = false;
+    for(std::size_t d = 0; d < counts.size(); ++d) {
+        if(radix_trivial(counts[d], n)) {
+            continue;
+        }
+        if(moved) {
+            pool.parallel_for(chunks, [&](std::size_t c) {
+                if(inBuffer) {
+                    const auto chunk = parallel_chunk(buffer.begin(), n, chunks, c);
+                    radix_count_digit<K>(chunk.first, chunk.second, proj, d, chunkCounts[c][d]);
+                }
+                else {
+                    const auto chunk = parallel_chunk(first, n, chunks, c);
+                    radix_count_digit<K>(chunk.first, chunk.second, proj, d, chunkCounts[c][d]);
+                }
+            });
+        }
+
+        std::size_t offset = 0;
+        for(std::size_t b = 0; b < radix_buckets; ++b) {
+            for(std::size_t c = 0; c < chunks; ++c) {
+                offsets[c][b] = offset;
+                offset += chunkCounts[c][d][b];
+            }
+        }
+
+        if(inBuffer || buffer.constructed()) {
+            pool.parallel_for(chunks, [&](std::size_t c) {
+                if(inBuffer) {
+                    const auto chunk = parallel_chunk(buffer.begin(), n, chunks, c);
+                    radix_scatter<K>(chunk.first, chunk.second, first, proj, d, offsets[c]);
+                }
+                else {
+                    const auto chunk = parallel_chunk(first, n, chunks, c);
+                    radix_scatter<K>(chunk.first, chunk.second, buffer.begin(), proj, d, offsets[c]);
+                }
+            });
+        }
+        else {
+            const auto construct = [&](std::size_t c) {
+                const auto chunk = parallel_chunk(first, n, chunks, c);
+                radix_scatter_construct<K>(chunk.first, chunk.second, buffer.begin(), proj, d, offsets[c]);
+            };
+#ifdef CGS_DETAIL_EXCEPTIONS
+            // parallel_for returns after every chunk stops, so on a throw each one's offsets are final
+            const std::vector<radix_histogram> starts = offsets;
+            try {
+                pool.parallel_for(chunks, construct);
+            }
+            catch(...) {
+                for(std::size_t c = 0; c < chunks; ++c) {
+                    radix_destroy_scattered(buffer.begin(), starts[c], offsets[c]);
+                }
+                throw;
+            }
+#else
+            // without exceptions the constructors can not fail
+            pool.parallel_for(chunks, construct);
+#endif
+            buffer.set_constructed();
+        }
+        inBuffer = !inBuffer;
+        moved = true;
+    }
+    if(inBuffer) {
+        pool.parallel_for(chunks, [&](std::size_t c) {
+            const auto chunk = parallel_chunk(buffer.begin(), n, chunks, c);
+            std::move(chunk.first, chunk.second, first + (chunk.first - buffer.begin()));
+        });
+    }
+}
+
+template <typename RandomIt, typename Projection>
+using radix_key_t = std::decay_t<decltype(std::declval<Projection&>()(*std::declval<RandomIt>()))>;
+
+} // namespace detail
+
+/**
+ * @brief Stable sort of [first, last) by proj(element), an integer, enum, float or double key, with LSD radix sort.
+ *
+ * O(n) time for each byte of the key whose value varies, and a buffer of n elements,
+ * move constructed by the first pass, so elements need not be default constructible.
+ * Float keys are ordered -0 before +0, NaNs by sign at the ends.
+ */
+template <typename RandomIt, typename Sentinal, typename Projection = detail::radix_identity>
+void radix_sort(RandomIt first, Sentinal last, Projection proj = {})
+{
+    using K = detail::radix_key_t<RandomIt, Projection>;
+    static_assert(detail::is_radix_key_v<K>, "radix_sort keys are integers, enums, float or double");
+    detail::radix_sort_sequential<K>(first, detail::sort_end(first, last), proj);
+}
+
+template <typename RandomIt, typename Sentinal, typename Projection = detail::radix_identity>
+void radix_sort(const execution::sequenced_policy&, RandomIt first, Sentinal last, Projection proj = {})
+{
+    cgs::radix_sort(first, last, proj);
+}
+
+template <typename RandomIt, typename Sentinal, typename Projection = detail::radix_identity>
+void radix_sort(const execution::unsequenced_policy&, RandomIt first, Sentinal last, Projection proj = {})
+{
+    cgs::radix_sort(first, last, proj);
+}
+
+/**
+ * @brief radix_sort, counting and scattering chunks of [first, last) on policy.pool.
+ *
+ * proj is called concurrently.
+ */
+template <typename RandomIt, typename Sentinal, typename Projection = detail::radix_identity>
+void radix_sort(const execution::parallel_policy& policy, RandomIt first, Sentinal last, Projection proj = {})
+{
+    using K = detail::radix_key_t<RandomIt, Projection>;
+    static_assert(detail::is_radix_key_v<K>, "radix_sort keys are integers, enums, float or double");
+    detail::parallel_radix_sort<K>(detail::policy_pool(policy), policy.min_chunk,
+        first, detail::sort_end(first, last), proj);
+}
+
+/**
+ * @brief Same as radix_sort with parallel_policy.
+ */
+template <typename RandomIt, typename Sentinal, typename Projection = detail::radix_identity>
+void radix_sort(const execution::parallel_unsequenced_policy& policy, RandomIt first, Sentinal last, Projection proj = {})
+{
+    using K = detail::radix_key_t<RandomIt, Projection>;
+    static_assert(detail::is_radix_key_v<K>, "radix_sort keys are integers, enums, float or double");
+    detail::parallel_radix_sort<K>(detail::policy_pool(policy), policy.min_chunk,
+        first, detail::sort_end(first, last), proj);
+}
+
+} // namespace cgs
+
+#endif // CGS_RADIX_SORT_HPP
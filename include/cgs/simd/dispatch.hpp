@@ -0,0 +1,302 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_SIMD_DISPATCH_HPP
+#define CGS_SIMD_DISPATCH_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/simd/isa.hpp"
+
+#include <atomic>
+#include <cstdlib> // getenv
+#include <cstring> // strcmp
+#include <mutex>
+#include <utility> // forward
+
+/*
+Runtime ISA dispatch, so one binary uses the best kernel on every CPU, without -march flags.
+
+Compile a kernel once per ISA, by calling a template from functions marked `CGS_TARGET_*`.
+These enable the ISA for that function only, and inline everything it calls,
+so packs wider than the compile flags allow still get full width registers.
+Then put the variants in a `dispatch` table, which picks the best one for the running CPU (using cpuid)
+when it is constructed, so each call is one indirect call.
+
+    template <std::size_t Width> float sum(const float* p, std::size_t n);
+
+    CGS_TARGET_AVX2 float sum_avx2(const float* p, std::size_t n) { return sum<8>(p, n); }
+
+    float sum_dispatched(const float* p, std::size_t n)
+    {
+        static const cgs::simd::dispatch<float(const float*, std::size_t)> table { &sum<4>, nullptr, &sum_avx2 };
+        return table(p, n);
+    }
+
+To test each variant on one machine, cap the ISA with `force_isa`,
+or set the environment variable `CGS_SIMD_ISA` to `baseline`, `sse2`, `avx2`, or `avx512`.
+*/
+
+#if defined(CGS_SIMD_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+    #define CGS_SIMD_DISPATCH
+    #define CGS_TARGET_SSE2 __attribute__((target("sse2"), flatten))
+    #define CGS_TARGET_AVX2 __attribute__((target("avx2,fma"), flatten))
+    #define CGS_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma"), flatten))
+#endif
+
+namespace cgs
+{
+namespace simd
+{
+
+/**
+ * @brief Instruction set levels for dispatch, each includes the ones before it.
+ *
+ * `baseline` is whatever the compile flags enable.
+ */
+enum class isa
+{
+    baseline,
+    sse2,
+    avx2,
+    avx512,
+};
+
+inline const char* to_string(isa level) noexcept
+{
+    switch(level) {
+        case isa::baseline: return "baseline";
+        case isa::sse2: return "sse2";
+        case isa::avx2: return "avx2";
+        case isa::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+isa current_isa() noexcept;
+isa force_isa(isa level) noexcept;
+
+namespace detail
+{
+
+inline isa detect_isa_uncached() noexcept
+{
+#ifdef CGS_SIMD_DISPATCH
+    // may run before libgcc's constructor, during static initialization
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return isa::avx512;
+    }
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return isa::avx2;
+    }
+    if(__builtin_cpu_supports("sse2")) {
+        return isa::sse2;
+    }
+#endif
+    return isa::baseline;
+}
+
+// CGS_SIMD_ISA, or avx512 (no cap) if unset or unknown
+inline isa environment_isa() noexcept
+{
+    const char* value = std::getenv("CGS_SIMD_ISA");
+    if(value) {
+        for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+            if(std::strcmp(value, to_string(level)) == 0) {
+                return level;
+            }
+        }
+    }
+    return isa::avx512;
+}
+
+inline isa min_isa(isa a, isa b) noexcept
+{
+    return static_cast<int>(a) < static_cast<int>(b) ? a : b;
+}
+
+// dispatch tables, in a list so force_isa can resolve them again
+class dispatch_node
+{
+private:
+
+    dispatch_node* _next {};
+    dispatch_node* _prev {};
+
+    static dispatch_node*& head() noexcept
+    {
+        static dispatch_node* list {};
+        return list;
+    }
+
+protected:
+
+    static std::mutex& list_mutex() noexcept
+    {
+        static std::mutex mutex {};
+        return mutex;
+    }
+
+    static std::atomic<isa>& current() noexcept
+    {
+        static std::atomic<isa> level { min_isa(detect_isa_uncached(), environment_isa()) };
+        return level;
+    }
+
+    dispatch_node() = default;
+    dispatch_node(const dispatch_node&) = delete;
+    dispatch_node& operator=(const dispatch_node&) = delete;
+    virtual ~dispatch_node() = default;
+
+    // with list_mutex locked
+    void attach() noexcept
+    {
+        _next = head();
+        if(_next) {
+            _next->_prev = this;
+        }
+        head() = this;
+    }
+
+    // with list_mutex locked
+    void detach() noexcept
+    {
+        if(_prev) {
+            _prev->_next = _next;
+        }
+        else {
+            head() = _next;
+        }
+        if(_next) {
+            _next->_prev = _prev;
+        }
+    }
+
+    virtual void resolve(isa level) noexcept = 0;
+
+    friend isa simd::force_isa(isa level) noexcept;
+    friend isa simd::current_isa() noexcept;
+};
+
+} // namespace detail
+
+/**
+ * @brief Highest level the running CPU and OS support.
+ */
+inline isa detect_isa() noexcept
+{
+    static const isa detected = detail::detect_isa_uncached();
+    return detected;
+}
+
+/**
+ * @brief Level dispatch tables currently use.
+ */
+inline isa current_isa() noexcept
+{
+    return detail::dispatch_node::current().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Use at most `level` in every dispatch table, to test lower ISA kernels.
+ *
+ * Levels the CPU does not support are clamped to detect_isa().
+ * Not meant to be called while other threads are dispatching.
+ *
+ * @return The level now in use.
+ */
+inline isa force_isa(isa level) noexcept
+{
+    const isa effective = detail::min_isa(level, detect_isa());
+
+    std::lock_guard<std::mutex> lock { detail::dispatch_node::list_mutex() };
+    detail::dispatch_node::current().store(effective, std::memory_order_relaxed);
+    for(detail::dispatch_node* node = detail::dispatch_node::head(); node; node = node->_next) {
+        node->resolve(effective);
+    }
+    return effective;
+}
+
+template <typename Signature>
+class dispatch;
+
+/**
+ * @brief Function pointer per ISA, resolved to the best supported one on construction.
+ *
+ * Null entries fall back to the next lower ISA, the baseline entry is required.
+ */
+template <typename R, typename... Args>
+class dispatch<R(Args...)> final : private detail::dispatch_node
+{
+public:
+
+    using function_type = R (*)(Args...);
+
+private:
+
+    function_type _table[4];
+    std::atomic<function_type> _resolved;
+
+    void resolve(isa level) noexcept override
+    {
+        for(int i = static_cast<int>(level); i >= 0; --i) {
+            if(_table[i]) {
+                _resolved.store(_table[i], std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+public:
+
+    explicit dispatch(function_type baseline,
+                      function_type sse2 = nullptr,
+                      function_type avx2 = nullptr,
+                      function_type avx512 = nullptr)
+        : _table{ baseline, sse2, avx2, avx512 }
+        , _resolved{ baseline }
+    {
+        cgs_assert(baseline);
+
+        std::lock_guard<std::mutex> lock { list_mutex() };
+        attach();
+        resolve(current_isa());
+    }
+
+    ~dispatch()
+    {
+        std::lock_guard<std::mutex> lock { list_mutex() };
+        detach();
+    }
+
+    /**
+     * @brief The resolved function.
+     */
+    function_type get() const noexcept
+    {
+        return _resolved.load(std::memory_order_relaxed);
+    }
+
+    R operator()(Args... args) const
+    {
+        return get()(std::forward<Args>(args)...);
+    }
+};
+
+} // namespace simd
+} // namespace cgs
+
+#endif // CGS_SIMD_DISPATCH_HPP
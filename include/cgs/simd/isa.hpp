@@ -0,0 +1,75 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_SIMD_ISA_HPP
+#define CGS_SIMD_ISA_HPP
+
+/*
+Instruction sets enabled at compile time.
+
+We only use intrinsics with GCC and clang, which share the x86 vector extension types
+(`__m128` is a `float __attribute__((vector_size(16)))`).
+Everything else gets the scalar fallback.
+
+Defines:
+* `CGS_SIMD_VECTOR_EXTENSIONS` GCC style `vector_size` types, on any architecture
+* `CGS_SIMD_SSE`    SSE, 4 x float
+* `CGS_SIMD_SSE2`   SSE2, integers and doubles in 128 bits
+* `CGS_SIMD_SSE41`  SSE4.1, blends and 32 bit integer min/max/mul
+* `CGS_SIMD_AVX`    AVX, floats and doubles in 256 bits
+* `CGS_SIMD_AVX2`   AVX2, integers in 256 bits
+* `CGS_SIMD_FMA`    fused multiply add
+* `CGS_SIMD_F16C`   conversions between float and binary16
+* `CGS_SIMD_AVX512` AVX-512 F, BW, DQ and VL, everything in 512 bits with mask registers
+
+Define `CGS_SIMD_DISABLE` to force the scalar fallback everywhere.
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(CGS_SIMD_DISABLE)
+    #define CGS_SIMD_VECTOR_EXTENSIONS
+#endif
+
+#if defined(CGS_SIMD_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+
+    #include <immintrin.h>
+
+    #ifdef __SSE__
+        #define CGS_SIMD_SSE
+    #endif
+    #ifdef __SSE2__
+        #define CGS_SIMD_SSE2
+    #endif
+    #ifdef __SSE4_1__
+        #define CGS_SIMD_SSE41
+    #endif
+    #ifdef __AVX__
+        #define CGS_SIMD_AVX
+    #endif
+    #ifdef __AVX2__
+        #define CGS_SIMD_AVX2
+    #endif
+    #ifdef __FMA__
+        #define CGS_SIMD_FMA
+    #endif
+    #ifdef __F16C__
+        #define CGS_SIMD_F16C
+    #endif
+    #if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+        #define CGS_SIMD_AVX512
+    #endif
+
+#endif
+
+#endif // CGS_SIMD_ISA_HPP
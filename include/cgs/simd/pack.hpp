@@ -0,0 +1,808 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_SIMD_PACK_HPP
+#define CGS_SIMD_PACK_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/meta/constexpr.hpp"
+#include "cgs/meta/invocable.hpp" // enable_if_t
+#include "cgs/simd/isa.hpp"
+
+#include <array>
+#include <cstddef> // size_t
+#include <cstdint> // int8_t ... int64_t, uintptr_t
+#include <functional> // plus, minus, multiplies, divides
+#include <type_traits>
+#include <utility> // index_sequence
+
+/*
+pack<T, N> is N lanes of T, for T in int8_t ... int64_t (signed or unsigned), float, or double.
+
+At runtime, operations are GCC vector extensions.
+The compiler picks instructions for the enabled ISA,
+and splits a pack wider than the registers into several registers.
+
+Under constant evaluation, lanes are read out to plain arrays and computed one at a time,
+so the same kernel source runs in constexpr algorithms.
+*/
+
+namespace cgs
+{
+namespace simd
+{
+
+namespace detail
+{
+
+template <std::size_t Bytes> struct int_of_size;
+template <> struct int_of_size<1> { using type = std::int8_t; };
+template <> struct int_of_size<2> { using type = std::int16_t; };
+template <> struct int_of_size<4> { using type = std::int32_t; };
+template <> struct int_of_size<8> { using type = std::int64_t; };
+
+template <std::size_t Bytes>
+using int_of_size_t = typename int_of_size<Bytes>::type;
+
+template <typename T>
+inline constexpr bool is_pack_element_v =
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+    || std::is_same<T, float>::value
+    || std::is_same<T, double>::value;
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+template <typename T, std::size_t N>
+struct native_vector
+{
+    typedef T type __attribute__((vector_size(sizeof(T) * N)));
+};
+#else
+template <typename T, std::size_t N>
+struct native_vector
+{
+    struct type
+    {
+        alignas(sizeof(T) * N) T v[N];
+
+        constexpr T operator[](std::size_t i) const
+        {
+            return v[i];
+        }
+    };
+};
+#endif
+
+// bytes in the widest register enabled for T
+template <typename T>
+constexpr std::size_t native_bytes()
+{
+#if defined(CGS_SIMD_AVX512)
+    return 64;
+#elif defined(CGS_SIMD_AVX2)
+    return 32;
+#elif defined(CGS_SIMD_AVX)
+    return std::is_floating_point<T>::value ? 32 : 16;
+#else
+    return 16;
+#endif
+}
+
+} // namespace detail
+
+template <typename T>
+inline constexpr std::size_t sse2_width_v = 16 / sizeof(T);
+
+template <typename T>
+inline constexpr std::size_t avx2_width_v = 32 / sizeof(T);
+
+template <typename T>
+inline constexpr std::size_t avx512_width_v = 64 / sizeof(T);
+
+/**
+ * @brief Lanes of T in the widest register enabled at compile time.
+ *
+ * Without SIMD, this is the SSE2 width, so kernels still get independent lanes to unroll.
+ */
+template <typename T>
+inline constexpr std::size_t native_width_v = detail::native_bytes<T>() / sizeof(T);
+
+template <typename T, std::size_t N>
+class pack;
+
+template <typename T>
+using native_pack = pack<T, native_width_v<T>>;
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+namespace detail
+{
+
+template <typename Native, typename T>
+void masked_load(Native& out, const T* p, std::size_t count);
+
+template <typename Native, typename T>
+void masked_store(const Native& v, T* p, std::size_t count);
+
+} // namespace detail
+#endif
+
+template <typename T, std::size_t N>
+class pack
+{
+    static_assert(detail::is_pack_element_v<T>, "pack lanes must be integers, float, or double");
+    static_assert(N > 0 && (N & (N - 1)) == 0, "pack width must be a power of 2");
+
+public:
+
+    using value_type = T;
+    using native_type = typename detail::native_vector<T, N>::type;
+
+    /**
+     * @brief Result of comparisons, each lane is all ones (true) or zero (false).
+     */
+    using mask_type = pack<detail::int_of_size_t<sizeof(T)>, N>;
+
+    static constexpr std::size_t width = N;
+
+private:
+
+    native_type _v;
+
+    template <typename F, std::size_t... I>
+    static constexpr pack generate_impl(F& f, std::index_sequence<I...>)
+    {
+        return pack{ native_type{ static_cast<T>(f(I))... } };
+    }
+
+public:
+
+    constexpr pack() noexcept
+        : _v{}
+    { }
+
+    /**
+     * @brief Broadcast s to every lane.
+     */
+    constexpr explicit pack(T s) noexcept
+        : pack(generate([s](std::size_t) { return s; }))
+    { }
+
+    constexpr explicit pack(const std::array<T, N>& lanes) noexcept
+        : pack(generate([&lanes](std::size_t i) { return lanes[i]; }))
+    { }
+
+    constexpr explicit pack(const native_type& v) noexcept
+        : _v(v)
+    { }
+
+    /**
+     * @brief Lane i is f(i).
+     */
+    template <typename F>
+    static constexpr pack generate(F f)
+    {
+        return generate_impl(f, std::make_index_sequence<N>{});
+    }
+
+    /**
+     * @brief Load N lanes, p must be aligned to alignof(pack).
+     */
+    static constexpr pack load(const T* p)
+    {
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            cgs_assert(reinterpret_cast<std::uintptr_t>(p) % alignof(native_type) == 0);
+            native_type v {};
+            __builtin_memcpy(&v, __builtin_assume_aligned(p, alignof(native_type)), sizeof(v));
+            return pack{v};
+        }
+#endif
+        return generate([p](std::size_t i) { return p[i]; });
+    }
+
+    /**
+     * @brief Load N lanes, p may be unaligned.
+     */
+    static constexpr pack loadu(const T* p)
+    {
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            native_type v {};
+            __builtin_memcpy(&v, p, sizeof(v));
+            return pack{v};
+        }
+#endif
+        return generate([p](std::size_t i) { return p[i]; });
+    }
+
+    /**
+     * @brief Load the first `count` lanes, and zero the rest.
+     *
+     * Never touches memory past p + count, so it can load the tail of an array.
+     * Uses masked loads with AVX-512 or AVX.
+     */
+    static constexpr pack load_partial(const T* p, std::size_t count)
+    {
+        count = count < N ? count : N;
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            native_type v {};
+            detail::masked_load(v, p, count);
+            return pack{v};
+        }
+#endif
+        return generate([p, count](std::size_t i) { return i < count ? p[i] : T{}; });
+    }
+
+    /**
+     * @brief Store N lanes, p must be aligned to alignof(pack).
+     */
+    constexpr void store(T* p) const
+    {
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            cgs_assert(reinterpret_cast<std::uintptr_t>(p) % alignof(native_type) == 0);
+            __builtin_memcpy(__builtin_assume_aligned(p, alignof(native_type)), &_v, sizeof(_v));
+            return;
+        }
+#endif
+        for(std::size_t i = 0; i < N; ++i) {
+            p[i] = _v[i];
+        }
+    }
+
+    /**
+     * @brief Store N lanes, p may be unaligned.
+     */
+    constexpr void storeu(T* p) const
+    {
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            __builtin_memcpy(p, &_v, sizeof(_v));
+            return;
+        }
+#endif
+        for(std::size_t i = 0; i < N; ++i) {
+            p[i] = _v[i];
+        }
+    }
+
+    /**
+     * @brief Store the first `count` lanes.
+     *
+     * Never touches memory past p + count, so it can store the tail of an array.
+     * Uses masked stores with AVX-512 or AVX.
+     */
+    constexpr void store_partial(T* p, std::size_t count) const
+    {
+        count = count < N ? count : N;
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+        if(!cgs::is_constant_evaluated()) {
+            detail::masked_store(_v, p, count);
+            return;
+        }
+#endif
+        for(std::size_t i = 0; i < count; ++i) {
+            p[i] = _v[i];
+        }
+    }
+
+    constexpr const native_type& native() const noexcept
+    {
+        return _v;
+    }
+
+    constexpr T operator[](std::size_t i) const
+    {
+        cgs_assert(i < N);
+        return _v[i];
+    }
+
+    constexpr std::array<T, N> to_array() const noexcept
+    {
+        std::array<T, N> result {};
+        for(std::size_t i = 0; i < N; ++i) {
+            result[i] = _v[i];
+        }
+        return result;
+    }
+};
+
+namespace detail
+{
+
+template <typename T, std::size_t N, typename Op>
+constexpr pack<T, N> lanewise(const pack<T, N>& a, Op op)
+{
+    return pack<T, N>::generate([&](std::size_t i) { return op(a[i]); });
+}
+
+template <typename T, std::size_t N, typename Op>
+constexpr pack<T, N> lanewise(const pack<T, N>& a, const pack<T, N>& b, Op op)
+{
+    return pack<T, N>::generate([&](std::size_t i) { return op(a[i], b[i]); });
+}
+
+template <typename T, std::size_t N, typename Op>
+constexpr typename pack<T, N>::mask_type compare(const pack<T, N>& a, const pack<T, N>& b, Op op)
+{
+    return pack<T, N>::mask_type::generate([&](std::size_t i) { return op(a[i], b[i]) ? -1 : 0; });
+}
+
+} // namespace detail
+
+template <typename T, std::size_t N>
+constexpr pack<T, N> operator+(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() + b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, std::plus<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr pack<T, N> operator-(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() - b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, std::minus<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr pack<T, N> operator*(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() * b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, std::multiplies<>{});
+}
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+namespace detail
+{
+
+// x86 has no integer vector division, the compiler would divide one lane at a time.
+// For 32 bits and less, the floating point quotient truncates to the exact integer one:
+// its rounding error is below 1 / d, the distance to the next integer.
+template <typename T, std::size_t N>
+pack<T, N> divide_integers(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+    using native_type = typename pack<T, N>::native_type;
+    using F = std::conditional_t<sizeof(T) <= 2, float, double>;
+    using float_type = typename native_vector<F, N>::type;
+    return pack<T, N>{ __builtin_convertvector(
+        __builtin_convertvector(a.native(), float_type) / __builtin_convertvector(b.native(), float_type),
+        native_type) };
+}
+
+} // namespace detail
+#endif
+
+/**
+ * @brief Lane-wise a / b, integers truncate like scalar division.
+ */
+template <typename T, std::size_t N>
+constexpr pack<T, N> operator/(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        if constexpr(std::is_integral<T>::value && sizeof(T) <= 4) {
+            return detail::divide_integers(a, b);
+        }
+        else {
+            return pack<T, N>{a.native() / b.native()};
+        }
+    }
+#endif
+    return detail::lanewise(a, b, std::divides<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr pack<T, N> operator-(const pack<T, N>& a) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{-a.native()};
+    }
+#endif
+    return detail::lanewise(a, [](T x) { return -x; });
+}
+
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator&(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() & b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, [](T x, T y) { return x & y; });
+}
+
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator|(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() | b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, [](T x, T y) { return x | y; });
+}
+
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator^(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() ^ b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, [](T x, T y) { return x ^ y; });
+}
+
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator~(const pack<T, N>& a) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{~a.native()};
+    }
+#endif
+    return detail::lanewise(a, [](T x) { return ~x; });
+}
+
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator<<(const pack<T, N>& a, int shift) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() << shift};
+    }
+#endif
+    return detail::lanewise(a, [shift](T x) { return x << shift; });
+}
+
+/**
+ * @brief Arithmetic shift for signed lanes, logical shift for unsigned lanes.
+ */
+template <typename T, std::size_t N>
+constexpr std::enable_if_t<std::is_integral<T>::value,
+    pack<T, N>> operator>>(const pack<T, N>& a, int shift) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() >> shift};
+    }
+#endif
+    return detail::lanewise(a, [shift](T x) { return x >> shift; });
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator==(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        using mask = typename pack<T, N>::mask_type;
+        return mask{typename mask::native_type(a.native() == b.native())};
+    }
+#endif
+    return detail::compare(a, b, std::equal_to<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator!=(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        using mask = typename pack<T, N>::mask_type;
+        return mask{typename mask::native_type(a.native() != b.native())};
+    }
+#endif
+    return detail::compare(a, b, std::not_equal_to<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator<(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        using mask = typename pack<T, N>::mask_type;
+        return mask{typename mask::native_type(a.native() < b.native())};
+    }
+#endif
+    return detail::compare(a, b, std::less<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator<=(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        using mask = typename pack<T, N>::mask_type;
+        return mask{typename mask::native_type(a.native() <= b.native())};
+    }
+#endif
+    return detail::compare(a, b, std::less_equal<>{});
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator>(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+    return b < a;
+}
+
+template <typename T, std::size_t N>
+constexpr typename pack<T, N>::mask_type operator>=(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+    return b <= a;
+}
+
+/**
+ * @brief Lane-wise `mask ? a : b`.
+ */
+template <typename T, std::size_t N>
+constexpr pack<T, N> select(const typename pack<T, N>::mask_type& mask, const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{mask.native() ? a.native() : b.native()};
+    }
+#endif
+    return pack<T, N>::generate([&](std::size_t i) { return mask[i] ? a[i] : b[i]; });
+}
+
+/**
+ * @brief Lane-wise `(a < b) ? a : b`, same as cgs::min2 and vec4's min.
+ */
+template <typename T, std::size_t N>
+constexpr pack<T, N> min(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() < b.native() ? a.native() : b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, [](T x, T y) { return (x < y) ? x : y; });
+}
+
+/**
+ * @brief Lane-wise `(a > b) ? a : b`, same as vec4's max.
+ */
+template <typename T, std::size_t N>
+constexpr pack<T, N> max(const pack<T, N>& a, const pack<T, N>& b) noexcept
+{
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+    if(!cgs::is_constant_evaluated()) {
+        return pack<T, N>{a.native() > b.native() ? a.native() : b.native()};
+    }
+#endif
+    return detail::lanewise(a, b, [](T x, T y) { return (x > y) ? x : y; });
+}
+
+/**
+ * @brief Is any lane of a comparison mask true?
+ */
+template <typename T, std::size_t N>
+constexpr bool any(const pack<T, N>& mask) noexcept
+{
+#ifdef CGS_SIMD_SSE2
+    if constexpr(sizeof(mask) % 16 == 0) {
+        if(!cgs::is_constant_evaluated()) {
+            // or all 16 byte chunks together, then test the sign bits
+            const auto v = mask.native();
+            const char* bytes = reinterpret_cast<const char*>(&v);
+            __m128i acc = _mm_setzero_si128();
+            for(std::size_t i = 0; i < sizeof(v); i += 16) {
+                acc = _mm_or_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)));
+            }
+            return _mm_movemask_epi8(acc) != 0;
+        }
+    }
+#endif
+    for(std::size_t i = 0; i < N; ++i) {
+        if(mask[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Is every lane of a comparison mask true?
+ */
+template <typename T, std::size_t N>
+constexpr bool all(const pack<T, N>& mask) noexcept
+{
+#ifdef CGS_SIMD_SSE2
+    if constexpr(sizeof(mask) % 16 == 0) {
+        if(!cgs::is_constant_evaluated()) {
+            // and all 16 byte chunks together, then test the sign bits
+            const auto v = mask.native();
+            const char* bytes = reinterpret_cast<const char*>(&v);
+            __m128i acc = _mm_set1_epi32(-1);
+            for(std::size_t i = 0; i < sizeof(v); i += 16) {
+                acc = _mm_and_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)));
+            }
+            return _mm_movemask_epi8(acc) == 0xFFFF;
+        }
+    }
+#endif
+    for(std::size_t i = 0; i < N; ++i) {
+        if(!mask[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Combine lanes with binaryOp, pairwise: ((0 op N/2) op (N/4 op 3N/4)) ...
+ *
+ * The order is fixed, so the runtime result matches constant evaluation.
+ */
+template <typename T, std::size_t N, typename BinaryOp>
+constexpr T reduce(const pack<T, N>& p, BinaryOp binaryOp)
+{
+    T lanes[N] {};
+    for(std::size_t i = 0; i < N; ++i) {
+        lanes[i] = p[i];
+    }
+    for(std::size_t half = N / 2; half > 0; half /= 2) {
+        for(std::size_t i = 0; i < half; ++i) {
+            lanes[i] = static_cast<T>(binaryOp(lanes[i], lanes[i + half]));
+        }
+    }
+    return lanes[0];
+}
+
+#ifdef CGS_SIMD_VECTOR_EXTENSIONS
+namespace detail
+{
+
+#ifdef CGS_SIMD_AVX
+// 8 set lanes then 8 clear lanes,
+// a 32 bit lane mask with the first `count` lanes set starts at (8 - count)
+alignas(64) inline constexpr std::int32_t tail_mask_table[16] {
+    -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  0,  0,  0,  0,  0,  0,  0,
+};
+#endif
+
+#ifdef CGS_SIMD_AVX512
+// the first `bytes` bits set
+inline std::uint64_t byte_mask(std::size_t bytes)
+{
+    return bytes >= 64 ? ~std::uint64_t{} : (std::uint64_t{1} << bytes) - 1;
+}
+#endif
+
+template <typename Native, typename T>
+void masked_load(Native& out, const T* p, std::size_t count)
+{
+    constexpr std::size_t bytes = sizeof(Native);
+
+#ifdef CGS_SIMD_AVX512
+    if constexpr(bytes == 64) {
+        const __m512i v = _mm512_maskz_loadu_epi8(byte_mask(count * sizeof(T)), p);
+        __builtin_memcpy(&out, &v, bytes);
+        return;
+    }
+    else if constexpr(bytes == 32) {
+        const __m256i v = _mm256_maskz_loadu_epi8(static_cast<__mmask32>(byte_mask(count * sizeof(T))), p);
+        __builtin_memcpy(&out, &v, bytes);
+        return;
+    }
+    else if constexpr(bytes == 16) {
+        const __m128i v = _mm_maskz_loadu_epi8(static_cast<__mmask16>(byte_mask(count * sizeof(T))), p);
+        __builtin_memcpy(&out, &v, bytes);
+        return;
+    }
+#endif
+
+#ifdef CGS_SIMD_AVX
+    if constexpr(sizeof(T) >= 4 && (bytes == 32 || bytes == 16)) {
+        const std::int32_t* mask = tail_mask_table + 8 - count * (sizeof(T) / 4);
+        const float* source = reinterpret_cast<const float*>(p);
+        if constexpr(bytes == 32) {
+            const __m256 v = _mm256_maskload_ps(source, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask)));
+            __builtin_memcpy(&out, &v, bytes);
+        }
+        else {
+            const __m128 v = _mm_maskload_ps(source, _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+            __builtin_memcpy(&out, &v, bytes);
+        }
+        return;
+    }
+#endif
+
+    // no masked instruction for this width, copy one lane at a time
+    T lanes[bytes / sizeof(T)] {};
+    for(std::size_t i = 0; i < count; ++i) {
+        lanes[i] = p[i];
+    }
+    __builtin_memcpy(&out, lanes, bytes);
+}
+
+template <typename Native, typename T>
+void masked_store(const Native& v, T* p, std::size_t count)
+{
+    constexpr std::size_t bytes = sizeof(Native);
+
+#ifdef CGS_SIMD_AVX512
+    if constexpr(bytes == 64) {
+        __m512i data {};
+        __builtin_memcpy(&data, &v, bytes);
+        _mm512_mask_storeu_epi8(p, byte_mask(count * sizeof(T)), data);
+        return;
+    }
+    else if constexpr(bytes == 32) {
+        __m256i data {};
+        __builtin_memcpy(&data, &v, bytes);
+        _mm256_mask_storeu_epi8(p, static_cast<__mmask32>(byte_mask(count * sizeof(T))), data);
+        return;
+    }
+    else if constexpr(bytes == 16) {
+        __m128i data {};
+        __builtin_memcpy(&data, &v, bytes);
+        _mm_mask_storeu_epi8(p, static_cast<__mmask16>(byte_mask(count * sizeof(T))), data);
+        return;
+    }
+#endif
+
+#ifdef CGS_SIMD_AVX
+    if constexpr(sizeof(T) >= 4 && (bytes == 32 || bytes == 16)) {
+        const std::int32_t* mask = tail_mask_table + 8 - count * (sizeof(T) / 4);
+        float* dest = reinterpret_cast<float*>(p);
+        if constexpr(bytes == 32) {
+            __m256 data {};
+            __builtin_memcpy(&data, &v, bytes);
+            _mm256_maskstore_ps(dest, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask)), data);
+        }
+        else {
+            __m128 data {};
+            __builtin_memcpy(&data, &v, bytes);
+            _mm_maskstore_ps(dest, _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)), data);
+        }
+        return;
+    }
+#endif
+
+    // no masked instruction for this width, copy one lane at a time
+    T lanes[bytes / sizeof(T)] {};
+    __builtin_memcpy(lanes, &v, bytes);
+    for(std::size_t i = 0; i < count; ++i) {
+        p[i] = lanes[i];
+    }
+}
+
+} // namespace detail
+#endif
+
+} // namespace simd
+} // namespace cgs
+
+#endif // CGS_SIMD_PACK_HPP
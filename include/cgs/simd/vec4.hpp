@@ -16,9 +16,353 @@
 #ifndef CGS_SIMD_VEC4_HPP
 #define CGS_SIMD_VEC4_HPP
 
+#include "cgs/assert.hpp"
+#include "cgs/meta/constexpr.hpp"
+#include "cgs/simd/isa.hpp"
+
+#include <cstddef> // size_t
+#include <cstdint> // uintptr_t
+#include <functional> // plus, minus, multiplies, divides
+
 /*
 Compiler Explorer, showing we can pass more efficiently than glm's simd_vec4 (glm::aligned_highp_vec4).
 http://localhost:10240/#z:OYLghAFBqd5QCxAYwPYBMCmBRdBLAF1QCcAaPECAKxAEZSBnVAV2OUxAHIBSAJgGY8AO2QAbZlgDU3fgGFgogLYB6BYoB0CAA5aZ2bgAYAgn0EjxUmfKXLMADwKadewyeOnhYiZmly7ADgA2YQJiYU0Xd2MxAEMGBkkAN0xkABYAfWRmBiJFV24AdgAhVy0wxJiCDldJWsl09MVaXn969EqYmRLjOuljLWYAI1E8ZBB8nrrktMzs3IgASl8AEUksADMY5lECLomjXuUAKjxFLRHkQiPlJJSMrJzURQgGppa1joWa3rqQNo7pMV2gROgVlt9aoUioDwVEDlM7rNHs91qJUJVJHZSJJUeiCJIAJ7Y3EYgBexLRGIA7l9Jj9JH90sCYoCiljCdjyZIqYVYfDIcUYftetN7nMnpJUFpMMRKiQ%2BEUIKKkblJMQEAwlmghDkIay9T9iJgCKwhPVFIp0jF0Oh0loGC9mdj1Qx1EzPns6UL3GDPW4jPYqsQzWoQCBRfTIwiZjFsVHlYM/YGZSGlGGYiNgEJMLaEHhgNp0hHbjHM9nbbGSxkM/ny%2BlE/xugGHCmqyqJVGfsqHrkrXHu%2BLLQ2m8ng/VGs1Wp3O29/H2Z5P637XFUzqJKj4rAQCdKhDFFD4ACqRIyJVB4dCSbUMZgHospCCHyQxL6N/Zni/Pm3pNSLfLFPVr1vTB72QJVERZBU20GV8m15d9z0va1bTUdIGFOdA/x9JteiAu9pnA0taxzK1pF4aFlRrLMSJg5dfThD8kO/HsnjQjCsJMACvTwkCCIHZFSKg/je1ot8fT5VxGK/W1Zw4qFANQHVgNAl4LStb97QgWd520mDYP/PlOAWUhRC4ABWThSCELgDEs1AuFkBUoKYVh2DI/haEsggbKM4yAGsQDMgx1DM2gDFScL%2BAATgKfh%2BAMXgTK4VJLOszhbNIezOEshgQAMUhvPSozSDgWAkDQM48FEGVyEoCqtCqmUQGUbJiGUQZhGUWIhGAJzyNIdYqqDXKIEGHzSA6vdiAJLhPNICqDyEAgAHkhFEGaitILBFBiHrqvG/AjWQAg8GSXLNvsFJmCqWbLJCTBTM20JTh84yRkGXLIGMqUTsU86AFocnQGRlmQPqiloApJH%2B5beBylg2A4Wg3vM1LxqylqGDayauvXHrwckCBcEIEh3PoSRZCeBrquIMmFi817/JAVIovUVJ/CiszOcCBLAkCKL/FoQIks4FKrPRrgcrygrGZFuHxc2rKGaKhZjOSYh0MU5mgA%3D%3D%3D
+
+glm's aligned vec4 has a user provided copy constructor, so it is passed and returned through memory.
+vec4 is trivially copyable and wraps a single __m128,
+so the SysV ABI passes and returns it in one xmm register.
 */
 
+namespace cgs
+{
+namespace simd
+{
+
+namespace detail
+{
+
+#ifdef CGS_SIMD_SSE
+using float4_native = __m128;
+#else
+struct float4_native
+{
+    alignas(16) float v[4];
+
+    constexpr float operator[](std::size_t i) const
+    {
+        return v[i];
+    }
+};
+#endif
+
+} // namespace detail
+
+/**
+ * @brief 4 floats in one SSE register.
+ *
+ * Every operation is constexpr.
+ * Constant evaluation takes a scalar path, runtime uses SSE when it is enabled.
+ */
+class vec4
+{
+public:
+
+    using native_type = detail::float4_native;
+
+private:
+
+    native_type _v;
+
+public:
+
+    constexpr vec4() noexcept
+        : _v{}
+    { }
+
+    constexpr vec4(float x, float y, float z, float w) noexcept
+        : _v{x, y, z, w}
+    { }
+
+    /**
+     * @brief Broadcast s to every lane.
+     */
+    constexpr explicit vec4(float s) noexcept
+        : _v{s, s, s, s}
+    { }
+
+    constexpr explicit vec4(native_type v) noexcept
+        : _v(v)
+    { }
+
+    /**
+     * @brief Load 4 floats, p must be 16 byte aligned.
+     */
+    static constexpr vec4 load(const float* p)
+    {
+#ifdef CGS_SIMD_SSE
+        if(!cgs::is_constant_evaluated()) {
+            cgs_assert(reinterpret_cast<std::uintptr_t>(p) % 16 == 0);
+            return vec4{_mm_load_ps(p)};
+        }
+#endif
+        return vec4{p[0], p[1], p[2], p[3]};
+    }
+
+    /**
+     * @brief Load 4 floats, p may be unaligned.
+     */
+    static constexpr vec4 loadu(const float* p)
+    {
+#ifdef CGS_SIMD_SSE
+        if(!cgs::is_constant_evaluated()) {
+            return vec4{_mm_loadu_ps(p)};
+        }
+#endif
+        return vec4{p[0], p[1], p[2], p[3]};
+    }
+
+    /**
+     * @brief Store 4 floats, p must be 16 byte aligned.
+     */
+    constexpr void store(float* p) const
+    {
+#ifdef CGS_SIMD_SSE
+        if(!cgs::is_constant_evaluated()) {
+            cgs_assert(reinterpret_cast<std::uintptr_t>(p) % 16 == 0);
+            _mm_store_ps(p, _v);
+            return;
+        }
+#endif
+        for(std::size_t i = 0; i < 4; ++i) {
+            p[i] = _v[i];
+        }
+    }
+
+    /**
+     * @brief Store 4 floats, p may be unaligned.
+     */
+    constexpr void storeu(float* p) const
+    {
+#ifdef CGS_SIMD_SSE
+        if(!cgs::is_constant_evaluated()) {
+            _mm_storeu_ps(p, _v);
+            return;
+        }
+#endif
+        for(std::size_t i = 0; i < 4; ++i) {
+            p[i] = _v[i];
+        }
+    }
+
+    constexpr native_type native() const noexcept
+    {
+        return _v;
+    }
+
+    constexpr float operator[](std::size_t i) const
+    {
+        cgs_assert(i < 4);
+        return _v[i];
+    }
+
+    constexpr float x() const noexcept { return _v[0]; }
+    constexpr float y() const noexcept { return _v[1]; }
+    constexpr float z() const noexcept { return _v[2]; }
+    constexpr float w() const noexcept { return _v[3]; }
+
+    constexpr vec4& operator+=(vec4 rhs) noexcept;
+    constexpr vec4& operator-=(vec4 rhs) noexcept;
+    constexpr vec4& operator*=(vec4 rhs) noexcept;
+    constexpr vec4& operator/=(vec4 rhs) noexcept;
+    constexpr vec4& operator*=(float rhs) noexcept;
+    constexpr vec4& operator/=(float rhs) noexcept;
+};
+
+namespace detail
+{
+
+template <typename Op>
+constexpr vec4 lanewise(vec4 a, vec4 b, Op op)
+{
+    return { op(a[0], b[0]), op(a[1], b[1]), op(a[2], b[2]), op(a[3], b[3]) };
+}
+
+} // namespace detail
+
+constexpr vec4 operator+(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_add_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, std::plus<>{});
+}
+
+constexpr vec4 operator-(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_sub_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, std::minus<>{});
+}
+
+constexpr vec4 operator*(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_mul_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, std::multiplies<>{});
+}
+
+constexpr vec4 operator/(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_div_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, std::divides<>{});
+}
+
+constexpr vec4 operator-(vec4 v) noexcept
+{
+    // flip the sign bit, 0 - v would turn +0 into +0 instead of -0
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_xor_ps(v.native(), _mm_set1_ps(-0.0f))};
+    }
+#endif
+    return { -v[0], -v[1], -v[2], -v[3] };
+}
+
+constexpr vec4 operator*(vec4 a, float b) noexcept
+{
+    return a * vec4{b};
+}
+
+constexpr vec4 operator*(float a, vec4 b) noexcept
+{
+    return vec4{a} * b;
+}
+
+constexpr vec4 operator/(vec4 a, float b) noexcept
+{
+    return a / vec4{b};
+}
+
+constexpr vec4& vec4::operator+=(vec4 rhs) noexcept { return *this = *this + rhs; }
+constexpr vec4& vec4::operator-=(vec4 rhs) noexcept { return *this = *this - rhs; }
+constexpr vec4& vec4::operator*=(vec4 rhs) noexcept { return *this = *this * rhs; }
+constexpr vec4& vec4::operator/=(vec4 rhs) noexcept { return *this = *this / rhs; }
+constexpr vec4& vec4::operator*=(float rhs) noexcept { return *this = *this * rhs; }
+constexpr vec4& vec4::operator/=(float rhs) noexcept { return *this = *this / rhs; }
+
+/**
+ * @brief Are all 4 lanes equal?
+ */
+constexpr bool operator==(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return _mm_movemask_ps(_mm_cmpeq_ps(a.native(), b.native())) == 0xF;
+    }
+#endif
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
+}
+
+constexpr bool operator!=(vec4 a, vec4 b) noexcept
+{
+    return !(a == b);
+}
+
+/**
+ * @brief Lane-wise `(a < b) ? a : b`, same as minps and cgs::min2.
+ *
+ * If either lane is NaN, returns b's lane.
+ */
+constexpr vec4 min(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_min_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, [](float x, float y) { return (x < y) ? x : y; });
+}
+
+/**
+ * @brief Lane-wise `(a > b) ? a : b`, same as maxps.
+ *
+ * If either lane is NaN, returns b's lane.
+ */
+constexpr vec4 max(vec4 a, vec4 b) noexcept
+{
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_max_ps(a.native(), b.native())};
+    }
+#endif
+    return detail::lanewise(a, b, [](float x, float y) { return (x > y) ? x : y; });
+}
+
+/**
+ * @brief a * b + c
+ *
+ * Fused (single rounding) at runtime when FMA is enabled,
+ * so the result may differ from constant evaluation in the last bit.
+ */
+constexpr vec4 fma(vec4 a, vec4 b, vec4 c) noexcept
+{
+#ifdef CGS_SIMD_FMA
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_fmadd_ps(a.native(), b.native(), c.native())};
+    }
+#endif
+    return a * b + c;
+}
+
+/**
+ * @brief Reorder lanes, result is { v[X], v[Y], v[Z], v[W] }.
+ */
+template <int X, int Y, int Z, int W>
+constexpr vec4 shuffle(vec4 v) noexcept
+{
+    static_assert(0 <= X && X < 4 && 0 <= Y && Y < 4 && 0 <= Z && Z < 4 && 0 <= W && W < 4,
+        "shuffle lanes must be in [0, 4)");
+
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        return vec4{_mm_shuffle_ps(v.native(), v.native(), _MM_SHUFFLE(W, Z, Y, X))};
+    }
+#endif
+    return { v[X], v[Y], v[Z], v[W] };
+}
+
+/**
+ * @brief Sum of lane products.
+ *
+ * Always adds in the order (0 + 2) + (1 + 3), so the runtime result matches constant evaluation.
+ */
+constexpr float dot(vec4 a, vec4 b) noexcept
+{
+    const vec4 products = a * b;
+
+#ifdef CGS_SIMD_SSE
+    if(!cgs::is_constant_evaluated()) {
+        const __m128 p = products.native();
+        const __m128 pairs = _mm_add_ps(p, _mm_movehl_ps(p, p));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+#endif
+    return (products[0] + products[2]) + (products[1] + products[3]);
+}
+
+} // namespace simd
+} // namespace cgs
+
 #endif // CGS_SIMD_VEC4_HPP
@@ -0,0 +1,518 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_SORT_HPP
+#define CGS_SORT_HPP
+
+#include "cgs/meta/constexpr.hpp"
+
+#include <algorithm> // stable_sort
+#include <array>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <cstring> // memcpy
+#include <functional> // less
+#include <iterator> // iterator_traits
+#include <type_traits>
+#include <utility> // move, index_sequence
+
+/*
+constexpr sort, stable_sort and partial_sort, taking (first, last) like cgs::fill, where last may be a sentinel.
+
+sort
+    Up to 32 elements: a sorting network, a fixed sequence of compare-exchanges with no data dependent branches
+    for arithmetic and pointer elements.
+    More: introsort, quicksort with a median of 3 pivot, heapsort past 2 log2(n) levels,
+    and sorting networks for the partitions of up to 32 elements.
+
+sort_network<N>
+    The network for N elements known at compile time, unrolled, on a local copy of arithmetic elements,
+    so the compiler keeps them in registers and may use vector min and max.
+    For many small arrays, e.g. k nearest candidates.
+
+stable_sort
+    At runtime std::stable_sort, which merges through a buffer.
+    At compile time, without allocation, insertion sort runs of 32 merged in place by rotations, O(n log^2 n).
+
+partial_sort
+    Heap selection of the middle - first smallest, O(n log k), then sort of those.
+
+The networks are Batcher's odd-even merge sort, 191 compare-exchanges for 32 elements.
+*/
+
+namespace cgs
+{
+
+namespace detail
+{
+
+// the largest sorting network
+constexpr std::size_t sort_network_max = 32;
+
+struct sort_pair
+{
+    std::uint8_t first;
+    std::uint8_t second;
+};
+
+// Batcher's odd-even merge sort for n elements, emit(i, j) for each compare-exchange, i < j.
+// Comparators past n are dropped, which sorts as if padded with elements larger than all others
+template <typename F>
+constexpr void odd_even_merge_network(std::size_t n, F&& emit)
+{
+    for(std::size_t p = 1; p < n; p *= 2) {
+        for(std::size_t k = p; k >= 1; k /= 2) {
+            for(std::size_t j = k % p; j + k < n; j += 2 * k) {
+                for(std::size_t i = 0; i < k && i + j + k < n; ++i) {
+                    if((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        emit(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <std::size_t N>
+constexpr std::size_t sorting_network_size()
+{
+    std::size_t size = 0;
+    odd_even_merge_network(N, [&size](std::size_t, std::size_t) { ++size; });
+    return size;
+}
+
+template <std::size_t N>
+struct sorting_network
+{
+    static constexpr std::size_t size = sorting_network_size<N>();
+
+    static constexpr std::array<sort_pair, size> make_pairs()
+    {
+        std::array<sort_pair, size> pairs {};
+        std::size_t c = 0;
+        odd_even_merge_network(N, [&pairs, &c](std::size_t i, std::size_t j) {
+            pairs[c++] = { static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(j) };
+        });
+        return pairs;
+    }
+
+    static constexpr std::array<sort_pair, size> pairs = make_pairs();
+};
+
+struct sort_network_view
+{
+    const sort_pair* pairs;
+    std::size_t size;
+};
+
+template <std::size_t... N>
+constexpr std::array<sort_network_view, sizeof...(N)> make_sort_network_views(std::index_sequence<N...>)
+{
+    return {{ { sorting_network<N>::pairs.data(), sorting_network<N>::size }... }};
+}
+
+// sorting_network_views[n] for n elements, n <= sort_network_max
+inline constexpr std::array<sort_network_view, sort_network_max + 1> sorting_network_views =
+    make_sort_network_views(std::make_index_sequence<sort_network_max + 1>{});
+
+// std::swap is not constexpr until C++20
+template <typename T>
+constexpr void sort_swap(T& a, T& b)
+{
+    T t = std::move(a);
+    a = std::move(b);
+    b = std::move(t);
+}
+
+template <typename T>
+inline constexpr bool is_branchless_sortable_v = std::is_arithmetic<T>::value || std::is_pointer<T>::value;
+
+// the unsigned integer the size of T, or void
+template <typename T>
+using sort_bits_t = std::conditional_t<sizeof(T) == 4, std::uint32_t,
+    std::conditional_t<sizeof(T) == 8, std::uint64_t, void>>;
+
+// a, b = min, max of a, b
+template <typename T, typename Compare>
+constexpr void compare_exchange(T& a, T& b, Compare& comp)
+{
+    if constexpr(std::is_floating_point<T>::value && !std::is_void<sort_bits_t<T>>::value) {
+        if(!cgs::is_constant_evaluated()) {
+            // GCC compiles floating point selects to branches, which mispredict half the time here,
+            // so select the bits with a mask.
+            // min and max instructions would be branchless, but turn -0, +0 into +0, +0
+            using bits_t = sort_bits_t<T>;
+            bits_t x, y;
+            std::memcpy(&x, &a, sizeof x);
+            std::memcpy(&y, &b, sizeof y);
+            const bits_t swap = (x ^ y) & (bits_t{0} - static_cast<bits_t>(comp(b, a)));
+            x ^= swap;
+            y ^= swap;
+            std::memcpy(&a, &x, sizeof x);
+            std::memcpy(&b, &y, sizeof y);
+            return;
+        }
+    }
+    if constexpr(is_branchless_sortable_v<T>) {
+        // selects, which compile to conditional moves
+        const bool swap = comp(b, a);
+        const T low = swap ? b : a;
+        const T high = swap ? a : b;
+        a = low;
+        b = high;
+    }
+    else {
+        if(comp(b, a)) {
+            sort_swap(a, b);
+        }
+    }
+}
+
+// the network for n <= sort_network_max elements from its table
+template <typename RandomIt, typename Compare>
+constexpr void sort_network_table(RandomIt first, std::size_t n, Compare& comp)
+{
+    const sort_network_view network = sorting_network_views[n];
+    for(std::size_t c = 0; c < network.size; ++c) {
+        compare_exchange(first[network.pairs[c].first], first[network.pairs[c].second], comp);
+    }
+}
+
+template <std::size_t N, typename RandomIt, typename Compare, std::size_t... C>
+constexpr void sort_network_unrolled(RandomIt values, Compare& comp, std::index_sequence<C...>)
+{
+    (compare_exchange(values[sorting_network<N>::pairs[C].first], values[sorting_network<N>::pairs[C].second], comp), ...);
+}
+
+template <typename RandomIt, typename Sentinal>
+constexpr RandomIt sort_end(RandomIt first, Sentinal last)
+{
+    if constexpr(std::is_same<RandomIt, Sentinal>::value) {
+        return last;
+    }
+    else {
+        for(; first != last; ++first) { }
+        return first;
+    }
+}
+
+constexpr std::size_t sort_log2(std::size_t n) noexcept
+{
+    std::size_t log = 0;
+    for(; n > 1; n /= 2) {
+        ++log;
+    }
+    return log;
+}
+
+// max heap of [first, first + size) by comp, move value into the hole and sift it down
+template <typename RandomIt, typename Compare, typename T>
+constexpr void sift_down(RandomIt first, std::size_t hole, std::size_t size, T value, Compare& comp)
+{
+    for(std::size_t child = 2 * hole + 1; child < size; child = 2 * hole + 1) {
+        if(child + 1 < size && comp(first[child], first[child + 1])) {
+            ++child;
+        }
+        if(!comp(value, first[child])) {
+            break;
+        }
+        first[hole] = std::move(first[child]);
+        hole = child;
+    }
+    first[hole] = std::move(value);
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void make_heap(RandomIt first, std::size_t size, Compare& comp)
+{
+    for(std::size_t i = size / 2; i-- > 0; ) {
+        sift_down(first, i, size, std::move(first[i]), comp);
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void heap_sort(RandomIt first, RandomIt last, Compare& comp)
+{
+    std::size_t size = static_cast<std::size_t>(last - first);
+    make_heap(first, size, comp);
+    for(; size > 1; --size) {
+        auto value = std::move(first[size - 1]);
+        first[size - 1] = std::move(first[0]);
+        sift_down(first, 0, size - 1, std::move(value), comp);
+    }
+}
+
+// move the median of a, b and c to result
+template <typename RandomIt, typename Compare>
+constexpr void move_median_to_first(RandomIt result, RandomIt a, RandomIt b, RandomIt c, Compare& comp)
+{
+    if(comp(*a, *b)) {
+        if(comp(*b, *c)) {
+            sort_swap(*result, *b);
+        }
+        else if(comp(*a, *c)) {
+            sort_swap(*result, *c);
+        }
+        else {
+            sort_swap(*result, *a);
+        }
+    }
+    else if(comp(*a, *c)) {
+        sort_swap(*result, *a);
+    }
+    else if(comp(*b, *c)) {
+        sort_swap(*result, *c);
+    }
+    else {
+        sort_swap(*result, *b);
+    }
+}
+
+// partition [first + 1, last) around the pivot *first, the median of 3 keeps both scans in range
+template <typename RandomIt, typename Compare>
+constexpr RandomIt partition_pivot(RandomIt first, RandomIt last, Compare& comp)
+{
+    move_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, comp);
+    RandomIt left = first + 1;
+    RandomIt right = last;
+    while(true) {
+        while(comp(*left, *first)) {
+            ++left;
+        }
+        --right;
+        while(comp(*first, *right)) {
+            --right;
+        }
+        if(!(left < right)) {
+            return left;
+        }
+        sort_swap(*left, *right);
+        ++left;
+    }
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void introsort(RandomIt first, RandomIt last, std::size_t depth, Compare& comp)
+{
+    while(static_cast<std::size_t>(last - first) > sort_network_max) {
+        if(depth == 0) {
+            heap_sort(first, last, comp);
+            return;
+        }
+        --depth;
+        const RandomIt cut = partition_pivot(first, last, comp);
+        // recurse into the smaller side, so the stack is O(log n)
+        if(cut - first < last - cut) {
+            introsort(first, cut, depth, comp);
+            first = cut;
+        }
+        else {
+            introsort(cut, last, depth, comp);
+            last = cut;
+        }
+    }
+    sort_network_table(first, static_cast<std::size_t>(last - first), comp);
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void insertion_sort(RandomIt first, RandomIt last, Compare& comp)
+{
+    if(first == last) {
+        return;
+    }
+    for(RandomIt i = first + 1; i != last; ++i) {
+        auto value = std::move(*i);
+        RandomIt hole = i;
+        for(; hole != first && comp(value, *(hole - 1)); --hole) {
+            *hole = std::move(*(hole - 1));
+        }
+        *hole = std::move(value);
+    }
+}
+
+template <typename RandomIt>
+constexpr void sort_reverse(RandomIt first, RandomIt last)
+{
+    for(; first < last; ++first) {
+        --last;
+        sort_swap(*first, *last);
+    }
+}
+
+// [first, middle) [middle, last) to [middle, last) [first, middle), returns the new middle
+template <typename RandomIt>
+constexpr RandomIt sort_rotate(RandomIt first, RandomIt middle, RandomIt last)
+{
+    sort_reverse(first, middle);
+    sort_reverse(middle, last);
+    sort_reverse(first, last);
+    return first + (last - middle);
+}
+
+// first element not before value, or after it if Upper
+template <bool Upper, typename RandomIt, typename T, typename Compare>
+constexpr RandomIt sort_bound(RandomIt first, RandomIt last, const T& value, Compare& comp)
+{
+    auto count = last - first;
+    while(count > 0) {
+        const auto half = count / 2;
+        const RandomIt middle = first + half;
+        if(Upper ? !comp(value, *middle) : comp(*middle, value)) {
+            first = middle + 1;
+            count -= half + 1;
+        }
+        else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+// stable merge of sorted [first, middle) and [middle, last) without a buffer
+template <typename RandomIt, typename Compare>
+constexpr void merge_in_place(RandomIt first, RandomIt middle, RandomIt last, Compare& comp)
+{
+    const auto left = middle - first;
+    const auto right = last - middle;
+    if(left == 0 || right == 0) {
+        return;
+    }
+    if(left + right == 2) {
+        if(comp(*middle, *first)) {
+            sort_swap(*first, *middle);
+        }
+        return;
+    }
+    RandomIt first_cut = first;
+    RandomIt second_cut = middle;
+    if(left > right) {
+        first_cut += left / 2;
+        second_cut = sort_bound<false>(middle, last, *first_cut, comp);
+    }
+    else {
+        second_cut += right / 2;
+        first_cut = sort_bound<true>(first, middle, *second_cut, comp);
+    }
+    const RandomIt new_middle = sort_rotate(first_cut, middle, second_cut);
+    merge_in_place(first, first_cut, new_middle, comp);
+    merge_in_place(new_middle, second_cut, last, comp);
+}
+
+template <typename RandomIt, typename Compare>
+constexpr void stable_sort_in_place(RandomIt first, RandomIt last, Compare& comp)
+{
+    const auto n = last - first;
+    constexpr auto run = static_cast<decltype(n)>(sort_network_max);
+    for(auto begin = decltype(n){0}; begin < n; begin += run) {
+        insertion_sort(first + begin, first + (n - begin < run ? n : begin + run), comp);
+    }
+    for(auto width = run; width < n; width *= 2) {
+        for(auto begin = decltype(n){0}; begin + width < n; begin += 2 * width) {
+            const auto end = n - begin < 2 * width ? n : begin + 2 * width;
+            merge_in_place(first + begin, first + begin + width, first + end, comp);
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Sort [first, last) by comp, not stable, constexpr.
+ *
+ * Up to 32 elements with a sorting network, more with introsort.
+ */
+template <typename RandomIt, typename Sentinal, typename Compare = std::less<>>
+constexpr void sort(RandomIt first, Sentinal last, Compare comp = {})
+{
+    const RandomIt end = detail::sort_end(first, last);
+    const auto n = static_cast<std::size_t>(end - first);
+    if(n <= detail::sort_network_max) {
+        detail::sort_network_table(first, n, comp);
+        return;
+    }
+    detail::introsort(first, end, 2 * detail::sort_log2(n), comp);
+}
+
+/**
+ * @brief Sort the N elements from first with the unrolled sorting network, N <= 32, constexpr.
+ */
+template <std::size_t N, typename RandomIt, typename Compare = std::less<>>
+constexpr void sort_network(RandomIt first, Compare comp = {})
+{
+    static_assert(N <= detail::sort_network_max, "sort_network takes at most 32 elements");
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr auto sequence = std::make_index_sequence<detail::sorting_network<N>::size>{};
+    if constexpr(N < 2) {
+        static_cast<void>(first);
+    }
+    else if constexpr(detail::is_branchless_sortable_v<T>) {
+        // values in locals, not behind the iterator, which may alias
+        T values[N] {};
+        for(std::size_t i = 0; i < N; ++i) {
+            values[i] = first[i];
+        }
+        detail::sort_network_unrolled<N>(values, comp, sequence);
+        for(std::size_t i = 0; i < N; ++i) {
+            first[i] = values[i];
+        }
+    }
+    else {
+        detail::sort_network_unrolled<N>(first, comp, sequence);
+    }
+}
+
+/**
+ * @brief Sort [first, last) by comp, keeping the order of equivalent elements, constexpr.
+ *
+ * At runtime std::stable_sort, at compile time merges in place.
+ */
+template <typename RandomIt, typename Sentinal, typename Compare = std::less<>>
+constexpr void stable_sort(RandomIt first, Sentinal last, Compare comp = {})
+{
+    const RandomIt end = detail::sort_end(first, last);
+    if(!is_constant_evaluated()) {
+        std::stable_sort(first, end, comp);
+        return;
+    }
+    detail::stable_sort_in_place(first, end, comp);
+}
+
+/**
+ * @brief Move the middle - first smallest elements of [first, last) to [first, middle) in order, constexpr.
+ *
+ * The order of [middle, last) is unspecified.
+ */
+template <typename RandomIt, typename Sentinal, typename Compare = std::less<>>
+constexpr void partial_sort(RandomIt first, RandomIt middle, Sentinal last, Compare comp = {})
+{
+    const auto k = static_cast<std::size_t>(middle - first);
+    if(k == 0) {
+        return;
+    }
+    // a max heap of the k smallest so far
+    detail::make_heap(first, k, comp);
+    for(RandomIt i = middle; i != last; ++i) {
+        if(comp(*i, *first)) {
+            auto value = std::move(*i);
+            *i = std::move(*first);
+            detail::sift_down(first, 0, k, std::move(value), comp);
+        }
+    }
+    cgs::sort(first, middle, comp);
+}
+
+} // namespace cgs
+
+#endif // CGS_SORT_HPP
@@ -0,0 +1,429 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_STATIC_MAP_HPP
+#define CGS_STATIC_MAP_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/meta/constexpr.hpp" // is_constant_evaluated
+#include "cgs/simd/pack.hpp"
+
+#include <array>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <cstring> // memcpy
+#include <string_view>
+#include <type_traits>
+#include <utility> // pair
+
+/*
+A map of N keys fixed at compile time, with a minimal perfect hash: every key has its own slot of N.
+
+    constexpr auto opcodes = cgs::make_static_map<std::string_view, int>({
+        { "add", 0x01 }, { "sub", 0x02 }, { "jmp", 0x10 }
+    });
+    static_assert(opcodes.at("sub") == 0x02);
+    const int* op = opcodes.find(token);
+
+A lookup hashes the key once, reads the pilot of its bucket, and compares the key in the one slot it can be in.
+No allocation, and a constexpr map at namespace scope is in read-only data.
+Keys are integers, enums, or std::string_view. Runtime string compares use 16 byte SIMD loads.
+
+The hash is PTHash-like: keys are split into about N / 2 buckets by their hash,
+and each bucket, largest first, searches for a pilot that moves all its keys to free slots.
+The construction restarts with another seed if a bucket finds no pilot, which is rare.
+It runs in the constant evaluator, practical for up to a few thousand keys.
+*/
+
+namespace cgs
+{
+
+namespace detail
+{
+
+constexpr std::uint64_t static_hash_mix(std::uint64_t x) noexcept
+{
+    // murmur3 finalizer, a bijection
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// little endian bytes [p, p + n), n <= 8
+constexpr std::uint64_t static_hash_word(const char* p, std::size_t n) noexcept
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if(n == 8 && !is_constant_evaluated()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, p, sizeof word);
+        return word;
+    }
+#endif
+    std::uint64_t word = 0;
+    for(std::size_t i = 0; i < n; ++i) {
+        word |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+    }
+    return word;
+}
+
+// x * n / 2^32, a multiply instead of a division
+constexpr std::size_t static_hash_reduce(std::uint64_t x, std::size_t n) noexcept
+{
+    return static_cast<std::size_t>(((x >> 32) * n) >> 32);
+}
+
+// the slot of a key with hash h, in a bucket with pilot
+constexpr std::size_t static_map_slot(std::uint64_t h, std::uint32_t pilot, std::size_t n) noexcept
+{
+    std::uint64_t x = h ^ (pilot * 0x9e3779b97f4a7c15ull);
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 31;
+    return static_hash_reduce(x, n);
+}
+
+// a[0, n) == b[0, n)
+inline bool static_map_bytes_equal(const char* a, const char* b, std::size_t n) noexcept
+{
+    using bytes = simd::pack<std::uint8_t, 16>;
+    const auto* x = reinterpret_cast<const std::uint8_t*>(a);
+    const auto* y = reinterpret_cast<const std::uint8_t*>(b);
+    if(n >= 16) {
+        // 16 bytes at a time, the last load overlapping the one before
+        for(std::size_t i = 0; i + 16 < n; i += 16) {
+            if(!simd::all(bytes::loadu(x + i) == bytes::loadu(y + i))) {
+                return false;
+            }
+        }
+        return simd::all(bytes::loadu(x + n - 16) == bytes::loadu(y + n - 16));
+    }
+#ifdef CGS_SIMD_AVX512
+    return simd::all(bytes::load_partial(x, n) == bytes::load_partial(y, n));
+#else
+    // words overlapping in the middle, never past n
+    const auto load = [](const std::uint8_t* p, auto word) {
+        std::memcpy(&word, p, sizeof word);
+        return word;
+    };
+    if(n >= 8) {
+        return load(x, std::uint64_t{}) == load(y, std::uint64_t{})
+            && load(x + n - 8, std::uint64_t{}) == load(y + n - 8, std::uint64_t{});
+    }
+    if(n >= 4) {
+        return load(x, std::uint32_t{}) == load(y, std::uint32_t{})
+            && load(x + n - 4, std::uint32_t{}) == load(y + n - 4, std::uint32_t{});
+    }
+    for(std::size_t i = 0; i < n; ++i) {
+        if(x[i] != y[i]) {
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 64 bit hash of key with seed, the same at compile time and runtime, for static_map.
+ *
+ * Specialized for integers, enums and std::string_view.
+ */
+template <typename Key, typename = void>
+struct static_hash;
+
+template <typename Key>
+struct static_hash<Key, std::enable_if_t<std::is_integral<Key>::value || std::is_enum<Key>::value>>
+{
+    constexpr std::uint64_t operator()(Key key, std::uint64_t seed) const noexcept
+    {
+        return detail::static_hash_mix(static_cast<std::uint64_t>(key) ^ seed);
+    }
+};
+
+template <>
+struct static_hash<std::string_view>
+{
+    constexpr std::uint64_t operator()(std::string_view key, std::uint64_t seed) const noexcept
+    {
+        std::uint64_t h = seed ^ (key.size() * 0x9e3779b97f4a7c15ull);
+        std::size_t i = 0;
+        for(; i + 8 <= key.size(); i += 8) {
+            h = (h ^ detail::static_hash_word(key.data() + i, 8)) * 0x9fb21c651e98df25ull;
+            h ^= h >> 29;
+        }
+        if(i != key.size() && key.size() >= 8) {
+            // the last 8 bytes, shifted down to the ones not yet hashed
+            h ^= detail::static_hash_word(key.data() + key.size() - 8, 8) >> (8 * (8 - (key.size() - i)));
+        }
+        else {
+            h ^= detail::static_hash_word(key.data() + i, key.size() - i);
+        }
+        return detail::static_hash_mix(h);
+    }
+};
+
+/**
+ * @brief Equality of static_map keys, comparing std::string_view with SIMD at runtime.
+ */
+template <typename Key>
+struct static_key_equal
+{
+    constexpr bool operator()(const Key& a, const Key& b) const noexcept
+    {
+        return a == b;
+    }
+};
+
+template <>
+struct static_key_equal<std::string_view>
+{
+    constexpr bool operator()(std::string_view a, std::string_view b) const noexcept
+    {
+        if(a.size() != b.size()) {
+            return false;
+        }
+        if(!is_constant_evaluated()) {
+            return detail::static_map_bytes_equal(a.data(), b.data(), a.size());
+        }
+        return a == b;
+    }
+};
+
+/**
+ * @brief Read-only map of N keys, built at compile time with a minimal perfect hash, constexpr.
+ *
+ * Keys must be unique, checked in every assertion mode. Keys and values must be default constructible.
+ */
+template <typename Key, typename Value, std::size_t N,
+          typename Hash = static_hash<Key>, typename KeyEqual = static_key_equal<Key>>
+class static_map
+{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+
+private:
+    static constexpr std::size_t bucket_count = N / 2 + 1;
+
+    // pilots tried for a bucket before the construction restarts with a new seed
+    static constexpr std::uint32_t max_pilot = 1u << 16;
+
+    // seeds tried before the construction fails, each failing with a small probability
+    static constexpr std::uint64_t max_seed = 64;
+
+    std::array<Key, N> _keys;
+    std::array<Value, N> _values;
+    std::array<std::uint32_t, bucket_count> _pilots;
+    std::uint64_t _seed;
+    Hash _hash;
+    KeyEqual _equal;
+
+    constexpr std::size_t bucket(std::uint64_t h) const noexcept
+    {
+        // the low half, the slot uses the high half
+        return detail::static_hash_reduce(h << 32, bucket_count);
+    }
+
+    // fill the slots with seed, false if some bucket found no pilot
+    constexpr bool build(const std::array<std::pair<Key, Value>, N>& pairs)
+    {
+        std::array<std::uint64_t, N> hashes {};
+        std::array<std::size_t, bucket_count + 1> starts {};
+        for(std::size_t i = 0; i < N; ++i) {
+            hashes[i] = _hash(pairs[i].first, _seed);
+            ++starts[bucket(hashes[i]) + 1];
+        }
+        for(std::size_t b = 0; b < bucket_count; ++b) {
+            starts[b + 1] += starts[b];
+        }
+        // keys by bucket
+        std::array<std::size_t, N> members {};
+        std::array<std::size_t, bucket_count> filled {};
+        std::size_t largest = 0;
+        for(std::size_t i = 0; i < N; ++i) {
+            const std::size_t b = bucket(hashes[i]);
+            members[starts[b] + filled[b]++] = i;
+            largest = filled[b] > largest ? filled[b] : largest;
+        }
+
+        std::array<bool, N> taken {};
+        std::array<std::size_t, N> slots {};
+        // largest buckets first, while most slots are free
+        for(std::size_t size = largest; size > 0; --size) {
+            for(std::size_t b = 0; b < bucket_count; ++b) {
+                if(filled[b] != size) {
+                    continue;
+                }
+                // keys with equal hashes never fit, a duplicate or a collision needing another seed
+                for(std::size_t m = 1; m < size; ++m) {
+                    const std::size_t i = members[starts[b] + m];
+                    for(std::size_t other = 0; other < m; ++other) {
+                        const std::size_t j = members[starts[b] + other];
+                        if(hashes[i] == hashes[j]) {
+                            // a duplicate would reseed forever, so it fails in every mode,
+                            // and in constant evaluation the failure does not compile
+                            const bool unique = !_equal(pairs[i].first, pairs[j].first);
+                            if constexpr(cgs_assert_levels.normal == violation::throw_) {
+                                cgs_assert_throw(unique);
+                            }
+                            else {
+                                cgs_assert_abort(unique);
+                            }
+                            return false;
+                        }
+                    }
+                }
+                std::uint32_t pilot = 0;
+                for(;; ++pilot) {
+                    if(pilot == max_pilot) {
+                        return false;
+                    }
+                    bool fits = true;
+                    for(std::size_t m = 0; m < size && fits; ++m) {
+                        const std::size_t i = members[starts[b] + m];
+                        slots[i] = detail::static_map_slot(hashes[i], pilot, N);
+                        fits = !taken[slots[i]];
+                        // keys of the bucket sharing a slot
+                        for(std::size_t other = 0; other < m && fits; ++other) {
+                            fits = slots[members[starts[b] + other]] != slots[i];
+                        }
+                    }
+                    if(fits) {
+                        break;
+                    }
+                }
+                _pilots[b] = pilot;
+                for(std::size_t m = 0; m < size; ++m) {
+                    taken[slots[members[starts[b] + m]]] = true;
+                }
+            }
+        }
+
+        for(std::size_t i = 0; i < N; ++i) {
+            _keys[slots[i]] = pairs[i].first;
+            _values[slots[i]] = pairs[i].second;
+        }
+        return true;
+    }
+
+    constexpr std::size_t slot(const Key& key) const noexcept
+    {
+        const std::uint64_t h = _hash(key, _seed);
+        return detail::static_map_slot(h, _pilots[bucket(h)], N);
+    }
+
+public:
+    /**
+     * @brief The map of the N pairs, whose keys must be unique.
+     */
+    constexpr explicit static_map(const std::array<std::pair<Key, Value>, N>& pairs, const Hash& hash = {}, const KeyEqual& equal = {})
+        : _keys {}
+        , _values {}
+        , _pilots {}
+        , _seed {}
+        , _hash { hash }
+        , _equal { equal }
+    {
+        for(std::uint64_t attempt = 1; !build(pairs); ++attempt) {
+            cgs_assert_abort(attempt < max_seed);
+            _seed = detail::static_hash_mix(attempt);
+            _pilots = {};
+        }
+    }
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    static constexpr bool empty() noexcept
+    {
+        return N == 0;
+    }
+
+    /**
+     * @brief The value of key, or null if there is none.
+     */
+    constexpr const Value* find(const Key& key) const noexcept
+    {
+        if constexpr(N == 0) {
+            static_cast<void>(key);
+            return nullptr;
+        }
+        else {
+            const std::size_t s = slot(key);
+            return _equal(_keys[s], key) ? &_values[s] : nullptr;
+        }
+    }
+
+    constexpr bool contains(const Key& key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief The value of key, which must be in the map.
+     */
+    constexpr const Value& at(const Key& key) const
+    {
+        const Value* value = find(key);
+        cgs_assert(value);
+        return *value;
+    }
+
+    /**
+     * @brief The keys, in slot order.
+     */
+    constexpr const std::array<Key, N>& keys() const noexcept
+    {
+        return _keys;
+    }
+
+    /**
+     * @brief The values, in the order of keys().
+     */
+    constexpr const std::array<Value, N>& values() const noexcept
+    {
+        return _values;
+    }
+};
+
+/**
+ * @brief static_map of the pairs, e.g. make_static_map<std::string_view, int>({ { "a", 1 }, { "b", 2 } }).
+ */
+template <typename Key, typename Value, std::size_t N>
+constexpr static_map<Key, Value, N> make_static_map(const std::pair<Key, Value> (&pairs)[N])
+{
+    std::array<std::pair<Key, Value>, N> copy {};
+    for(std::size_t i = 0; i < N; ++i) {
+        // pair assignment is not constexpr until C++20
+        copy[i].first = pairs[i].first;
+        copy[i].second = pairs[i].second;
+    }
+    return static_map<Key, Value, N> { copy };
+}
+
+template <typename Key, typename Value, std::size_t N>
+constexpr static_map<Key, Value, N> make_static_map(const std::array<std::pair<Key, Value>, N>& pairs)
+{
+    return static_map<Key, Value, N> { pairs };
+}
+
+} // namespace cgs
+
+#endif // CGS_STATIC_MAP_HPP
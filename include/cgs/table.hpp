@@ -0,0 +1,429 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_TABLE_HPP
+#define CGS_TABLE_HPP
+
+#include "cgs/assert.hpp"
+#include "cgs/elementary.hpp" // to_bits, from_bits, nearest, pow2
+#include "cgs/math.hpp" // lerp, clamp
+#include "cgs/meta/constexpr.hpp" // is_constant_evaluated
+#include "cgs/optimize.hpp" // cache_line_size
+#include "cgs/simd/isa.hpp"
+
+#include <array>
+#include <cstddef> // size_t
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/*
+Lookup tables computed at compile time.
+A constexpr table at namespace scope is stored in read-only data, with no initialization at runtime.
+
+    // f(i) for i in [0, N)
+    constexpr auto bit_reverse = cgs::make_table<256>([](std::size_t i) { ... });
+
+    // f at 65 evenly spaced points of [0, pi / 2], sampled with linear interpolation,
+    // and stored in 16 bits each
+    constexpr auto sine = cgs::make_lerp_table<65, cgs::float16>([](float x) { return cgs::sin(x); }, 0.f, 1.5707964f);
+    static_assert(sine.error([](float x) { return cgs::sin(x); }).max_abs < 1e-3f);
+    float y = sine(x);
+
+Entries are cache line aligned, so a table of 64 bytes or less is a single line.
+Entry types other than the value type compress the table:
+    float16             IEEE binary16, 11 significant bits, rounded to nearest even
+    fixed<Int, Bits>    Int scaled by 2^-Bits, rounded to nearest, asserted to fit
+*/
+
+namespace cgs
+{
+
+/**
+ * @brief IEEE 754 binary16, a storage format, converted to and from float or double.
+ */
+class float16
+{
+private:
+
+    std::uint16_t _bits;
+
+    template <typename T>
+    static constexpr std::uint16_t encode(T value) noexcept
+    {
+        using U = detail::float_bits_t<T>;
+        constexpr int mantissa = detail::float_layout<T>::mantissa;
+        constexpr int bias = detail::float_layout<T>::bias;
+        constexpr int exponent_max = 2 * bias + 1;
+
+        const U bits = detail::to_bits(value);
+        const auto sign = static_cast<std::uint16_t>((bits >> (sizeof(U) * 8 - 16)) & 0x8000);
+        const int biased = static_cast<int>((bits >> mantissa) & static_cast<U>(exponent_max));
+        const U fraction = bits & ((U{1} << mantissa) - 1);
+        if(biased == exponent_max) {
+            return static_cast<std::uint16_t>(sign | 0x7c00 | (fraction != 0 ? 0x200 : 0));
+        }
+        const int exponent = biased - bias + 15;
+        if(biased == 0 || exponent < -10) {
+            // below half the smallest binary16 subnormal
+            return sign;
+        }
+        if(exponent >= 31) {
+            return static_cast<std::uint16_t>(sign | 0x7c00);
+        }
+
+        // keep 10 fraction bits, or fewer for a subnormal result, and round the rest to nearest even
+        U kept {};
+        int shift = mantissa - 10;
+        if(exponent > 0) {
+            kept = (U(exponent) << 10) | (fraction >> shift);
+        }
+        else {
+            shift += 1 - exponent;
+            kept = (fraction | (U{1} << mantissa)) >> shift;
+        }
+        const U rest = (exponent > 0 ? fraction : fraction | (U{1} << mantissa)) & ((U{1} << shift) - 1);
+        const U half = U{1} << (shift - 1);
+        if(rest > half || (rest == half && (kept & 1) != 0)) {
+            // a carry out of the fraction increments the exponent, up to infinity
+            ++kept;
+        }
+        return static_cast<std::uint16_t>(sign | kept);
+    }
+
+public:
+
+    constexpr float16() noexcept
+        : _bits()
+    { }
+
+    /**
+     * @brief Rounded to nearest even, overflowing to infinity.
+     */
+    template <typename T, typename = std::enable_if_t<detail::is_elementary_v<T>>>
+    constexpr explicit float16(T value) noexcept
+        : _bits(encode(value))
+    { }
+
+    static constexpr float16 from_bits(std::uint16_t bits) noexcept
+    {
+        float16 result;
+        result._bits = bits;
+        return result;
+    }
+
+    constexpr std::uint16_t bits() const noexcept
+    {
+        return _bits;
+    }
+
+    /**
+     * @brief Exact.
+     */
+    constexpr operator float() const noexcept
+    {
+#ifdef CGS_SIMD_F16C
+        if(!is_constant_evaluated()) {
+            return _cvtsh_ss(_bits);
+        }
+#endif
+        const std::uint32_t sign = std::uint32_t{_bits & 0x8000u} << 16;
+        const std::uint32_t exponent = (_bits >> 10) & 0x1f;
+        const std::uint32_t fraction = _bits & 0x3ffu;
+        if(exponent == 0) {
+            const float magnitude = static_cast<float>(fraction) * 0x1p-24f;
+            return sign != 0 ? -magnitude : magnitude;
+        }
+        const std::uint32_t biased = exponent == 0x1f ? 0xff : exponent - 15 + 127;
+        return detail::from_bits<float>(sign | (biased << 23) | (fraction << 13));
+    }
+};
+
+/**
+ * @brief A fixed point number, Int scaled by 2^-FractionBits.
+ */
+template <typename Int, int FractionBits>
+class fixed
+{
+    static_assert(std::is_integral<Int>::value, "fixed needs an integer type");
+    static_assert(FractionBits >= 0 && FractionBits < std::numeric_limits<Int>::digits + 1,
+        "fixed needs 0 <= FractionBits <= the bits of Int");
+
+private:
+
+    Int _raw;
+
+public:
+
+    constexpr fixed() noexcept
+        : _raw()
+    { }
+
+    /**
+     * @brief Rounded to nearest, asserts the result fits Int.
+     */
+    template <typename T, typename = std::enable_if_t<detail::is_elementary_v<T>>>
+    constexpr explicit fixed(T value)
+        : _raw()
+    {
+        const double product = static_cast<double>(value) * detail::pow2<double>(FractionBits);
+        // doubles from 2^52 are integers
+        const double scaled = detail::fabs(product) < 0x1p52 ? detail::nearest(product) : product;
+        // max + 1 is a power of two, exact where max is not
+        cgs_assert(scaled >= static_cast<double>(std::numeric_limits<Int>::min())
+            && scaled < static_cast<double>(std::numeric_limits<Int>::max()) + 1);
+        _raw = static_cast<Int>(scaled);
+    }
+
+    static constexpr fixed from_raw(Int raw) noexcept
+    {
+        fixed result;
+        result._raw = raw;
+        return result;
+    }
+
+    constexpr Int raw() const noexcept
+    {
+        return _raw;
+    }
+
+    template <typename T, typename = std::enable_if_t<detail::is_elementary_v<T>>>
+    constexpr explicit operator T() const noexcept
+    {
+        return static_cast<T>(_raw) * detail::pow2<T>(-FractionBits);
+    }
+};
+
+/**
+ * @brief The largest differences of a table from the function it approximates.
+ */
+template <typename T>
+struct table_error
+{
+    T max_abs;
+    // relative to the reference, where it is not zero
+    T max_rel;
+    // where max_abs is
+    T worst;
+};
+
+namespace detail
+{
+
+template <typename T>
+constexpr void table_error_add(table_error<T>& error, T at, T value, T reference) noexcept
+{
+    const T abs = value < reference ? reference - value : value - reference;
+    if(abs > error.max_abs) {
+        error.max_abs = abs;
+        error.worst = at;
+    }
+    if(reference != 0) {
+        const T rel = abs / (reference < 0 ? -reference : reference);
+        if(rel > error.max_rel) {
+            error.max_rel = rel;
+        }
+    }
+}
+
+template <typename Entry, typename T>
+using table_entry_t = std::conditional_t<std::is_void<Entry>::value, T, Entry>;
+
+} // namespace detail
+
+/**
+ * @brief N entries, cache line aligned.
+ */
+template <typename T, std::size_t N>
+class table
+{
+    static_assert(N > 0, "table needs at least one entry");
+
+private:
+
+    alignas(cache_line_size) std::array<T, N> _entries;
+
+public:
+
+    using value_type = T;
+
+    constexpr table() noexcept
+        : _entries()
+    { }
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    constexpr const T& operator[](std::size_t i) const
+    {
+        cgs_assert(i < N);
+        return _entries[i];
+    }
+
+    constexpr T& operator[](std::size_t i)
+    {
+        cgs_assert(i < N);
+        return _entries[i];
+    }
+
+    constexpr const T* data() const noexcept
+    {
+        return _entries.data();
+    }
+
+    constexpr const T* begin() const noexcept
+    {
+        return _entries.data();
+    }
+
+    constexpr const T* end() const noexcept
+    {
+        return _entries.data() + N;
+    }
+
+    /**
+     * @brief The error of each entry, converted to the result of reference(i), against reference(i).
+     */
+    template <typename F, typename R = std::decay_t<decltype(std::declval<F&>()(std::size_t{}))>>
+    constexpr table_error<R> error(F reference) const
+    {
+        static_assert(std::is_floating_point<R>::value, "table error needs a floating point reference");
+        table_error<R> result {};
+        for(std::size_t i = 0; i < N; ++i) {
+            detail::table_error_add(result, static_cast<R>(i), static_cast<R>(_entries[i]), reference(i));
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief f(i) for i in [0, N), each converted to Entry if given.
+ */
+template <std::size_t N, typename Entry = void, typename F>
+constexpr auto make_table(F f)
+{
+    using T = detail::table_entry_t<Entry, std::decay_t<decltype(f(std::size_t{}))>>;
+    table<T, N> result;
+    for(std::size_t i = 0; i < N; ++i) {
+        result[i] = T(f(i));
+    }
+    return result;
+}
+
+/**
+ * @brief A function sampled at N evenly spaced points of [min, max], read by linear interpolation.
+ *
+ * Arguments outside [min, max] are clamped, NaN reads max.
+ */
+template <typename T, std::size_t N, typename Entry = T>
+class lerp_table
+{
+    static_assert(std::is_floating_point<T>::value, "lerp_table needs a floating point argument");
+    static_assert(N >= 2, "lerp_table needs at least two entries");
+
+private:
+
+    table<Entry, N> _entries;
+    T _min;
+    T _max;
+    // entries per unit
+    T _scale;
+
+public:
+
+    using value_type = T;
+
+    /**
+     * @brief entries[i] is the value at lerp(min, max, i / (N - 1)).
+     */
+    constexpr lerp_table(const table<Entry, N>& entries, T min, T max)
+        : _entries(entries),
+          _min(min),
+          _max(max),
+          _scale(static_cast<T>(N - 1) / (max - min))
+    {
+        cgs_assert(min < max);
+    }
+
+    constexpr T min() const noexcept
+    {
+        return _min;
+    }
+
+    constexpr T max() const noexcept
+    {
+        return _max;
+    }
+
+    constexpr const table<Entry, N>& entries() const noexcept
+    {
+        return _entries;
+    }
+
+    /**
+     * @brief Where entries()[i] is sampled.
+     */
+    constexpr T node(std::size_t i) const noexcept
+    {
+        return lerp<finite_check::none>(_min, _max, static_cast<T>(i) / static_cast<T>(N - 1));
+    }
+
+    constexpr T operator()(T x) const noexcept
+    {
+        const T position = (clamp(x, _min, _max) - _min) * _scale;
+        // position rounds to at most N - 1, which interpolates the last interval at 1
+        const std::size_t truncated = static_cast<std::size_t>(position);
+        const std::size_t i = truncated < N - 2 ? truncated : N - 2;
+        return lerp<finite_check::none>(static_cast<T>(_entries[i]), static_cast<T>(_entries[i + 1]),
+            position - static_cast<T>(i));
+    }
+
+    /**
+     * @brief The error against reference at Samples evenly spaced points of [min, max].
+     *
+     * The default samples 16 points per interval, linear interpolation error peaks between the entries.
+     */
+    template <typename F>
+    constexpr table_error<T> error(F reference, std::size_t samples = 16 * (N - 1) + 1) const
+    {
+        cgs_assert(samples >= 2);
+        table_error<T> result {};
+        for(std::size_t i = 0; i < samples; ++i) {
+            const T x = lerp<finite_check::none>(_min, _max, static_cast<T>(i) / static_cast<T>(samples - 1));
+            detail::table_error_add(result, x, (*this)(x), static_cast<T>(reference(x)));
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief f at N evenly spaced points of [min, max], each converted to Entry if given.
+ */
+template <std::size_t N, typename Entry = void, typename T, typename F>
+constexpr auto make_lerp_table(F f, T min, T max)
+{
+    using E = detail::table_entry_t<Entry, T>;
+    table<E, N> entries;
+    for(std::size_t i = 0; i < N; ++i) {
+        entries[i] = E(f(lerp<finite_check::none>(min, max, static_cast<T>(i) / static_cast<T>(N - 1))));
+    }
+    return lerp_table<T, N, E>(entries, min, max);
+}
+
+} // namespace cgs
+
+#endif // CGS_TABLE_HPP
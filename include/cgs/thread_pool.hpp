@@ -0,0 +1,205 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef CGS_THREAD_POOL_HPP
+#define CGS_THREAD_POOL_HPP
+
+#include "cgs/assert.hpp" // CGS_DETAIL_EXCEPTIONS
+
+#include <algorithm> // min
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <deque>
+#include <exception> // exception_ptr
+#include <functional> // function
+#include <memory> // shared_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgs
+{
+
+/**
+ * @brief Fixed set of worker threads, running submitted tasks in order.
+ *
+ * Used by the parallel execution policies, see "cgs/execution.hpp".
+ */
+class thread_pool
+{
+private:
+
+    std::mutex _mutex {};
+    std::condition_variable _wake {};
+    std::deque<std::function<void()>> _tasks {};
+    bool _stopping {};
+
+    // last, so every other member is ready when the workers start
+    std::vector<std::thread> _threads {};
+
+    void work()
+    {
+        for(;;) {
+            std::function<void()> task {};
+            {
+                std::unique_lock<std::mutex> lock { _mutex };
+                _wake.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+                if(_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+
+    /**
+     * @brief Workers to add to a calling thread, to use every hardware thread.
+     */
+    static std::size_t default_size() noexcept
+    {
+        const std::size_t hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+    /**
+     * @brief Shared pool used by cgs::execution::par, created on first use.
+     */
+    static thread_pool& global()
+    {
+        static thread_pool pool {};
+        return pool;
+    }
+
+    explicit thread_pool(std::size_t threads = default_size())
+    {
+        _threads.reserve(threads);
+        for(std::size_t i = 0; i < threads; ++i) {
+            _threads.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /**
+     * @brief Finishes every submitted task, then joins the workers.
+     */
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock { _mutex };
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for(auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _threads.size();
+    }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock { _mutex };
+            _tasks.push_back(std::move(task));
+        }
+        _wake.notify_one();
+    }
+
+    /**
+     * @brief Call f(i) for every i in [0, count), and wait for them all.
+     *
+     * The calling thread runs iterations too, so this makes progress even when every worker is busy,
+     * and may be nested inside another parallel_for.
+     * If any iteration throws, the first exception is rethrown here after the others finish.
+     */
+    template <typename F>
+    void parallel_for(std::size_t count, F f)
+    {
+        if(count == 0) {
+            return;
+        }
+        if(count == 1 || _threads.empty()) {
+            for(std::size_t i = 0; i < count; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        // Workers may start after every iteration is done, and after we return.
+        // They share ownership of the counters, and only touch f while iterations remain.
+        struct shared_state
+        {
+            std::atomic<std::size_t> next {};
+            std::atomic<std::size_t> remaining {};
+            std::mutex mutex {};
+            std::condition_variable done {};
+#ifdef CGS_DETAIL_EXCEPTIONS
+            std::exception_ptr error {};
+#endif
+        };
+        auto state = std::make_shared<shared_state>();
+        state->remaining = count;
+
+        const auto run = [state, count, fp = &f] {
+            for(std::size_t i; (i = state->next++) < count; ) {
+#ifdef CGS_DETAIL_EXCEPTIONS
+                try {
+                    (*fp)(i);
+                }
+                catch(...) {
+                    std::lock_guard<std::mutex> lock { state->mutex };
+                    if(!state->error) {
+                        state->error = std::current_exception();
+                    }
+                }
+#else
+                (*fp)(i);
+#endif
+                if(--state->remaining == 0) {
+                    std::lock_guard<std::mutex> lock { state->mutex };
+                    state->done.notify_all();
+                }
+            }
+        };
+
+        const std::size_t helpers = std::min(_threads.size(), count - 1);
+        for(std::size_t h = 0; h < helpers; ++h) {
+            submit(run);
+        }
+        run();
+
+        std::unique_lock<std::mutex> lock { state->mutex };
+        state->done.wait(lock, [&state] { return state->remaining == 0; });
+#ifdef CGS_DETAIL_EXCEPTIONS
+        if(state->error) {
+            std::rethrow_exception(state->error);
+        }
+#endif
+    }
+};
+
+} // namespace cgs
+
+#endif // CGS_THREAD_POOL_HPP
@@ -20,6 +20,14 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
 
 constexpr auto fillArray()
 {
@@ -37,6 +45,61 @@ TEST(Algorithm, Fill)
     EXPECT_EQ(filled[2], 20);
 }
 
+namespace
+{
+
+struct Rgba
+{
+    unsigned char r, g, b, a;
+};
+
+template <typename T>
+void expectContiguousFill(T value, T guard)
+{
+    // sizes and offsets around vector widths, so every head, body, and tail is covered
+    for(std::size_t size : { 0, 1, 3, 64, 255, 256, 257, 1000, 4099 }) {
+        for(std::size_t offset : { 0, 1, 3 }) {
+            std::vector<T> data(size + offset + 1, guard);
+            T* first = data.data() + offset;
+            cgs::fill(first, first + size, value);
+            for(std::size_t i = 0; i < data.size(); ++i) {
+                const bool inside = i >= offset && i < offset + size;
+                EXPECT_EQ(std::memcmp(&data[i], inside ? &value : &guard, sizeof(T)), 0)
+                    << "size " << size << " offset " << offset << " index " << i;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(Algorithm, FillContiguous)
+{
+    using cgs::simd::isa;
+    const std::size_t threshold = cgs::fill_streaming_threshold();
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        // 0 streams every fill, SIZE_MAX none
+        for(std::size_t streamFrom : { std::size_t{0}, std::numeric_limits<std::size_t>::max() }) {
+            cgs::set_fill_streaming_threshold(streamFrom);
+            expectContiguousFill<char>('x', 'g');
+            expectContiguousFill<std::uint16_t>(0xabcd, 1);
+            expectContiguousFill<int>(-7, 2);
+            expectContiguousFill<double>(0.5, 3.0);
+            expectContiguousFill<Rgba>({ 1, 2, 3, 4 }, { 9, 9, 9, 9 });
+            // 12 bytes does not tile a vector, assigns one by one
+            expectContiguousFill<std::array<int, 3>>({ 1, 2, 3 }, { 0, 0, 0 });
+            expectContiguousFill<std::array<double, 2>>({ 1.0, 2.0 }, { 0.0, 0.0 });
+        }
+    }
+    cgs::set_fill_streaming_threshold(threshold);
+
+    // converts once, like assigning value to each element
+    std::vector<int> ints(1000);
+    cgs::fill(ints.data(), ints.data() + ints.size(), 2.75);
+    EXPECT_EQ(std::count(ints.begin(), ints.end(), 2), 1000);
+}
+
 constexpr int transformReduceArray()
 {
     return cgs::transform_reduce(filled.begin(), filled.end(),
@@ -80,3 +143,184 @@ TEST(Algorithm, TransformReduceStruct)
     EXPECT_EQ(minAge, 15);
     EXPECT_EQ(maxAge, 45);
 }
+
+constexpr int unseqConstexpr = cgs::transform_reduce(cgs::execution::unseq, people.begin(), people.end(),
+    getAge,
+    std::plus<int>{}
+);
+
+TEST(Algorithm, TransformReduceUnseqConstexpr)
+{
+    static_assert(unseqConstexpr == 45 + 15 + 21);
+}
+
+TEST(Algorithm, TransformReduceUnseq)
+{
+    // every size around the pack and accumulator boundaries, to cover seeding and tails
+    for(int size = 0; size < 300; ++size) {
+        std::vector<int> ints(static_cast<std::size_t>(size));
+        std::iota(ints.begin(), ints.end(), -50);
+
+        const auto minus1 = [](int val) { return val - 1; };
+        const int expected = cgs::transform_reduce(ints.begin(), ints.end(), minus1, std::plus<int>{}, 7);
+
+        // contiguous, with pack operators
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, ints.data(), ints.data() + size,
+            minus1, std::plus<int>{}, 7), expected);
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, ints.data(), ints.data() + size,
+            minus1, std::plus<>{}, 7), expected);
+
+        // contiguous, with a lane by lane binaryOp
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, ints.data(), ints.data() + size,
+            minus1, cgs::min2<int>, std::numeric_limits<int>::max()),
+            size == 0 ? std::numeric_limits<int>::max() : -51);
+
+        // random access, not contiguous
+        std::deque<int> deque(ints.begin(), ints.end());
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, deque.begin(), deque.end(),
+            minus1, std::plus<int>{}, 7), expected);
+
+        // not random access
+        std::list<int> list(ints.begin(), ints.end());
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, list.begin(), list.end(),
+            minus1, std::plus<int>{}, 7), expected);
+    }
+}
+
+TEST(Algorithm, TransformReduceUnseqFloat)
+{
+    // small integers sum exactly in any order
+    std::vector<float> floats(1000);
+    std::iota(floats.begin(), floats.end(), 1.0f);
+    const auto identity = [](float val) { return val; };
+    EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, floats.data(), floats.data() + floats.size(),
+        identity, std::plus<float>{}), 500500.0f);
+    EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, floats.data(), floats.data() + floats.size(),
+        identity, cgs::max2<float>), 1000.0f);
+
+    std::vector<double> doubles(floats.begin(), floats.end());
+    EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, doubles.data(), doubles.data() + doubles.size(),
+        [](double val) { return val * 2.0; }, std::plus<>{}), 1001000.0);
+}
+
+TEST(Algorithm, TransformReduceUnseqDispatch)
+{
+    std::vector<float> floats(1000);
+    std::iota(floats.begin(), floats.end(), 1.0f);
+    const auto identity = [](float val) { return val; };
+
+    // every kernel the CPU supports gives the same exact sum
+    using cgs::simd::isa;
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, floats.data(), floats.data() + floats.size(),
+            identity, std::plus<float>{}), 500500.0f) << cgs::simd::to_string(level);
+    }
+}
+
+TEST(Algorithm, TransformReduceUnseqStruct)
+{
+    // people is contiguous, but Person is not arithmetic, the transformed int is
+    std::vector<Person> many(100, Person{30});
+    many[57].age = 99;
+    EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, many.data(), many.data() + many.size(),
+        getAge, cgs::max2<int>), 99);
+    EXPECT_EQ(cgs::transform_reduce(cgs::execution::unseq, many.begin(), many.end(),
+        getAge, std::plus<int>{}), 99 * 30 + 99);
+}
+
+TEST(Algorithm, Policies)
+{
+    static_assert(cgs::execution::is_execution_policy_v<cgs::execution::sequenced_policy>);
+    static_assert(cgs::execution::is_execution_policy_v<cgs::execution::parallel_unsequenced_policy>);
+    static_assert(!cgs::execution::is_execution_policy_v<int>);
+
+    constexpr int seqMax = cgs::transform_reduce(cgs::execution::seq, people.begin(), people.end(),
+        getAge, cgs::max2<int>);
+    static_assert(seqMax == 45);
+
+    // constant evaluation is sequential
+    constexpr int parMin = cgs::transform_reduce(cgs::execution::par, people.begin(), people.end(),
+        getAge, cgs::min2<int>, std::numeric_limits<int>::max());
+    static_assert(parMin == 15);
+}
+
+constexpr auto parFillArray()
+{
+    std::array<int, 3> result {};
+    cgs::fill(cgs::execution::par, result.begin(), result.end(), 20);
+    return result;
+}
+
+TEST(Algorithm, FillParallel)
+{
+    static_assert(parFillArray()[2] == 20);
+
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy policy {};
+    policy.pool = &pool;
+    policy.min_chunk = 10;
+
+    for(std::size_t size : { 0, 1, 9, 10, 39, 40, 41, 1000 }) {
+        std::vector<int> ints(size, -1);
+        cgs::fill(policy, ints.begin(), ints.end(), 7);
+        EXPECT_EQ(std::count(ints.begin(), ints.end(), 7), static_cast<std::ptrdiff_t>(size));
+
+        std::list<int> list(size, -1);
+        cgs::fill(policy, list.begin(), list.end(), 7);
+        EXPECT_EQ(std::count(list.begin(), list.end(), 7), static_cast<std::ptrdiff_t>(size));
+    }
+
+    // default pool
+    std::vector<int> big(100000, -1);
+    cgs::fill(cgs::execution::par_unseq, big.begin(), big.end(), 3);
+    EXPECT_EQ(std::count(big.begin(), big.end(), 3), 100000);
+}
+
+TEST(Algorithm, TransformReduceParallel)
+{
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy par {};
+    par.pool = &pool;
+    par.min_chunk = 10;
+    cgs::execution::parallel_unsequenced_policy parUnseq {};
+    parUnseq.pool = &pool;
+    parUnseq.min_chunk = 10;
+
+    const auto minus1 = [](int val) { return val - 1; };
+    // the sums of the larger sizes do not fit in an int
+    const auto minus1Wide = [](int val) { return static_cast<std::int64_t>(val) - 1; };
+    const std::plus<std::int64_t> plus {};
+    for(int size : { 0, 1, 9, 10, 39, 40, 41, 1000, 100000 }) {
+        std::vector<int> ints(static_cast<std::size_t>(size));
+        std::iota(ints.begin(), ints.end(), -50);
+        const std::int64_t expected = cgs::transform_reduce(ints.begin(), ints.end(), minus1Wide, plus, std::int64_t { 7 });
+
+        EXPECT_EQ(cgs::transform_reduce(par, ints.begin(), ints.end(), minus1Wide, plus, std::int64_t { 7 }), expected);
+        EXPECT_EQ(cgs::transform_reduce(parUnseq, ints.data(), ints.data() + size, minus1Wide, plus, std::int64_t { 7 }), expected);
+        EXPECT_EQ(cgs::transform_reduce(parUnseq, ints.begin(), ints.end(), minus1, cgs::min2<int>, 1000),
+            size == 0 ? 1000 : -51);
+        EXPECT_EQ(cgs::transform_reduce(cgs::execution::par, ints.begin(), ints.end(), minus1Wide, plus, std::int64_t { 7 }), expected);
+    }
+
+    // associative, but not commutative: chunks combine in order
+    std::vector<std::string> words(100, "a");
+    words.front() = "<";
+    words.back() = ">";
+    const std::string joined = cgs::transform_reduce(par, words.begin(), words.end(),
+        [](const std::string& word) { return word; }, std::plus<std::string>{});
+    EXPECT_EQ(joined, "<" + std::string(98, 'a') + ">");
+}
+
+TEST(Algorithm, ParallelThrow)
+{
+    cgs::thread_pool pool { 2 };
+    cgs::execution::parallel_policy policy {};
+    policy.pool = &pool;
+    policy.min_chunk = 1;
+
+    std::vector<int> ints(10, 1);
+    ints[7] = 0;
+    EXPECT_THROW(cgs::transform_reduce(policy, ints.begin(), ints.end(),
+        [](int val) { cgs_assert(val != 0); return val; }, std::plus<int>{}), std::logic_error);
+}
@@ -28,7 +28,7 @@ TEST(Assert, ManualAbort)
 static int saved = 0;
 static bool save(int value) {
     saved = value;
-    return false;
+    return true;
 }
 
 TEST(Assert, ManualIgnore)
@@ -54,3 +54,102 @@ TEST(Assert, ManualThrow)
             << "Expected: \"" << reString << "\"\n";
     }
 }
+
+TEST(Assert, ManualCompareAbort)
+{
+    const int i = 7;
+    const int size = 5;
+    cgs_assert_compare_abort(size, <, i);
+    EXPECT_DEATH(cgs_assert_compare_abort(i, <, size), R"(Assertion failed \(i < size\) at .*/test/assert\.cpp:63 with i = 7, size = 5)");
+}
+
+TEST(Assert, ManualCompareIgnore)
+{
+    saved = 0;
+    cgs_assert_compare_ignore(save(1), ==, true);
+    EXPECT_EQ(saved, 0);
+}
+
+static int evaluated = 0;
+static int next() {
+    return ++evaluated;
+}
+
+// what() of the logic_error thrown by cgs_assert_compare_throw(lhs, op, rhs)
+#define compare_message(lhs, op, rhs) ([&]() -> std::string { \
+    try { \
+        cgs_assert_compare_throw(lhs, op, rhs); \
+    } \
+    catch(const std::logic_error& e) { \
+        return e.what(); \
+    } \
+    return "not thrown"; \
+}())
+
+TEST(Assert, ManualCompareThrow)
+{
+    // operands are evaluated once
+    evaluated = 0;
+    cgs_assert_compare_throw(next(), ==, 1);
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_EQ(compare_message(next(), <=, 1), "Assertion failed (next() <= 1) at " __FILE__ ":95 with next() = 2");
+    EXPECT_EQ(evaluated, 2);
+
+    // literals are not repeated
+    EXPECT_EQ(compare_message(2, <, 1), "Assertion failed (2 < 1) at " __FILE__ ":99");
+}
+
+enum class color { red, green };
+
+TEST(Assert, CompareOperandFormat)
+{
+    const auto expectWith = [](const std::string& message, const std::string& with) {
+        const std::size_t found = message.find(" with ");
+        ASSERT_NE(found, std::string::npos) << message;
+        EXPECT_EQ(message.substr(found + 6), with);
+    };
+
+    const long long negative = -3;
+    const unsigned long long big = 18446744073709551615u;
+    expectWith(compare_message(negative, ==, -4), "negative = -3");
+    expectWith(compare_message(big - 1, ==, big), "big - 1 = 18446744073709551614, big = 18446744073709551615");
+
+    const double half = 0.5;
+    const float third = 1.0f / 3;
+    expectWith(compare_message(half, <, third), "half = 0.5, third = 0.333333343");
+
+    const bool yes = true;
+    const color c = color::green;
+    expectWith(compare_message(yes, ==, false), "yes = true");
+    expectWith(compare_message(c, ==, color::red), "c = 1, color::red = 0");
+
+    const decltype(nullptr) none {};
+    const int* some = &evaluated;
+    const std::string pointers = compare_message(none, ==, some);
+    EXPECT_NE(pointers.find(" with none = nullptr, some = 0x"), std::string::npos) << pointers;
+
+    const std::string text = "text";
+    expectWith(compare_message(text, ==, "other"), "text = ?, \"other\" = ?");
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 int128;
+    const int128 huge = -(static_cast<int128>(1) << 100);
+    expectWith(compare_message(huge, >, 0), "huge = -1267650600228229401496703205376");
+    expectWith(compare_message(huge, ==, huge / 10 * 10 + 1),
+        "huge = -1267650600228229401496703205376, huge / 10 * 10 + 1 = -1267650600228229401496703205369");
+#endif
+}
+
+// assertions have no closure, so they can be in a signature
+template <typename T>
+static auto checkedPositive(T value) -> decltype(cgs_assert(value > 0), cgs_assert_lt(0, value), T {})
+{
+    return value;
+}
+
+TEST(Assert, Unevaluated)
+{
+    EXPECT_EQ(checkedPositive(3), 3);
+    // only the type of the assertion is used
+    EXPECT_EQ(checkedPositive(-1.5), -1.5);
+}
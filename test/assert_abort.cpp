@@ -25,3 +25,10 @@ TEST(Assert, Abort)
     cgs_assert(2 + 2 == 4);
     EXPECT_DEATH(cgs_assert(2 + 2 == 5), R"(Assertion failed \(2 \+ 2 == 5\) at .*/test/assert_abort\.cpp:26)");
 }
+
+TEST(Assert, AbortCompare)
+{
+    const int size = 4;
+    cgs_assert_lt(3, size);
+    EXPECT_DEATH(cgs_assert_lt(4, size), R"(Assertion failed \(4 < size\) at .*/test/assert_abort\.cpp:33 with size = 4)");
+}
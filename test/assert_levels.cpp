@@ -0,0 +1,172 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_ABORT
+#include "cgs/assert.hpp"
+
+#include <functional>
+#include <utility>
+
+using cgs::violation;
+
+static int evaluated = 0;
+static bool count(bool result) {
+    ++evaluated;
+    return result;
+}
+
+// each level of a namespace set to a different violation, four namespaces cover every pair
+#define DEFINE_LEVELS(name, cheapViolation, normalViolation, expensiveViolation) \
+    namespace name { \
+    constexpr cgs::assert_levels cgs_assert_levels { cheapViolation, normalViolation, expensiveViolation }; \
+    static void cheap(bool result) { cgs_assert_cheap(count(result)); } \
+    static void normal(bool result) { cgs_assert(count(result)); } \
+    static void expensive(bool result) { cgs_assert_expensive(count(result)); } \
+    }
+
+DEFINE_LEVELS(levels0, violation::abort, violation::ignore, violation::throw_)
+DEFINE_LEVELS(levels1, violation::ignore, violation::throw_, violation::sample)
+DEFINE_LEVELS(levels2, violation::throw_, violation::sample, violation::abort)
+DEFINE_LEVELS(levels3, violation::sample, violation::abort, violation::ignore)
+
+// check that `assertion` behaves as `expected`
+static void expectViolation(violation expected, const std::function<void(bool)>& assertion)
+{
+    evaluated = 0;
+    switch(expected) {
+    case violation::abort:
+        assertion(true);
+        EXPECT_EQ(evaluated, 1);
+        EXPECT_DEATH(assertion(false), R"(Assertion failed \(count\(result\)\) at .*/test/assert_levels\.cpp:)");
+        break;
+    case violation::ignore:
+        assertion(true);
+        EXPECT_EQ(evaluated, 0);
+        break;
+    case violation::throw_:
+        assertion(true);
+        EXPECT_EQ(evaluated, 1);
+        EXPECT_THROW(assertion(false), std::logic_error);
+        EXPECT_EQ(evaluated, 2);
+        break;
+    case violation::sample:
+        for(int i = 0; i < 100; ++i) {
+            assertion(true);
+        }
+        // hits 1, 17, 33, ... 97
+        EXPECT_EQ(evaluated, 7);
+        EXPECT_DEATH({
+            for(int i = 0; i < CGS_SAMPLE_PERIOD; ++i) {
+                assertion(false);
+            }
+        }, R"(Assertion failed \(count\(result\)\) at .*/test/assert_levels\.cpp:)");
+        break;
+    }
+}
+
+TEST(AssertLevels, Namespace)
+{
+    expectViolation(violation::abort, levels0::cheap);
+    expectViolation(violation::ignore, levels0::normal);
+    expectViolation(violation::throw_, levels0::expensive);
+
+    expectViolation(violation::ignore, levels1::cheap);
+    expectViolation(violation::throw_, levels1::normal);
+    expectViolation(violation::sample, levels1::expensive);
+
+    expectViolation(violation::throw_, levels2::cheap);
+    expectViolation(violation::sample, levels2::normal);
+    expectViolation(violation::abort, levels2::expensive);
+
+    expectViolation(violation::sample, levels3::cheap);
+    expectViolation(violation::abort, levels3::normal);
+    expectViolation(violation::ignore, levels3::expensive);
+}
+
+TEST(AssertLevels, TranslationUnit)
+{
+    // outside the namespaces, every level has this file's CGS_VIOLATE_ABORT
+    static_assert(::cgs_assert_levels.cheap == violation::abort);
+    static_assert(::cgs_assert_levels.normal == violation::abort);
+    static_assert(::cgs_assert_levels.expensive == violation::abort);
+    expectViolation(violation::abort, [](bool result) { cgs_assert_expensive(count(result)); });
+}
+
+struct validated
+{
+    // a class sets the levels of its members
+    static constexpr cgs::assert_levels cgs_assert_levels { violation::throw_, violation::throw_, violation::ignore };
+
+    static void lt(int a, int b) {
+        cgs_assert_lt(a, b);
+    }
+
+    static void expensive(bool result) {
+        cgs_assert_expensive(count(result));
+    }
+};
+
+TEST(AssertLevels, Class)
+{
+    EXPECT_THROW(validated::lt(2, 1), std::logic_error);
+    expectViolation(violation::ignore, validated::expensive);
+}
+
+namespace levels0
+{
+
+static constexpr int checkedHalf(int value)
+{
+    cgs_assert_cheap(value % 2 == 0);
+    cgs_assert(value % 2 == 0);
+    return value / 2;
+}
+
+} // namespace levels0
+
+TEST(AssertLevels, Constexpr)
+{
+    static_assert(levels0::checkedHalf(4) == 2);
+    EXPECT_EQ(levels0::checkedHalf(6), 3);
+}
+
+// an ignored level does not use its expression, so it may call a function that is never defined
+bool neverDefined();
+
+namespace levels0
+{
+
+// assertions are expressions, so they work in any initializer
+const int namespaceInitializer = (cgs_assert_cheap(evaluated >= 0), cgs_assert(neverDefined()), 1);
+
+struct memberInitializer
+{
+    int value = (cgs_assert_cheap(namespaceInitializer == 1), 2);
+};
+
+} // namespace levels0
+
+TEST(AssertLevels, Expression)
+{
+    EXPECT_EQ(levels0::namespaceInitializer, 1);
+    EXPECT_EQ(levels0::memberInitializer{}.value, 2);
+
+    // nothing is captured, so structured bindings can be asserted on
+    const auto [low, high] = std::pair<int, int>{ 1, 2 };
+    cgs_assert(low < high);
+    cgs_assert_lt(low, high);
+}
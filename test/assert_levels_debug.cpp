@@ -0,0 +1,46 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+// expensive checks off in the debug build, cheap ones throw
+#undef NDEBUG
+#define CGS_VIOLATE_CHEAP_THROW
+#define CGS_VIOLATE_EXPENSIVE_IGNORE
+#include "cgs/assert.hpp"
+
+static int saved = 0;
+static bool save(int value) {
+    saved = value;
+    return false;
+}
+
+TEST(AssertLevels, DebugCheapThrows)
+{
+    cgs_assert_cheap(2 + 2 == 4);
+    EXPECT_THROW(cgs_assert_cheap(2 + 2 == 5), std::logic_error);
+}
+
+TEST(AssertLevels, DebugAborts)
+{
+    cgs_assert(2 + 2 == 4);
+    EXPECT_DEATH(cgs_assert(2 + 2 == 5), R"(Assertion failed \(2 \+ 2 == 5\) at .*/test/assert_levels_debug\.cpp:39)");
+}
+
+TEST(AssertLevels, DebugExpensiveNotEvaluated)
+{
+    cgs_assert_expensive(save(1));
+    EXPECT_EQ(saved, 0);
+}
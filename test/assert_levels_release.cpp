@@ -0,0 +1,41 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+// cheap checks stay in the release build
+#define NDEBUG
+#define CGS_VIOLATE_CHEAP_ABORT
+#include "cgs/assert.hpp"
+
+static int saved = 0;
+static bool save(int value) {
+    saved = value;
+    return true;
+}
+
+TEST(AssertLevels, ReleaseCheapAborts)
+{
+    cgs_assert_cheap(2 + 2 == 4);
+    EXPECT_DEATH(cgs_assert_cheap(2 + 2 == 5), R"(Assertion failed \(2 \+ 2 == 5\) at .*/test/assert_levels_release\.cpp:32)");
+}
+
+TEST(AssertLevels, ReleaseNotEvaluated)
+{
+    cgs_assert(save(1));
+    cgs_assert_expensive(save(2));
+    cgs_assert_eq(save(3), true);
+    EXPECT_EQ(saved, 0);
+}
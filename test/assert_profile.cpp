@@ -0,0 +1,137 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#define CGS_ASSERT_PROFILE
+#include "cgs/assert.hpp"
+
+#include <cstdio> // tmpfile
+#include <string>
+#include <thread>
+
+// the profile of the site ending in `file:line`
+static cgs::assert_profile_entry find_site(int line)
+{
+    const std::string suffix = "assert_profile.cpp:" + std::to_string(line);
+    for(const cgs::assert_profile_entry& entry : cgs::assert_profile()) {
+        const std::string site = entry.site;
+        if(site.size() >= suffix.size() && site.compare(site.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            return entry;
+        }
+    }
+    return { "", "", 0, 0 };
+}
+
+static bool slow(int rounds)
+{
+    volatile unsigned sum = 0;
+    for(int i = 0; i < rounds; ++i) {
+        sum = sum + static_cast<unsigned>(i);
+    }
+    return sum != 1;
+}
+
+TEST(AssertProfile, Hits)
+{
+    for(int i = 0; i < 10; ++i) {
+        cgs_assert(i >= 0);
+    }
+    const cgs::assert_profile_entry entry = find_site(__LINE__ - 2);
+    EXPECT_EQ(entry.hits, 10u);
+    EXPECT_STREQ(entry.expression, "i >= 0");
+
+    // a failed assertion is a hit too
+    EXPECT_THROW(cgs_assert(1 + 1 == 3), std::logic_error);
+    EXPECT_EQ(find_site(__LINE__ - 1).hits, 1u);
+}
+
+TEST(AssertProfile, Threads)
+{
+    const auto hit = [] {
+        for(int i = 0; i < 100; ++i) {
+            cgs_assert(i < 100);
+        }
+    };
+    const int line = __LINE__ - 3;
+    std::thread first { hit };
+    std::thread second { hit };
+    first.join();
+    second.join();
+    hit();
+    // merged into one entry, also after the threads exited
+    EXPECT_EQ(find_site(line).hits, 300u);
+}
+
+TEST(AssertProfile, SortedByCycles)
+{
+    for(int i = 0; i < 10; ++i) {
+        cgs_assert(slow(100000));
+        cgs_assert(slow(1));
+    }
+    const cgs::assert_profile_entry slowEntry = find_site(__LINE__ - 3);
+    const cgs::assert_profile_entry fastEntry = find_site(__LINE__ - 3);
+    EXPECT_GT(slowEntry.cycles, fastEntry.cycles);
+
+    const std::vector<cgs::assert_profile_entry> entries = cgs::assert_profile();
+    for(std::size_t i = 1; i < entries.size(); ++i) {
+        EXPECT_GE(entries[i - 1].cycles, entries[i].cycles);
+    }
+    EXPECT_STREQ(entries.front().expression, "slow(100000)");
+}
+
+static std::string written(cgs::assert_profile_format format)
+{
+    std::FILE* file = std::tmpfile();
+    cgs::write_assert_profile(file, format);
+    std::rewind(file);
+    std::string text;
+    for(int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        text += static_cast<char>(c);
+    }
+    std::fclose(file);
+    return text;
+}
+
+TEST(AssertProfile, Write)
+{
+    const char* text = "\"quoted\\";
+    for(int i = 0; i < 3; ++i) {
+        cgs_assert(text != nullptr && *text == '"');
+    }
+
+    const std::string csv = written(cgs::assert_profile_format::csv);
+    EXPECT_EQ(csv.rfind("site,expression,hits,cycles,cycles_per_hit\n", 0), 0u);
+    EXPECT_NE(csv.find(R"(,"text != nullptr && *text == '""'",3,)"), std::string::npos);
+
+    const std::string json = written(cgs::assert_profile_format::json);
+    EXPECT_EQ(json.front(), '[');
+    EXPECT_NE(json.find(R"("expression": "text != nullptr && *text == '\"'", "hits": 3, )"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 3), "\n]\n");
+}
+
+static constexpr int checkedHalf(int value)
+{
+    cgs_assert(value % 2 == 0);
+    return value / 2;
+}
+
+TEST(AssertProfile, Constexpr)
+{
+    // not recorded at compile time
+    static_assert(checkedHalf(4) == 2);
+    EXPECT_EQ(checkedHalf(6), 3);
+}
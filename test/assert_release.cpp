@@ -21,14 +21,20 @@
 static int saved = 0;
 static bool save(int value) {
     saved = value;
-    return false;
+    return true;
+}
+static int saveInt(int value) {
+    saved = value;
+    return value;
 }
 
 TEST(Assert, ReleaseNotEvaluated)
 {
     cgs_assert(true);
-    cgs_assert(false);
     EXPECT_EQ(saved, 0);
     cgs_assert(save(1));
     EXPECT_EQ(saved, 0);
+    cgs_assert_eq(save(2), true);
+    cgs_assert_lt(1, saveInt(3));
+    EXPECT_EQ(saved, 0);
 }
@@ -0,0 +1,166 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_SAMPLE
+#define CGS_SAMPLE_PERIOD 4
+#include "cgs/assert.hpp"
+
+#include <cstdint>
+#include <cstdlib> // setenv
+#include <string>
+#include <thread>
+
+static int evaluated = 0;
+static bool count() {
+    ++evaluated;
+    return true;
+}
+
+TEST(Assert, SampleEveryNth)
+{
+    evaluated = 0;
+    for(int i = 0; i < 100; ++i) {
+        cgs_assert(count());
+    }
+    // the first hit, then every 4th
+    EXPECT_EQ(evaluated, 25);
+
+    // each site counts separately
+    evaluated = 0;
+    cgs_assert(count());
+    cgs_assert(count());
+    EXPECT_EQ(evaluated, 2);
+}
+
+TEST(Assert, SampleAborts)
+{
+    cgs_assert(2 + 2 == 4);
+    EXPECT_DEATH(cgs_assert(2 + 2 == 5), R"(Assertion failed \(2 \+ 2 == 5\) at .*/test/assert_sample\.cpp:52)");
+}
+
+TEST(Assert, SampleSiteRate)
+{
+    evaluated = 0;
+    for(int i = 0; i < 100; ++i) {
+        cgs_assert_sample_every(count(), 10);
+    }
+    EXPECT_EQ(evaluated, 10);
+
+    // 0 turns the site off
+    evaluated = 0;
+    for(int i = 0; i < 100; ++i) {
+        cgs_assert_sample_every(count(), 0);
+    }
+    EXPECT_EQ(evaluated, 0);
+}
+
+TEST(Assert, SamplePerThread)
+{
+    evaluated = 0;
+    const auto hit = [] {
+        for(int i = 0; i < 5; ++i) {
+            cgs_assert(count());
+        }
+    };
+    hit();
+    EXPECT_EQ(evaluated, 2);
+    // a new thread starts its own count, and evaluates its first hit
+    std::thread { hit }.join();
+    EXPECT_EQ(evaluated, 4);
+}
+
+TEST(Assert, SampleEnvironment)
+{
+    // sites read the variable on their first hit, the next line's site is set to every hit
+    const std::string site = "assert_sample.cpp:" + std::to_string(__LINE__ + 6);
+    const std::string value = "1000," + site + "=1,other.cpp:1=7";
+    ASSERT_EQ(setenv("CGS_SAMPLE_PERIOD", value.c_str(), 1), 0);
+
+    evaluated = 0;
+    for(int i = 0; i < 10; ++i) {
+        cgs_assert(count());
+    }
+    EXPECT_EQ(evaluated, 10);
+
+    // other sites use the default from the variable
+    evaluated = 0;
+    for(int i = 0; i < 10; ++i) {
+        cgs_assert(count());
+    }
+    EXPECT_EQ(evaluated, 1);
+
+    unsetenv("CGS_SAMPLE_PERIOD");
+}
+
+// the period of site with CGS_SAMPLE_PERIOD set to value, 4 if it is not set there
+static std::uint32_t envPeriod(const char* value, const char* site = "src/a.cpp:10")
+{
+    setenv("CGS_SAMPLE_PERIOD", value, 1);
+    const std::uint32_t period = cgs::detail::assert_sample_env_period(site, 4);
+    unsetenv("CGS_SAMPLE_PERIOD");
+    return period;
+}
+
+TEST(Assert, SampleEnvironmentParse)
+{
+    EXPECT_EQ(envPeriod("8"), 8u);
+    EXPECT_EQ(envPeriod("0"), 0u);
+    EXPECT_EQ(envPeriod("8,a.cpp:10=2"), 2u);
+    EXPECT_EQ(envPeriod("a.cpp:10=2,8"), 2u);
+    EXPECT_EQ(envPeriod("8,b/a.cpp:10=2"), 8u);
+    EXPECT_EQ(envPeriod("8,xa.cpp:10=2"), 8u);
+    // patterns longer than the site
+    EXPECT_EQ(envPeriod("8,some/long/path/src/a.cpp:10=2"), 8u);
+
+    // malformed numbers are ignored, not read as 0
+    EXPECT_EQ(envPeriod("abc"), 4u);
+    EXPECT_EQ(envPeriod("12x"), 4u);
+    EXPECT_EQ(envPeriod(""), 4u);
+    EXPECT_EQ(envPeriod("-1"), 4u);
+    EXPECT_EQ(envPeriod("4294967296"), 4u);
+    EXPECT_EQ(envPeriod("4294967295"), 4294967295u);
+    EXPECT_EQ(envPeriod("8,a.cpp:10=abc"), 8u);
+    EXPECT_EQ(envPeriod("8,a.cpp:10="), 8u);
+    EXPECT_EQ(envPeriod("a.cpp:10=x,8"), 8u);
+}
+
+static constexpr int checkedHalf(int value)
+{
+    cgs_assert(value % 2 == 0);
+    return value / 2;
+}
+
+TEST(Assert, SampleConstexpr)
+{
+    // always evaluated at compile time
+    static_assert(checkedHalf(4) == 2);
+    EXPECT_EQ(checkedHalf(6), 3);
+}
+
+// the sample arm has no closure either, so an assertion can be in a signature
+template <typename T>
+static auto sampledPositive(T value) -> decltype(cgs_assert(value > 0), T {})
+{
+    return value;
+}
+
+TEST(Assert, SampleUnevaluated)
+{
+    EXPECT_EQ(sampledPositive(3), 3);
+    // only the type of the assertion is used
+    EXPECT_EQ(sampledPositive(-1.5), -1.5);
+}
@@ -35,3 +35,22 @@ TEST(Assert, Throw)
             << "Expected: \"" << reString << "\"\n";
     }
 }
+
+TEST(Assert, ThrowCompare)
+{
+    const int size = 4;
+    int i = 3;
+    cgs_assert_eq(i, 3);
+    cgs_assert_lt(i, size);
+    cgs_assert_le(i + 1, size);
+    EXPECT_THROW(cgs_assert_eq(i, 4), std::logic_error);
+    EXPECT_THROW(cgs_assert_le(i + 2, size), std::logic_error);
+    try {
+        ++i;
+        cgs_assert_lt(i, size);
+        EXPECT_FALSE(true);
+    }
+    catch(const std::logic_error& e) {
+        EXPECT_STREQ(e.what(), "Assertion failed (i < size) at " __FILE__ ":50 with i = 4, size = 4");
+    }
+}
@@ -0,0 +1,180 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/bounded.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+using cgs::bounded;
+using cgs::div_round_mode;
+
+TEST(Bounded, Construct)
+{
+    constexpr bounded<int, 1, 10> one {};
+    static_assert(one == 1);
+    static_assert(bounded<int, -10, -1>{} == -1);
+    static_assert(bounded<int, -10, 10>{} == 0);
+    static_assert(cgs::constant<16u> == 16u);
+    static_assert(std::is_same<decltype(cgs::constant<16u>)::value_type, unsigned>::value);
+    static_assert(sizeof(bounded<std::int16_t, 0, 9>) == sizeof(std::int16_t));
+    static_assert(std::is_trivially_copyable<bounded<int, 0, 9>>::value);
+
+    bounded<int, 0, 9> digit { 9 };
+    EXPECT_EQ(digit.value(), 9);
+    EXPECT_THROW((bounded<int, 0, 9>{ 10 }), std::logic_error);
+    EXPECT_THROW((bounded<int, 0, 9>{ -1 }), std::logic_error);
+
+    // widening is implicit, narrowing explicit and checked
+    bounded<int, -100, 100> wide = digit;
+    EXPECT_EQ(wide, 9);
+    wide = bounded<int, -100, 100>{ -50 };
+    static_assert(!std::is_convertible<bounded<int, -100, 100>, bounded<int, 0, 9>>::value);
+    EXPECT_THROW((bounded<int, 0, 9>{ wide }), std::logic_error);
+    EXPECT_EQ((bounded<int, -60, 0>{ wide }), -50);
+}
+
+TEST(Bounded, Arithmetic)
+{
+    constexpr bounded<int, 0, 9> a { 7 };
+    constexpr bounded<int, -3, 2> b { -3 };
+
+    constexpr auto sum = a + b;
+    static_assert(std::is_same<decltype(sum), const bounded<int, -3, 11>>::value);
+    static_assert(sum == 4);
+
+    constexpr auto difference = a - b;
+    static_assert(std::is_same<decltype(difference), const bounded<int, -2, 12>>::value);
+    static_assert(difference == 10);
+
+    constexpr auto product = a * b;
+    static_assert(std::is_same<decltype(product), const bounded<int, -27, 18>>::value);
+    static_assert(product == -21);
+
+    // a range that does not fit converts to Int
+    constexpr bounded<std::int8_t, 0, 100> big { 100 };
+    static_assert(std::is_same<decltype(big + big), int>::value);
+    static_assert(std::is_same<decltype(big + bounded<std::int8_t, 0, 27>{}), bounded<std::int8_t, 0, 127>>::value);
+    static_assert(std::is_same<decltype(bounded<unsigned, 0, ~0u>{} + cgs::constant<1u>), unsigned>::value);
+    static_assert(std::is_same<decltype(cgs::constant<0u> - cgs::constant<1u>), unsigned>::value);
+
+    bounded<int, 0, 9> c { 5 };
+    c += 4;
+    EXPECT_EQ(c, 9);
+    EXPECT_THROW(c += 1, std::logic_error);
+    EXPECT_THROW(++c, std::logic_error);
+    c -= 9;
+    EXPECT_EQ(c, 0);
+    EXPECT_THROW(c--, std::logic_error);
+    EXPECT_EQ(c++, 0);
+    EXPECT_EQ(c, 1);
+    c *= 9;
+    EXPECT_EQ(c, 9);
+    EXPECT_THROW(c *= 2, std::logic_error);
+}
+
+namespace
+{
+
+// every n in [NMin, NMax] and d in [DMin, DMax] divides as the plain integers do
+template <div_round_mode RoundMode, typename Int, Int NMin, Int NMax, Int DMin, Int DMax>
+void expectBoundedDivmod()
+{
+    for(Int n = NMin;; ++n) {
+        for(Int d = DMin;; ++d) {
+            if(d != 0) {
+                const bounded<Int, NMin, NMax> bn { n };
+                const bounded<Int, DMin, DMax> bd { d };
+                const auto expected = cgs::divmod<RoundMode>(n, d);
+
+                const auto both = cgs::divmod<RoundMode>(bn, bd);
+                EXPECT_EQ(both.quot, expected.quot) << +n << " / " << +d;
+                EXPECT_EQ(both.rem, expected.rem) << +n << " % " << +d;
+
+                EXPECT_EQ(cgs::div<RoundMode>(n, bd), expected.quot) << +n << " / " << +d;
+                EXPECT_EQ(cgs::mod<RoundMode>(bn, d), expected.rem) << +n << " % " << +d;
+            }
+            if(d == DMax) {
+                break;
+            }
+        }
+        if(n == NMax) {
+            break;
+        }
+    }
+}
+
+template <typename Int, Int NMin, Int NMax, Int DMin, Int DMax>
+void expectBoundedDivmodModes()
+{
+    expectBoundedDivmod<div_round_mode::trunc, Int, NMin, NMax, DMin, DMax>();
+    expectBoundedDivmod<div_round_mode::floor, Int, NMin, NMax, DMin, DMax>();
+    expectBoundedDivmod<div_round_mode::euclid, Int, NMin, NMax, DMin, DMax>();
+}
+
+} // namespace
+
+TEST(Bounded, DivMod)
+{
+    using i8 = std::int8_t;
+    constexpr i8 min = INT8_MIN;
+    constexpr i8 max = INT8_MAX;
+
+    // power of two
+    expectBoundedDivmodModes<i8, min, max, 16, 16>();
+    expectBoundedDivmodModes<i8, 0, max, 16, 16>();
+    expectBoundedDivmodModes<i8, min, max, 1, 1>();
+    expectBoundedDivmodModes<std::uint8_t, 0, 255, 8, 8>();
+    // other constants
+    expectBoundedDivmodModes<i8, min, max, 7, 7>();
+    expectBoundedDivmodModes<i8, min, max, -8, -8>();
+    expectBoundedDivmodModes<i8, min, max, -1, -1>();
+    // positive, negative or either sign divisors
+    expectBoundedDivmodModes<i8, min, max, 1, max>();
+    expectBoundedDivmodModes<i8, 0, max, 1, max>();
+    expectBoundedDivmodModes<i8, min, 0, 1, max>();
+    expectBoundedDivmodModes<i8, min, max, min, -1>();
+    expectBoundedDivmodModes<i8, 0, max, min, -1>();
+    expectBoundedDivmodModes<i8, min, 0, min, -1>();
+    expectBoundedDivmodModes<i8, -20, 20, -5, 5>();
+    expectBoundedDivmodModes<std::uint8_t, 0, 255, 1, 255>();
+
+    EXPECT_THROW(cgs::div_floor(7, bounded<int, -5, 5>{}), std::logic_error);
+}
+
+TEST(Bounded, DivModNamed)
+{
+    constexpr bounded<int, 0, 1023> index { 100 };
+    constexpr auto rowColumn = cgs::divmod_floor(index, cgs::constant<16>);
+    static_assert(rowColumn.quot == 6 && rowColumn.rem == 4);
+
+    static_assert(cgs::div_floor(bounded<int, -100, 100>{ -7 }, cgs::constant<2>) == -4);
+    static_assert(cgs::mod_euclid(-7, bounded<int, -8, -1>{ -2 }) == 1);
+    static_assert(cgs::mod_floor(-7, bounded<int, -8, -1>{ -2 }) == -1);
+    static_assert(cgs::div_trunc(cgs::constant<-7>, 2) == -3);
+    static_assert(std::is_same<decltype(cgs::mod_trunc(index, 5)), int>::value);
+    static_assert(cgs::div_floor(index, index) == 1);
+    static_assert(cgs::mod_floor<int>(index, 7) == 2);
+
+#ifdef CGS_HAS_INT128
+    using int128 = cgs::detail::int128;
+    constexpr bounded<int128, 0, int128{1} << 100> big { int128{1} << 99 };
+    static_assert(cgs::div_floor(big, cgs::constant<int128{1} << 64>) == int128{1} << 35);
+#endif
+}
@@ -0,0 +1,183 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/divider.hpp"
+using cgs::divider;
+using cgs::div_round_mode;
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr divider<int, div_round_mode::floor> floor10 { -10 };
+static_assert(floor10.div(43) == -5);
+static_assert(floor10.mod(43) == -7);
+static_assert(floor10.divmod(-43).quot == 4);
+static_assert(floor10.divmod(-43).rem == -3);
+
+constexpr divider<int, div_round_mode::euclid> euclid10 { -10 };
+static_assert(euclid10.div(-43) == 5);
+static_assert(euclid10.mod(-43) == 7);
+static_assert(-43 / euclid10 == 5);
+static_assert(-43 % euclid10 == 7);
+
+constexpr divider<std::uint64_t, div_round_mode::trunc> trunc7 { 7 };
+static_assert(trunc7.div(std::numeric_limits<std::uint64_t>::max()) == std::numeric_limits<std::uint64_t>::max() / 7);
+
+// streams have no __int128 operator<<, write its high and low halves
+template <typename Int>
+std::string printable(Int n)
+{
+    if constexpr(sizeof(Int) > 8) {
+        const auto u = static_cast<cgs::detail::uint128>(n);
+        return "(" + std::to_string(static_cast<std::uint64_t>(u >> 64)) + " << 64 | "
+            + std::to_string(static_cast<std::uint64_t>(u)) + ")";
+    }
+    else {
+        return std::to_string(+n);
+    }
+}
+
+template <typename Int, div_round_mode Mode>
+void expectDivider(Int d, const std::vector<Int>& numerators)
+{
+    const divider<Int, Mode> divider { d };
+    EXPECT_EQ(divider.divisor(), d);
+    for(Int n : numerators) {
+        // the only overflowing division
+        if(std::is_signed<Int>::value && n == std::numeric_limits<Int>::min() && d == static_cast<Int>(-1)) {
+            continue;
+        }
+        ASSERT_EQ(divider.div(n), cgs::div<Mode>(n, d)) << printable(n) << " / " << printable(d);
+        ASSERT_EQ(divider.mod(n), cgs::mod<Mode>(n, d)) << printable(n) << " % " << printable(d);
+        ASSERT_EQ(divider.divmod(n).quot, cgs::div<Mode>(n, d));
+        ASSERT_EQ(divider.divmod(n).rem, cgs::mod<Mode>(n, d));
+    }
+}
+
+template <typename Int>
+void expectDividerModes(Int d, const std::vector<Int>& numerators)
+{
+    expectDivider<Int, div_round_mode::trunc>(d, numerators);
+    expectDivider<Int, div_round_mode::floor>(d, numerators);
+    expectDivider<Int, div_round_mode::euclid>(d, numerators);
+}
+
+// every n and d
+template <typename Int>
+void expectDividerExhaustive()
+{
+    std::vector<Int> all;
+    for(int n = std::numeric_limits<Int>::min(); n <= std::numeric_limits<Int>::max(); ++n) {
+        all.push_back(static_cast<Int>(n));
+    }
+    for(Int d : all) {
+        if(d != 0) {
+            expectDividerModes(d, all);
+        }
+    }
+}
+
+// edge values, powers of 2 and their neighbours, and pseudo random values
+template <typename Int>
+std::vector<Int> interesting()
+{
+    using UInt = std::make_unsigned_t<Int>;
+    std::vector<Int> values { 0, 1, 2, 3, 5, 7, 10, 100, 641, 1000,
+        std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max() };
+    values.push_back(static_cast<Int>(6700417));
+    for(int bit = 0; bit < std::numeric_limits<UInt>::digits; ++bit) {
+        const UInt power = UInt{1} << bit;
+        values.push_back(static_cast<Int>(power));
+        values.push_back(static_cast<Int>(power - 1));
+        values.push_back(static_cast<Int>(power + 1));
+    }
+    std::uint64_t seed = 88172645463325252u;
+    for(int i = 0; i < 200; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        if constexpr(std::numeric_limits<UInt>::digits > 64) {
+            const UInt wide = UInt{seed} << 64 | UInt{seed * 0x9e3779b97f4a7c15u};
+            values.push_back(static_cast<Int>(wide >> (seed % 128)));
+        }
+        else {
+            values.push_back(static_cast<Int>(seed >> (seed % 64)));
+        }
+    }
+    if(std::is_signed<Int>::value) {
+        const std::size_t size = values.size();
+        for(std::size_t i = 0; i < size; ++i) {
+            values.push_back(static_cast<Int>(UInt{0} - static_cast<UInt>(values[i])));
+        }
+    }
+    return values;
+}
+
+template <typename Int>
+void expectDividerInteresting()
+{
+    const std::vector<Int> values = interesting<Int>();
+    for(Int d : values) {
+        if(d != 0) {
+            expectDividerModes(d, values);
+        }
+    }
+}
+
+} // namespace
+
+TEST(Divider, Exhaustive8)
+{
+    expectDividerExhaustive<std::int8_t>();
+    expectDividerExhaustive<std::uint8_t>();
+}
+
+TEST(Divider, Interesting)
+{
+    expectDividerInteresting<std::int16_t>();
+    expectDividerInteresting<std::uint16_t>();
+    expectDividerInteresting<std::int32_t>();
+    expectDividerInteresting<std::uint32_t>();
+    expectDividerInteresting<std::int64_t>();
+    expectDividerInteresting<std::uint64_t>();
+    expectDividerInteresting<long long>();
+}
+
+// the standard traits only admit __int128 in GNU mode
+#if defined(CGS_HAS_INT128) && !defined(__STRICT_ANSI__)
+TEST(Divider, Interesting128)
+{
+    using int128 = cgs::detail::int128;
+    using uint128 = cgs::detail::uint128;
+    static_assert(divider<int128, div_round_mode::trunc>{ 1000000007 }.div(int128{1} << 100) == (int128{1} << 100) / 1000000007);
+    static_assert(divider<uint128, div_round_mode::trunc>{ 3 }.div(~uint128{}) == ~uint128{} / 3);
+    expectDividerInteresting<int128>();
+    expectDividerInteresting<uint128>();
+}
+#endif
+
+TEST(Divider, Zero)
+{
+    EXPECT_THROW((divider<int, div_round_mode::floor>{ 0 }), std::logic_error);
+}
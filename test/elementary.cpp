@@ -0,0 +1,469 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#include "cgs/elementary.hpp"
+using cgs::accuracy;
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr float inf_f = std::numeric_limits<float>::infinity();
+constexpr double inf = std::numeric_limits<double>::infinity();
+constexpr double not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+// equal with the same sign, or both NaN
+template <typename T>
+bool same(T a, T b)
+{
+    return (std::isnan(a) && std::isnan(b)) || (a == b && std::signbit(a) == std::signbit(b));
+}
+
+template <typename T>
+std::vector<T> uniform(double low, double high, std::size_t count = 4000)
+{
+    std::mt19937_64 engine { 1234 };
+    std::uniform_real_distribution<double> distribution { low, high };
+    std::vector<T> values(count);
+    for(T& value : values) {
+        value = static_cast<T>(distribution(engine));
+    }
+    return values;
+}
+
+// 2^u for uniform u, with random sign if Signed
+template <typename T, bool Signed = false>
+std::vector<T> logarithmic(double low, double high, std::size_t count = 4000)
+{
+    const std::vector<double> values = uniform<double>(low, high, count);
+    std::vector<T> result(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        result[i] = static_cast<T>(std::exp2(values[i]));
+        if(Signed && i % 2 == 1) {
+            result[i] = -result[i];
+        }
+    }
+    return result;
+}
+
+template <typename T, std::size_t N, typename F>
+constexpr std::array<T, N> transform(const std::array<T, N>& in, F f)
+{
+    std::array<T, N> out {};
+    for(std::size_t i = 0; i < N; ++i) {
+        out[i] = f(in[i]);
+    }
+    return out;
+}
+
+constexpr std::array<double, 8> samples { -3.75, -0.5, 0x1p-30, 0.1, 1.0 / 3, 2.5, 17.25, 300.125 };
+
+} // namespace
+
+TEST(Elementary, Constexpr)
+{
+    static_assert(cgs::sqrt(2.0) == 0x1.6a09e667f3bcdp+0);
+    static_assert(cgs::sqrt(2.0f) == 0x1.6a09e6p+0f);
+    static_assert(cgs::exp(1.0) == 0x1.5bf0a8b145769p+1);
+    static_assert(cgs::exp(1.0f) == 0x1.5bf0a8p+1f);
+    static_assert(cgs::exp2(10.0) == 1024);
+    static_assert(cgs::exp2(-0.5) == 0x1.6a09e667f3bcdp-1);
+    static_assert(cgs::log(2.0) == 0x1.62e42fefa39efp-1);
+    static_assert(cgs::log(10.0f) == 0x1.26bb1cp+1f);
+    static_assert(cgs::log2(1024.0) == 10);
+    static_assert(cgs::log2(3.0) == 0x1.95c01a39fbd68p+0);
+    static_assert(cgs::sin(1.0) == 0x1.aed548f090ceep-1);
+    static_assert(cgs::cos(1.0) == 0x1.14a280fb5068cp-1);
+    static_assert(cgs::sin(1e22) == -0x1.b453ab76bf397p-1);
+    static_assert(cgs::cos(0.5f) == 0x1.c1528p-1f);
+    static_assert(cgs::atan2(1.0, 1.0) == 0x1.921fb54442d18p-1);
+    static_assert(cgs::atan2(1.0, -1.0) == 0x1.2d97c7f3321d2p+1);
+    static_assert(cgs::pow(2.0, 0.5) == 0x1.6a09e667f3bcdp+0);
+    static_assert(cgs::pow(3.0, 4.0) == 81);
+    static_assert(cgs::pow(-2.0f, 3.0f) == -8);
+
+    static_assert(cgs::exp<accuracy::fast>(1.0) == 0x1.5bf0a8b145769p+1);
+    static_assert(cgs::log<accuracy::fast>(2.0f) == 0x1.62e43p-1f);
+    static_assert(cgs::pow<accuracy::fast>(2.0, 10.0) == 1024);
+}
+
+namespace unqualified
+{
+
+using namespace cgs;
+
+// cgs takes only float and double, so an int still finds the standard library
+double sqrtInt(int i)
+{
+    return sqrt(i);
+}
+
+} // namespace unqualified
+
+TEST(Elementary, OtherTypes)
+{
+    EXPECT_EQ(unqualified::sqrtInt(4), 2);
+}
+
+TEST(Elementary, SpecialValues)
+{
+    static_assert(cgs::exp(-inf) == 0);
+    static_assert(cgs::exp(inf) == inf);
+    static_assert(cgs::exp(1000.0) == inf);
+    static_assert(cgs::exp(-1000.0) == 0);
+    static_assert(cgs::exp(100.0f) == inf_f);
+    static_assert(cgs::exp2(1024.0) == inf);
+    static_assert(cgs::exp2(-1074.0) == 0x1p-1074);
+    static_assert(cgs::exp(-740.0) > 0);
+    static_assert(cgs::log(0.0) == -inf);
+    static_assert(cgs::log(inf) == inf);
+    static_assert(cgs::log(1.0) == 0);
+    static_assert(cgs::log2(0x1p-1074) == -1074);
+    static_assert(cgs::sqrt(inf) == inf);
+    static_assert(cgs::sqrt(-0.0) == 0);
+    static_assert(cgs::atan2(0.0, -1.0) == 0x1.921fb54442d18p+1);
+    static_assert(cgs::atan2(-0.0, -1.0) == -0x1.921fb54442d18p+1);
+    static_assert(cgs::atan2(inf, inf) == 0x1.921fb54442d18p-1);
+    static_assert(cgs::pow(0.0, -1.0) == inf);
+    static_assert(cgs::pow(-0.0, -1.0) == -inf);
+    static_assert(cgs::pow(-1.0, inf) == 1);
+    static_assert(cgs::pow(not_a_number, 0.0) == 1);
+    static_assert(cgs::pow(1.0, not_a_number) == 1);
+    static_assert(cgs::pow(10.0, 400.0) == inf);
+
+    constexpr double nan_log = cgs::log(-1.0);
+    constexpr double nan_sqrt = cgs::sqrt(-1.0);
+    constexpr double nan_sin = cgs::sin(inf);
+    constexpr double nan_pow = cgs::pow(-2.0, 0.5);
+    EXPECT_TRUE(std::isnan(nan_log));
+    EXPECT_TRUE(std::isnan(nan_sqrt));
+    EXPECT_TRUE(std::isnan(nan_sin));
+    EXPECT_TRUE(std::isnan(nan_pow));
+    EXPECT_TRUE(std::isnan(cgs::exp<accuracy::fast>(not_a_number)));
+    EXPECT_TRUE(std::isnan(cgs::log<accuracy::fast>(-1.0f)));
+
+    // the fast tier agrees with the accurate one on every special value
+    for(double x : { 0.0, -0.0, 1.0, -1.0, inf, -inf, 0x1p-1074, 1000.0, -1000.0, 710.0, -746.0 }) {
+        for(double y : { 0.0, -0.0, 0.5, -1.0, 3.0, inf, -inf }) {
+            EXPECT_TRUE(same(cgs::pow<accuracy::fast>(x, y), cgs::pow<accuracy::accurate>(x, y))) << x << " " << y;
+            EXPECT_TRUE(same(cgs::atan2<accuracy::fast>(x, y), cgs::atan2<accuracy::accurate>(x, y))) << x << " " << y;
+        }
+        if(!std::isfinite(x) || x == 0) {
+            EXPECT_TRUE(same(cgs::exp<accuracy::fast>(x), cgs::exp<accuracy::accurate>(x))) << x;
+            EXPECT_TRUE(same(cgs::log<accuracy::fast>(x), cgs::log<accuracy::accurate>(x))) << x;
+            EXPECT_TRUE(same(cgs::log2<accuracy::fast>(x), cgs::log2<accuracy::accurate>(x))) << x;
+        }
+        EXPECT_TRUE(same(cgs::exp2<accuracy::fast>(x), cgs::exp2<accuracy::accurate>(x))) << x;
+    }
+    EXPECT_EQ(std::signbit(cgs::sin<accuracy::fast>(-0.0)), true);
+}
+
+TEST(Elementary, Subnormal)
+{
+    // correctly rounded, from 400 digit decimal arithmetic
+    struct sample { double x; double result; };
+    constexpr sample exp_samples[] {
+        { -0x1.62776e90a8112p+9, 0x0.95af680e86e3bp-1022 },
+        { -0x1.62433ea62ae17p+9, 0x0.e1086b9c33591p-1022 },
+        { -0x1.62787c48cfb7ep+9, 0x0.9475497ba61e5p-1022 },
+        { -0x1.6276f5681e0bdp+9, 0x0.963d5a6a8b38dp-1022 },
+    };
+    constexpr sample exp2_samples[] {
+        { -0x1.ff1e88db4b6e4p+9, 0x0.d8fc0b089f09dp-1022 },
+        { -0x1.ff78f6320103fp+9, 0x0.84f905894db7dp-1022 },
+        { -0x1.ff48e9ab3551cp+9, 0x0.ac7d71442db7bp-1022 },
+        { -0x1.ff1010d8e213fp+9, 0x0.eaab5d2f03379p-1022 },
+        { -0x1.ff1c5eed33e77p+9, 0x0.db8abfae93eebp-1022 },
+        { -1022.5, 0x0.b504f333f9de6p-1022 },
+        { -1050, 0x1p-1050 },
+        { -1074.5, 0x1p-1074 },
+        // the tie between 0 and the smallest subnormal, to even
+        { -1075, 0 },
+    };
+    static_assert(cgs::exp(exp_samples[0].x) == exp_samples[0].result);
+    static_assert(cgs::exp2(exp2_samples[0].x) == exp2_samples[0].result);
+    for(const sample& s : exp_samples) {
+        EXPECT_EQ(cgs::detail::exp_accurate(s.x), s.result) << s.x;
+    }
+    for(const sample& s : exp2_samples) {
+        EXPECT_EQ(cgs::detail::exp2_accurate(s.x), s.result) << s.x;
+    }
+}
+
+TEST(Elementary, HardToRound)
+{
+    // within 2^-90 of a midpoint, so double-double is not enough. Correctly rounded, from 300 digit decimal arithmetic
+    struct sample { double x; double result; };
+    constexpr sample exp_samples[] {
+        // 1 + 2^-53 + 2^-107, just above the tie
+        { 0x1p-53, 0x1.0000000000001p+0 },
+        { -0x1p-53, 0x1.fffffffffffffp-1 },
+        { 0x1p-54, 1 },
+        // 1 - 2^-54 + 2^-109, just above the tie below 1
+        { -0x1p-54, 1 },
+        { 0x3p-53, 0x1.0000000000002p+0 },
+    };
+    constexpr sample exp2_samples[] {
+        { 0x1p-53, 1 },
+        { -0x1p-53, 0x1.fffffffffffffp-1 },
+        { -0x1p-54, 1 },
+    };
+    constexpr sample log_samples[] {
+        { 1 + 0x1p-52, 0x1.fffffffffffffp-53 },
+        { 1 - 0x1p-53, -0x1p-53 },
+        { 1 + 0x1p-51, 0x1.ffffffffffffep-52 },
+    };
+    constexpr sample log2_samples[] {
+        { 1 + 0x1p-52, 0x1.71547652b82fdp-52 },
+        { 1 - 0x1p-53, -0x1.71547652b82fep-53 },
+    };
+    static_assert(cgs::exp(exp_samples[0].x) == exp_samples[0].result);
+    static_assert(cgs::log(log_samples[0].x) == log_samples[0].result);
+    static_assert(cgs::exp(0x1p-24f) == 0x1.000002p+0f);
+    static_assert(cgs::exp(-0x1p-24f) == 0x1.fffffep-1f);
+    for(const sample& s : exp_samples) {
+        volatile double x = s.x;
+        EXPECT_EQ(cgs::exp<accuracy::accurate>(x), s.result) << s.x;
+    }
+    for(const sample& s : exp2_samples) {
+        volatile double x = s.x;
+        EXPECT_EQ(cgs::exp2<accuracy::accurate>(x), s.result) << s.x;
+    }
+    for(const sample& s : log_samples) {
+        volatile double x = s.x;
+        EXPECT_EQ(cgs::log<accuracy::accurate>(x), s.result) << s.x;
+    }
+    for(const sample& s : log2_samples) {
+        volatile double x = s.x;
+        EXPECT_EQ(cgs::log2<accuracy::accurate>(x), s.result) << s.x;
+    }
+
+    // double-double holds e^(2^-53) as the tie 1 + 2^-53, the rounding test sends it to triple-double
+    const auto [v, k] = cgs::detail::exp_dd(cgs::detail::double_double{ 0x1p-53, 0 });
+    EXPECT_TRUE(cgs::detail::hard_to_round<double>(v, k, cgs::detail::double_double_error));
+    const auto [w, wk] = cgs::detail::exp_td(0x1p-53);
+    EXPECT_EQ(cgs::detail::round_scaled<double>(w, wk), 0x1.0000000000001p+0);
+    EXPECT_FALSE(cgs::detail::hard_to_round<double>(cgs::detail::log_dd(3.0), 0, cgs::detail::double_double_error));
+}
+
+TEST(Elementary, PowExact)
+{
+    // exact squares and cubes, many of them midpoints, rounded once by the hardware multiply
+    static_assert(cgs::pow(134217727.0, 2.0) == 18014398241046528.0);
+    static_assert(cgs::pow(116179291.0, 2.0) == 116179291.0 * 116179291.0);
+    static_assert(cgs::pow(-3.0, 3.0) == -27);
+    static_assert(cgs::pow(4096.0f, 1.5f) == 262144.0f);
+    std::mt19937_64 engine { 1234 };
+    std::uniform_int_distribution<std::uint64_t> squares { 1, 1u << 31 };
+    std::uniform_int_distribution<std::uint64_t> cubes { 1, 1u << 18 };
+    for(int i = 0; i < 4000; ++i) {
+        volatile double x = static_cast<double>(squares(engine));
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(x, 2.0), x * x) << x;
+        volatile double c = static_cast<double>(cubes(engine));
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(c, 3.0), c * c * c) << c;
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(-c, 3.0), -(c * c * c)) << c;
+        // x^1.5 where x is a square
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(c * c, 1.5), c * c * c) << c;
+        volatile float f = static_cast<float>(cubes(engine) >> 8);
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(f, 2.0f), f * f) << f;
+        EXPECT_EQ(cgs::pow<accuracy::accurate>(f, 3.0f), f * f * f) << f;
+    }
+
+    // 2^-1075 is the midpoint between 0 and the smallest subnormal, 243 2^-1075 between 121 and 122 of it
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(2.0, -1075.0), 0);
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(0x1p-25, 43.0), 0);
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(0x3p-215, 5.0), 122 * 0x1p-1074);
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(0x1p-1074, 0.5), 0x1p-537);
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(2.0f, -150.0f), 0);
+    EXPECT_EQ(cgs::pow<accuracy::accurate>(0x1p-8, -128.0), inf);
+}
+
+TEST(Elementary, CompileTimeMatchesRuntime)
+{
+    // where the fast tier runs its inline code at runtime, it is the same code as at compile time
+    constexpr auto exp_fast = transform(samples, [](double x) { return cgs::exp<accuracy::fast>(x); });
+    constexpr auto sin_fast = transform(samples, [](double x) { return cgs::sin<accuracy::fast>(x); });
+    constexpr auto exp2_fast = transform(samples, [](double x) { return cgs::exp2<accuracy::fast>(x); });
+    // the accurate tier runs its double-double code at runtime too
+    constexpr auto exp_accurate = transform(samples, [](double x) { return cgs::exp<accuracy::accurate>(x); });
+    constexpr auto cos_accurate = transform(samples, [](double x) { return cgs::cos<accuracy::accurate>(x); });
+    constexpr auto log2_accurate = transform(samples, [](double x) { return cgs::log2<accuracy::accurate>(x < 0 ? -x : x); });
+    constexpr auto pow_accurate = transform(samples, [](double x) { return cgs::pow<accuracy::accurate>(1.5, x); });
+    constexpr auto sin_float = transform(samples,
+        [](double x) { return static_cast<double>(cgs::sin<accuracy::accurate>(static_cast<float>(x))); });
+    // the default tier evaluates constants with the same code
+    constexpr auto exp_standard = transform(samples, [](double x) { return cgs::exp(x); });
+    constexpr auto pow_standard = transform(samples, [](double x) { return cgs::pow(1.5, x); });
+    for(std::size_t i = 0; i < samples.size(); ++i) {
+        volatile double x = samples[i];
+        EXPECT_EQ(exp_fast[i], cgs::exp<accuracy::fast>(x));
+        EXPECT_EQ(sin_fast[i], cgs::sin<accuracy::fast>(x));
+        EXPECT_EQ(exp2_fast[i], cgs::exp2<accuracy::fast>(x));
+        EXPECT_EQ(exp_accurate[i], cgs::exp<accuracy::accurate>(x));
+        EXPECT_EQ(cos_accurate[i], cgs::cos<accuracy::accurate>(x));
+        EXPECT_EQ(log2_accurate[i], cgs::log2<accuracy::accurate>(std::fabs(x)));
+        EXPECT_EQ(pow_accurate[i], cgs::pow<accuracy::accurate>(1.5, x));
+        EXPECT_EQ(sin_float[i], cgs::sin<accuracy::accurate>(static_cast<float>(x)));
+        EXPECT_EQ(exp_standard[i], exp_accurate[i]);
+        EXPECT_EQ(pow_standard[i], pow_accurate[i]);
+    }
+}
+
+// |result - v 2^k| in units in the last place of T at v 2^k, v the unrounded double-double of the accurate tier
+template <typename T>
+double ulp_error(T result, cgs::detail::double_double v, int k = 0)
+{
+    const int e = std::max(std::ilogb(v.hi) + k, std::numeric_limits<T>::min_exponent - 1);
+    const cgs::detail::double_double d = cgs::detail::double_double{ std::ldexp(static_cast<double>(result), -k), 0 } - v;
+    return std::fabs(std::ldexp(d.hi + d.lo, k - e + std::numeric_limits<T>::digits - 1));
+}
+
+// the error of fast, or 0 if it equals accurate when that is infinite or zero, which has no ULP
+template <typename T>
+double ulp_error(T fast, T accurate, cgs::detail::scaled_double_double exact)
+{
+    if(accurate == 0 || std::isinf(accurate)) {
+        return fast == accurate ? 0 : std::numeric_limits<double>::infinity();
+    }
+    return ulp_error(fast, exact.v, exact.k);
+}
+
+// largest errors of the fast tier in ULP, the table in elementary.hpp
+struct fast_bounds
+{
+    double exp;
+    double exp_normal;
+    double log;
+    double sin;
+    double atan2;
+    double pow;
+};
+
+constexpr fast_bounds float_bounds { 0.51, 0.51, 0.51, 0.51, 0.51, 0.51 };
+constexpr fast_bounds double_bounds { 0.75, 0.51, 0.52, 0.77, 1.91, 0.53 };
+
+template <typename T>
+void expect_fast_unary(const fast_bounds& bounds)
+{
+    using namespace cgs::detail;
+    const auto exp_bound = [&bounds](scaled_double_double exact) {
+        return std::ldexp(exact.v.hi, exact.k) >= std::numeric_limits<T>::min() ? bounds.exp_normal : bounds.exp;
+    };
+    for(T x : uniform<T>(-740, 709)) {
+        const scaled_double_double exact = exp_dd(double_double{ x, 0 });
+        EXPECT_LE(ulp_error(exp_fast(x), exp_accurate(x), exact), exp_bound(exact)) << x;
+    }
+    for(T x : uniform<T>(-1074, 1023)) {
+        const scaled_double_double exact = exp2_dd(x);
+        EXPECT_LE(ulp_error(exp2_fast(x), exp2_accurate(x), exact), exp_bound(exact)) << x;
+    }
+    for(const std::vector<T>& values : { logarithmic<T>(-1074, 1024), uniform<T>(0.5, 2) }) {
+        for(T x : values) {
+            if(x > 0 && x < std::numeric_limits<T>::infinity() && x != 1) {
+                EXPECT_LE(ulp_error(log_fast(x), log_dd(x)), bounds.log) << x;
+                EXPECT_LE(ulp_error(log2_fast(x), log2_dd(x)), bounds.log) << x;
+            }
+        }
+    }
+    for(T x : uniform<T>(-1.6e6, 1.6e6)) {
+        EXPECT_LE(ulp_error(sin_fast<0>(x), sin_dd<0>(x)), bounds.sin) << x;
+        EXPECT_LE(ulp_error(sin_fast<1>(x), sin_dd<1>(x)), bounds.sin) << x;
+    }
+}
+
+template <typename T>
+void expect_fast_binary(const fast_bounds& bounds)
+{
+    using namespace cgs::detail;
+    const std::vector<T> a = logarithmic<T, true>(-100, 100);
+    const std::vector<T> b = uniform<T>(-10, 10);
+    for(std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_LE(ulp_error(atan2_fast(a[i], b[i]), atan2_dd(a[i], b[i])), bounds.atan2) << a[i] << " " << b[i];
+        EXPECT_LE(ulp_error(atan2_fast(b[i], a[i]), atan2_dd(b[i], a[i])), bounds.atan2) << b[i] << " " << a[i];
+    }
+    const std::vector<T> x = uniform<T>(0, 10);
+    const std::vector<T> y = uniform<T>(-30, 30);
+    const std::vector<T> near1 = uniform<T>(0.5, 2);
+    const std::vector<T> big = uniform<T>(-1000, 1000);
+    for(std::size_t i = 0; i < x.size(); ++i) {
+        for(const auto& [base, power] : { std::pair<T, T>{ x[i], y[i] }, std::pair<T, T>{ near1[i], big[i] } }) {
+            const scaled_double_double exact = exp_dd(log_dd(base) * static_cast<double>(power));
+            if(std::ldexp(exact.v.hi, exact.k) >= std::numeric_limits<T>::min()
+                && std::ldexp(exact.v.hi, exact.k) <= std::numeric_limits<T>::max()) {
+                EXPECT_LE(ulp_error(pow_fast(base, power), exact.v, exact.k), bounds.pow) << base << " " << power;
+            }
+        }
+    }
+}
+
+TEST(Elementary, FastRuntime)
+{
+    // the fast tier calls the standard library at runtime where its inline code is slower
+    for(double sample : samples) {
+        volatile double x = sample < 0 ? -sample : sample;
+        volatile float f = static_cast<float>(x);
+        EXPECT_EQ(cgs::exp<accuracy::fast>(f), std::exp(f));
+        EXPECT_EQ(cgs::log<accuracy::fast>(f), std::log(f));
+        EXPECT_EQ(cgs::sin<accuracy::fast>(f), std::sin(f));
+        EXPECT_EQ(cgs::log2<accuracy::fast>(x), std::log2(x));
+        EXPECT_EQ(cgs::pow<accuracy::fast>(x, 1.5), std::pow(x, 1.5));
+        EXPECT_EQ(cgs::atan2<accuracy::fast>(x, 2.0), std::atan2(x, 2.0));
+    }
+}
+
+TEST(Elementary, StandardRuntime)
+{
+    // the default tier calls the standard library at runtime
+    for(double sample : samples) {
+        volatile double x = sample;
+        volatile float f = static_cast<float>(x);
+        EXPECT_EQ(cgs::exp(x), std::exp(x));
+        EXPECT_EQ(cgs::exp2(f), std::exp2(f));
+        EXPECT_EQ(cgs::log(std::fabs(x)), std::log(std::fabs(x)));
+        EXPECT_EQ(cgs::sin(x), std::sin(x));
+        EXPECT_EQ(cgs::cos(f), std::cos(f));
+        EXPECT_EQ(cgs::atan2(x, 2.0), std::atan2(x, 2.0));
+        EXPECT_EQ(cgs::pow(1.5, x), std::pow(1.5, x));
+    }
+}
+
+TEST(Elementary, FastFloat)
+{
+    expect_fast_unary<float>(float_bounds);
+    expect_fast_binary<float>(float_bounds);
+}
+
+TEST(Elementary, FastDouble)
+{
+    expect_fast_unary<double>(double_bounds);
+    expect_fast_binary<double>(double_bounds);
+
+    // the largest atan2 errors found, near t = 1/8 where the angle is small for the error of u
+    EXPECT_LE(ulp_error(cgs::detail::atan2_fast(0x1.39dd64fba37a8p+2, 0x1.38da2c0fc68c2p+5),
+        cgs::detail::atan2_dd(0x1.39dd64fba37a8p+2, 0x1.38da2c0fc68c2p+5)), double_bounds.atan2);
+    EXPECT_LE(ulp_error(cgs::detail::atan2_fast(0x1.9ead501cc77f1p-9, 0x1.9cb12a5e89eb6p-6),
+        cgs::detail::atan2_dd(0x1.9ead501cc77f1p-9, 0x1.9cb12a5e89eb6p-6)), double_bounds.atan2);
+}
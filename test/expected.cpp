@@ -0,0 +1,217 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/expected.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+using cgs::expected;
+using cgs::unexpected;
+
+enum class error
+{
+    empty,
+    invalid,
+};
+
+static_assert(std::is_trivially_copyable<expected<int, error>>::value);
+static_assert(std::is_trivially_destructible<expected<double, error>>::value);
+static_assert(std::is_trivially_copyable<expected<void, error>>::value);
+static_assert(sizeof(expected<int, int>) == 2 * sizeof(int));
+static_assert(sizeof(expected<void, int>) == 2 * sizeof(int));
+static_assert(!std::is_trivially_copyable<expected<std::string, error>>::value);
+
+static constexpr expected<int, error> half(int value)
+{
+    if(value % 2 != 0) {
+        return unexpected(error::invalid);
+    }
+    return value / 2;
+}
+
+TEST(Expected, Constexpr)
+{
+    static_assert(half(4).has_value());
+    static_assert(*half(4) == 2);
+    static_assert(!half(3));
+    static_assert(half(3).error() == error::invalid);
+    static_assert(half(3).value_or(-1) == -1);
+    static_assert(half(4) == 2);
+    static_assert(half(3) == unexpected(error::invalid));
+    static_assert(half(3) != half(4));
+
+    constexpr expected<int, error> defaulted {};
+    static_assert(defaulted && *defaulted == 0);
+    constexpr expected<int, error> failed { cgs::unexpect, error::empty };
+    static_assert(failed.error() == error::empty);
+}
+
+TEST(Expected, WrongAccess)
+{
+    const expected<int, error> value = half(4);
+    const expected<int, error> failed = half(3);
+    EXPECT_THROW(value.error(), std::logic_error);
+    EXPECT_THROW(failed.value(), std::logic_error);
+    EXPECT_THROW(*failed, std::logic_error);
+}
+
+TEST(Expected, NonTrivial)
+{
+    expected<std::string, std::string> a { "value" };
+    expected<std::string, std::string> b { unexpected(std::string{ "error" }) };
+    EXPECT_EQ(*a, "value");
+    EXPECT_EQ(a->size(), 5u);
+    EXPECT_EQ(b.error(), "error");
+
+    // assignment switches the active member
+    a = b;
+    EXPECT_FALSE(a);
+    EXPECT_EQ(a.error(), "error");
+    b = expected<std::string, std::string>{ std::string(100, 'x') };
+    a = std::move(b);
+    EXPECT_EQ(a->size(), 100u);
+
+    expected<std::string, std::string> c { a };
+    EXPECT_EQ(c, a);
+    EXPECT_EQ(std::move(c).value_or("none").size(), 100u);
+
+    expected<std::unique_ptr<int>, error> moveOnly { std::make_unique<int>(3) };
+    const std::unique_ptr<int> taken = std::move(moveOnly).value();
+    EXPECT_EQ(*taken, 3);
+}
+
+static expected<void, error> check(bool valid)
+{
+    if(!valid) {
+        return unexpected(error::invalid);
+    }
+    return {};
+}
+
+TEST(Expected, Void)
+{
+    EXPECT_TRUE(check(true));
+    EXPECT_NO_THROW(check(true).value());
+    EXPECT_EQ(check(false).error(), error::invalid);
+    EXPECT_EQ(check(false), unexpected(error::invalid));
+    EXPECT_THROW(check(false).value(), std::logic_error);
+}
+
+static constexpr expected<int, cgs::assert_error> digit(char c)
+{
+    cgs_assert_return(c >= '0' && c <= '9');
+    return c - '0';
+}
+
+static expected<void, cgs::assert_error> both_digits(char a, char b)
+{
+    cgs_assert_return(digit(a));
+    cgs_assert_return(digit(b));
+    return {};
+}
+
+TEST(Expected, AssertReturn)
+{
+    static_assert(*digit('7') == 7);
+    static_assert(!digit('x'));
+    EXPECT_STREQ(digit('x').error().message,
+        "Assertion failed (c >= '0' && c <= '9') at " __FILE__ ":120");
+
+    EXPECT_TRUE(both_digits('1', '2'));
+    EXPECT_FALSE(both_digits('1', 'b'));
+}
+
+// counts live objects, and throws from its copy while throwing is set
+template <bool NothrowMove>
+struct Throwing
+{
+    static inline int live = 0;
+    static inline bool throwing = false;
+
+    Throwing() { ++live; }
+    Throwing(const Throwing&)
+    {
+        if(throwing) {
+            throw std::runtime_error("copy");
+        }
+        ++live;
+    }
+    Throwing(Throwing&&) noexcept(NothrowMove) { ++live; }
+    Throwing& operator=(const Throwing&) = default;
+    ~Throwing() { --live; }
+};
+
+template <bool NothrowMove>
+static void expectAssignmentUnchangedOnThrow()
+{
+    using T = Throwing<NothrowMove>;
+    {
+        const expected<T, std::string> value {};
+        expected<T, std::string> failed { unexpected(std::string{ "error" }) };
+        T::throwing = true;
+        EXPECT_THROW(failed = value, std::runtime_error);
+        T::throwing = false;
+        // still the error, and no T destroyed twice
+        EXPECT_FALSE(failed);
+        EXPECT_EQ(failed.error(), "error");
+        EXPECT_EQ(T::live, 1);
+
+        failed = value;
+        EXPECT_TRUE(failed);
+        EXPECT_EQ(T::live, 2);
+    }
+    EXPECT_EQ(T::live, 0);
+}
+
+TEST(Expected, AssignmentThrows)
+{
+    // a copy then a move into place
+    expectAssignmentUnchangedOnThrow<true>();
+    // the error moved aside and back
+    expectAssignmentUnchangedOnThrow<false>();
+}
+
+TEST(Expected, CopyMove)
+{
+    // copyable and movable as far as T and E are, like std::expected
+    using unique = expected<std::unique_ptr<int>, int>;
+    static_assert(!std::is_copy_constructible<unique>::value);
+    static_assert(!std::is_copy_assignable<unique>::value);
+    static_assert(std::is_nothrow_move_constructible<unique>::value);
+    static_assert(std::is_nothrow_move_assignable<unique>::value);
+    static_assert(!std::is_copy_constructible<expected<void, std::unique_ptr<int>>>::value);
+    static_assert(std::is_move_constructible<expected<void, std::unique_ptr<int>>>::value);
+
+    // switching members could lose both if neither moves without throwing
+    using throwing = expected<Throwing<false>, Throwing<false>>;
+    static_assert(std::is_copy_constructible<throwing>::value);
+    static_assert(!std::is_copy_assignable<throwing>::value);
+    static_assert(!std::is_move_assignable<throwing>::value);
+
+    unique a { std::make_unique<int>(3) };
+    unique b = std::move(a);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(**b, 3);
+    a = unexpected(1);
+    a = std::move(b);
+    ASSERT_TRUE(a);
+    EXPECT_EQ(**a, 3);
+}
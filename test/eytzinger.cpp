@@ -0,0 +1,182 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/eytzinger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr auto primes = cgs::make_eytzinger_set(std::array<int, 10>{ 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 });
+
+constexpr auto opcodes = cgs::make_eytzinger_map(std::array<std::pair<std::string_view, int>, 5>{{
+    { "add", 1 }, { "div", 4 }, { "jmp", 7 }, { "mul", 3 }, { "sub", 2 }
+}});
+
+constexpr int lowerBoundOf(int key)
+{
+    const int* found = primes.lower_bound(key);
+    return found ? *found : -1;
+}
+
+std::vector<int> sortedRandom(std::size_t n, unsigned seed)
+{
+    std::mt19937 engine { seed };
+    std::vector<int> values(n);
+    for(int& value : values) {
+        value = static_cast<int>(engine() % (4 * n + 1));
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+} // namespace
+
+TEST(Eytzinger, Constexpr)
+{
+    static_assert(primes.size() == 10);
+    static_assert(primes.contains(2));
+    static_assert(primes.contains(29));
+    static_assert(!primes.contains(1));
+    static_assert(!primes.contains(9));
+    static_assert(!primes.contains(30));
+    static_assert(lowerBoundOf(0) == 2);
+    static_assert(lowerBoundOf(8) == 11);
+    static_assert(lowerBoundOf(29) == 29);
+    static_assert(lowerBoundOf(30) == -1);
+
+    static_assert(opcodes.at("jmp") == 7);
+    static_assert(opcodes.find("nop") == nullptr);
+    static_assert(*opcodes.find("add") == 1);
+    static_assert(alignof(decltype(primes)) == cgs::cache_line_size);
+
+    constexpr auto empty = cgs::make_eytzinger_set(std::array<int, 0>{});
+    static_assert(empty.empty());
+    static_assert(!empty.contains(0));
+}
+
+TEST(Eytzinger, LowerBound)
+{
+    // every tree shape, full and partial last levels
+    for(std::size_t n = 0; n <= 130; ++n) {
+        const std::vector<int> values = sortedRandom(n, static_cast<unsigned>(n));
+        const cgs::eytzinger_set<int> set(values.begin(), values.end());
+        EXPECT_EQ(set.size(), n);
+        for(int key = -1; key <= static_cast<int>(4 * n + 2); ++key) {
+            const auto expected = std::lower_bound(values.begin(), values.end(), key);
+            const int* found = set.lower_bound(key);
+            if(expected == values.end()) {
+                ASSERT_EQ(found, nullptr) << n << " " << key;
+            }
+            else {
+                ASSERT_NE(found, nullptr) << n << " " << key;
+                ASSERT_EQ(*found, *expected) << n << " " << key;
+            }
+            ASSERT_EQ(set.contains(key), std::binary_search(values.begin(), values.end(), key));
+        }
+    }
+}
+
+TEST(Eytzinger, Batch)
+{
+    const std::vector<int> values = sortedRandom(5000, 1);
+    const cgs::eytzinger_set<int> set(values.begin(), values.end());
+    std::vector<int> queries(1001);
+    std::mt19937 engine { 2 };
+    for(int& query : queries) {
+        query = static_cast<int>(engine() % 20010) - 5;
+    }
+
+    std::vector<char> contained(queries.size());
+    std::vector<const int*> bounds(queries.size());
+    EXPECT_EQ(set.contains(queries.begin(), queries.end(), contained.begin()), contained.end());
+    EXPECT_EQ(set.lower_bound(queries.begin(), queries.end(), bounds.begin()), bounds.end());
+    for(std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(static_cast<bool>(contained[i]), set.contains(queries[i]));
+        EXPECT_EQ(bounds[i], set.lower_bound(queries[i]));
+    }
+
+    std::vector<std::pair<int, std::string>> pairs;
+    for(int value : { 1, 4, 9, 16, 25 }) {
+        pairs.emplace_back(value, std::to_string(value));
+    }
+    const cgs::eytzinger_map<int, std::string> squares(pairs.begin(), pairs.end());
+    const std::array<int, 4> keys { 9, 10, 25, 1 };
+    std::array<const std::string*, 4> found {};
+    squares.find(keys.begin(), keys.end(), found.begin());
+    EXPECT_EQ(*found[0], "9");
+    EXPECT_EQ(found[1], nullptr);
+    EXPECT_EQ(*found[2], "25");
+    EXPECT_EQ(*found[3], "1");
+}
+
+TEST(Eytzinger, Map)
+{
+    std::vector<std::pair<std::string, int>> pairs;
+    for(int i = 0; i < 300; ++i) {
+        pairs.emplace_back("key" + std::to_string(1000 + i), i);
+    }
+    const cgs::eytzinger_map<std::string, int> map(pairs.begin(), pairs.end());
+    EXPECT_EQ(map.size(), pairs.size());
+    for(const auto& pair : pairs) {
+        ASSERT_NE(map.find(pair.first), nullptr);
+        EXPECT_EQ(*map.find(pair.first), pair.second);
+        EXPECT_EQ(map.at(pair.first), pair.second);
+    }
+    // transparent comparison
+    EXPECT_TRUE(map.contains("key1005"));
+    EXPECT_FALSE(map.contains(std::string_view { "key0999" }));
+    EXPECT_THROW(map.at("missing"), std::logic_error);
+
+    // descending
+    const std::vector<int> descending { 9, 7, 5, 3 };
+    const cgs::eytzinger_set<int, cgs::dynamic_extent, std::greater<>> set(descending.begin(), descending.end());
+    EXPECT_EQ(*set.lower_bound(6), 5);
+    EXPECT_EQ(set.lower_bound(2), nullptr);
+}
+
+TEST(Eytzinger, Alignment)
+{
+    const std::vector<int> values = sortedRandom(1000, 3);
+    const cgs::eytzinger_set<int> set(values.begin(), values.end());
+    const cgs::eytzinger_set<int> copy = set;
+    EXPECT_EQ(*copy.lower_bound(values[500]), values[500]);
+    // the storage starts a line, found from the smallest key, the leftmost node
+    const int* smallest = copy.lower_bound(values[0]);
+    const int* storage = smallest - cgs::detail::eytzinger_first(values.size());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(storage) % cgs::cache_line_size, 0u);
+}
+
+TEST(Eytzinger, Invalid)
+{
+    const std::vector<int> unsorted { 1, 3, 2 };
+    EXPECT_THROW((cgs::eytzinger_set<int>(unsorted.begin(), unsorted.end())), std::logic_error);
+    const std::vector<int> two { 1, 2 };
+    EXPECT_THROW((cgs::eytzinger_set<int, 3>(two.begin(), two.end())), std::logic_error);
+}
@@ -17,6 +17,7 @@
 
 #define CGS_VIOLATE_THROW
 #include "cgs/math.hpp"
+#include "cgs/simd/dispatch.hpp"
 using cgs::lerp;
 using cgs::clamp;
 using cgs::is_between;
@@ -29,6 +30,14 @@ using cgs::detail::isnan_nobuiltin;
 using cgs::isfinite;
 using cgs::detail::isfinite_nobuiltin;
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 TEST(Math, LerpConstexpr)
 {
     constexpr float a = 500.0f;
@@ -93,6 +102,37 @@ TEST(Math, LerpInfinities)
     EXPECT_TRUE(std::isnan(lerp(-inf, inf, 2.0f)));
 }
 
+TEST(Math, LerpExplicitType)
+{
+    static_assert(lerp<float>(500.0f, 1000.0f, 0.5f) == 750.0f);
+    static_assert(lerp<double, float>(500.0, 1000.0, 0.5f) == 750.0);
+    EXPECT_TRUE(std::isnan(lerp<float>(0.0f, std::numeric_limits<float>::infinity(), 0.5f)));
+}
+
+TEST(Math, LerpFiniteCheck)
+{
+    using cgs::finite_check;
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    constexpr float max = std::numeric_limits<float>::max();
+
+    static_assert(lerp<finite_check::difference>(500.0f, 1000.0f, 0.5f) == 750.0f);
+    static_assert(lerp<finite_check::none>(500.0f, 1000.0f, 0.5f) == 750.0f);
+
+    // both checks reject non-finite inputs
+    EXPECT_TRUE(std::isnan(lerp<finite_check::difference>(0.0f, inf, 0.0f)));
+    EXPECT_TRUE(std::isnan(lerp<finite_check::difference>(-inf, 0.0f, 1.0f)));
+    EXPECT_TRUE(std::isnan(lerp<finite_check::difference>(inf, inf, 0.5f)));
+    EXPECT_TRUE(std::isnan(lerp<finite_check::difference>(0.0f, NAN, 0.5f)));
+
+    // only difference rejects an overflowing b - a
+    EXPECT_FLOAT_EQ(lerp<finite_check::inputs>(-max, max, 0.5f), inf);
+    EXPECT_TRUE(std::isnan(lerp<finite_check::difference>(-max, max, 0.5f)));
+
+    // none does the arithmetic
+    EXPECT_FLOAT_EQ(lerp<finite_check::none>(0.0f, inf, 0.5f), inf);
+    EXPECT_TRUE(std::isnan(lerp<finite_check::none>(inf, inf, 0.5f)));
+}
+
 TEST(Math, LerpDouble)
 {
     constexpr double a = 500.0;
@@ -129,19 +169,16 @@ TEST(Math, IsBetween)
     static_assert(!is_between(2, 0, 1));
 }
 
-#if 0 // static assertions
+// divmod is constexpr, check at compile time and at runtime
 #define expect_dm(mode, n, d, expected_q, expected_r) \
     static_assert(div<mode>(n, d) == expected_q); \
     static_assert(mod<mode>(n, d) == expected_r); \
-    static_assert(divmod<mode>(n, d).first == expected_q); \
-    static_assert(divmod<mode>(n, d).second == expected_r)
-#else // runtime expectations
-#define expect_dm(mode, n, d, expected_q, expected_r) \
+    static_assert(divmod<mode>(n, d).quot == expected_q); \
+    static_assert(divmod<mode>(n, d).rem == expected_r); \
     EXPECT_EQ(div<mode>(n, d), expected_q); \
     EXPECT_EQ(mod<mode>(n, d), expected_r); \
     EXPECT_EQ(divmod<mode>(n, d).quot, expected_q); \
     EXPECT_EQ(divmod<mode>(n, d).rem, expected_r)
-#endif
 
 TEST(Math, DivModTrunc)
 {
@@ -171,6 +208,15 @@ TEST(Math, DivModFloor)
     expect_dm(div_round_mode::floor, -43, -10,  4, -3);
 
     expect_dm(div_round_mode::floor, -99, 11, -9, 0);
+
+    // exact multiples and zero, with the divisor negative
+    expect_dm(div_round_mode::floor,  40, -10, -4,  0);
+    expect_dm(div_round_mode::floor,   0, -10,  0,  0);
+    expect_dm(div_round_mode::floor, -40,  10, -4,  0);
+
+    // adjusting the dividend first would overflow
+    expect_dm(div_round_mode::floor, std::numeric_limits<int>::min(), 10, -214748365, 2);
+    expect_dm(div_round_mode::floor, std::numeric_limits<int>::max(), -10, -214748365, -3);
 }
 
 TEST(Math, DivModEuclid)
@@ -185,6 +231,203 @@ TEST(Math, DivModEuclid)
     expect_dm(div_round_mode::euclid, -43, -10,  5,  7);
 
     expect_dm(div_round_mode::euclid, -99, 11, -9, 0);
+
+    expect_dm(div_round_mode::euclid,   0, -10,  0,  0);
+    expect_dm(div_round_mode::euclid, std::numeric_limits<int>::min(), 10, -214748365, 2);
+    expect_dm(div_round_mode::euclid, -7, std::numeric_limits<int>::min(), 1, 2147483641);
+}
+
+TEST(Math, DivModNamed)
+{
+    // the type can be given, and the divisor converts to it
+    static_assert(cgs::mod_euclid<std::int64_t>(-43, 10) == 7);
+    static_assert(cgs::div_floor<std::int64_t>(-43, 10) == -5);
+    static_assert(cgs::divmod_trunc<std::int64_t>(-43, 10).rem == -3);
+    static_assert(std::is_same<decltype(cgs::div_trunc<std::int64_t>(-43, 10)), std::int64_t>::value);
+}
+
+TEST(Math, DivModUnsigned)
+{
+    // every mode truncates
+    expect_dm(div_round_mode::trunc, 43u, 10u, 4u, 3u);
+    expect_dm(div_round_mode::floor, 43u, 10u, 4u, 3u);
+    expect_dm(div_round_mode::euclid, 43u, 10u, 4u, 3u);
+    expect_dm(div_round_mode::floor, std::numeric_limits<std::uint64_t>::max(), std::uint64_t{10},
+        std::uint64_t{1844674407370955161u}, std::uint64_t{5});
+    expect_dm(div_round_mode::euclid, std::uint8_t{255}, std::uint8_t{7}, std::uint8_t{36}, std::uint8_t{3});
+}
+
+#ifdef CGS_HAS_INT128
+TEST(Math, DivModInt128)
+{
+    using int128 = cgs::detail::int128;
+    using uint128 = cgs::detail::uint128;
+    constexpr int128 big = static_cast<int128>(1) << 100;
+
+    // 2^100 ends in 6, -2^100 - 3 == 10 * (-2^100 / 10 - 1) + 1
+    expect_dm(div_round_mode::trunc, -big - 3, int128{10}, -big / 10, int128{-9});
+    expect_dm(div_round_mode::floor, -big - 3, int128{10}, -big / 10 - 1, int128{1});
+    expect_dm(div_round_mode::euclid, -big - 3, int128{-10}, big / 10 + 1, int128{1});
+    expect_dm(div_round_mode::euclid, ~uint128{}, uint128{3}, ~uint128{} / 3, uint128{0});
+}
+#endif
+
+namespace
+{
+
+template <div_round_mode Mode, typename Int>
+void expectDivModArray(const std::vector<Int>& n, const std::vector<Int>& d)
+{
+    const Int* first = n.data();
+    const Int* last = n.data() + n.size();
+    std::vector<Int> quot(n.size()), rem(n.size()), quotScalar(n.size()), remScalar(n.size());
+
+    div<Mode>(first, last, d.data(), quot.data());
+    mod<Mode>(first, last, d.data(), rem.data());
+    for(std::size_t i = 0; i < n.size(); ++i) {
+        ASSERT_EQ(quot[i], div<Mode>(n[i], d[i])) << +n[i] << " / " << +d[i];
+        ASSERT_EQ(rem[i], mod<Mode>(n[i], d[i])) << +n[i] << " % " << +d[i];
+    }
+
+    divmod<Mode>(first, last, d[0], quotScalar.data(), remScalar.data());
+    for(std::size_t i = 0; i < n.size(); ++i) {
+        ASSERT_EQ(quotScalar[i], div<Mode>(n[i], d[0])) << +n[i] << " / " << +d[0];
+        ASSERT_EQ(remScalar[i], mod<Mode>(n[i], d[0])) << +n[i] << " % " << +d[0];
+    }
+}
+
+template <typename Int>
+void expectDivModArrays()
+{
+    // sizes with and without a scalar tail
+    for(std::size_t size : { 1, 7, 64, 200 }) {
+        std::vector<Int> n(size), d(size);
+        unsigned seed = 12345;
+        for(std::size_t i = 0; i < size; ++i) {
+            seed = seed * 1103515245 + 12345;
+            n[i] = static_cast<Int>(seed >> 8);
+            // small and large divisors, both signs
+            d[i] = static_cast<Int>(i % 3 == 0 ? static_cast<Int>(seed >> 20) % 13 : seed);
+            if(d[i] == 0 || (std::is_signed<Int>::value && d[i] == static_cast<Int>(-1))) {
+                d[i] = 3;
+            }
+        }
+        n[0] = std::numeric_limits<Int>::min();
+        n[size / 2] = std::numeric_limits<Int>::max();
+        d[0] = static_cast<Int>(std::is_signed<Int>::value ? -7 : 7);
+
+        expectDivModArray<div_round_mode::trunc>(n, d);
+        expectDivModArray<div_round_mode::floor>(n, d);
+        expectDivModArray<div_round_mode::euclid>(n, d);
+    }
+}
+
+constexpr int divModArrayConstexpr()
+{
+    const int n[] { -43, 43, -40, 0 };
+    int quot[4] {};
+    int rem[4] {};
+    cgs::divmod_floor(n, n + 4, -10, quot, rem);
+    cgs::mod_euclid(n, n + 4, 10, rem);
+    return quot[0] + quot[1] + quot[2] + quot[3] + rem[0] + rem[1] + rem[2] + rem[3];
+}
+
+// Int comes from the arrays, a literal divisor converts to it
+template <typename Int>
+void expectDivModArrayLiteral()
+{
+    const Int n[] { 0, 47, 48, 100, 95 };
+    Int out[5] {};
+    Int quot[5] {};
+    cgs::mod_euclid(n, n + 5, 48, out);
+    EXPECT_EQ(out[1], 47);
+    EXPECT_EQ(out[2], 0);
+    EXPECT_EQ(out[3], 4);
+    cgs::div_floor(n, n + 5, 48, out);
+    EXPECT_EQ(out[4], 1);
+    cgs::divmod_trunc(n, n + 5, 48, quot, out);
+    EXPECT_EQ(quot[3], 2);
+    EXPECT_EQ(out[3], 4);
+    cgs::div<div_round_mode::euclid>(n, n + 5, 10, out);
+    EXPECT_EQ(out[3], 10);
+    cgs::mod<div_round_mode::floor>(n, n + 5, 10u, out);
+    EXPECT_EQ(out[1], 7);
+    cgs::divmod<div_round_mode::trunc>(n, n + 5, 3, quot, out);
+    EXPECT_EQ(quot[1], 15);
+    EXPECT_EQ(out[1], 2);
+}
+
+} // namespace
+
+TEST(Math, DivModArrayLiteralDivisor)
+{
+    expectDivModArrayLiteral<std::int16_t>();
+    expectDivModArrayLiteral<long>();
+    expectDivModArrayLiteral<std::int64_t>();
+    expectDivModArrayLiteral<std::uint32_t>();
+    expectDivModArrayLiteral<std::uint8_t>();
+}
+
+TEST(Math, DivModArray)
+{
+    // 4 + -5 + 4 + 0 + 7 + 3 + 0 + 0
+    static_assert(divModArrayConstexpr() == 13);
+
+    using cgs::simd::isa;
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        SCOPED_TRACE(cgs::simd::to_string(level));
+        expectDivModArrays<std::int8_t>();
+        expectDivModArrays<std::uint8_t>();
+        expectDivModArrays<std::int16_t>();
+        expectDivModArrays<std::uint16_t>();
+        expectDivModArrays<std::int32_t>();
+        expectDivModArrays<std::uint32_t>();
+        expectDivModArrays<std::int64_t>();
+        expectDivModArrays<std::uint64_t>();
+    }
+
+    // in place, with the named modes
+    std::vector<int> coords { -5, -1, 0, 1, 15, 16, -16, -17 };
+    cgs::mod_euclid(coords.data(), coords.data() + coords.size(), 16, coords.data());
+    EXPECT_EQ(coords, (std::vector<int>{ 11, 15, 0, 1, 15, 0, 0, 15 }));
+}
+
+TEST(Math, DivModArrayZero)
+{
+    const int n[] { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    int d[16] { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+    int out[16] {};
+    EXPECT_THROW(cgs::div_floor(n, n + 16, 0, out), std::logic_error);
+    d[3] = 0;
+    EXPECT_THROW(cgs::div_floor(n, n + 16, d, out), std::logic_error);
+}
+
+TEST(Math, DivModExpected)
+{
+    using cgs::as_expected;
+    using cgs::div_error;
+
+    static_assert(*cgs::div_floor(-7, 2, as_expected) == -4);
+    static_assert(cgs::mod_floor(7, 0, as_expected).error() == div_error::zero_divisor);
+    static_assert(!cgs::div_euclid(std::numeric_limits<int>::min(), -1, as_expected));
+
+    EXPECT_EQ(*cgs::mod_euclid(-7, 2, as_expected), 1);
+    EXPECT_EQ(*cgs::div_trunc(-7, 2, as_expected), -3);
+    EXPECT_EQ(cgs::divmod_floor(-7, 2, as_expected)->rem, 1);
+    EXPECT_EQ(div<div_round_mode::euclid>(7, 0, as_expected).error(), div_error::zero_divisor);
+    EXPECT_EQ(cgs::divmod_trunc(std::int64_t{1}, std::int64_t{0}, as_expected).error(), div_error::zero_divisor);
+    EXPECT_EQ(cgs::mod_trunc(std::numeric_limits<std::int8_t>::min(), std::int8_t{-1}, as_expected).error(),
+        div_error::overflow);
+
+    // unsigned can not overflow
+    EXPECT_EQ(*cgs::div_floor(~0u, ~0u, as_expected), 1u);
+    EXPECT_EQ(cgs::mod_floor(1u, 0u, as_expected).error(), div_error::zero_divisor);
+
+#ifdef CGS_HAS_INT128
+    using int128 = cgs::detail::int128;
+    EXPECT_EQ(cgs::div_floor(std::numeric_limits<int128>::min(), int128{-1}, as_expected).error(), div_error::overflow);
+#endif
 }
 
 TEST(Math, IsNaN)
@@ -251,3 +494,203 @@ TEST(Math, IsFinite)
     ISNOTFINITE(std::numeric_limits<long double>::infinity());
     ISNOTFINITE(-std::numeric_limits<long double>::infinity());
 }
+
+namespace
+{
+
+constexpr double constexprFrame[] { 1.0, -2.0, 0.0, std::numeric_limits<double>::infinity(), 3.0,
+    std::numeric_limits<double>::quiet_NaN() };
+static_assert(cgs::find_first_nonfinite(std::begin(constexprFrame), std::end(constexprFrame)) == constexprFrame + 3);
+static_assert(cgs::find_first_nan(std::begin(constexprFrame), std::end(constexprFrame)) == constexprFrame + 5);
+static_assert(cgs::count_nonfinite(std::begin(constexprFrame), std::end(constexprFrame)) == 2);
+static_assert(cgs::count_nan(std::begin(constexprFrame), std::end(constexprFrame)) == 1);
+static_assert(!cgs::all_finite(std::begin(constexprFrame), std::end(constexprFrame)));
+static_assert(cgs::all_finite(std::begin(constexprFrame), std::begin(constexprFrame) + 3));
+
+template <typename T>
+void expectNonFiniteScan()
+{
+    const T nonfinites[] {
+        std::numeric_limits<T>::quiet_NaN(), -std::numeric_limits<T>::quiet_NaN(),
+        std::numeric_limits<T>::signaling_NaN(),
+        std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+    };
+    // finite values next to the exponent mask
+    const T finites[] {
+        T{}, -T{}, T{1}, std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest(),
+        std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::min(),
+    };
+
+    for(std::size_t size : { 0, 1, 5, 16, 63, 64, 65, 300 }) {
+        std::vector<T> frame(size);
+        for(std::size_t i = 0; i < size; ++i) {
+            frame[i] = finites[i % std::size(finites)];
+        }
+        const T* first = frame.data();
+        const T* last = frame.data() + size;
+        EXPECT_TRUE(cgs::all_finite(first, last));
+        EXPECT_EQ(cgs::find_first_nonfinite(first, last), last);
+        EXPECT_EQ(cgs::count_nan(first, last), 0u);
+
+        // a bad value at every position, and a second one after it
+        for(std::size_t bad = 0; bad < size; ++bad) {
+            const T value = nonfinites[bad % std::size(nonfinites)];
+            const bool nan = cgs::isnan(value);
+            std::vector<T> copy = frame;
+            copy[bad] = value;
+            copy[size - 1] = std::numeric_limits<T>::quiet_NaN();
+            first = copy.data();
+            last = copy.data() + size;
+
+            ASSERT_EQ(cgs::find_first_nonfinite(first, last) - first, static_cast<std::ptrdiff_t>(bad));
+            ASSERT_EQ(cgs::find_first_nan(first, last) - first, static_cast<std::ptrdiff_t>(nan ? bad : size - 1));
+            ASSERT_FALSE(cgs::all_finite(first, last));
+            ASSERT_EQ(cgs::count_nonfinite(first, last), bad == size - 1 ? 1u : 2u);
+            ASSERT_EQ(cgs::count_nan(first, last), bad == size - 1 || nan ? 1u + (bad != size - 1) : 1u);
+        }
+    }
+}
+
+} // namespace
+
+TEST(Math, NonFiniteScan)
+{
+    using cgs::simd::isa;
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        SCOPED_TRACE(cgs::simd::to_string(level));
+        expectNonFiniteScan<float>();
+        expectNonFiniteScan<double>();
+    }
+
+    // every element of a large frame
+    std::vector<float> frame(100000, 1.0f);
+    frame[1000] = NAN;
+    frame[70000] = INFINITY;
+    frame[99999] = -NAN;
+    EXPECT_EQ(cgs::count_nan(frame.data(), frame.data() + frame.size()), 2u);
+    EXPECT_EQ(cgs::count_nonfinite(frame.data(), frame.data() + frame.size()), 3u);
+
+    // integers are always finite
+    const int ints[] { 1, 2, 3 };
+    EXPECT_TRUE(cgs::all_finite(std::begin(ints), std::end(ints)));
+    EXPECT_EQ(cgs::count_nan(std::begin(ints), std::end(ints)), 0u);
+}
+
+namespace
+{
+
+constexpr float constexprLerp()
+{
+    const float a[] { 0.0f, 1.0f, 2.0f };
+    const float b[] { 4.0f, 5.0f, 6.0f };
+    float out[3] {};
+    lerp(std::begin(a), std::end(a), b, 0.25f, out);
+    clamp(std::begin(out), std::end(out), 1.5f, 2.5f, out);
+    return out[0] + out[1] + out[2];
+}
+static_assert(constexprLerp() == 1.5f + 2.0f + 2.5f);
+
+template <cgs::finite_check Check, typename T>
+void expectLerpArray()
+{
+    const T inf = std::numeric_limits<T>::infinity();
+    const T max = std::numeric_limits<T>::max();
+
+    for(std::size_t size : { 0, 1, 7, 16, 33, 64, 100 }) {
+        std::vector<T> a(size), b(size), amount(size), out(size);
+        for(std::size_t i = 0; i < size; ++i) {
+            // exact with or without FMA
+            a[i] = static_cast<T>(i);
+            b[i] = static_cast<T>(2 * i + 1);
+            amount[i] = static_cast<T>(i % 5) * T(0.25);
+        }
+        // every kind of non-finite input, and an overflowing difference
+        const T specials[][2] { { inf, T(1) }, { T(1), -inf }, { NAN, T(1) }, { inf, inf }, { -max, max } };
+        for(std::size_t i = 0; i < std::size(specials) && 3 * i < size; ++i) {
+            a[3 * i] = specials[i][0];
+            b[3 * i] = specials[i][1];
+        }
+
+        const auto expectLerped = [&](auto amountAt) {
+            for(std::size_t i = 0; i < size; ++i) {
+                const T expected = lerp<Check>(a[i], b[i], amountAt(i));
+                if(std::isnan(expected)) {
+                    ASSERT_TRUE(std::isnan(out[i])) << i;
+                }
+                else {
+                    ASSERT_EQ(out[i], expected) << i;
+                }
+            }
+        };
+
+        lerp<Check>(a.data(), a.data() + size, b.data(), 0.75, out.data());
+        expectLerped([](std::size_t) { return T(0.75); });
+
+        lerp<Check>(a.data(), a.data() + size, b.data(), amount.data(), out.data());
+        expectLerped([&](std::size_t i) { return amount[i]; });
+    }
+}
+
+template <typename T>
+void expectClampArray()
+{
+    for(std::size_t size : { 0, 1, 7, 16, 33, 64, 100 }) {
+        std::vector<T> val(size), out(size);
+        for(std::size_t i = 0; i < size; ++i) {
+            val[i] = static_cast<T>(static_cast<int>(i % 21) - 10);
+        }
+        clamp(val.data(), val.data() + size, T(2), T(6), out.data());
+        for(std::size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(out[i], clamp(val[i], T(2), T(6))) << i;
+        }
+
+        // in place
+        clamp(val.data(), val.data() + size, T(0), T(0), val.data());
+        for(std::size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(val[i], T(0)) << i;
+        }
+    }
+}
+
+} // namespace
+
+TEST(Math, LerpArray)
+{
+    using cgs::finite_check;
+    using cgs::simd::isa;
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        SCOPED_TRACE(cgs::simd::to_string(level));
+        expectLerpArray<finite_check::inputs, float>();
+        expectLerpArray<finite_check::difference, float>();
+        expectLerpArray<finite_check::none, float>();
+        expectLerpArray<finite_check::inputs, double>();
+        expectLerpArray<finite_check::difference, double>();
+        expectLerpArray<finite_check::none, double>();
+    }
+}
+
+TEST(Math, ClampArray)
+{
+    using cgs::simd::isa;
+    for(isa level : { isa::baseline, isa::sse2, isa::avx2, isa::avx512 }) {
+        cgs::simd::force_isa(level);
+        SCOPED_TRACE(cgs::simd::to_string(level));
+        expectClampArray<float>();
+        expectClampArray<double>();
+        expectClampArray<std::int8_t>();
+        expectClampArray<std::int32_t>();
+        expectClampArray<std::uint16_t>();
+        expectClampArray<std::int64_t>();
+    }
+
+    // NaN clamps to max, like the scalar clamp
+    const float nan[] { NAN, 0.5f };
+    float out[2] {};
+    clamp(std::begin(nan), std::end(nan), 0.0f, 1.0f, out);
+    EXPECT_EQ(out[0], 1.0f);
+    EXPECT_EQ(out[1], 0.5f);
+
+    EXPECT_THROW(clamp(std::begin(nan), std::end(nan), 1.0f, 0.0f, out), std::logic_error);
+}
@@ -0,0 +1,148 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+// compiled with -fno-exceptions, in its own test executable
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_ABORT
+#include "cgs/algorithm.hpp"
+#include "cgs/assert.hpp"
+#include "cgs/expected.hpp"
+#include "cgs/math.hpp"
+#include "cgs/radix_sort.hpp"
+#include "cgs/thread_pool.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <vector>
+
+using cgs::expected;
+using cgs::violation;
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+    #error test/no_exceptions.cpp must be compiled without exceptions
+#endif
+
+namespace ignored {
+constexpr cgs::assert_levels cgs_assert_levels { violation::abort, violation::ignore, violation::sample };
+static void normal(bool result) { cgs_assert(result); }
+static void expensive(bool result) { cgs_assert_expensive(result); }
+}
+
+TEST(NoExceptions, Abort)
+{
+    cgs_assert(2 + 2 == 4);
+    cgs_assert_eq(2 + 2, 4);
+    EXPECT_DEATH(cgs_assert(2 + 2 == 5), R"(Assertion failed \(2 \+ 2 == 5\))");
+    EXPECT_DEATH(cgs_assert_eq(2 + 2, 5), R"(Assertion failed \(2 \+ 2 == 5\))");
+}
+
+TEST(NoExceptions, Levels)
+{
+    // sampled, the first hit of the site is evaluated
+    EXPECT_DEATH(ignored::expensive(false), R"(Assertion failed \(result\))");
+    ignored::expensive(true);
+    ignored::normal(true);
+    EXPECT_DEATH(cgs_assert_cheap(false), R"(Assertion failed \(false\))");
+}
+
+// switching the active member to one with a throwing move constructor uses the rollback path with exceptions
+struct ThrowingMove
+{
+    int value = 0;
+    ThrowingMove(int value) : value { value } {}
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) noexcept(false) : value { other.value } {}
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+};
+
+TEST(NoExceptions, Expected)
+{
+    expected<ThrowingMove, int> a { 3 };
+    EXPECT_EQ(a->value, 3);
+    EXPECT_EQ((*a).value, 3);
+
+    a = expected<ThrowingMove, int> { cgs::unexpect, 7 };
+    EXPECT_FALSE(a);
+    EXPECT_EQ(a.error(), 7);
+    a = expected<ThrowingMove, int> { ThrowingMove { 5 } };
+    EXPECT_EQ(a.value().value, 5);
+
+    EXPECT_DEATH(a.error(), "Assertion failed");
+    a = expected<ThrowingMove, int> { cgs::unexpect, 7 };
+    EXPECT_DEATH(a.value(), "Assertion failed");
+    EXPECT_DEATH(*a, "Assertion failed");
+}
+
+TEST(NoExceptions, AsExpected)
+{
+    // not constants, so the runtime paths compile
+    volatile int n = -43;
+    volatile int d = 10;
+    EXPECT_EQ(*cgs::div_trunc(n, d, cgs::as_expected), -4);
+    EXPECT_EQ(*cgs::div_floor(n, d, cgs::as_expected), -5);
+    EXPECT_EQ(*cgs::div_euclid(n, d, cgs::as_expected), -5);
+    EXPECT_EQ(*cgs::mod_trunc(n, d, cgs::as_expected), -3);
+    EXPECT_EQ(*cgs::mod_floor(n, d, cgs::as_expected), 7);
+    EXPECT_EQ(*cgs::mod_euclid(n, d, cgs::as_expected), 7);
+    EXPECT_EQ(cgs::divmod_trunc(n, d, cgs::as_expected)->rem, -3);
+    EXPECT_EQ(cgs::divmod_floor(n, d, cgs::as_expected)->quot, -5);
+    EXPECT_EQ(cgs::divmod_euclid(n, d, cgs::as_expected)->rem, 7);
+
+    EXPECT_EQ(cgs::div_floor(n, 0, cgs::as_expected).error(), cgs::div_error::zero_divisor);
+    EXPECT_EQ(cgs::mod_euclid(INT_MIN, -1, cgs::as_expected).error(), cgs::div_error::overflow);
+    EXPECT_DEATH(*cgs::div_trunc(n, 0, cgs::as_expected), "Assertion failed");
+}
+
+TEST(NoExceptions, RadixSort)
+{
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy par {};
+    par.pool = &pool;
+    par.min_chunk = 10;
+
+    // move only, so the first pass constructs the buffer's elements
+    const auto key = [](const std::unique_ptr<int>& p) { return *p; };
+    for(bool parallel : { false, true }) {
+        std::vector<std::unique_ptr<int>> values;
+        for(int i = 0; i < 1000; ++i) {
+            values.push_back(std::make_unique<int>((i * 7919) % 2001 - 1000));
+        }
+        if(parallel) {
+            cgs::radix_sort(par, values.begin(), values.end(), key);
+        }
+        else {
+            cgs::radix_sort(values.begin(), values.end(), key);
+        }
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end(),
+            [](const auto& a, const auto& b) { return *a < *b; })) << parallel;
+    }
+}
+
+TEST(NoExceptions, ParallelFill)
+{
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy par {};
+    par.pool = &pool;
+    par.min_chunk = 10;
+
+    std::vector<int> ints(1000, -1);
+    cgs::fill(par, ints.begin(), ints.end(), 3);
+    EXPECT_EQ(std::count(ints.begin(), ints.end(), 3), 1000);
+    cgs::fill(cgs::execution::par, ints.begin(), ints.end(), 4);
+    EXPECT_EQ(std::count(ints.begin(), ints.end(), 4), 1000);
+}
@@ -0,0 +1,137 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_IGNORE
+#include "cgs/assert.hpp"
+#include "cgs/optimize.hpp"
+#include "cgs/unowned_ptr.hpp"
+
+#include <cstdint>
+
+// Codegen tests: each function calls not_eliminated() on a path its assumption rules out.
+// With CGS_TEST_CODEGEN on GCC, a call that survives is a compile error, so these build only if the hints are used.
+// Configured with -DCGS_TEST_CODEGEN=ON, CMake defines it for copies of this file compiled at -O1, -O2, -O3 and -Os,
+// where the hints are verified with GCC 12,
+// but not for cgs-test, which builds at any level (-Og drops some hints).
+// They can not hold with -fsanitize=unreachable, which turns the hints into checks.
+#if defined(CGS_TEST_CODEGEN) && defined(__GNUC__) && !defined(__clang__)
+[[gnu::error("an assumption was not used by the optimizer")]] void not_eliminated();
+// optimized alone, without the constant arguments of the calls below
+#define CODEGEN [[gnu::noipa]]
+#else
+static void not_eliminated() {}
+#define CODEGEN
+#endif
+
+namespace
+{
+
+int saved = 0;
+bool save(int value)
+{
+    saved = value;
+    return true;
+}
+
+CODEGEN int assumeLess(int i)
+{
+    cgs_assume(i < 100);
+    if(i >= 100) {
+        not_eliminated();
+    }
+    return i;
+}
+
+CODEGEN unsigned assumeRange(unsigned x)
+{
+    cgs_assume_range(x, 10u, 20u);
+    if(x < 10 || x > 20) {
+        not_eliminated();
+    }
+    return x;
+}
+
+CODEGEN const int* assumeAligned(const int* p)
+{
+    const int* aligned = cgs_assume_aligned(p, 64);
+    if(reinterpret_cast<std::uintptr_t>(aligned) % 64 != 0) {
+        not_eliminated();
+    }
+    return aligned;
+}
+
+// an ignored assertion is a hint
+CODEGEN int assertIgnored(int i)
+{
+    cgs_assert(i != 0);
+    if(i == 0) {
+        not_eliminated();
+    }
+    return i;
+}
+
+// an unowned_ptr is not null where it is used
+CODEGEN const int* unownedNotNull(cgs::unowned_ptr<const int> p)
+{
+    const int* used = p.operator->();
+    if(!used) {
+        not_eliminated();
+    }
+    return used;
+}
+
+constexpr int assumeConstexpr(int i)
+{
+    cgs_assume_range(i, 0, 9);
+    return *cgs::assume_aligned<alignof(int)>(&i);
+}
+
+constexpr int prefetchConstexpr(const int* p)
+{
+    cgs::prefetch(p);
+    return *p;
+}
+
+} // namespace
+
+TEST(Optimize, Assume)
+{
+    EXPECT_EQ(assumeLess(5), 5);
+    EXPECT_EQ(assumeRange(15u), 15u);
+    alignas(64) static const int values[16] {};
+    EXPECT_EQ(assumeAligned(values), values);
+    EXPECT_EQ(assertIgnored(3), 3);
+    const int three = 3;
+    EXPECT_EQ(unownedNotNull(&three), &three);
+    static_assert(assumeConstexpr(7) == 7);
+}
+
+TEST(Optimize, Prefetch)
+{
+    static constexpr int value = 4;
+    static_assert(prefetchConstexpr(&value) == 4);
+    EXPECT_EQ(prefetchConstexpr(&value), 4);
+    // never dereferenced
+    cgs::prefetch(nullptr);
+}
+
+TEST(Optimize, AssumeNotEvaluated)
+{
+    cgs_assume(save(1));
+    cgs_assume_range(saved, save(2), save(3));
+    EXPECT_EQ(saved, 0);
+}
@@ -0,0 +1,311 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#include "cgs/radix_sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+struct Person
+{
+    int age;
+    int id;
+};
+
+constexpr int getAge(const Person& person)
+{
+    return person.age;
+}
+
+// move only, not default constructible, and counts the live objects.
+// The moveThrowsAt-th move construction throws.
+struct Tracked
+{
+    static inline int live = 0;
+    static inline int moves = 0;
+    static inline int moveThrowsAt = 0;
+
+    std::unique_ptr<int> key;
+
+    explicit Tracked(int value) : key { std::make_unique<int>(value) } { ++live; }
+    Tracked(Tracked&& other) : key {}
+    {
+        if(++moves == moveThrowsAt) {
+            throw std::runtime_error("move");
+        }
+        key = std::move(other.key);
+        ++live;
+    }
+    Tracked& operator=(Tracked&&) = default;
+    ~Tracked() { --live; }
+};
+
+int getKey(const Tracked& tracked)
+{
+    return *tracked.key;
+}
+
+enum class Priority : std::int8_t
+{
+    low = -1,
+    normal = 0,
+    high = 1
+};
+
+// uniform in [lo, hi], hi - lo < 2^63
+template <typename T>
+std::vector<T> randomIntegers(std::size_t n, T lo, T hi, unsigned seed)
+{
+    std::mt19937_64 engine { seed };
+    std::uniform_int_distribution<std::int64_t> distribution { static_cast<std::int64_t>(lo), static_cast<std::int64_t>(hi) };
+    std::vector<T> values(n);
+    for(T& value : values) {
+        value = static_cast<T>(distribution(engine));
+    }
+    return values;
+}
+
+// every bit random
+template <typename T>
+std::vector<T> randomBits(std::size_t n, unsigned seed)
+{
+    std::mt19937_64 engine { seed };
+    std::vector<T> values(n);
+    for(T& value : values) {
+        value = static_cast<T>(engine());
+    }
+    return values;
+}
+
+template <typename T>
+void expectSortsIntegers()
+{
+    for(std::size_t n : { 0, 1, 2, 64, 65, 1000, 100000 }) {
+        for(bool narrow : { false, true }) {
+            // narrow keys leave the high bytes trivial
+            std::vector<T> values = narrow ? randomIntegers<T>(n, T{0}, T{100}, static_cast<unsigned>(n))
+                                           : randomBits<T>(n, static_cast<unsigned>(n));
+            std::vector<T> expected = values;
+            std::sort(expected.begin(), expected.end());
+            cgs::radix_sort(values.begin(), values.end());
+            ASSERT_EQ(values, expected) << n << " " << narrow;
+        }
+    }
+}
+
+// the bits, so -0 and NaNs compare by representation
+template <typename T>
+std::vector<std::uint64_t> representations(const std::vector<T>& values)
+{
+    std::vector<std::uint64_t> bits;
+    for(T value : values) {
+        bits.push_back(cgs::detail::radix_key(value));
+    }
+    return bits;
+}
+
+template <typename T>
+void expectSortsFloats()
+{
+    using limits = std::numeric_limits<T>;
+    std::vector<T> values { T(1), T(-1), T(0), T(-0.0), -limits::infinity(), limits::infinity(),
+        limits::denorm_min(), -limits::denorm_min(), limits::max(), limits::lowest(), limits::min(), T(0.5) };
+    std::mt19937_64 engine { 3 };
+    std::uniform_real_distribution<T> distribution { T(-1e6), T(1e6) };
+    for(int i = 0; i < 10000; ++i) {
+        values.push_back(distribution(engine));
+    }
+
+    std::vector<T> expected = values;
+    // -0 before +0, like the radix order
+    std::stable_sort(expected.begin(), expected.end(), [](T a, T b) {
+        return a < b || (a == b && std::signbit(a) && !std::signbit(b));
+    });
+    cgs::radix_sort(values.begin(), values.end());
+    EXPECT_EQ(representations(values), representations(expected));
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+
+    // NaNs at the ends by sign
+    std::vector<T> nans { T(2), limits::quiet_NaN(), T(-3), -limits::quiet_NaN(), T(1) };
+    cgs::radix_sort(nans.begin(), nans.end());
+    EXPECT_TRUE(std::isnan(nans[0]) && std::signbit(nans[0]));
+    EXPECT_EQ(nans[1], T(-3));
+    EXPECT_EQ(nans[2], T(1));
+    EXPECT_EQ(nans[3], T(2));
+    EXPECT_TRUE(std::isnan(nans[4]) && !std::signbit(nans[4]));
+}
+
+std::vector<Person> randomPeople(std::size_t n)
+{
+    std::vector<int> ages = randomIntegers<int>(n, -5, 120, 7);
+    std::vector<Person> people(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        people[i] = { ages[i], static_cast<int>(i) };
+    }
+    return people;
+}
+
+void expectSortedByAge(const std::vector<Person>& people, std::vector<Person> input)
+{
+    std::stable_sort(input.begin(), input.end(), [](const Person& a, const Person& b) { return a.age < b.age; });
+    ASSERT_EQ(people.size(), input.size());
+    for(std::size_t i = 0; i < people.size(); ++i) {
+        ASSERT_EQ(people[i].age, input[i].age) << i;
+        ASSERT_EQ(people[i].id, input[i].id) << i;
+    }
+}
+
+} // namespace
+
+TEST(RadixSort, Integers)
+{
+    expectSortsIntegers<std::uint8_t>();
+    expectSortsIntegers<std::int8_t>();
+    expectSortsIntegers<std::uint16_t>();
+    expectSortsIntegers<std::int16_t>();
+    expectSortsIntegers<std::uint32_t>();
+    expectSortsIntegers<std::int32_t>();
+    expectSortsIntegers<std::uint64_t>();
+    expectSortsIntegers<std::int64_t>();
+}
+
+TEST(RadixSort, Floats)
+{
+    expectSortsFloats<float>();
+    expectSortsFloats<double>();
+}
+
+TEST(RadixSort, Projection)
+{
+    for(std::size_t n : { 10, 1000, 50000 }) {
+        const std::vector<Person> input = randomPeople(n);
+        std::vector<Person> people = input;
+        cgs::radix_sort(people.begin(), people.end(), getAge);
+        expectSortedByAge(people, input);
+    }
+
+    std::vector<Priority> priorities { Priority::high, Priority::low, Priority::normal, Priority::low };
+    cgs::radix_sort(priorities.begin(), priorities.end());
+    EXPECT_EQ(priorities, (std::vector<Priority>{ Priority::low, Priority::low, Priority::normal, Priority::high }));
+}
+
+TEST(RadixSort, SkipsTrivialPasses)
+{
+    std::vector<std::uint64_t> values = randomIntegers<std::uint64_t>(1000, 0, 255, 1);
+    std::size_t calls = 0;
+    const auto counted = [&calls](std::uint64_t value) {
+        ++calls;
+        return value;
+    };
+    cgs::radix_sort(values.begin(), values.end(), counted);
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+    // the count, and one pass of 8
+    EXPECT_EQ(calls, 2 * values.size());
+
+    calls = 0;
+    std::vector<std::uint64_t> same(1000, 0x1234);
+    cgs::radix_sort(same.begin(), same.end(), counted);
+    EXPECT_EQ(calls, same.size());
+}
+
+TEST(RadixSort, Parallel)
+{
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy par {};
+    par.pool = &pool;
+    par.min_chunk = 10;
+    cgs::execution::parallel_unsequenced_policy parUnseq {};
+    parUnseq.pool = &pool;
+    parUnseq.min_chunk = 10;
+
+    for(std::size_t n : { 0, 5, 37, 1000, 100000 }) {
+        const std::vector<Person> input = randomPeople(n);
+        std::vector<Person> people = input;
+        cgs::radix_sort(par, people.begin(), people.end(), getAge);
+        expectSortedByAge(people, input);
+
+        people = input;
+        cgs::radix_sort(parUnseq, people.begin(), people.end(), getAge);
+        expectSortedByAge(people, input);
+
+        std::vector<std::int64_t> values = randomBits<std::int64_t>(n, static_cast<unsigned>(n));
+        std::vector<std::int64_t> expected = values;
+        std::sort(expected.begin(), expected.end());
+        cgs::radix_sort(par, values.begin(), values.end());
+        EXPECT_EQ(values, expected);
+    }
+
+    std::vector<float> values { 3.f, -1.f, 2.f, -0.5f };
+    cgs::radix_sort(cgs::execution::seq, values.begin(), values.end());
+    EXPECT_EQ(values, (std::vector<float>{ -1.f, -0.5f, 2.f, 3.f }));
+}
+
+TEST(RadixSort, MoveOnly)
+{
+    cgs::thread_pool pool { 3 };
+    cgs::execution::parallel_policy par {};
+    par.pool = &pool;
+    par.min_chunk = 10;
+
+    for(bool parallel : { false, true }) {
+        for(std::size_t n : { 1000, 50000 }) {
+            // negative keys, so every byte is a pass, and the later passes assign into the buffer
+            std::vector<int> keys = randomIntegers<int>(n, -1000, 1000, static_cast<unsigned>(n));
+            std::vector<Tracked> values;
+            values.reserve(n);
+            for(int key : keys) {
+                values.emplace_back(key);
+            }
+            Tracked::moves = 0;
+            Tracked::moveThrowsAt = 0;
+            if(parallel) {
+                cgs::radix_sort(par, values.begin(), values.end(), getKey);
+            }
+            else {
+                cgs::radix_sort(values.begin(), values.end(), getKey);
+            }
+            EXPECT_EQ(Tracked::live, static_cast<int>(n));
+            std::sort(keys.begin(), keys.end());
+            for(std::size_t i = 0; i < n; ++i) {
+                ASSERT_EQ(getKey(values[i]), keys[i]) << parallel << " " << n << " " << i;
+            }
+
+            // a throw in the first pass destroys the elements already moved into the buffer
+            Tracked::moves = 0;
+            Tracked::moveThrowsAt = static_cast<int>(n / 2);
+            if(parallel) {
+                EXPECT_THROW(cgs::radix_sort(par, values.begin(), values.end(), getKey), std::runtime_error);
+            }
+            else {
+                EXPECT_THROW(cgs::radix_sort(values.begin(), values.end(), getKey), std::runtime_error);
+            }
+            EXPECT_EQ(Tracked::live, static_cast<int>(n));
+            Tracked::moveThrowsAt = 0;
+        }
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
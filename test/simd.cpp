@@ -0,0 +1,293 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/algorithm.hpp"
+#include "cgs/elementary.hpp"
+#include "cgs/simd.hpp"
+using cgs::simd::vec4;
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// vec4 must stay trivially copyable, so it is passed in registers
+static_assert(std::is_trivially_copyable<vec4>::value);
+static_assert(std::is_trivially_destructible<vec4>::value);
+static_assert(sizeof(vec4) == 16);
+static_assert(alignof(vec4) == 16);
+
+constexpr vec4 a { 1.0f, 2.0f, 3.0f, 4.0f };
+constexpr vec4 b { 8.0f, 6.0f, 4.0f, 2.0f };
+
+TEST(Simd, Vec4Constexpr)
+{
+    static_assert(a + b == vec4{9.0f, 8.0f, 7.0f, 6.0f});
+    static_assert(b - a == vec4{7.0f, 4.0f, 1.0f, -2.0f});
+    static_assert(a * b == vec4{8.0f, 12.0f, 12.0f, 8.0f});
+    static_assert(b / a == vec4{8.0f, 3.0f, 4.0f / 3.0f, 0.5f});
+    static_assert(-a == vec4{-1.0f, -2.0f, -3.0f, -4.0f});
+    static_assert(a * 2.0f == 2.0f * a);
+    static_assert(dot(a, b) == 40.0f);
+    static_assert(fma(a, b, a) == vec4{9.0f, 14.0f, 15.0f, 12.0f});
+    static_assert(min(a, b) == vec4{1.0f, 2.0f, 3.0f, 2.0f});
+    static_assert(max(a, b) == vec4{8.0f, 6.0f, 4.0f, 4.0f});
+    static_assert(cgs::simd::shuffle<3, 2, 1, 0>(a) == vec4{4.0f, 3.0f, 2.0f, 1.0f});
+    static_assert(a.x() == 1.0f && a.y() == 2.0f && a.z() == 3.0f && a.w() == 4.0f);
+}
+
+constexpr vec4 roundTrip()
+{
+    float data[4] {};
+    vec4{5.0f, 6.0f, 7.0f, 8.0f}.storeu(data);
+    vec4 v = vec4::loadu(data);
+    v += vec4{1.0f};
+    v *= 2.0f;
+    return v;
+}
+
+TEST(Simd, Vec4LoadStoreConstexpr)
+{
+    static_assert(roundTrip() == vec4{12.0f, 14.0f, 16.0f, 18.0f});
+}
+
+TEST(Simd, Vec4Runtime)
+{
+    // volatile, so these are computed at runtime
+    volatile float one = 1.0f;
+    const vec4 ra { one, 2.0f * one, 3.0f * one, 4.0f * one };
+    const vec4 rb { 8.0f * one, 6.0f * one, 4.0f * one, 2.0f * one };
+
+    EXPECT_EQ(ra + rb, a + b);
+    EXPECT_EQ(rb - ra, b - a);
+    EXPECT_EQ(ra * rb, a * b);
+    EXPECT_EQ(rb / ra, b / a);
+    EXPECT_EQ(-ra, -a);
+    EXPECT_EQ(dot(ra, rb), dot(a, b));
+    EXPECT_EQ(fma(ra, rb, ra), fma(a, b, a));
+    EXPECT_EQ(min(ra, rb), min(a, b));
+    EXPECT_EQ(max(ra, rb), max(a, b));
+    EXPECT_EQ((cgs::simd::shuffle<1, 1, 3, 0>(ra)), (vec4{2.0f, 2.0f, 4.0f, 1.0f}));
+    EXPECT_EQ(ra[2], 3.0f);
+    EXPECT_NE(ra, rb);
+}
+
+TEST(Simd, Vec4LoadStore)
+{
+    alignas(16) float data[4] { 1.0f, 2.0f, 3.0f, 4.0f };
+    vec4 v = vec4::load(data);
+    EXPECT_EQ(v, a);
+    (v * 2.0f).store(data);
+    EXPECT_EQ(data[3], 8.0f);
+
+    float unaligned[5] { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f };
+    EXPECT_EQ(vec4::loadu(unaligned + 1), a);
+    b.storeu(unaligned + 1);
+    EXPECT_EQ(unaligned[0], 0.0f);
+    EXPECT_EQ(unaligned[4], 2.0f);
+}
+
+TEST(Simd, Vec4MinMaxNaN)
+{
+    // like minps and maxps, NaN in either lane returns the second operand
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const vec4 n { nan };
+    EXPECT_EQ(min(n, a), a);
+    EXPECT_EQ(max(n, a), a);
+    EXPECT_TRUE(std::isnan(min(a, n)[0]));
+    EXPECT_TRUE(std::isnan(max(a, n)[0]));
+}
+
+TEST(Simd, Vec4NegateZero)
+{
+    static_assert(cgs::detail::signbit((-vec4{0.0f})[0]));
+    static_assert(!cgs::detail::signbit((-vec4{-0.0f})[0]));
+
+    volatile float zero = 0.0f;
+    const vec4 z { zero, -zero, zero, -zero };
+    const vec4 n = -z;
+    EXPECT_TRUE(std::signbit(n[0]));
+    EXPECT_FALSE(std::signbit(n[1]));
+    EXPECT_TRUE(std::signbit(n[2]));
+    EXPECT_FALSE(std::signbit(n[3]));
+}
+
+TEST(Simd, Vec4Throw)
+{
+    EXPECT_ANY_THROW(a[4]);
+}
+
+using cgs::simd::pack;
+
+template <typename T, std::size_t N>
+constexpr pack<T, N> iota()
+{
+    return pack<T, N>::generate([](std::size_t i) { return static_cast<T>(i); });
+}
+
+constexpr int sumTail()
+{
+    // sum 5 ints with a 4 wide pack, the tail uses a partial load
+    const int data[5] { 1, 2, 3, 4, 5 };
+    pack<int, 4> acc {};
+    acc = acc + pack<int, 4>::loadu(data);
+    acc = acc + pack<int, 4>::load_partial(data + 4, 1);
+    return cgs::simd::reduce(acc, std::plus<int>{});
+}
+
+TEST(Simd, PackConstexpr)
+{
+    constexpr auto i = iota<int, 8>();
+    constexpr auto two = pack<int, 8>{2};
+    static_assert(all(i * two == i + i));
+    static_assert(all((i << 1) == i + i));
+    static_assert(all((i >> 1) == i / two));
+    static_assert(any(i == two));
+    static_assert(!all(i == two));
+    static_assert(!any(i == -two));
+    static_assert(all(min(i, two) <= two));
+    static_assert(max(i, two)[0] == 2 && max(i, two)[7] == 7);
+    static_assert(select(i < two, i, -i)[1] == 1);
+    static_assert(select(i < two, i, -i)[5] == -5);
+    static_assert(cgs::simd::reduce(i, std::plus<int>{}) == 28);
+    static_assert(sumTail() == 15);
+
+    constexpr auto f = iota<double, 4>();
+    static_assert(all(f * pack<double, 4>{0.5} == f / pack<double, 4>{2.0}));
+    static_assert(cgs::simd::reduce(f, cgs::max2<double>) == 3.0);
+}
+
+template <typename T, std::size_t N>
+void expectPackOps()
+{
+    // volatile, so these are computed at runtime
+    volatile T one = 1;
+    const auto i = pack<T, N>::generate([&](std::size_t lane) { return static_cast<T>(lane % 16 * one); });
+    const auto constI = iota<T, N>();
+    const pack<T, N> two { static_cast<T>(2 * one) };
+
+    EXPECT_TRUE(all(i + i == i * two));
+    EXPECT_TRUE(all(i - i == pack<T, N>{}));
+    EXPECT_TRUE(any(i == pack<T, N>{one}));
+    EXPECT_FALSE(all(i == pack<T, N>{one}));
+    EXPECT_TRUE(all(min(i, two) <= two));
+    EXPECT_TRUE(all(max(i, two) >= two));
+    EXPECT_TRUE(all(select(i < two, two, i) >= two));
+    EXPECT_EQ(i[N - 1], static_cast<T>((N - 1) % 16));
+    if constexpr(N <= 16) {
+        EXPECT_TRUE(all(i == constI));
+        EXPECT_EQ(cgs::simd::reduce(i, std::plus<>{}), static_cast<T>(N * (N - 1) / 2));
+    }
+}
+
+TEST(Simd, PackTypes)
+{
+    expectPackOps<std::int8_t, 16>();
+    expectPackOps<std::uint8_t, 64>();
+    expectPackOps<std::int16_t, 8>();
+    expectPackOps<std::uint16_t, 32>();
+    expectPackOps<std::int32_t, 4>();
+    expectPackOps<std::uint32_t, 8>();
+    expectPackOps<std::int32_t, 16>();
+    expectPackOps<std::int64_t, 2>();
+    expectPackOps<std::uint64_t, 8>();
+    expectPackOps<float, 4>();
+    expectPackOps<float, 8>();
+    expectPackOps<float, 16>();
+    expectPackOps<double, 2>();
+    expectPackOps<double, 8>();
+    expectPackOps<double, cgs::simd::native_width_v<double>>();
+}
+
+template <typename T, std::size_t N>
+void expectPartial()
+{
+    T data[N + 1] {};
+    for(std::size_t i = 0; i <= N; ++i) {
+        data[i] = static_cast<T>(i + 1);
+    }
+
+    for(std::size_t count = 0; count <= N + 1; ++count) {
+        const auto p = pack<T, N>::load_partial(data, count);
+        for(std::size_t lane = 0; lane < N; ++lane) {
+            EXPECT_EQ(p[lane], lane < count ? data[lane] : T{}) << "count " << count << " lane " << lane;
+        }
+
+        T out[N + 1] {};
+        pack<T, N>{ static_cast<T>(7) }.store_partial(out, count);
+        for(std::size_t lane = 0; lane <= N; ++lane) {
+            EXPECT_EQ(out[lane], lane < count && lane < N ? T{7} : T{}) << "count " << count << " lane " << lane;
+        }
+    }
+}
+
+TEST(Simd, PackPartial)
+{
+    expectPartial<std::int8_t, 16>();
+    expectPartial<std::int16_t, 16>();
+    expectPartial<std::int32_t, 4>();
+    expectPartial<std::int32_t, 8>();
+    expectPartial<std::int64_t, 4>();
+    expectPartial<float, 8>();
+    expectPartial<float, 16>();
+    expectPartial<double, 2>();
+    expectPartial<double, 8>();
+    expectPartial<std::uint8_t, 64>();
+}
+
+TEST(Simd, PackAlignedLoadStore)
+{
+    alignas(64) float data[16] {};
+    const auto i = iota<float, 16>();
+    i.store(data);
+    EXPECT_EQ(data[15], 15.0f);
+    EXPECT_TRUE(all(pack<float, 16>::load(data) == i));
+    EXPECT_TRUE(all(pack<float, 16>{i.to_array()} == i));
+}
+
+namespace
+{
+int whichBaseline() { return 0; }
+int whichSse2() { return 1; }
+int whichAvx512() { return 3; }
+} // namespace
+
+TEST(Simd, Dispatch)
+{
+    using cgs::simd::isa;
+    const isa detected = cgs::simd::detect_isa();
+    EXPECT_STREQ(cgs::simd::to_string(isa::avx2), "avx2");
+
+    // no avx2 entry, falls back to sse2
+    const cgs::simd::dispatch<int()> which { &whichBaseline, &whichSse2, nullptr, &whichAvx512 };
+
+    EXPECT_EQ(cgs::simd::force_isa(isa::baseline), isa::baseline);
+    EXPECT_EQ(which(), 0);
+    if(detected >= isa::sse2) {
+        EXPECT_EQ(cgs::simd::force_isa(isa::sse2), isa::sse2);
+        EXPECT_EQ(which(), 1);
+    }
+    if(detected >= isa::avx2) {
+        EXPECT_EQ(cgs::simd::force_isa(isa::avx2), isa::avx2);
+        EXPECT_EQ(which(), 1);
+    }
+
+    // clamped to what the CPU supports
+    EXPECT_EQ(cgs::simd::force_isa(isa::avx512), detected);
+    EXPECT_EQ(cgs::simd::current_isa(), detected);
+    EXPECT_EQ(which(), detected == isa::avx512 ? 3 : detected == isa::baseline ? 0 : 1);
+}
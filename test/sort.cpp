@@ -0,0 +1,313 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#include "cgs/sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// the end of a null terminated string
+struct NullTerminated
+{ };
+
+constexpr bool operator!=(const char* p, NullTerminated)
+{
+    return *p != '\0';
+}
+
+struct Keyed
+{
+    int key;
+    int order;
+};
+
+constexpr bool byKey(const Keyed& a, const Keyed& b)
+{
+    return a.key < b.key;
+}
+
+template <std::size_t N>
+constexpr std::array<int, N> scrambled()
+{
+    std::array<int, N> values {};
+    for(std::size_t i = 0; i < N; ++i) {
+        values[i] = static_cast<int>((i * 37 + 11) % 101) - 50;
+    }
+    return values;
+}
+
+template <std::size_t N>
+constexpr bool isSorted(const std::array<int, N>& values)
+{
+    for(std::size_t i = 1; i < N; ++i) {
+        if(values[i] < values[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t N>
+constexpr std::array<int, N> sorted()
+{
+    std::array<int, N> values = scrambled<N>();
+    cgs::sort(values.begin(), values.end());
+    return values;
+}
+
+template <std::size_t N>
+constexpr std::array<Keyed, N> stableSorted()
+{
+    std::array<Keyed, N> values {};
+    for(std::size_t i = 0; i < N; ++i) {
+        values[i] = { static_cast<int>((i * 7) % 5), static_cast<int>(i) };
+    }
+    cgs::stable_sort(values.begin(), values.end(), byKey);
+    return values;
+}
+
+template <std::size_t N>
+constexpr bool isStable(const std::array<Keyed, N>& values)
+{
+    for(std::size_t i = 1; i < N; ++i) {
+        if(values[i].key < values[i - 1].key
+            || (values[i].key == values[i - 1].key && values[i].order < values[i - 1].order)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the sum of the k smallest
+constexpr int sumSmallest(std::array<int, 40> values, std::size_t k)
+{
+    cgs::partial_sort(values.begin(), values.begin() + k, values.end());
+    int sum = 0;
+    for(std::size_t i = 0; i < k; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+std::vector<int> randomInts(std::size_t n, int range, std::uint64_t seed)
+{
+    std::mt19937_64 engine { seed };
+    std::uniform_int_distribution<int> distribution { 0, range };
+    std::vector<int> values(n);
+    for(int& value : values) {
+        value = distribution(engine);
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(Sort, Constexpr)
+{
+    static_assert(isSorted(sorted<0>()));
+    static_assert(isSorted(sorted<1>()));
+    static_assert(isSorted(sorted<17>()));
+    static_assert(isSorted(sorted<32>()));
+    static_assert(isSorted(sorted<100>()));
+    static_assert(isSorted(sorted<300>()));
+    static_assert(isStable(stableSorted<10>()));
+    static_assert(isStable(stableSorted<200>()));
+    static_assert(sumSmallest(scrambled<40>(), 5) == sorted<40>()[0] + sorted<40>()[1] + sorted<40>()[2]
+        + sorted<40>()[3] + sorted<40>()[4]);
+    static_assert(cgs::detail::sorting_network<32>::size == 191);
+}
+
+TEST(Sort, NetworksZeroOne)
+{
+    // a network sorts everything if it sorts every sequence of 0s and 1s
+    for(std::size_t n = 0; n <= 16; ++n) {
+        for(std::uint32_t bits = 0; bits < (std::uint32_t{1} << n); ++bits) {
+            std::array<int, 16> values {};
+            for(std::size_t i = 0; i < n; ++i) {
+                values[i] = (bits >> i) & 1;
+            }
+            cgs::sort(values.begin(), values.begin() + n);
+            ASSERT_TRUE(std::is_sorted(values.begin(), values.begin() + n)) << n << " " << bits;
+        }
+    }
+}
+
+TEST(Sort, Random)
+{
+    std::vector<std::size_t> sizes;
+    for(std::size_t n = 0; n <= 100; ++n) {
+        sizes.push_back(n);
+    }
+    for(std::size_t n : { 255, 1000, 4097, 100000 }) {
+        sizes.push_back(n);
+    }
+    for(std::size_t n : sizes) {
+        // many duplicates, and few
+        for(int range : { 3, 1 << 30 }) {
+            std::vector<int> values = randomInts(n, range, n);
+            std::vector<int> expected = values;
+            std::sort(expected.begin(), expected.end());
+            cgs::sort(values.begin(), values.end());
+            ASSERT_EQ(values, expected) << n;
+
+            cgs::sort(values.begin(), values.end(), std::greater<>{});
+            std::reverse(expected.begin(), expected.end());
+            ASSERT_EQ(values, expected) << n;
+        }
+    }
+}
+
+TEST(Sort, Patterns)
+{
+    const std::size_t n = 10000;
+    std::vector<std::vector<int>> inputs(4, std::vector<int>(n));
+    for(std::size_t i = 0; i < n; ++i) {
+        inputs[0][i] = static_cast<int>(i);
+        inputs[1][i] = static_cast<int>(n - i);
+        inputs[2][i] = static_cast<int>(i < n / 2 ? i : n - i);
+        inputs[3][i] = 7;
+    }
+    for(std::vector<int> values : inputs) {
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        cgs::sort(values.begin(), values.end());
+        EXPECT_EQ(values, expected);
+    }
+
+    // past the depth limit, heapsort
+    std::vector<int> values = randomInts(5000, 1000, 1);
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+    std::less<> less;
+    cgs::detail::introsort(values.begin(), values.end(), 0, less);
+    EXPECT_EQ(values, expected);
+}
+
+TEST(Sort, Sentinel)
+{
+    char text[] = "sorting";
+    cgs::sort(text + 0, NullTerminated{});
+    EXPECT_EQ(std::string(text), "ginorst");
+
+    char longer[] = "the quick brown fox jumps over the lazy dog, and sorts itself";
+    std::string expected = longer;
+    std::sort(expected.begin(), expected.end());
+    cgs::stable_sort(longer + 0, NullTerminated{});
+    EXPECT_EQ(std::string(longer), expected);
+}
+
+TEST(Sort, NonArithmetic)
+{
+    std::vector<std::string> words { "pear", "fig", "apple", "kiwi", "date", "lime", "plum", "banana", "cherry" };
+    std::vector<std::string> expected = words;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> sorted = words;
+    cgs::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sorted, expected);
+
+    sorted = words;
+    cgs::sort_network<9>(sorted.begin());
+    EXPECT_EQ(sorted, expected);
+
+    std::vector<std::string> many;
+    for(int i = 0; i < 500; ++i) {
+        many.push_back(std::to_string(i * 7919 % 1000));
+    }
+    expected = many;
+    std::sort(expected.begin(), expected.end());
+    cgs::sort(many.begin(), many.end());
+    EXPECT_EQ(many, expected);
+}
+
+template <std::size_t... N>
+void expectSortNetworks(std::index_sequence<N...>)
+{
+    std::mt19937 engine { 5 };
+    auto check = [&engine](auto n) {
+        constexpr std::size_t size = decltype(n)::value;
+        std::array<float, size + 1> values {};
+        for(float& value : values) {
+            value = static_cast<float>(engine() % 100);
+        }
+        const float guard = values[size];
+        std::array<float, size + 1> expected = values;
+        std::sort(expected.begin(), expected.begin() + size);
+        cgs::sort_network<size>(values.begin());
+        EXPECT_EQ(values, expected) << size;
+        EXPECT_EQ(values[size], guard);
+    };
+    (check(std::integral_constant<std::size_t, N>{}), ...);
+}
+
+TEST(Sort, SortNetwork)
+{
+    for(int repeat = 0; repeat < 20; ++repeat) {
+        expectSortNetworks(std::make_index_sequence<33>{});
+    }
+}
+
+TEST(Sort, Stable)
+{
+    for(std::size_t n : { 0, 1, 31, 32, 33, 100, 1000, 5000 }) {
+        std::vector<Keyed> values(n);
+        std::mt19937 engine { static_cast<unsigned>(n) };
+        for(std::size_t i = 0; i < n; ++i) {
+            values[i] = { static_cast<int>(engine() % 10), static_cast<int>(i) };
+        }
+        std::vector<Keyed> expected = values;
+        std::stable_sort(expected.begin(), expected.end(), byKey);
+
+        // the compile time merges, at runtime
+        std::vector<Keyed> inPlace = values;
+        auto comp = byKey;
+        cgs::detail::stable_sort_in_place(inPlace.begin(), inPlace.end(), comp);
+        cgs::stable_sort(values.begin(), values.end(), byKey);
+        for(std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(values[i].order, expected[i].order) << n << " " << i;
+            ASSERT_EQ(inPlace[i].order, expected[i].order) << n << " " << i;
+        }
+    }
+}
+
+TEST(Sort, Partial)
+{
+    for(std::size_t n : { 0, 1, 10, 100, 10000 }) {
+        for(std::size_t k : { 0, 1, 5, 32, 33, 100 }) {
+            if(k > n) {
+                continue;
+            }
+            std::vector<int> values = randomInts(n, 1000, n + k);
+            std::vector<int> expected = values;
+            std::sort(expected.begin(), expected.end());
+            cgs::partial_sort(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), values.end());
+            EXPECT_TRUE(std::equal(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(k), expected.begin()));
+            std::sort(values.begin(), values.end());
+            EXPECT_EQ(values, expected);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/static_map.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+
+enum class Color
+{
+    red,
+    green,
+    blue
+};
+
+constexpr auto opcodes = cgs::make_static_map<std::string_view, int>({
+    { "add", 1 }, { "sub", 2 }, { "mul", 3 }, { "div", 4 }, { "mov", 5 }, { "jmp", 7 },
+    { "", 0 }, { "a_rather_long_opcode_name", 8 }, { "exactly_16_bytes", 9 }
+});
+
+constexpr auto colorNames = cgs::make_static_map<Color, std::string_view>({
+    { Color::red, "red" }, { Color::green, "green" }, { Color::blue, "blue" }
+});
+
+// squares of 0 .. N-1
+template <std::size_t N>
+constexpr auto squares()
+{
+    std::array<std::pair<std::uint32_t, std::uint32_t>, N> pairs {};
+    for(std::uint32_t i = 0; i < N; ++i) {
+        pairs[i].first = i * 7919u;
+        pairs[i].second = i * i;
+    }
+    return cgs::static_map<std::uint32_t, std::uint32_t, N> { pairs };
+}
+
+// every key in one bucket and one slot, so no seed builds a map of two keys
+struct ConstantHash
+{
+    constexpr std::uint64_t operator()(int, std::uint64_t) const noexcept
+    {
+        return 0;
+    }
+};
+
+constexpr std::string_view alphabet = "abcdefghijklmnopqrstuvwxyz";
+
+// hashes of every prefix of alphabet
+template <std::size_t... Sizes>
+constexpr std::array<std::uint64_t, sizeof...(Sizes)> prefixHashes(std::index_sequence<Sizes...>)
+{
+    return { cgs::static_hash<std::string_view>{}(alphabet.substr(0, Sizes), 42)... };
+}
+
+} // namespace
+
+TEST(StaticMap, Constexpr)
+{
+    static_assert(opcodes.size() == 9);
+    static_assert(opcodes.at("jmp") == 7);
+    static_assert(opcodes.at("") == 0);
+    static_assert(opcodes.at("a_rather_long_opcode_name") == 8);
+    static_assert(opcodes.find("nop") == nullptr);
+    static_assert(!opcodes.contains("ad"));
+    static_assert(!opcodes.contains("addd"));
+    static_assert(colorNames.at(Color::green) == "green");
+
+    constexpr auto empty = cgs::make_static_map(std::array<std::pair<int, int>, 0>{});
+    static_assert(empty.empty());
+    static_assert(!empty.contains(0));
+
+    constexpr auto large = squares<500>();
+    static_assert(large.at(499 * 7919u) == 499 * 499);
+    static_assert(!large.contains(1));
+}
+
+TEST(StaticMap, Runtime)
+{
+    for(const auto& pair : { std::pair<std::string, int>{ "add", 1 }, { "div", 4 }, { "", 0 },
+            { "a_rather_long_opcode_name", 8 }, { "exactly_16_bytes", 9 } }) {
+        // a copy, not the same pointer as the key
+        const std::string key = pair.first;
+        ASSERT_NE(opcodes.find(key), nullptr) << key;
+        EXPECT_EQ(*opcodes.find(key), pair.second);
+        EXPECT_EQ(opcodes.at(key), pair.second);
+    }
+    for(const std::string key : { "nop", "ADD", "ad", "a_rather_long_opcode_namE", "A_rather_long_opcode_name",
+            "exactly_16_byteS", "exactly_16_bytes_" }) {
+        EXPECT_FALSE(opcodes.contains(key)) << key;
+    }
+    EXPECT_FALSE(opcodes.contains(std::string_view { "\0\0\0", 3 }));
+    EXPECT_THROW(opcodes.at("nop"), std::logic_error);
+    EXPECT_EQ(colorNames.at(Color::blue), "blue");
+}
+
+TEST(StaticMap, Perfect)
+{
+    // each key in its own slot
+    static constexpr auto large = squares<500>();
+    std::set<std::uint32_t> keys(large.keys().begin(), large.keys().end());
+    EXPECT_EQ(keys.size(), large.size());
+    for(std::uint32_t i = 0; i < 500; ++i) {
+        ASSERT_EQ(large.at(i * 7919u), i * i);
+        ASSERT_FALSE(large.contains(i * 7919u + 1));
+    }
+}
+
+TEST(StaticMap, Hash)
+{
+    // the same at compile time and runtime, for every length
+    constexpr auto expected = prefixHashes(std::make_index_sequence<alphabet.size() + 1>{});
+    for(std::size_t n = 0; n <= alphabet.size(); ++n) {
+        const std::string prefix { alphabet.substr(0, n) };
+        EXPECT_EQ(cgs::static_hash<std::string_view>{}(prefix, 42), expected[n]) << n;
+    }
+    static_assert(cgs::static_hash<int>{}(-1, 0) != cgs::static_hash<int>{}(1, 0));
+}
+
+TEST(StaticMap, BytesEqual)
+{
+    // every length and mismatch position, against the end of a buffer
+    const std::string a(40, 'x');
+    for(std::size_t n = 0; n <= a.size(); ++n) {
+        std::string b(a.data(), n);
+        EXPECT_TRUE(cgs::detail::static_map_bytes_equal(a.data() + a.size() - n, b.data(), n));
+        for(std::size_t i = 0; i < n; ++i) {
+            b[i] = 'y';
+            ASSERT_FALSE(cgs::detail::static_map_bytes_equal(a.data() + a.size() - n, b.data(), n)) << n << " " << i;
+            b[i] = 'x';
+        }
+    }
+}
+
+TEST(StaticMap, Invalid)
+{
+    const std::array<std::pair<int, int>, 3> duplicate {{ { 1, 1 }, { 2, 2 }, { 1, 3 } }};
+    EXPECT_THROW(cgs::make_static_map(duplicate), std::logic_error);
+
+    // the seeds run out instead of looping forever
+    const std::array<std::pair<int, int>, 2> unhashable {{ { 1, 1 }, { 2, 2 } }};
+    EXPECT_DEATH((cgs::static_map<int, int, 2, ConstantHash>{ unhashable }), R"(Assertion failed \(attempt < max_seed\))");
+}
@@ -0,0 +1,181 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#define CGS_VIOLATE_THROW
+#include "cgs/table.hpp"
+using cgs::float16;
+using cgs::fixed;
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+
+constexpr std::uint8_t reverse_bits(std::size_t i)
+{
+    std::uint8_t result = 0;
+    for(int bit = 0; bit < 8; ++bit) {
+        result = static_cast<std::uint8_t>(result << 1 | ((i >> bit) & 1));
+    }
+    return result;
+}
+
+constexpr auto reversed = cgs::make_table<256>(reverse_bits);
+
+constexpr float quarter_turn = 1.57079637f;
+
+constexpr auto sine = cgs::make_lerp_table<65>([](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+constexpr auto sine16 = cgs::make_lerp_table<65, float16>([](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+constexpr auto sine_fixed = cgs::make_lerp_table<65, fixed<std::int16_t, 14>>([](float x) { return cgs::sin(x); }, 0.f, quarter_turn);
+
+float16 from_float_bits(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof value);
+    return float16 { value };
+}
+
+} // namespace
+
+TEST(Table, Make)
+{
+    static_assert(reversed.size() == 256);
+    static_assert(reversed[1] == 0x80);
+    static_assert(reversed[0x0f] == 0xf0);
+    static_assert(alignof(decltype(reversed)) == cgs::cache_line_size);
+    static_assert(std::is_same<decltype(reversed)::value_type, std::uint8_t>::value);
+
+    for(std::size_t i = 0; i < reversed.size(); ++i) {
+        EXPECT_EQ(reversed[reverse_bits(i)], i);
+    }
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(reversed.data()) % cgs::cache_line_size, 0u);
+    EXPECT_THROW(reversed[256], std::logic_error);
+
+    // converted entries
+    constexpr auto squares = cgs::make_table<8, double>([](std::size_t i) { return i * i; });
+    static_assert(squares[7] == 49.0);
+}
+
+TEST(Table, Float16)
+{
+    static_assert(float16{ 1.f }.bits() == 0x3c00);
+    static_assert(float16{ -2.0 }.bits() == 0xc000);
+    static_assert(float16{ 65504.f }.bits() == 0x7bff);
+    static_assert(float16{ 65520.f }.bits() == 0x7c00);
+    static_assert(float16{ 0x1p-24f }.bits() == 0x0001);
+    static_assert(float16{ 0x1p-25f }.bits() == 0x0000);
+    static_assert(float16{ 0x1.8p-25f }.bits() == 0x0001);
+    // ties to even
+    static_assert(float16{ 1 + 0x1p-11f }.bits() == 0x3c00);
+    static_assert(float16{ 1 + 0x3p-11f }.bits() == 0x3c02);
+    static_assert(float16{ 0.1 }.bits() == 0x2e66);
+    static_assert(float(float16{ 0.1f }) == 0x1.998p-4f);
+    static_assert(float(float16::from_bits(0x8001)) == -0x1p-24f);
+    static_assert(float(float16::from_bits(0x7c00)) == std::numeric_limits<float>::infinity());
+    EXPECT_TRUE(std::isnan(float(float16{ std::numeric_limits<double>::quiet_NaN() })));
+
+    // every binary16 converts to float and back exactly
+    for(std::uint32_t bits = 0; bits <= 0xffff; ++bits) {
+        const float16 h = float16::from_bits(static_cast<std::uint16_t>(bits));
+        if(!std::isnan(float(h))) {
+            EXPECT_EQ(float16{ float(h) }.bits(), bits);
+            EXPECT_EQ(float16{ double(h) }.bits(), bits);
+        }
+    }
+
+    // rounding of finite values between two binary16, against the nearest by comparison
+    for(std::uint32_t bits = 0x33800000; bits < 0x477fe000; bits += 0x1f1) {
+        float value;
+        std::memcpy(&value, &bits, sizeof value);
+        const float16 rounded = from_float_bits(bits);
+        const float16 below = float16::from_bits(static_cast<std::uint16_t>(rounded.bits() - 1));
+        const float16 above = float16::from_bits(static_cast<std::uint16_t>(rounded.bits() + 1));
+        EXPECT_LE(std::fabs(float(rounded) - value), std::fabs(float(below) - value));
+        EXPECT_LE(std::fabs(float(rounded) - value), std::fabs(float(above) - value));
+    }
+}
+
+TEST(Table, Fixed)
+{
+    using q14 = fixed<std::int16_t, 14>;
+    static_assert(q14{ 1.0 }.raw() == 1 << 14);
+    static_assert(q14{ -0.5f }.raw() == -(1 << 13));
+    static_assert(q14{ 0x1p-15 }.raw() == 0);
+    static_assert(q14{ 0x3p-15 }.raw() == 2);
+    static_assert(double(q14::from_raw(3)) == 0x3p-14);
+    static_assert(fixed<std::uint8_t, 0>{ 255.0 }.raw() == 255);
+    static_assert(fixed<std::int64_t, 0>{ 0x1p62 }.raw() == std::int64_t{1} << 62);
+    EXPECT_THROW((q14{ 2.0 }), std::logic_error);
+    EXPECT_THROW((q14{ -2.0001 }), std::logic_error);
+    EXPECT_THROW((fixed<std::int64_t, 0>{ 0x1p63 }), std::logic_error);
+    EXPECT_THROW((fixed<std::uint8_t, 0>{ 255.5 }), std::logic_error);
+    EXPECT_THROW((q14{ std::numeric_limits<double>::quiet_NaN() }), std::logic_error);
+}
+
+TEST(Table, Lerp)
+{
+    static_assert(sine(0.f) == 0);
+    static_assert(sine(quarter_turn) == 1);
+    static_assert(sine.node(32) == quarter_turn / 2);
+    static_assert(sizeof(sine16.entries()) == cgs::cache_line_size * 3);
+
+    // clamped outside [min, max]
+    EXPECT_EQ(sine(-1.f), 0);
+    EXPECT_EQ(sine(10.f), 1);
+    EXPECT_EQ(sine(std::numeric_limits<float>::infinity()), 1);
+    EXPECT_EQ(sine(std::numeric_limits<float>::quiet_NaN()), 1);
+
+    for(std::size_t i = 0; i < 65; ++i) {
+        const float x = sine.node(i);
+        EXPECT_FLOAT_EQ(sine(x), std::sin(x));
+    }
+    for(float x = 0; x < quarter_turn; x += 0.001f) {
+        EXPECT_NEAR(sine(x), std::sin(x), 1e-4f);
+        EXPECT_NEAR(sine16(x), std::sin(x), 1e-3f);
+        EXPECT_NEAR(sine_fixed(x), std::sin(x), 2e-4f);
+    }
+
+    EXPECT_THROW((cgs::make_lerp_table<4>([](double x) { return x; }, 1.0, 1.0)), std::logic_error);
+}
+
+TEST(Table, Error)
+{
+    constexpr auto reference = [](float x) { return cgs::sin(x); };
+
+    // interpolation error is about h^2 / 8 max |sin''|, h = pi / 128
+    constexpr cgs::table_error<float> error = sine.error(reference);
+    static_assert(error.max_abs > 5e-5f && error.max_abs < 8e-5f);
+    static_assert(error.worst > 1.5f);
+    static_assert(error.max_rel > error.max_abs);
+
+    // compression adds its rounding to that
+    static_assert(sine16.error(reference).max_abs > error.max_abs);
+    static_assert(sine16.error(reference).max_abs < error.max_abs + 0x1p-12f);
+    static_assert(sine_fixed.error(reference).max_abs < error.max_abs + 0x1p-15f);
+
+    // for a plain table, the entry rounding alone
+    constexpr auto thirds = cgs::make_table<16, float16>([](std::size_t i) { return i / 3.0; });
+    constexpr auto entry_error = thirds.error([](std::size_t i) { return i / 3.0; });
+    static_assert(entry_error.max_abs > 0 && entry_error.max_abs <= 0x1p-9);
+    static_assert(entry_error.max_rel <= 0x1p-11);
+    EXPECT_EQ(cgs::make_table<4>([](std::size_t i) { return i * 0.5; }).error([](std::size_t i) { return i * 0.5; }).max_abs, 0);
+}
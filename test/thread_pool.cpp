@@ -0,0 +1,76 @@
+/*
+   Copyright 2017 Cory Sherman
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+
+#include "cgs/thread_pool.hpp"
+using cgs::thread_pool;
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPool, Submit)
+{
+    std::atomic<int> sum {};
+    {
+        thread_pool pool { 2 };
+        EXPECT_EQ(pool.size(), 2u);
+        for(int i = 1; i <= 100; ++i) {
+            pool.submit([&sum, i] { sum += i; });
+        }
+        // destructor finishes every task
+    }
+    EXPECT_EQ(sum, 5050);
+}
+
+TEST(ThreadPool, ParallelFor)
+{
+    for(std::size_t threads : { 0, 1, 4 }) {
+        thread_pool pool { threads };
+        std::vector<int> hits(1000);
+        pool.parallel_for(hits.size(), [&hits](std::size_t i) { ++hits[i]; });
+        for(int hit : hits) {
+            EXPECT_EQ(hit, 1);
+        }
+        pool.parallel_for(0, [](std::size_t) { FAIL(); });
+    }
+}
+
+TEST(ThreadPool, ParallelForNested)
+{
+    // every worker may be blocked in the outer loop, inner loops still progress on their calling threads
+    thread_pool pool { 2 };
+    std::atomic<int> count {};
+    pool.parallel_for(8, [&](std::size_t) {
+        pool.parallel_for(8, [&](std::size_t) { ++count; });
+    });
+    EXPECT_EQ(count, 64);
+}
+
+TEST(ThreadPool, ParallelForThrow)
+{
+    thread_pool pool { 2 };
+    std::atomic<int> count {};
+    EXPECT_THROW(pool.parallel_for(100, [&count](std::size_t i) {
+        ++count;
+        if(i == 50) {
+            throw std::runtime_error("fifty");
+        }
+    }), std::runtime_error);
+
+    // the other iterations still ran
+    EXPECT_EQ(count, 100);
+}